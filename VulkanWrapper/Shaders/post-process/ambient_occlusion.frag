@@ -20,11 +20,13 @@ layout (set = 0, binding = 4) uniform accelerationStructureEXT topLevelAS;
 layout (push_constant) uniform PushConstants {
     float aoRadius;
     int sampleIndex; // Which sample to use this frame (for progressive accumulation)
+    vec2 inputUvScale; // Used area of pooled G-buffer images
 } pushConstants;
 
 void main()
 {
-    vec4 positionSample = texture(samplerPosition, inUV);
+    vec2 uv = inUV * pushConstants.inputUvScale;
+    vec4 positionSample = texture(samplerPosition, uv);
 
     // Skip background (alpha = 0 means no geometry was rendered)
     // Output white (no occlusion) for background pixels
@@ -34,9 +36,9 @@ void main()
     }
 
     vec3 position = positionSample.rgb;
-    vec3 normal = normalize(texture(samplerNormal, inUV).rgb);
-    vec3 tangent = normalize(texture(samplerTangent, inUV).rgb);
-    vec3 bitangent = normalize(texture(samplerBitangent, inUV).rgb);
+    vec3 normal = normalize(texture(samplerNormal, uv).rgb);
+    vec3 tangent = normalize(texture(samplerTangent, uv).rgb);
+    vec3 bitangent = normalize(texture(samplerBitangent, uv).rgb);
 
     float aoRadius = pushConstants.aoRadius;
 
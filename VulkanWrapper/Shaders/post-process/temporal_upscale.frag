@@ -0,0 +1,72 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform sampler2D sky_buffer;          // sky radiance
+layout(set = 0, binding = 1) uniform sampler2D direct_light_buffer; // direct light
+layout(set = 0, binding = 2) uniform sampler2D indirect_buffer;     // indirect light
+layout(set = 0, binding = 3) uniform sampler2D depth_buffer;        // depth, render resolution
+layout(set = 0, binding = 4) uniform sampler2D history_buffer;      // previous output
+
+layout(location = 0) in vec2 in_uv;
+layout(location = 0) out vec4 out_color;
+layout(location = 1) out vec4 out_history;
+
+layout(push_constant) uniform PushConstants {
+    mat4 reprojection;       // previous view-projection * inverse(current)
+    vec2 input_uv_scale;     // used area of the input images
+    vec2 input_uv_jitter;    // jitter of the frame, in input UV
+    float indirect_intensity;
+    float blend_factor;      // weight of the current frame, 1 = no history
+} push;
+
+vec3 radiance_at(vec2 uv) {
+    return texture(sky_buffer, uv).rgb + texture(direct_light_buffer, uv).rgb +
+           texture(indirect_buffer, uv).rgb * push.indirect_intensity;
+}
+
+vec3 radiance_at_texel(ivec2 texel) {
+    return texelFetch(sky_buffer, texel, 0).rgb +
+           texelFetch(direct_light_buffer, texel, 0).rgb +
+           texelFetch(indirect_buffer, texel, 0).rgb * push.indirect_intensity;
+}
+
+void main() {
+    // Jittered frames rendered the point at in_uv offset by the jitter
+    vec2 image_size = vec2(textureSize(direct_light_buffer, 0));
+    vec2 used_area = push.input_uv_scale;
+    vec2 half_texel = 0.5 / image_size;
+    vec2 input_uv = clamp(in_uv * used_area + push.input_uv_jitter,
+                          half_texel, used_area - half_texel);
+
+    vec3 current = radiance_at(input_uv);
+
+    // Color range of the 3x3 neighbourhood in the current frame
+    ivec2 center = ivec2(input_uv * image_size);
+    ivec2 last_texel = ivec2(used_area * image_size) - 1;
+    vec3 lowest = current;
+    vec3 highest = current;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            ivec2 texel = clamp(center + ivec2(x, y), ivec2(0), last_texel);
+            vec3 neighbour = radiance_at_texel(texel);
+            lowest = min(lowest, neighbour);
+            highest = max(highest, neighbour);
+        }
+    }
+
+    // Where the surface of the pixel was in the previous frame
+    float depth = texelFetch(depth_buffer, center, 0).r;
+    vec4 previous = push.reprojection * vec4(in_uv * 2.0 - 1.0, depth, 1.0);
+    vec2 previous_uv = previous.xy / previous.w * 0.5 + 0.5;
+
+    vec3 result = current;
+    bool on_screen = all(greaterThanEqual(previous_uv, vec2(0.0))) &&
+                     all(lessThanEqual(previous_uv, vec2(1.0)));
+    if (push.blend_factor < 1.0 && on_screen) {
+        vec3 history = texture(history_buffer, previous_uv).rgb;
+        history = clamp(history, lowest, highest);
+        result = mix(history, current, push.blend_factor);
+    }
+
+    out_color = vec4(result, 1.0);
+    out_history = vec4(result, 1.0);
+}
@@ -15,6 +15,7 @@ const int OPERATOR_UNCHARTED2 = 3;
 const int OPERATOR_NEUTRAL = 4;
 
 layout(push_constant) uniform PushConstants {
+    vec2 input_uv_scale;      // Used area of pooled input images
     float exposure;           // EV multiplier (default: 1.0)
     int operator_id;          // ToneMappingOperator enum value
     float white_point;        // For Reinhard Extended (default: 4.0)
@@ -93,8 +94,9 @@ vec3 apply_tone_mapping(vec3 hdr_color, int op, float white_point) {
 }
 
 void main() {
-    // UVs are already in [0, 1] from fullscreen vertex shader
-    vec2 uv = in_uv;
+    // UVs are in [0, 1] from fullscreen vertex shader, scaled to
+    // the area of the inputs in use
+    vec2 uv = in_uv * push.input_uv_scale;
 
     // Sample sky radiance buffer
     vec3 sky_color = texture(sky_buffer, uv).rgb;
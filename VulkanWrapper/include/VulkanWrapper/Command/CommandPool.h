@@ -9,7 +9,15 @@ class CommandPool : public ObjectWithUniqueHandle<vk::UniqueCommandPool> {
     friend class CommandPoolBuilder;
 
   public:
-    std::vector<vk::CommandBuffer> allocate(std::size_t number);
+    std::vector<vk::CommandBuffer>
+    allocate(std::size_t number,
+             vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary);
+
+    /**
+     * @brief Resets every command buffer of the pool to the initial
+     * state, keeping their memory for the next recording
+     */
+    void reset();
 
   private:
     CommandPool(std::shared_ptr<const Device> device,
@@ -25,11 +33,16 @@ class CommandPoolBuilder {
     /** @brief Allow individual command buffers to be reset */
     CommandPoolBuilder &with_reset_command_buffer();
 
+    /** @brief Queue family the command buffers are submitted to (0 by
+     * default) */
+    CommandPoolBuilder &with_queue_family(uint32_t family_index);
+
     CommandPool build();
 
   private:
     std::shared_ptr<const Device> m_device;
     vk::CommandPoolCreateFlags m_flags{};
+    uint32_t m_queue_family_index = 0;
 };
 
 } // namespace vw
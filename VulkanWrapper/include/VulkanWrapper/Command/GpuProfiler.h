@@ -0,0 +1,126 @@
+#pragma once
+#include "VulkanWrapper/3rd_party.h"
+#include "VulkanWrapper/fwd.h"
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vw {
+
+/**
+ * Counters of the pipeline-statistics query of a scope, in the order
+ * Vulkan writes them.
+ */
+struct PipelineStatistics {
+    uint64_t input_assembly_vertices = 0;
+    uint64_t vertex_shader_invocations = 0;
+    uint64_t clipping_primitives = 0;
+    uint64_t fragment_shader_invocations = 0;
+    uint64_t compute_shader_invocations = 0;
+};
+
+/**
+ * GPU time of a named scope over the last frames, see
+ * GpuProfiler::timings().
+ */
+struct ScopeTiming {
+    std::string name;
+    std::size_t sample_count = 0;
+    double min_ms = 0.0;
+    double avg_ms = 0.0;
+    double max_ms = 0.0;
+    /** @brief Counters of the latest sample, zero without statistics */
+    PipelineStatistics statistics;
+};
+
+/**
+ * Measures the GPU time of named scopes, e.g. render passes, with
+ * timestamps written before and after them.
+ *
+ * Every frame in flight has its own query pools. begin_frame() reads back
+ * the queries of the frame that last used the slot, `frames_in_flight`
+ * frames ago, without waiting: the caller has waited for that frame to
+ * complete before recording in its slot again, and results that are not
+ * available anyway are dropped rather than stalled on. Timings are thus
+ * `frames_in_flight` frames late.
+ *
+ * With pipeline statistics, each scope is also wrapped in a
+ * pipeline-statistics query; the device must be created with
+ * DeviceFinder::with_pipeline_statistics_query(). Scopes do not nest. Not
+ * thread-safe.
+ *
+ * With VW_ENABLE_TRACING, the scopes read back are also recorded as
+ * trace zones on the GPU track, see trace::to_chrome_json(). A timestamp
+ * written by begin_frame() anchors them at the CPU time of that call, so
+ * they show the GPU durations and gaps of the frame but not the latency
+ * between recording and execution.
+ */
+class GpuProfiler {
+  public:
+    /** @brief Number of frames the min/avg/max of a scope cover */
+    static constexpr std::size_t window_size = 128;
+
+    GpuProfiler(std::shared_ptr<const Device> device,
+                uint32_t frames_in_flight, uint32_t max_scopes = 64,
+                bool pipeline_statistics = false, uint32_t queue_family = 0);
+
+    /**
+     * Starts a new frame recorded into `cmd`: reads back the slot of the
+     * frame and resets its queries. Call outside of a render pass, before
+     * the first scope.
+     */
+    void begin_frame(vk::CommandBuffer cmd);
+
+    void begin_scope(vk::CommandBuffer cmd, std::string_view name);
+    void end_scope(vk::CommandBuffer cmd);
+
+    /** @brief Timings of every scope measured so far, by first use */
+    [[nodiscard]] std::vector<ScopeTiming> timings() const;
+
+    /** @brief One line per scope, after a header line */
+    [[nodiscard]] std::string to_csv() const;
+
+    /** @brief Single-line JSON object, for logs and tooling */
+    [[nodiscard]] std::string to_json() const;
+
+  private:
+    struct FrameSlot {
+        vk::UniqueQueryPool timestamps;
+        vk::UniqueQueryPool statistics;
+        std::vector<std::string> names;
+        uint32_t scope_count = 0;
+        // trace::now() at begin_frame(), for the trace anchor
+        uint64_t cpu_begin_ns = 0;
+    };
+
+    // Latest samples of a scope, in a ring
+    struct History {
+        std::string name;
+        std::array<double, window_size> samples{};
+        std::size_t count = 0;
+        std::size_t next = 0;
+        PipelineStatistics statistics;
+    };
+
+    void read_back(FrameSlot &slot);
+    void trace_scopes(const FrameSlot &slot);
+    History &history(std::string_view name);
+
+    std::shared_ptr<const Device> m_device;
+    uint32_t m_max_scopes;
+    bool m_pipeline_statistics;
+    double m_timestamp_period;
+    uint64_t m_timestamp_mask;
+
+    std::vector<FrameSlot> m_slots;
+    std::size_t m_frame_slot = 0;
+    bool m_frame_begun = false;
+    bool m_scope_open = false;
+
+    std::vector<History> m_history;
+    std::vector<uint64_t> m_results;
+};
+
+} // namespace vw
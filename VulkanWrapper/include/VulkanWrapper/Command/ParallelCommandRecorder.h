@@ -0,0 +1,98 @@
+#pragma once
+#include "VulkanWrapper/3rd_party.h"
+#include "VulkanWrapper/Command/CommandPool.h"
+#include "VulkanWrapper/fwd.h"
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vw {
+
+/**
+ * Records long draw loops on several threads, into secondary command
+ * buffers that the primary one executes in order.
+ *
+ * record() splits a range of items in contiguous chunks, one per thread:
+ * the calling thread records the first one and `thread_count - 1` workers
+ * the others. Every thread allocates from its own command pool, one per
+ * frame in flight. A command buffer recorded in a frame may be reused once
+ * begin_frame() has been called `frames_in_flight` times, when the caller
+ * has waited for that frame to complete.
+ *
+ * The secondary command buffers continue a dynamic rendering begun with
+ * eContentsSecondaryCommandBuffers. They inherit no state: the record
+ * function binds pipelines and descriptor sets and sets the dynamic state
+ * of every chunk. Not thread-safe.
+ */
+class ParallelCommandRecorder {
+  public:
+    /** @brief Records the items [first, last) into `cmd_buffer` */
+    using RecordFunction = std::function<void(
+        vk::CommandBuffer cmd_buffer, std::size_t first, std::size_t last)>;
+
+    ParallelCommandRecorder(std::shared_ptr<const Device> device,
+                            uint32_t thread_count, uint32_t frames_in_flight,
+                            uint32_t queue_family = 0);
+    ~ParallelCommandRecorder();
+
+    ParallelCommandRecorder(const ParallelCommandRecorder &) = delete;
+    ParallelCommandRecorder &
+    operator=(const ParallelCommandRecorder &) = delete;
+
+    /**
+     * Records `count` items, returning the secondary command buffers to
+     * execute in order. Empty chunks are not recorded. An exception thrown
+     * by `record` is rethrown once every thread is done.
+     */
+    [[nodiscard]] std::vector<vk::CommandBuffer>
+    record(const vk::CommandBufferInheritanceRenderingInfo &rendering,
+           std::size_t count, const RecordFunction &record);
+
+    /** @brief Starts a new frame, resetting the pools it made safe */
+    void begin_frame();
+
+    [[nodiscard]] uint32_t thread_count() const noexcept {
+        return static_cast<uint32_t>(m_recorders.size());
+    }
+
+  private:
+    // Command pools of one thread, per frame slot
+    struct ThreadRecorder {
+        struct Slot {
+            CommandPool pool;
+            std::vector<vk::CommandBuffer> command_buffers;
+            std::size_t used = 0;
+        };
+        std::vector<Slot> slots;
+    };
+
+    struct Job {
+        const vk::CommandBufferInheritanceRenderingInfo *rendering;
+        const RecordFunction *record;
+        std::size_t count;
+        std::vector<vk::CommandBuffer> *recorded;
+    };
+
+    void record_chunk(std::size_t thread_index, const Job &job);
+    void work(std::size_t thread_index, std::stop_token stop);
+
+    std::shared_ptr<const Device> m_device;
+    std::vector<ThreadRecorder> m_recorders;
+    std::size_t m_frame_slot = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable_any m_job_ready;
+    std::condition_variable m_job_done;
+    const Job *m_job = nullptr;
+    uint64_t m_generation = 0;
+    std::size_t m_running = 0;
+    std::exception_ptr m_error;
+
+    // Declared last: the workers stop before the state they use goes away
+    std::vector<std::jthread> m_workers;
+};
+
+} // namespace vw
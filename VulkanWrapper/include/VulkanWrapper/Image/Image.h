@@ -27,6 +27,8 @@ class Image : public ObjectWithHandle<vk::Image> {
 
     [[nodiscard]] vk::Format format() const noexcept;
 
+    [[nodiscard]] vk::ImageUsageFlags usage() const noexcept;
+
     [[nodiscard]] vk::ImageSubresourceRange full_range() const noexcept;
 
     [[nodiscard]] vk::ImageSubresourceRange
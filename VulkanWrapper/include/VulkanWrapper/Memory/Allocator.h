@@ -1,7 +1,10 @@
 #pragma once
 #include "VulkanWrapper/3rd_party.h"
 #include "VulkanWrapper/fwd.h"
+#include "VulkanWrapper/Memory/MemoryReport.h"
+#include <atomic>
 #include <memory>
+#include <optional>
 #include <vk_mem_alloc.h>
 
 namespace vw {
@@ -20,25 +23,80 @@ class Allocator : public std::enable_shared_from_this<Allocator> {
 
     [[nodiscard]] VmaAllocator handle() const noexcept;
 
-    [[nodiscard]] IndexBuffer allocate_index_buffer(VkDeviceSize size) const;
+    /**
+     * True when the allocator was built with internal synchronization and
+     * can be used from several threads at once.
+     */
+    [[nodiscard]] bool is_internally_synchronized() const noexcept;
 
-    [[nodiscard]] std::shared_ptr<const Image>
-    create_image_2D(Width width, Height height, bool mipmap, vk::Format format,
-                    vk::ImageUsageFlags usage) const;
+    [[nodiscard]] IndexBuffer allocate_index_buffer(VkDeviceSize size) const;
 
-    [[nodiscard]] BufferBase
-    allocate_buffer(VkDeviceSize size, bool host_visible,
-                    vk::BufferUsageFlags usage,
-                    vk::SharingMode sharing_mode) const;
+    /**
+     * `category` overrides the one inferred from `usage` in the memory
+     * accounting.
+     */
+    [[nodiscard]] std::shared_ptr<const Image> create_image_2D(
+        Width width, Height height, bool mipmap, vk::Format format,
+        vk::ImageUsageFlags usage,
+        std::optional<AllocationCategory> category = std::nullopt) const;
+
+    [[nodiscard]] BufferBase allocate_buffer(
+        VkDeviceSize size, bool host_visible, vk::BufferUsageFlags usage,
+        vk::SharingMode sharing_mode,
+        std::optional<AllocationCategory> category = std::nullopt) const;
+
+    /**
+     * Raw memory for resources the caller binds itself, such as images
+     * aliasing one another. Release it with free_memory().
+     */
+    [[nodiscard]] VmaAllocation
+    allocate_memory(const vk::MemoryRequirements &requirements,
+                    AllocationCategory category) const;
+    void free_memory(VmaAllocation allocation) const noexcept;
+
+    /**
+     * Destroy a buffer or an image created by this allocator, keeping the
+     * accounting up to date. Called by BufferBase and Image. A null
+     * `allocation` only destroys the resource.
+     */
+    void destroy_buffer(vk::Buffer buffer,
+                        VmaAllocation allocation) const noexcept;
+    void destroy_image(vk::Image image,
+                       VmaAllocation allocation) const noexcept;
+
+    /** @brief Budget and usage of every memory heap */
+    [[nodiscard]] std::vector<HeapBudget> heap_budgets() const;
+
+    /**
+     * Live buffers and images of `category` created by this allocator.
+     * Cheap enough to poll every frame.
+     */
+    [[nodiscard]] CategoryUsage
+    category_usage(AllocationCategory category) const noexcept;
+
+    [[nodiscard]] MemoryReport memory_report() const;
 
   private:
-    Allocator(std::shared_ptr<const Device> device, VmaAllocator allocator);
+    Allocator(std::shared_ptr<const Device> device, VmaAllocator allocator,
+              bool internally_synchronized);
+
+    void track(VmaAllocation allocation) const noexcept;
+    void untrack(VmaAllocation allocation) const noexcept;
 
     struct Impl {
         std::shared_ptr<const Device> device;
         VmaAllocator allocator;
+        bool internally_synchronized;
 
-        Impl(std::shared_ptr<const Device> dev, VmaAllocator alloc);
+        struct Counters {
+            std::atomic<uint64_t> allocation_count{0};
+            std::atomic<vk::DeviceSize> bytes{0};
+            std::atomic<vk::DeviceSize> peak_bytes{0};
+        };
+        std::array<Counters, allocation_category_count> counters;
+
+        Impl(std::shared_ptr<const Device> dev, VmaAllocator alloc,
+             bool synchronized);
         ~Impl();
 
         Impl(const Impl &) = delete;
@@ -55,11 +113,19 @@ class AllocatorBuilder {
     AllocatorBuilder(std::shared_ptr<const Instance> instance,
                      std::shared_ptr<const Device> device);
 
+    /**
+     * Lets VMA lock internally so that buffers and images can be created
+     * and destroyed from several threads. Off by default: single-threaded
+     * users keep the cheaper externally synchronized allocator.
+     */
+    AllocatorBuilder &with_internal_synchronization() noexcept;
+
     std::shared_ptr<Allocator> build();
 
   private:
     std::shared_ptr<const Instance> m_instance;
     std::shared_ptr<const Device> m_device;
+    bool m_internally_synchronized = false;
 };
 
 } // namespace vw
@@ -0,0 +1,143 @@
+#pragma once
+#include "VulkanWrapper/3rd_party.h"
+#include "VulkanWrapper/Command/CommandPool.h"
+#include "VulkanWrapper/fwd.h"
+#include "VulkanWrapper/Memory/Buffer.h"
+#include "VulkanWrapper/Memory/StagingRing.h"
+#include "VulkanWrapper/Synchronization/TimelineSemaphore.h"
+#include <deque>
+#include <mutex>
+
+namespace vw {
+
+/**
+ * Streams uploads on the device transfer queue, so that they overlap with
+ * rendering instead of stalling the graphics queue.
+ *
+ * Each submit() signals a new value of a timeline semaphore. Consumers
+ * make their submission wait on it with wait_info() and, before the first
+ * use of the uploaded resources, record the acquire barriers of the batch
+ * with record_acquire(). When the device has no dedicated transfer queue,
+ * uploads go to the graphics queue and batches carry no acquire barrier.
+ *
+ * Destination buffers and images use exclusive sharing: they must not be
+ * accessed by another queue while an upload to them is in flight. Images
+ * are uploaded whole, as RGBA8 without mipmaps, and end up in
+ * eReadOnlyOptimal. Requires DeviceFinder::with_transfer_queue() or
+ * with_timeline_semaphore().
+ *
+ * Calls to the uploader are thread-safe, but it submits to a Queue,
+ * which is not: submit(), and uploads that fill the ring, must not run
+ * concurrently with other submissions to the same queue. Without a
+ * dedicated transfer queue that is the graphics queue, so call them from
+ * the thread that renders, or serialize them with it.
+ */
+class AsyncUploader {
+  public:
+    static constexpr vk::DeviceSize default_ring_size = 1 << 25;
+
+    struct UploadBatch {
+        /** @brief Timeline value signaled once the batch completed */
+        uint64_t value = 0;
+        std::vector<vk::BufferMemoryBarrier2> buffer_acquires;
+        std::vector<vk::ImageMemoryBarrier2> image_acquires;
+    };
+
+    AsyncUploader(std::shared_ptr<const Device> device,
+                  std::shared_ptr<const Allocator> allocator,
+                  vk::DeviceSize ring_size = default_ring_size);
+
+    template <typename T, bool HostVisible, VkBufferUsageFlags Usage>
+    void upload(std::span<const T> data,
+                const Buffer<T, HostVisible, Usage> &buffer,
+                uint32_t offset_dst_buffer) {
+        static_assert((Usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT) ==
+                      VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+        upload_bytes(std::as_bytes(data), buffer.handle(),
+                     vk::DeviceSize(offset_dst_buffer) * sizeof(T));
+    }
+
+    /**
+     * Uploads tightly packed RGBA8 `pixels` to the first mip level of
+     * `image`, which must have been created with eTransferDst usage.
+     */
+    void upload_image(std::span<const std::byte> pixels,
+                      std::shared_ptr<const Image> image);
+
+    /**
+     * Submits every upload recorded since the previous call. The returned
+     * batch also holds the acquire barriers of uploads that were submitted
+     * early because the ring was full.
+     */
+    [[nodiscard]] UploadBatch submit();
+
+    /**
+     * Wait on the batch whose value is `value`, for Queue::submit2(). The
+     * consumer's work at `stage` and later waits for the upload.
+     */
+    [[nodiscard]] vk::SemaphoreSubmitInfo
+    wait_info(uint64_t value, vk::PipelineStageFlags2 stage) const noexcept;
+
+    /**
+     * Records the queue family ownership acquire of `batch` on the queue
+     * that consumes it. Does nothing when the batch has no barrier.
+     */
+    static void record_acquire(vk::CommandBuffer cmd_buffer,
+                               const UploadBatch &batch);
+
+    /** @brief Blocks until the batch whose value is `value` completed */
+    void wait(uint64_t value) const;
+    [[nodiscard]] bool is_complete(uint64_t value) const;
+
+    [[nodiscard]] bool uses_dedicated_queue() const noexcept {
+        return m_transfer_family != m_graphics_family;
+    }
+
+    [[nodiscard]] const TimelineSemaphore &semaphore() const noexcept {
+        return m_semaphore;
+    }
+
+  private:
+    struct PendingBufferCopy {
+        vk::Buffer dst;
+        vk::BufferCopy2 region;
+    };
+
+    struct PendingImageCopy {
+        std::shared_ptr<const Image> image;
+        vk::BufferImageCopy2 region;
+        bool first_chunk;
+        bool last_chunk;
+    };
+
+    void upload_bytes(std::span<const std::byte> data, vk::Buffer dst,
+                      vk::DeviceSize dst_offset);
+
+    // The helpers below expect m_mutex to be held
+    StagingRing::Region acquire(vk::DeviceSize size,
+                                vk::DeviceSize alignment);
+    void recycle_command_buffers(std::size_t count);
+    void record_pending(vk::CommandBuffer cmd_buffer);
+    void submit_locked();
+    [[nodiscard]] bool has_pending() const noexcept;
+
+    std::shared_ptr<const Device> m_device;
+    uint32_t m_transfer_family;
+    uint32_t m_graphics_family;
+    CommandPool m_command_pool;
+    TimelineSemaphore m_semaphore;
+
+    std::mutex m_mutex;
+    uint64_t m_last_value = 0;
+    // Declared after the pool and the semaphore: it waits for in-flight
+    // batches on destruction
+    StagingRing m_ring;
+    std::vector<PendingBufferCopy> m_pending_buffer_copies;
+    std::vector<PendingImageCopy> m_pending_image_copies;
+    UploadBatch m_acquires;
+    std::deque<vk::CommandBuffer> m_in_flight_command_buffers;
+    std::vector<vk::CommandBuffer> m_free_command_buffers;
+};
+
+} // namespace vw
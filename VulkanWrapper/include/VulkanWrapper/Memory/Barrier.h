@@ -1,9 +1,27 @@
 #pragma once
 #include "VulkanWrapper/3rd_party.h"
 #include "VulkanWrapper/fwd.h"
+#include <span>
 
 namespace vw {
 
+// Barrier descriptions, for callers that batch several transitions into a
+// single pipelineBarrier2
+[[nodiscard]] vk::ImageMemoryBarrier2
+image_barrier_undefined_to_transfer_dst(const Image &image);
+
+[[nodiscard]] vk::ImageMemoryBarrier2
+image_barrier_transfer_dst_to_src(const Image &image, MipLevel mip_level);
+
+[[nodiscard]] vk::ImageMemoryBarrier2
+image_barrier_transfer_src_to_sampled(const Image &image);
+
+[[nodiscard]] vk::ImageMemoryBarrier2
+image_barrier_transfer_dst_to_sampled(const Image &image);
+
+void execute_image_barriers(vk::CommandBuffer cmd_buffer,
+                            std::span<const vk::ImageMemoryBarrier2> barriers);
+
 void execute_image_barrier_undefined_to_transfer_dst(
     vk::CommandBuffer cmd_buffer, const std::shared_ptr<const Image> &image);
 
@@ -2,8 +2,10 @@
 #include "VulkanWrapper/3rd_party.h"
 #include "VulkanWrapper/fwd.h"
 #include "VulkanWrapper/Memory/BufferUsage.h"
+#include "VulkanWrapper/Utils/Error.h"
 #include "VulkanWrapper/Utils/ObjectWithHandle.h"
 #include <cstring>
+#include <span>
 #include <vk_mem_alloc.h>
 
 namespace vw {
@@ -12,7 +14,8 @@ class BufferBase : public ObjectWithHandle<vk::Buffer> {
   public:
     BufferBase(std::shared_ptr<const Device> device,
                std::shared_ptr<const Allocator> allocator, vk::Buffer buffer,
-               VmaAllocation allocation, VkDeviceSize size);
+               VmaAllocation allocation, VkDeviceSize size,
+               void *mapped_data = nullptr);
 
     BufferBase(const BufferBase &) = delete;
     BufferBase &operator=(const BufferBase &) = delete;
@@ -27,6 +30,21 @@ class BufferBase : public ObjectWithHandle<vk::Buffer> {
     [[nodiscard]] std::vector<std::byte> read_bytes(VkDeviceSize offset,
                                                     VkDeviceSize size) const;
 
+    /**
+     * Host-visible buffers are persistently mapped at creation.
+     * Returns an empty span for device-local buffers.
+     */
+    [[nodiscard]] bool is_mapped() const noexcept;
+    [[nodiscard]] std::span<std::byte> mapped_bytes() noexcept;
+    [[nodiscard]] std::span<const std::byte> mapped_bytes() const noexcept;
+
+    /**
+     * Makes host writes done through mapped_bytes() visible to the device,
+     * and device writes visible to the host. No-op on coherent memory.
+     */
+    void flush_bytes(VkDeviceSize offset, VkDeviceSize size) const;
+    void invalidate_bytes(VkDeviceSize offset, VkDeviceSize size) const;
+
     ~BufferBase();
 
   private:
@@ -35,6 +53,7 @@ class BufferBase : public ObjectWithHandle<vk::Buffer> {
         std::shared_ptr<const Allocator> m_allocator;
         VmaAllocation m_allocation;
         VkDeviceSize m_size_in_bytes;
+        void *m_mapped_data;
     };
     std::unique_ptr<Data> m_data;
 };
@@ -80,11 +99,63 @@ class Buffer : public BufferBase {
                                                 std::size_t count) const
         requires(HostVisible)
     {
-        auto bytes =
-            BufferBase::read_bytes(offset * sizeof(T), count * sizeof(T));
-        std::vector<T> result(count);
-        std::memcpy(result.data(), bytes.data(), bytes.size());
-        return result;
+        auto view = as_span(offset, count);
+        invalidate(offset, count);
+        return std::vector<T>(view.begin(), view.end());
+    }
+
+    /**
+     * Zero-copy view over the persistently mapped memory.
+     * Call flush() after writing and invalidate() before reading data
+     * produced by the device.
+     */
+    [[nodiscard]] std::span<T> as_span() noexcept
+        requires(HostVisible)
+    {
+        auto bytes = mapped_bytes();
+        return {reinterpret_cast<T *>(bytes.data()), size()};
+    }
+
+    [[nodiscard]] std::span<const T> as_span() const noexcept
+        requires(HostVisible)
+    {
+        auto bytes = mapped_bytes();
+        return {reinterpret_cast<const T *>(bytes.data()), size()};
+    }
+
+    [[nodiscard]] std::span<T> as_span(std::size_t offset, std::size_t count)
+        requires(HostVisible)
+    {
+        check_range(offset, count);
+        return as_span().subspan(offset, count);
+    }
+
+    [[nodiscard]] std::span<const T> as_span(std::size_t offset,
+                                             std::size_t count) const
+        requires(HostVisible)
+    {
+        check_range(offset, count);
+        return as_span().subspan(offset, count);
+    }
+
+    void flush(std::size_t offset, std::size_t count) const
+        requires(HostVisible)
+    {
+        BufferBase::flush_bytes(offset * sizeof(T), count * sizeof(T));
+    }
+
+    void invalidate(std::size_t offset, std::size_t count) const
+        requires(HostVisible)
+    {
+        BufferBase::invalidate_bytes(offset * sizeof(T), count * sizeof(T));
+    }
+
+  private:
+    void check_range(std::size_t offset, std::size_t count) const {
+        if (offset + count > size()) {
+            throw LogicException::out_of_range("buffer view", offset + count,
+                                               size());
+        }
     }
 };
 
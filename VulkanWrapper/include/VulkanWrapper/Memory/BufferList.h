@@ -2,56 +2,183 @@
 #include "VulkanWrapper/3rd_party.h"
 #include "VulkanWrapper/Memory/AllocateBufferUtils.h"
 #include "VulkanWrapper/Memory/Buffer.h"
+#include "VulkanWrapper/Memory/VirtualBlock.h"
+#include "VulkanWrapper/Utils/Error.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <optional>
 
 namespace vw {
+
+/**
+ * Sub-allocates ranges out of large shared buffers.
+ * Each backing buffer is managed by a VirtualBlock, so ranges can be
+ * released and reused. Sizes, offsets and alignments are expressed in
+ * elements of T.
+ * create_buffer() and release() are safe to call from several threads;
+ * creating new backing buffers concurrently additionally requires an
+ * allocator built with AllocatorBuilder::with_internal_synchronization().
+ */
 template <typename T, bool HostVisible, VkBufferUsageFlags flags>
 class BufferList {
   public:
+    using BufferType = Buffer<T, HostVisible, flags>;
+
     struct BufferInfo {
-        std::shared_ptr<Buffer<T, HostVisible, flags>> buffer;
+        std::shared_ptr<BufferType> buffer;
         std::size_t offset;
+        VmaVirtualAllocation allocation = VK_NULL_HANDLE;
+        // Identifies the backing buffer within the list; unlike its
+        // address, never reused after trim()
+        std::size_t buffer_id = 0;
+        // Value of the buffer's release_all() count at creation, which
+        // tells release() whether the range is still live
+        std::size_t generation = 0;
+    };
+
+    struct Statistics {
+        std::size_t buffer_count;
+        std::size_t allocation_count;
+        std::size_t total_size;
+        std::size_t used_size;
+        std::size_t free_region_count;
+        std::size_t largest_free_region;
     };
 
-    BufferList(std::shared_ptr<const Allocator> allocator) noexcept
+    static constexpr std::size_t default_buffer_size = 1 << 24;
+
+    BufferList(std::shared_ptr<const Allocator> allocator)
         : m_allocator{std::move(allocator)} {}
 
     BufferInfo create_buffer(std::size_t size, std::size_t alignment = 1) {
-        constexpr std::size_t buffer_size = 1 << 24;
-
-        // Helper to align offset
-        auto align_up = [](std::size_t value, std::size_t align) {
-            return (value + align - 1) & ~(align - 1);
-        };
-
-        auto has_enough_place = [size, alignment,
-                                 align_up](auto &buffer_and_offset) {
-            std::size_t aligned_offset =
-                align_up(buffer_and_offset.offset, alignment);
-            return buffer_and_offset.buffer->size() >= size + aligned_offset;
-        };
-        auto it = std::ranges::find_if(m_buffer_list, has_enough_place);
-        if (it != m_buffer_list.end()) {
-            std::size_t aligned_offset = align_up(it->offset, alignment);
-            BufferInfo result{it->buffer, aligned_offset};
-            it->offset = aligned_offset + size;
-            return result;
-        }
-        auto buffer = std::make_shared<Buffer<T, HostVisible, flags>>(
-            vw::create_buffer<T, HostVisible, flags>(
-                *m_allocator, std::max(buffer_size, size)));
-        auto &buffer_and_offset =
-            m_buffer_list.emplace_back(BufferAndOffset{buffer, size});
-        return {buffer_and_offset.buffer, 0};
+        std::scoped_lock lock(*m_mutex);
+
+        // Most allocations land in the last used buffer, try it first
+        if (m_last_used < m_buffer_list.size()) {
+            if (auto info = try_allocate(m_last_used, size, alignment)) {
+                return *info;
+            }
+        }
+        for (std::size_t i = 0; i < m_buffer_list.size(); ++i) {
+            if (i == m_last_used) {
+                continue;
+            }
+            if (auto info = try_allocate(i, size, alignment)) {
+                m_last_used = i;
+                return *info;
+            }
+        }
+
+        const auto buffer_size = std::max(default_buffer_size, size);
+        m_buffer_list.push_back(std::make_unique<BufferAndBlock>(
+            BufferAndBlock{std::make_shared<BufferType>(
+                               vw::create_buffer<T, HostVisible, flags>(
+                                   *m_allocator, buffer_size)),
+                           VirtualBlock(buffer_size), m_next_buffer_id++}));
+        m_last_used = m_buffer_list.size() - 1;
+
+        auto info = try_allocate(m_last_used, size, alignment);
+        if (!info) {
+            throw LogicException::invalid_state(
+                "BufferList: allocation does not fit in a fresh buffer");
+        }
+        return *info;
+    }
+
+    /**
+     * Returns a range created by this list, in time linear in the number
+     * of backing buffers. The caller must guarantee the GPU no longer
+     * accesses it. Throws LogicException if the range is not live: from
+     * another list, or already released by release_all() or trim().
+     */
+    void release(const BufferInfo &info) {
+        if (info.allocation == VK_NULL_HANDLE) {
+            return;
+        }
+        std::scoped_lock lock(*m_mutex);
+        // The range holds its buffer: no live entry can share its address
+        auto it = std::ranges::find(m_buffer_list, info.buffer,
+                                    [](const auto &entry) -> const auto & {
+                                        return entry->buffer;
+                                    });
+        if (it == m_buffer_list.end() ||
+            (*it)->generation != info.generation) {
+            throw LogicException::invalid_state(
+                "BufferList: released range is not live in this list");
+        }
+        (*it)->block.free(info.allocation);
+    }
+
+    /**
+     * Releases every range at once, keeping the backing buffers.
+     */
+    void release_all() {
+        std::scoped_lock lock(*m_mutex);
+        for (auto &entry : m_buffer_list) {
+            entry->block.clear();
+            ++entry->generation;
+        }
+    }
+
+    /**
+     * Destroys backing buffers that hold no live range and returns how many
+     * were freed. This is the hook for compaction passes: once every range
+     * of a buffer has been released (or moved elsewhere) its memory goes
+     * back to the allocator.
+     */
+    std::size_t trim() {
+        std::scoped_lock lock(*m_mutex);
+        const auto removed =
+            std::erase_if(m_buffer_list, [](const auto &entry) {
+                return entry->block.empty();
+            });
+        m_last_used = 0;
+        return removed;
+    }
+
+    [[nodiscard]] Statistics statistics() const {
+        std::scoped_lock lock(*m_mutex);
+        Statistics result{};
+        result.buffer_count = m_buffer_list.size();
+        for (const auto &entry : m_buffer_list) {
+            const auto stats = entry->block.statistics();
+            result.allocation_count += stats.allocation_count;
+            result.total_size += entry->block.size();
+            result.used_size += stats.used_size;
+            result.free_region_count += stats.free_region_count;
+            result.largest_free_region = std::max<std::size_t>(
+                result.largest_free_region, stats.largest_free_region);
+        }
+        return result;
     }
 
   private:
-    struct BufferAndOffset {
-        std::shared_ptr<Buffer<T, HostVisible, flags>> buffer;
-        std::size_t offset;
+    struct BufferAndBlock {
+        std::shared_ptr<BufferType> buffer;
+        VirtualBlock block;
+        std::size_t id;
+        std::size_t generation = 0;
     };
 
+    std::optional<BufferInfo> try_allocate(std::size_t index, std::size_t size,
+                                           std::size_t alignment) {
+        auto &entry = *m_buffer_list[index];
+        auto allocation = entry.block.allocate(size, alignment);
+        if (!allocation) {
+            return std::nullopt;
+        }
+        return BufferInfo{entry.buffer, std::size_t(allocation->offset),
+                          allocation->handle, entry.id, entry.generation};
+    }
+
     std::shared_ptr<const Allocator> m_allocator;
-    std::vector<BufferAndOffset> m_buffer_list;
+    // Boxed so that growing the list does not move the blocks
+    std::vector<std::unique_ptr<BufferAndBlock>> m_buffer_list;
+    std::size_t m_last_used = 0;
+    std::size_t m_next_buffer_id = 0;
+    // Boxed so that the list stays movable
+    std::unique_ptr<std::mutex> m_mutex = std::make_unique<std::mutex>();
 };
 
 using IndexBufferList = BufferList<uint32_t, false, IndexBufferUsage>;
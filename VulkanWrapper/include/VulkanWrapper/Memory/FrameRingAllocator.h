@@ -0,0 +1,132 @@
+#pragma once
+
+#include "VulkanWrapper/3rd_party.h"
+#include "VulkanWrapper/fwd.h"
+#include "VulkanWrapper/Memory/Buffer.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
+#include <cstring>
+#include <optional>
+#include <vector>
+
+namespace vw {
+
+constexpr VkBufferUsageFlags2 TransientBufferUsage =
+    VkBufferUsageFlags2{vk::BufferUsageFlagBits2::eUniformBuffer |
+                        vk::BufferUsageFlagBits2::eStorageBuffer |
+                        vk::BufferUsageFlagBits2::eShaderDeviceAddress};
+
+using TransientBuffer = Buffer<std::byte, true, TransientBufferUsage>;
+
+/**
+ * A range handed out by a FrameRingAllocator. Only valid until the frame
+ * that produced it is recycled.
+ */
+template <typename T> struct FrameAllocation {
+    vk::Buffer handle{};     // The ring buffer
+    vk::DeviceSize offset{}; // Offset within the ring buffer
+    vk::DeviceSize size{};   // Aligned size of the range in bytes
+    std::byte *mapped{};     // Host pointer to the start of the range
+
+    /**
+     * Offset to pass to vkCmdBindDescriptorSets when the descriptor binds
+     * the ring buffer as a dynamic uniform or storage buffer.
+     */
+    [[nodiscard]] uint32_t dynamic_offset() const noexcept {
+        return static_cast<uint32_t>(offset);
+    }
+
+    [[nodiscard]] vk::DescriptorBufferInfo descriptor_info() const {
+        return vk::DescriptorBufferInfo(handle, offset, size);
+    }
+
+    void write(const T &value) { std::memcpy(mapped, &value, sizeof(T)); }
+
+    void write(std::span<const T> data) {
+        std::memcpy(mapped, data.data(), data.size_bytes());
+    }
+};
+
+/**
+ * Linear allocator for transient per-frame uniform and storage data.
+ *
+ * A single persistently mapped buffer is split into `frame_count` regions.
+ * Allocations bump a cursor inside the current region, so they are O(1)
+ * and never fragment. begin_frame() moves to the next region, first
+ * waiting for the SubmitTicket handed to end_frame() when that region was
+ * last used, and then recycles the whole region at once. The allocator
+ * starts inside frame 0.
+ */
+class FrameRingAllocator {
+  public:
+    /**
+     * Throws LogicException unless `frame_count` is non zero and
+     * `min_alignment` is a power of two.
+     */
+    FrameRingAllocator(std::shared_ptr<const Allocator> allocator,
+                       vk::DeviceSize frame_size, uint32_t frame_count,
+                       vk::DeviceSize min_alignment = 256);
+
+    /**
+     * Starts a new frame. Blocks until the GPU has finished with the
+     * region being recycled.
+     */
+    void begin_frame();
+
+    /**
+     * Flushes the data written during the frame. `ticket` must complete
+     * when the GPU is done reading it; with a default ticket the caller
+     * guarantees this before the region comes around again.
+     */
+    void end_frame(SubmitTicket ticket = {});
+
+    /**
+     * Returns nullopt when the current frame region is exhausted.
+     */
+    template <typename T>
+    [[nodiscard]] std::optional<FrameAllocation<T>>
+    allocate(std::size_t count = 1) {
+        const auto size = align(sizeof(T) * count);
+        const auto offset = m_frame_begin + m_cursor;
+        if (m_cursor + size > m_frame_size) {
+            return std::nullopt;
+        }
+        m_cursor += size;
+        return FrameAllocation<T>{.handle = m_buffer->handle(),
+                                  .offset = offset,
+                                  .size = size,
+                                  .mapped = m_mapped + offset};
+    }
+
+    [[nodiscard]] uint32_t frame_index() const noexcept {
+        return m_frame_index;
+    }
+    [[nodiscard]] uint32_t frame_count() const noexcept {
+        return static_cast<uint32_t>(m_frame_tickets.size());
+    }
+    [[nodiscard]] vk::DeviceSize frame_size() const noexcept {
+        return m_frame_size;
+    }
+    [[nodiscard]] vk::DeviceSize used_size() const noexcept { return m_cursor; }
+
+    [[nodiscard]] vk::Buffer buffer() const { return m_buffer->handle(); }
+    [[nodiscard]] std::shared_ptr<const TransientBuffer>
+    buffer_ref() const noexcept {
+        return m_buffer;
+    }
+
+  private:
+    [[nodiscard]] vk::DeviceSize align(vk::DeviceSize size) const noexcept {
+        return (size + m_min_alignment - 1) & ~(m_min_alignment - 1);
+    }
+
+    std::shared_ptr<TransientBuffer> m_buffer;
+    std::byte *m_mapped;
+    vk::DeviceSize m_frame_size;
+    vk::DeviceSize m_min_alignment;
+    std::vector<SubmitTicket> m_frame_tickets;
+    uint32_t m_frame_index = 0;
+    vk::DeviceSize m_frame_begin = 0;
+    vk::DeviceSize m_cursor = 0;
+};
+
+} // namespace vw
@@ -0,0 +1,101 @@
+#pragma once
+#include "VulkanWrapper/3rd_party.h"
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vw {
+
+/**
+ * What an allocation is used for. Allocator infers it from the usage
+ * flags unless the caller passes one explicitly.
+ */
+enum class AllocationCategory {
+    Other,
+    RenderTarget,
+    Texture,
+    Mesh,
+    AccelerationStructure,
+    Staging,
+};
+
+constexpr std::size_t allocation_category_count = 6;
+
+[[nodiscard]] std::string_view to_string(AllocationCategory category) noexcept;
+
+/**
+ * Attachment and storage images are render targets, other sampled images
+ * textures.
+ */
+[[nodiscard]] AllocationCategory
+infer_allocation_category(vk::ImageUsageFlags usage) noexcept;
+
+/**
+ * Acceleration structure storage, then vertex and index buffers, then
+ * host-visible transfer sources. Everything else is Other.
+ */
+[[nodiscard]] AllocationCategory
+infer_allocation_category(vk::BufferUsageFlags usage,
+                          bool host_visible) noexcept;
+
+struct CategoryUsage {
+    uint64_t allocation_count = 0;
+    vk::DeviceSize bytes = 0;
+    /** @brief Highest value `bytes` reached since the allocator was built */
+    vk::DeviceSize peak_bytes = 0;
+};
+
+/**
+ * Usage and budget of one memory heap, from vmaGetHeapBudgets(). The budget
+ * comes from the driver when the device has VK_EXT_memory_budget, see
+ * Device::has_memory_budget(); otherwise it is VMA's estimate.
+ */
+struct HeapBudget {
+    uint32_t heap_index = 0;
+    vk::MemoryHeapFlags flags;
+    /** @brief Heap size reported by the device */
+    vk::DeviceSize size = 0;
+    /** @brief Memory the process may use before allocations start failing
+     * or evicting */
+    vk::DeviceSize budget = 0;
+    /** @brief Memory used by the process, including other allocators */
+    vk::DeviceSize usage = 0;
+    /** @brief Memory in VMA blocks, and the allocations within them */
+    vk::DeviceSize block_bytes = 0;
+    vk::DeviceSize allocation_bytes = 0;
+    uint32_t block_count = 0;
+    uint32_t allocation_count = 0;
+
+    [[nodiscard]] bool is_device_local() const noexcept {
+        return bool(flags & vk::MemoryHeapFlagBits::eDeviceLocal);
+    }
+    [[nodiscard]] vk::DeviceSize available() const noexcept {
+        return budget > usage ? budget - usage : 0;
+    }
+    [[nodiscard]] bool is_over_budget() const noexcept {
+        return usage > budget;
+    }
+};
+
+/**
+ * Point-in-time view of an Allocator's memory, see
+ * Allocator::memory_report().
+ */
+struct MemoryReport {
+    std::vector<HeapBudget> heaps;
+    std::array<CategoryUsage, allocation_category_count> categories;
+
+    [[nodiscard]] const CategoryUsage &
+    category(AllocationCategory category) const noexcept {
+        return categories[static_cast<std::size_t>(category)];
+    }
+
+    /** @brief Bytes of every category */
+    [[nodiscard]] vk::DeviceSize total_bytes() const noexcept;
+
+    /** @brief Single-line JSON object, for logs and tooling */
+    [[nodiscard]] std::string to_json() const;
+};
+
+} // namespace vw
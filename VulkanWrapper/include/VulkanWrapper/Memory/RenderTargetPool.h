@@ -0,0 +1,99 @@
+#pragma once
+#include "VulkanWrapper/3rd_party.h"
+#include "VulkanWrapper/fwd.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vw {
+
+/**
+ * Recycles render targets, so that resizes and resolution changes stop
+ * allocating and destroying full-screen images every frame.
+ *
+ * Images are keyed by format, usage and size bucket: requested sizes are
+ * rounded up to a multiple of `bucket_size`, and the image of the bucket
+ * is rendered into its top-left `extent`. Consumers sampling such an
+ * image scale their coordinates by the extent over the image size, see
+ * CachedImage::uv_scale(). With the default bucket size, a resize or a
+ * render scale step of a few pixels keeps the same images; a bucket size
+ * of 1 always yields an image of the requested size.
+ *
+ * A released image may still be used by frames in flight: it becomes
+ * available again once begin_frame() has been called `frames_in_flight`
+ * times. A RenderPipeline using the pool calls it every frame. Images of sizes no longer requested stay in the pool until
+ * trim(). Thread-safe.
+ */
+class RenderTargetPool {
+  public:
+    struct RenderTarget {
+        std::shared_ptr<const Image> image;
+        std::shared_ptr<const ImageView> view;
+        /** @brief Top-left area of the image to render into */
+        vk::Extent2D extent;
+    };
+
+    struct Statistics {
+        std::size_t image_count = 0;
+        std::size_t available_count = 0;
+        /** @brief Acquisitions that allocated a new image */
+        std::size_t allocation_count = 0;
+        /** @brief Acquisitions served by a recycled image */
+        std::size_t reuse_count = 0;
+    };
+
+    static constexpr uint32_t default_bucket_size = 64;
+
+    RenderTargetPool(std::shared_ptr<const Device> device,
+                     std::shared_ptr<const Allocator> allocator,
+                     uint32_t frames_in_flight,
+                     uint32_t bucket_size = default_bucket_size);
+
+    [[nodiscard]] RenderTarget acquire(vk::Format format,
+                                       vk::ImageUsageFlags usage,
+                                       Width width, Height height);
+
+    /**
+     * Gives back an image returned by acquire(). It is recycled once the
+     * frames in flight that may use it are complete.
+     */
+    void release(const std::shared_ptr<const Image> &image);
+
+    /** @brief Starts a new frame, recycling the images it made safe */
+    void begin_frame();
+
+    /**
+     * Destroys the available images.
+     * @return The number of images destroyed
+     */
+    std::size_t trim();
+
+    [[nodiscard]] Statistics statistics() const;
+
+    [[nodiscard]] vk::Extent2D bucket(Width width,
+                                      Height height) const noexcept;
+
+  private:
+    struct Entry {
+        std::shared_ptr<const Image> image;
+        std::shared_ptr<const ImageView> view;
+        vk::Format format;
+        vk::ImageUsageFlags usage;
+        bool in_use;
+        /** @brief Frame after which the image may be reused */
+        uint64_t available_frame;
+    };
+
+    std::shared_ptr<const Device> m_device;
+    std::shared_ptr<const Allocator> m_allocator;
+    uint32_t m_frames_in_flight;
+    uint32_t m_bucket_size;
+
+    mutable std::mutex m_mutex;
+    uint64_t m_frame = 0;
+    std::vector<Entry> m_entries;
+    std::size_t m_allocation_count = 0;
+    std::size_t m_reuse_count = 0;
+};
+
+} // namespace vw
@@ -4,56 +4,147 @@
 #include "VulkanWrapper/fwd.h"
 #include "VulkanWrapper/Memory/Allocator.h"
 #include "VulkanWrapper/Memory/Buffer.h"
-#include "VulkanWrapper/Memory/BufferList.h"
+#include "VulkanWrapper/Memory/StagingRing.h"
+#include <deque>
+#include <mutex>
 
 namespace vw {
 
+/**
+ * Records host-to-device uploads through a fixed-size staging ring.
+ *
+ * Uploads are copied into the ring right away and the matching transfer
+ * commands are recorded later, either by flush(), which submits them on the
+ * queue given at construction, or by fill_command_buffer(), in which case
+ * the caller submits them and hands the SubmitTicket to
+ * track_submission(). Staging memory is recycled once the ticket of its
+ * batch completed.
+ *
+ * Uploads larger than the ring are split into chunks. When the ring is
+ * full, the manager flushes pending uploads on its queue and waits for
+ * older ones to complete, so host memory stays bounded however much data is
+ * streamed. fill_buffer() and stage_image_from_path() may be called
+ * concurrently; since they can submit to the queue, they must not race with
+ * other submissions on it.
+ */
 class StagingBufferManager {
   public:
+    static constexpr vk::DeviceSize default_ring_size = 1 << 25;
+
+    /**
+     * `queue` is where flush() and a full ring submit uploads. It must
+     * outlive the manager.
+     */
     StagingBufferManager(std::shared_ptr<const Device> device,
-                         std::shared_ptr<const Allocator> allocator);
+                         std::shared_ptr<const Allocator> allocator,
+                         Queue &queue,
+                         vk::DeviceSize ring_size = default_ring_size);
 
+    /**
+     * Records the pending uploads into a command buffer for the caller to
+     * submit. Pass the ticket of that submission to track_submission(), or
+     * call release_staging_memory() once it completed.
+     */
     [[nodiscard]] vk::CommandBuffer fill_command_buffer();
 
+    /**
+     * Recycles the staging memory of the command buffers returned by
+     * fill_command_buffer() so far once `ticket` completed.
+     */
+    void track_submission(SubmitTicket ticket);
+
+    /**
+     * Recycles all staging memory, including the uploads recorded by
+     * fill_command_buffer(). Call once those command buffers have
+     * completed on the GPU.
+     */
+    void release_staging_memory();
+
+    /**
+     * Submits the pending uploads on the queue. Their staging memory is
+     * recycled when the submission completes.
+     */
+    void flush();
+
+    /**
+     * Flushes and blocks until every upload submitted by flush() is done.
+     */
+    void wait_idle();
+
+    /**
+     * Back-pressure: blocks until a region of `size` bytes can be staged
+     * without blocking, flushing pending uploads if needed.
+     */
+    void wait_for_space(vk::DeviceSize size);
+
+    /**
+     * Bytes that can be staged right now without blocking. Regions do not
+     * straddle the end of the ring, so this can be less than the free
+     * bytes.
+     */
+    [[nodiscard]] vk::DeviceSize available_bytes();
+
+    [[nodiscard]] vk::DeviceSize ring_size() const noexcept {
+        return m_ring.capacity();
+    }
+
     template <typename T, bool HostVisible, VkBufferUsageFlags Usage>
     void fill_buffer(std::span<const T> data,
                      const Buffer<T, HostVisible, Usage> &buffer,
                      uint32_t offset_dst_buffer) {
-        auto [staging_buffer, offset_src] =
-            m_staging_buffers.create_buffer(data.size_bytes());
-
         static_assert((Usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT) ==
                       VK_BUFFER_USAGE_TRANSFER_DST_BIT);
 
-        staging_buffer->write_bytes(data, offset_src);
-
-        auto function = [src_buffer_handle = staging_buffer->handle(), &buffer,
-                         size = data.size_bytes(),
-                         offset_dst = offset_dst_buffer * sizeof(T),
-                         offset_src = offset_src * sizeof(std::byte)](
-                            vk::CommandBuffer command_buffer) {
-            const auto region = vk::BufferCopy()
-                                    .setSrcOffset(offset_src)
-                                    .setDstOffset(offset_dst)
-                                    .setSize(size);
-            command_buffer.copyBuffer(src_buffer_handle, buffer.handle(),
-                                      region);
-        };
-
-        m_transfer_functions.emplace_back(function);
+        fill_buffer_bytes(std::as_bytes(data), buffer.handle(),
+                          vk::DeviceSize(offset_dst_buffer) * sizeof(T));
     }
 
     [[nodiscard]] CombinedImage
     stage_image_from_path(const std::filesystem::path &path, bool mipmaps);
 
   private:
+    struct PendingBufferCopy {
+        vk::Buffer src;
+        vk::Buffer dst;
+        vk::BufferCopy region;
+    };
+
+    struct PendingImageCopy {
+        vk::Buffer src;
+        std::shared_ptr<const Image> image;
+        vk::BufferImageCopy region;
+        bool first_chunk;
+        bool last_chunk;
+        bool mipmaps;
+    };
+
+    void fill_buffer_bytes(std::span<const std::byte> data, vk::Buffer dst,
+                           vk::DeviceSize dst_offset);
+
+    // The helpers below expect m_mutex to be held
+    StagingRing::Region acquire(vk::DeviceSize size,
+                                vk::DeviceSize alignment);
+    void recycle_command_buffers(std::size_t count);
+    void retire();
+    void wait_oldest();
+    void record_buffer_copies(vk::CommandBuffer cmd_buffer);
+    void record_image_copies(vk::CommandBuffer cmd_buffer);
+    vk::CommandBuffer record_pending();
+    void flush_locked();
+    [[nodiscard]] bool has_pending() const noexcept;
+
     std::shared_ptr<const Device> m_device;
     std::shared_ptr<const Allocator> m_allocator;
+    Queue *m_queue;
     CommandPool m_command_pool;
-    BufferList<std::byte, true, VK_BUFFER_USAGE_TRANSFER_SRC_BIT>
-        m_staging_buffers;
 
-    std::vector<std::function<void(vk::CommandBuffer)>> m_transfer_functions;
+    std::mutex m_mutex;
+    StagingRing m_ring;
+    std::vector<PendingBufferCopy> m_pending_buffer_copies;
+    std::vector<PendingImageCopy> m_pending_image_copies;
+    // One command buffer per ring batch, recycled with it
+    std::deque<vk::CommandBuffer> m_in_flight_command_buffers;
+    std::vector<vk::CommandBuffer> m_free_command_buffers;
     std::shared_ptr<const Sampler> m_sampler;
 };
 } // namespace vw
@@ -0,0 +1,126 @@
+#pragma once
+#include "VulkanWrapper/3rd_party.h"
+#include "VulkanWrapper/fwd.h"
+#include "VulkanWrapper/Memory/Buffer.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
+#include <deque>
+#include <optional>
+
+namespace vw {
+
+/**
+ * Fixed-size ring of host-visible staging memory.
+ *
+ * Regions are handed out in order and grouped into batches with
+ * close_batch(). A batch is recycled once the SubmitTicket of the
+ * submission that reads it has completed, so memory use never exceeds the
+ * capacity chosen at creation. Destruction waits for the batches that have
+ * a ticket. Not thread-safe.
+ */
+class StagingRing {
+  public:
+    using RingBuffer = Buffer<std::byte, true, StagingBufferUsage>;
+
+    struct Region {
+        vk::Buffer buffer;
+        vk::DeviceSize offset;
+        std::span<std::byte> data;
+    };
+
+    StagingRing(std::shared_ptr<const Allocator> allocator,
+                vk::DeviceSize capacity);
+    ~StagingRing();
+
+    StagingRing(const StagingRing &) = delete;
+    StagingRing &operator=(const StagingRing &) = delete;
+
+    /**
+     * Returns nullopt when `size` contiguous bytes are not available until
+     * older batches are recycled. `alignment` must be a power of two no
+     * larger than 256.
+     */
+    [[nodiscard]] std::optional<Region> try_allocate(vk::DeviceSize size,
+                                                     vk::DeviceSize alignment);
+
+    /**
+     * Whether try_allocate() would succeed, counting the padding skipped
+     * when a region would straddle the end of the buffer.
+     */
+    [[nodiscard]] bool can_allocate(vk::DeviceSize size,
+                                    vk::DeviceSize alignment) const;
+
+    /**
+     * Size of the largest region that can be allocated right now, before
+     * alignment.
+     */
+    [[nodiscard]] vk::DeviceSize largest_free_region() const noexcept;
+
+    /**
+     * Makes host writes to `region` visible to the device.
+     */
+    void flush(const Region &region) const;
+
+    /**
+     * Groups every region allocated since the previous call. Without a
+     * ticket the batch is only recycled by retire_all(), until
+     * set_ticket() gives it one.
+     */
+    void close_batch(SubmitTicket ticket = {});
+
+    /**
+     * Gives `ticket` to the closed batches that have none yet.
+     */
+    void set_ticket(SubmitTicket ticket);
+
+    /**
+     * Recycles batches whose ticket has completed, oldest first, without
+     * blocking. Returns how many were recycled.
+     */
+    std::size_t retire();
+
+    /**
+     * Blocks on the oldest batch and recycles it. Returns false if there is
+     * no batch or the oldest one has no ticket.
+     */
+    bool wait_oldest();
+
+    /**
+     * Recycles every closed batch. Batches with a ticket are waited on; for
+     * the others the caller guarantees the GPU is done with them. Returns
+     * how many were recycled.
+     */
+    std::size_t retire_all();
+
+    [[nodiscard]] vk::Buffer buffer() const noexcept {
+        return m_buffer.handle();
+    }
+    [[nodiscard]] vk::DeviceSize capacity() const noexcept {
+        return m_capacity;
+    }
+    [[nodiscard]] vk::DeviceSize used_bytes() const noexcept {
+        return m_head - m_tail;
+    }
+    [[nodiscard]] std::size_t batch_count() const noexcept {
+        return m_batches.size();
+    }
+
+  private:
+    struct Batch {
+        vk::DeviceSize end;
+        SubmitTicket ticket;
+    };
+
+    // Monotonic position of a region of `size` bytes, if it fits
+    [[nodiscard]] std::optional<vk::DeviceSize>
+    find_position(vk::DeviceSize size, vk::DeviceSize alignment) const;
+    void recycle_front();
+
+    RingBuffer m_buffer;
+    vk::DeviceSize m_capacity;
+    // Monotonic positions, taken modulo the capacity to address the buffer
+    vk::DeviceSize m_head = 0;
+    vk::DeviceSize m_tail = 0;
+    std::deque<Batch> m_batches;
+};
+
+} // namespace vw
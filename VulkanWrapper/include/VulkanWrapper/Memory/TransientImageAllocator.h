@@ -0,0 +1,120 @@
+#pragma once
+#include "VulkanWrapper/3rd_party.h"
+#include "VulkanWrapper/fwd.h"
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <vk_mem_alloc.h>
+
+namespace vw {
+
+/**
+ * Inclusive range of pass indices during which an image is in use.
+ */
+struct ImageLifetime {
+    std::size_t first;
+    std::size_t last;
+
+    [[nodiscard]] bool overlaps(const ImageLifetime &other) const noexcept {
+        return first <= other.last && other.first <= last;
+    }
+};
+
+/**
+ * Places images whose lifetimes do not overlap in the same memory.
+ *
+ * Images are grouped by frame and size: two frames may be in flight at
+ * once, so only images of the same group alias. Within a group, an image
+ * is placed first-fit at an offset where no image with an overlapping
+ * lifetime lives, in a memory block of a compatible type; a new block is
+ * allocated when none fits. Blocks are sized by the largest image created
+ * at the group's size so far, in any frame, so that the groups after the
+ * first one alias every image into blocks that fit the largest. Destroying
+ * an image frees its place in the block. Requesting a group with the same
+ * frame but a different size drops the previous one, as after a resize.
+ *
+ * Aliased images lose their content between lifetimes: the caller makes
+ * their first use of each frame start from an undefined layout, after the
+ * previous occupant of the memory is done. Not thread-safe.
+ */
+class TransientImageAllocator {
+  public:
+    struct GroupKey {
+        std::size_t frame_index;
+        uint32_t width;
+        uint32_t height;
+        auto operator<=>(const GroupKey &) const = default;
+    };
+
+    struct AliasedImage {
+        std::shared_ptr<const Image> image;
+        /** @brief Keeps the memory the image is bound to alive */
+        std::shared_ptr<const void> memory;
+    };
+
+    struct Statistics {
+        std::size_t image_count = 0;
+        std::size_t block_count = 0;
+        /** @brief Memory the images would take with one allocation each */
+        vk::DeviceSize requested_bytes = 0;
+        /** @brief Memory actually allocated for them */
+        vk::DeviceSize allocated_bytes = 0;
+
+        [[nodiscard]] vk::DeviceSize saved_bytes() const noexcept {
+            return requested_bytes - allocated_bytes;
+        }
+    };
+
+    TransientImageAllocator(std::shared_ptr<const Device> device,
+                            std::shared_ptr<const Allocator> allocator);
+
+    [[nodiscard]] AliasedImage create_image(const GroupKey &group,
+                                            ImageLifetime lifetime,
+                                            vk::Format format,
+                                            vk::ImageUsageFlags usage);
+
+    /**
+     * True when another image of the group is bound to memory overlapping
+     * that of `image`.
+     */
+    [[nodiscard]] bool shares_memory(vk::Image image) const noexcept;
+
+    [[nodiscard]] Statistics statistics() const noexcept;
+
+  private:
+    struct Placement {
+        vk::Image image;
+        vk::DeviceSize offset;
+        vk::DeviceSize size;
+        ImageLifetime lifetime;
+    };
+
+    struct Block {
+        std::shared_ptr<const Allocator> allocator;
+        VmaAllocation allocation;
+        vk::DeviceSize size;
+        uint32_t memory_type;
+        std::vector<Placement> placements;
+
+        Block(std::shared_ptr<const Allocator> allocator,
+              VmaAllocation allocation, vk::DeviceSize size,
+              uint32_t memory_type);
+        ~Block();
+
+        Block(const Block &) = delete;
+        Block &operator=(const Block &) = delete;
+
+        [[nodiscard]] std::optional<vk::DeviceSize>
+        find_offset(const vk::MemoryRequirements &requirements,
+                    ImageLifetime lifetime) const noexcept;
+    };
+
+    std::shared_ptr<const Device> m_device;
+    std::shared_ptr<const Allocator> m_allocator;
+    std::map<GroupKey, std::vector<std::shared_ptr<Block>>> m_groups;
+    // Largest image requirement per group size, in any frame
+    std::map<std::pair<uint32_t, uint32_t>, vk::DeviceSize> m_largest_images;
+};
+
+} // namespace vw
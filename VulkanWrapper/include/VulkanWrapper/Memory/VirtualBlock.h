@@ -0,0 +1,58 @@
+#pragma once
+#include "VulkanWrapper/3rd_party.h"
+#include <optional>
+#include <vk_mem_alloc.h>
+
+namespace vw {
+
+/**
+ * RAII wrapper over a VMA virtual block.
+ * Hands out offsets inside a range of `size` abstract units (bytes or
+ * elements) using VMA's TLSF allocator: allocation and free are O(1) and
+ * freed ranges are coalesced and reused. Not thread-safe.
+ */
+class VirtualBlock {
+  public:
+    struct Allocation {
+        VmaVirtualAllocation handle;
+        vk::DeviceSize offset;
+    };
+
+    struct Statistics {
+        std::size_t allocation_count;
+        vk::DeviceSize used_size;
+        std::size_t free_region_count;
+        vk::DeviceSize largest_free_region;
+    };
+
+    explicit VirtualBlock(vk::DeviceSize size);
+
+    VirtualBlock(const VirtualBlock &) = delete;
+    VirtualBlock &operator=(const VirtualBlock &) = delete;
+    VirtualBlock(VirtualBlock &&other) noexcept;
+    VirtualBlock &operator=(VirtualBlock &&other) noexcept;
+    ~VirtualBlock();
+
+    /**
+     * Returns nullopt when no free range fits. `alignment` must be a power
+     * of two.
+     */
+    [[nodiscard]] std::optional<Allocation> allocate(vk::DeviceSize size,
+                                                     vk::DeviceSize alignment);
+    void free(VmaVirtualAllocation allocation);
+
+    /**
+     * Frees every allocation at once.
+     */
+    void clear();
+
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] vk::DeviceSize size() const noexcept { return m_size; }
+    [[nodiscard]] Statistics statistics() const;
+
+  private:
+    VmaVirtualBlock m_block = VK_NULL_HANDLE;
+    vk::DeviceSize m_size;
+};
+
+} // namespace vw
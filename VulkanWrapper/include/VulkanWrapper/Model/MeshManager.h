@@ -7,21 +7,48 @@
 #include "VulkanWrapper/Model/Material/BindlessMaterialManager.h"
 #include "VulkanWrapper/Model/Material/Material.h"
 #include "VulkanWrapper/Model/Mesh.h"
+#include <map>
 
 namespace vw::Model {
 
 class MeshManager {
   public:
+    // Stable handle of a mesh, valid until the mesh is removed
+    using MeshId = std::size_t;
+
+    // Uploads that overflow the staging ring are submitted on `queue`
     MeshManager(std::shared_ptr<const Device> device,
-                std::shared_ptr<Allocator> allocator);
+                std::shared_ptr<Allocator> allocator, Queue &queue);
+
+    /**
+     * Adds a mesh at the end of meshes(). On failure, nothing is
+     * allocated.
+     */
+    MeshId add_mesh(std::vector<FullVertex3D> vertices,
+                    std::vector<uint32_t> indices,
+                    Material::Material material);
 
-    void add_mesh(std::vector<FullVertex3D> vertices,
-                  std::vector<uint32_t> indices, Material::Material material);
+    /**
+     * Removes a mesh and returns its vertex and index ranges for reuse, in
+     * O(1). The last mesh of meshes() takes its place: use ids, not
+     * positions, to refer to meshes across removals. The GPU must no
+     * longer reference the mesh.
+     */
+    void remove_mesh(MeshId id);
+
+    /** @brief Position of a mesh in meshes() */
+    [[nodiscard]] std::size_t mesh_index(MeshId id) const;
 
     void read_file(const std::filesystem::path &path);
 
     [[nodiscard]] vk::CommandBuffer fill_command_buffer();
 
+    /**
+     * Frees the staging memory of uploads recorded so far. Call once the
+     * command buffer from fill_command_buffer() has completed.
+     */
+    void release_staging_memory();
+
     [[nodiscard]] const std::vector<Mesh> &meshes() const noexcept;
 
     [[nodiscard]] Material::BindlessMaterialManager &
@@ -31,12 +58,35 @@ class MeshManager {
     material_manager() const noexcept;
 
   private:
+    using FullVertexBufferList =
+        BufferList<FullVertex3D, false, VertexBufferUsage>;
+
+    struct MeshAllocation {
+        MeshId id;
+        // Also the range of the position-only vertices
+        FullVertexBufferList::BufferInfo vertices;
+        IndexBufferList::BufferInfo indices;
+    };
+
+    static constexpr std::size_t no_mesh = ~std::size_t{0};
+
+    // Position-only buffer mirroring the full vertex buffer of a range,
+    // so that both share one vertex offset
+    std::shared_ptr<Vertex3DBuffer>
+    position_buffer(const FullVertexBufferList::BufferInfo &full_vertices);
+
+    std::shared_ptr<Allocator> m_allocator;
     std::shared_ptr<StagingBufferManager> m_staging_buffer_manager;
-    BufferList<Vertex3D, false, VertexBufferUsage> m_vertex_buffer;
-    BufferList<FullVertex3D, false, VertexBufferUsage> m_full_vertex_buffer;
+    FullVertexBufferList m_full_vertex_buffer;
+    // By BufferInfo::buffer_id of the full vertex buffer
+    std::map<std::size_t, std::shared_ptr<Vertex3DBuffer>> m_position_buffers;
     IndexBufferList m_index_buffer;
     Material::BindlessMaterialManager m_material_manager;
     std::vector<Mesh> m_meshes;
+    // Parallel to m_meshes
+    std::vector<MeshAllocation> m_allocations;
+    // Position in m_meshes of each id, no_mesh once removed
+    std::vector<std::size_t> m_mesh_indices;
 };
 
 } // namespace vw::Model
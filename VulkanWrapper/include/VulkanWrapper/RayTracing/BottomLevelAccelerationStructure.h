@@ -58,11 +58,22 @@ class BottomLevelAccelerationStructureList {
     [[nodiscard]] std::vector<vk::DeviceAddress> device_addresses() const;
 
     vk::CommandBuffer command_buffer();
+
+    /**
+     * Submits the recorded builds, waits for them and releases the scratch
+     * memory they used.
+     */
     void submit_and_wait();
 
+    [[nodiscard]] ScratchBufferList::Statistics
+    scratch_statistics() const {
+        return m_scratch_buffer_list.statistics();
+    }
+
   private:
     AccelerationStructureBufferList m_acceleration_structure_buffer_list;
     ScratchBufferList m_scratch_buffer_list;
+    std::vector<ScratchBufferList::BufferInfo> m_pending_scratch_buffers;
     std::vector<BottomLevelAccelerationStructure>
         m_all_bottom_level_acceleration_structure;
 
@@ -62,6 +62,11 @@ class RayTracedScene {
 
     void update();
 
+    /// Hand the acceleration structures replaced by update() to `frames`,
+    /// which keeps them alive while frames in flight may trace against
+    /// them, instead of waiting for the device to be idle.
+    void set_frame_context(std::shared_ptr<FrameContext> frames);
+
     [[nodiscard]] bool needs_build() const noexcept;
 
     [[nodiscard]] bool needs_update() const noexcept;
@@ -119,6 +124,7 @@ class RayTracedScene {
 
     std::shared_ptr<const Device> m_device;
     std::shared_ptr<const Allocator> m_allocator;
+    std::shared_ptr<FrameContext> m_frames;
 
     std::vector<Instance> m_instances;
 
@@ -35,6 +35,10 @@ class TopLevelAccelerationStructure
 
     [[nodiscard]] vk::DeviceAddress device_address() const noexcept;
 
+    // Backing storage, to request from the tracker when the structure is
+    // read from several queue families
+    [[nodiscard]] const AccelerationStructureBuffer &buffer() const noexcept;
+
   private:
     vk::DeviceAddress m_device_address;
     AccelerationStructureBuffer m_buffer;
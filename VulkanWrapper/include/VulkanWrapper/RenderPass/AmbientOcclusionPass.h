@@ -30,6 +30,8 @@ class AmbientOcclusionPass : public ScreenSpacePass {
     struct PushConstants {
         float aoRadius;
         int32_t sampleIndex;
+        // From the fragment UV to the used area of the inputs
+        glm::vec2 inputUvScale;
     };
 
     AmbientOcclusionPass(
@@ -44,6 +46,7 @@ class AmbientOcclusionPass : public ScreenSpacePass {
 
     std::vector<Slot> input_slots() const override;
     std::vector<Slot> output_slots() const override;
+    std::vector<Slot> persistent_slots() const override;
 
     std::string_view name() const override {
         return "AmbientOcclusionPass";
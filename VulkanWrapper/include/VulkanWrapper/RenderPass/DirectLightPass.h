@@ -8,10 +8,12 @@
 #include "VulkanWrapper/RenderPass/RenderPass.h"
 #include "VulkanWrapper/RenderPass/SkyParameters.h"
 #include <filesystem>
+#include <span>
 
 namespace vw {
 
 class BufferBase;
+class ParallelCommandRecorder;
 
 namespace rt {
 class RayTracedScene;
@@ -46,6 +48,9 @@ struct DirectLightPassFormats {
  * per-fragment using ray queries for shadows, producing a
  * DirectLight attachment as part of the G-Buffer.
  *
+ * With a parallel recorder, the instances are drawn from
+ * secondary command buffers recorded on its threads.
+ *
  * Inputs: Slot::Depth (from ZPass)
  * Outputs: Slot::Albedo, Slot::Normal, Slot::Tangent,
  *          Slot::Bitangent, Slot::Position,
@@ -90,7 +95,20 @@ class DirectLightPass : public RenderPass {
     /// Set the frame count for temporal sampling
     void set_frame_count(uint32_t count);
 
+    /// Record the draws on the threads of `recorder`, or on
+    /// the calling thread when null
+    void set_parallel_recorder(
+        std::shared_ptr<ParallelCommandRecorder> recorder);
+
   private:
+    // Binds the pipelines, descriptor sets and dynamic state
+    // while drawing `instances`
+    void record_draws(
+        vk::CommandBuffer cmd, vk::DescriptorSet descriptor_set,
+        std::optional<vk::DescriptorSet> texture_set,
+        vk::Extent2D extent,
+        std::span<const Model::MeshInstance> instances) const;
+
     Formats m_formats;
     const rt::RayTracedScene *m_ray_traced_scene;
     Model::Material::BindlessMaterialManager
@@ -118,6 +136,7 @@ class DirectLightPass : public RenderPass {
         SkyParameters::create_earth_sun(45.0f);
     glm::vec3 m_camera_pos{0.f};
     uint32_t m_frame_count = 0;
+    std::shared_ptr<ParallelCommandRecorder> m_recorder;
 };
 
 } // namespace vw
@@ -0,0 +1,57 @@
+#pragma once
+
+namespace vw {
+
+/**
+ * @brief Picks the render scale of a RenderPipeline that keeps
+ *        the GPU frame time within a budget
+ *
+ * GPU frame times, e.g. the sum of the pass timings of a
+ * GpuProfiler, are smoothed with an exponential moving average.
+ * The cost of a frame is taken as proportional to its pixel
+ * count, the square of the scale: when the average leaves the band
+ * from `1 - headroom` times the budget to the budget, the scale
+ * moves towards the one that would hit the lower end, by up
+ * to `max_step` per update. The band keeps the scale steady
+ * once it fits.
+ *
+ * Scales are rounded to multiples of `scale_step`, so that a
+ * RenderTargetPool reuses its size buckets across updates.
+ */
+class DynamicResolution {
+  public:
+    static constexpr float scale_step = 1.0f / 32.0f;
+    static constexpr float max_step = 0.05f;
+    static constexpr double headroom = 0.1;
+    // Weight of a new frame time in the average
+    static constexpr double smoothing = 0.2;
+
+    /**
+     * Starts at `max_scale`. Throws LogicException unless the
+     * budget is positive and 0 < min_scale <= max_scale <= 1.
+     */
+    explicit DynamicResolution(double budget_ms,
+                               float min_scale = 0.5f,
+                               float max_scale = 1.0f);
+
+    /// Account for the GPU time of a frame, returns the scale
+    /// of the next one
+    float update(double frame_ms);
+
+    float scale() const { return m_scale; }
+
+    /// Smoothed frame time, 0 before the first update
+    double average_ms() const { return m_average_ms; }
+
+    double budget_ms() const { return m_budget_ms; }
+    void set_budget_ms(double budget_ms);
+
+  private:
+    double m_budget_ms;
+    float m_min_scale;
+    float m_max_scale;
+    float m_scale;
+    double m_average_ms = 0.0;
+};
+
+} // namespace vw
@@ -31,6 +31,8 @@ namespace vw {
 struct IndirectLightPushConstants {
     SkyParametersGPU sky; // 96 bytes
     uint32_t frame_count; // 4 bytes
+    // Size of the G-buffer images, which may be larger than the
+    // launch when they come from a RenderTargetPool
     uint32_t width;       // 4 bytes
     uint32_t height;      // 4 bytes
 }; // 108 bytes total
@@ -80,6 +82,17 @@ class IndirectLightPass : public RenderPass {
     std::vector<Slot> output_slots() const override {
         return {Slot::IndirectLight};
     }
+    // Samples accumulate across frames
+    std::vector<Slot> persistent_slots() const override {
+        return {Slot::IndirectLight};
+    }
+    // Ray tracing pipelines run on compute queues too. The
+    // acceleration structure, the geometry buffer and the material
+    // textures are requested from the tracker, which moves them
+    // to the compute family
+    PassQueue preferred_queue() const override {
+        return PassQueue::Compute;
+    }
 
     // -- Unified execute --
     void execute(vk::CommandBuffer cmd,
@@ -4,6 +4,8 @@
 #include "VulkanWrapper/Image/Image.h"
 #include "VulkanWrapper/Image/ImageView.h"
 #include "VulkanWrapper/Memory/Allocator.h"
+#include "VulkanWrapper/Memory/RenderTargetPool.h"
+#include "VulkanWrapper/Memory/TransientImageAllocator.h"
 #include "VulkanWrapper/RenderPass/Slot.h"
 #include "VulkanWrapper/Vulkan/Device.h"
 #include <map>
@@ -21,10 +23,37 @@ class ResourceTracker;
 struct CachedImage {
     std::shared_ptr<const Image> image;
     std::shared_ptr<const ImageView> view;
+    // Memory shared with other transient images, if aliased
+    std::shared_ptr<const void> memory;
+    // Top-left area in use when the image comes from a
+    // RenderTargetPool bucket; empty means the whole image
+    vk::Extent2D extent;
+
+    vk::Extent2D render_extent() const {
+        if (extent.width == 0 || extent.height == 0) {
+            return image->extent2D();
+        }
+        return extent;
+    }
+
+    // Scale from UV over the render extent to UV over the image,
+    // for passes sampling it
+    glm::vec2 uv_scale() const {
+        const auto used = render_extent();
+        const auto size = image->extent2D();
+        return glm::vec2(used.width, used.height) /
+               glm::vec2(size.width, size.height);
+    }
 };
 
 class RenderPipeline;
 
+// Queue a pass runs on with RenderPipeline::execute_async()
+enum class PassQueue { Graphics, Compute };
+
+// Size a pass renders at, see RenderPipeline::set_render_scale()
+enum class PassResolution { Render, Output };
+
 /**
  * @brief Non-templated base class for render passes with lazy image
  * allocation
@@ -32,7 +61,8 @@ class RenderPipeline;
  * Each pass identifies its image slots using the Slot enum.
  * Images are lazily allocated on first use and cached by
  * (slot, width, height, frame_index). When dimensions change,
- * old images with different dimensions are deleted.
+ * the old image of the frame index is deleted, or given back to
+ * the RenderTargetPool it came from.
  */
 class RenderPass {
   public:
@@ -44,12 +74,32 @@ class RenderPass {
     RenderPass &operator=(RenderPass &&) = delete;
     RenderPass &operator=(const RenderPass &) = delete;
 
-    virtual ~RenderPass() = default;
+    virtual ~RenderPass();
 
     // Introspection: which slots this pass reads/writes
     virtual std::vector<Slot> input_slots() const = 0;
     virtual std::vector<Slot> output_slots() const = 0;
 
+    // Outputs whose content carries over from one frame to the next,
+    // e.g. temporal accumulation. They are never aliased.
+    virtual std::vector<Slot> persistent_slots() const { return {}; }
+
+    // Compute passes record no rasterization, only dispatches,
+    // ray tracing and copies, and may run on an async compute
+    // queue. Every resource they use must then be requested from
+    // the tracker, for its ownership transfers, or be shared
+    // concurrently.
+    virtual PassQueue preferred_queue() const {
+        return PassQueue::Graphics;
+    }
+
+    // Passes render at the scaled render resolution, except
+    // upscalers and the passes after them, which render at the
+    // output resolution
+    virtual PassResolution resolution() const {
+        return PassResolution::Render;
+    }
+
     // Execute the pass
     virtual void execute(vk::CommandBuffer cmd,
                          Barrier::ResourceTracker &tracker,
@@ -59,6 +109,10 @@ class RenderPass {
     // Get output images after execute()
     std::vector<std::pair<Slot, CachedImage>> result_images() const;
 
+    // Output image of `slot` after execute(), or null. Unlike
+    // result_images(), it does not allocate.
+    const CachedImage *result_image(Slot slot) const;
+
     // Human-readable name for debugging / pipeline graph
     virtual std::string_view name() const = 0;
 
@@ -68,14 +122,29 @@ class RenderPass {
     // Wire an input image for the given slot
     void set_input(Slot slot, CachedImage image);
 
+    // Allocate non-transient outputs from a shared pool. Set by
+    // RenderPipeline::use_render_target_pool().
+    void set_render_target_pool(std::shared_ptr<RenderTargetPool> pool);
+
   protected:
     /**
      * @brief Get or create an image for the given slot and dimensions
      *
      * If an image with matching (slot, width, height, frame_index)
      * exists, returns it. Otherwise, creates a new image and caches
-     * it. Images with different dimensions are removed from cache
-     * to avoid memory overhead.
+     * it. The image of the slot at other dimensions for the same
+     * frame_index is removed from cache to avoid memory overhead:
+     * as for reusing an image, the previous frame with that index
+     * must be done with it. Those of other frame indices may still
+     * be in flight, and are removed when their index comes back.
+     *
+     * With a RenderTargetPool, an image whose size bucket still fits
+     * is kept and only its extent changes, so that resizing does not
+     * allocate.
+     *
+     * When RenderPipeline aliases the slot, the image shares memory
+     * with transient images of other passes and its content is
+     * undefined each frame until the pass writes it.
      */
     const CachedImage &get_or_create_image(Slot slot, Width width,
                                            Height height,
@@ -92,6 +161,14 @@ class RenderPass {
     friend class RenderPipeline;
 
   private:
+    // Set by RenderPipeline for the duration of execute() when
+    // transient aliasing is enabled
+    struct TransientContext {
+        TransientImageAllocator *allocator = nullptr;
+        Barrier::ResourceTracker *tracker = nullptr;
+        // Owned by the pipeline
+        const std::map<Slot, ImageLifetime> *lifetimes = nullptr;
+    };
 
     // Output image cache keyed by (Slot, width, height, frame_index)
     struct ImageKey {
@@ -101,7 +178,24 @@ class RenderPass {
         size_t frame_index;
         auto operator<=>(const ImageKey &) const = default;
     };
-    std::map<ImageKey, CachedImage> m_image_cache;
+    struct CacheEntry {
+        CachedImage cached;
+        // Pool to give the image back to, if it came from one
+        std::shared_ptr<RenderTargetPool> pool;
+    };
+
+    CacheEntry create_image(Slot slot, Width width, Height height,
+                            size_t frame_index, vk::Format format,
+                            vk::ImageUsageFlags usage);
+    void discard_if_aliased(const CachedImage &cached);
+
+    TransientContext m_transient;
+    std::shared_ptr<RenderTargetPool> m_render_targets;
+
+    std::map<ImageKey, CacheEntry> m_image_cache;
+    // Entry last returned by get_or_create_image() for each slot;
+    // other frame indices may still hold images at older sizes
+    std::map<Slot, ImageKey> m_latest_keys;
 
     // Input images from predecessor passes
     std::map<Slot, CachedImage> m_inputs;
@@ -1,8 +1,17 @@
 #pragma once
 
 #include "VulkanWrapper/RenderPass/RenderPass.h"
+#include "VulkanWrapper/Command/CommandPool.h"
+#include "VulkanWrapper/Memory/TransientImageAllocator.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
+#include "VulkanWrapper/fwd.h"
+#include <array>
 #include <concepts>
+#include <map>
 #include <memory>
+#include <optional>
+#include <set>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -13,11 +22,16 @@ class RenderPipeline {
     RenderPipeline() = default;
 
     // Add a pass. Returns reference for configuration.
-    // Order matters: passes execute in insertion order.
+    // A pass reads the slots produced by the passes added
+    // before it: see graph() for the execution order.
     template <std::derived_from<RenderPass> T>
     T &add(std::unique_ptr<T> pass) {
         auto &ref = *pass;
+        if (m_render_targets) {
+            ref.set_render_target_pool(m_render_targets);
+        }
         m_passes.push_back(std::move(pass));
+        m_compiled.reset();
         return ref;
     }
 
@@ -28,7 +42,168 @@ class RenderPipeline {
     };
     ValidationResult validate() const;
 
-    // Execute all passes in order, wiring outputs to inputs
+    /**
+     * @brief Dependency graph of the passes, built from their slots
+     *
+     * A pass depends on the last pass added before it producing
+     * each of its inputs and, for each slot it produces, on the
+     * previous producer and readers of the slot.
+     *
+     * The outputs of the last pass and the external slots are
+     * the outputs of the pipeline. Passes they do not depend on
+     * through the slots they read are culled; passes without
+     * outputs are kept for their side effects. An input without
+     * an earlier producer reads the previous frame: it keeps the
+     * last producer of the slot alive, without ordering them.
+     *
+     * The other passes are ordered greedily: each step runs the
+     * ready pass whose latest dependency ran earliest, leaving
+     * the barriers of its dependencies the most time to resolve.
+     * Ties keep the insertion order.
+     */
+    struct PassGraph {
+        // Live passes, by index, in execution order
+        std::vector<size_t> order;
+        // For each pass, the live passes it must run after
+        std::vector<std::vector<size_t>> dependencies;
+        std::vector<bool> culled;
+    };
+
+    // Compiled on first use, with the slot wiring, and kept
+    // until a pass is added or a slot marked external
+    const PassGraph &graph() const;
+
+    /**
+     * @brief Live passes submitted together to one queue by
+     * execute_async()
+     *
+     * Passes preferring PassQueue::Compute run on the compute
+     * queue, except the last pass and the producers of external
+     * slots, whose outputs are read after the pipeline. Walking
+     * the graph order, a pass depending on a pass of the other
+     * queue starts a new segment waiting for the segment of that
+     * pass, unless its queue's segment already waits for it. The
+     * last segment runs on the graphics queue and waits for any
+     * compute segment left.
+     */
+    struct QueueSegment {
+        PassQueue queue;
+        // Passes, by index, in execution order
+        std::vector<size_t> passes;
+        // Earlier segments of the other queue to wait for
+        std::vector<size_t> waits;
+    };
+
+    // In submission order, compiled with the graph
+    const std::vector<QueueSegment> &queue_segments() const;
+
+    // Positions, in execution order, of the passes producing
+    // and last reading each slot. A slot is transient when a
+    // later pass reads it and it is neither persistent,
+    // external, nor produced twice.
+    struct SlotLifetime {
+        ImageLifetime passes;
+        bool transient;
+    };
+    std::map<Slot, SlotLifetime> slot_lifetimes() const;
+
+    /**
+     * @brief Alias the memory of transient slots whose lifetimes do
+     * not overlap
+     *
+     * Call before the first execute(). The content of a transient
+     * slot is only valid between the pass producing it and the last
+     * pass reading it.
+     */
+    void enable_transient_aliasing();
+
+    // A slot read after execute(), e.g. to present it, is never
+    // aliased
+    void mark_external(Slot slot);
+
+    /**
+     * @brief Allocate the outputs of every pass from `pool`
+     *
+     * Resizing then reuses images of the same size bucket, or
+     * recycled ones, instead of allocating. execute() and
+     * execute_async() call RenderTargetPool::begin_frame(): give
+     * each pipeline its own pool. Transient slots are still
+     * aliased when aliasing is enabled.
+     */
+    void use_render_target_pool(std::shared_ptr<RenderTargetPool> pool);
+
+    /**
+     * @brief Split the barriers of `slot` around the passes between
+     * its producer and its first reader
+     *
+     * Right after the producing pass, the tracker releases the slot
+     * to the state its first reader requests, given here. The
+     * tracker must have split barriers enabled, otherwise the
+     * barrier is only recorded at the reader's flush. A later
+     * pass must request the slot every frame.
+     */
+    void release_after_producer(Slot slot, vk::ImageLayout layout,
+                                vk::PipelineStageFlags2 stage,
+                                vk::AccessFlags2 access);
+
+    /**
+     * @brief Measure the GPU time of every pass, under its name
+     *
+     * Each pass executes in a scope of `profiler`. Call
+     * GpuProfiler::begin_frame() on the command buffer before
+     * execute(), once per frame.
+     */
+    void use_gpu_profiler(std::shared_ptr<GpuProfiler> profiler);
+
+    /**
+     * @brief Submit the compute passes to `compute`, overlapping
+     * with the graphics ones on `graphics`
+     *
+     * Each frame slot, frame_index modulo `frames_in_flight`, has
+     * its own command pools; execute_async() waits for the
+     * previous frame of the slot before reusing them. The queues
+     * are joined with their timeline semaphores, see
+     * queue_segments(). With the same queue twice, the segments
+     * run one after the other.
+     *
+     * With queues of different families, images are moved
+     * between them with ownership transfers: a resource read on
+     * both queues serializes their segments. Resources a compute
+     * pass uses without requesting them from the tracker must be
+     * created with concurrent sharing.
+     */
+    void use_async_compute(std::shared_ptr<const Device> device,
+                           Queue &graphics, Queue &compute,
+                           uint32_t frames_in_flight);
+
+    /**
+     * @brief Record and submit the segments of the frame
+     *
+     * The tracker gives each request the family of the queue it
+     * is recorded for, see ResourceTracker::set_queue_family().
+     * The first graphics submission waits on `waits`, e.g. the
+     * swapchain image, and the last one signals `signals`; its
+     * ticket, returned, completes after every pass.
+     *
+     * Transient aliasing cannot be used: lifetimes assume one
+     * queue. Slots given to release_after_producer() are not
+     * released early, as events do not cross queues. The
+     * GpuProfiler only measures the graphics passes, and
+     * execute_async() calls GpuProfiler::begin_frame() itself.
+     */
+    SubmitTicket
+    execute_async(Barrier::ResourceTracker &tracker, Width width,
+                  Height height, size_t frame_index,
+                  std::span<const vk::SemaphoreSubmitInfo> waits = {},
+                  std::span<const vk::SemaphoreSubmitInfo> signals = {});
+
+    // Memory requested by the aliased images and actually allocated
+    TransientImageAllocator::Statistics aliasing_statistics() const;
+
+    // Execute the live passes in the order of the graph,
+    // wiring outputs to inputs. Once every image exists, the
+    // wiring, aliasing and barriers of the pipeline allocate no
+    // memory; what the passes' execute() allocates is theirs.
     void execute(vk::CommandBuffer cmd,
                  Barrier::ResourceTracker &tracker,
                  Width width, Height height,
@@ -37,12 +212,100 @@ class RenderPipeline {
     // Reset progressive accumulation in all passes
     void reset_accumulation();
 
+    /**
+     * @brief Render the passes of PassResolution::Render at a
+     * fraction of the output size
+     *
+     * execute() and execute_async() give these passes the
+     * output size times `scale`, see render_extent(), and the
+     * others, e.g. a TemporalUpscalePass and the tone mapping
+     * after it, the output size. Changing the scale resets the
+     * accumulation of the Render passes, whose images are
+     * recreated. With a RenderTargetPool, the images of nearby
+     * scales share size buckets.
+     *
+     * Throws LogicException unless 0 < scale <= 1.
+     */
+    void set_render_scale(float scale);
+    float render_scale() const;
+
+    // Output size times the render scale, at least one pixel
+    vk::Extent2D render_extent(Width width, Height height) const;
+
     // Access passes by index
     RenderPass &pass(size_t index);
     const RenderPass &pass(size_t index) const;
     size_t pass_count() const;
 
   private:
+    // Slots of a pass with their dense index, from 0 to the
+    // number of slots in the pipeline
+    struct PassSlots {
+        std::vector<std::pair<Slot, size_t>> inputs;
+        std::vector<std::pair<Slot, size_t>> outputs;
+    };
+    struct Compiled {
+        PassGraph graph;
+        std::vector<PassSlots> slots;
+        size_t slot_count = 0;
+        std::map<Slot, ImageLifetime> transient_lifetimes;
+        std::vector<QueueSegment> segments;
+    };
+
+    const Compiled &compiled() const;
+    PassGraph compile_graph() const;
+    std::vector<QueueSegment>
+    compile_segments(const PassGraph &graph) const;
+
+    // Executes one pass and collects its outputs
+    void execute_pass(vk::CommandBuffer cmd,
+                      Barrier::ResourceTracker &tracker,
+                      size_t index, Width width, Height height,
+                      size_t frame_index, bool aliasing,
+                      bool profiled, bool release);
+    std::map<Slot, SlotLifetime>
+    slot_lifetimes(const PassGraph &graph) const;
+
+    mutable std::optional<Compiled> m_compiled;
+    // Output of each dense slot during execute()
+    std::vector<const CachedImage *> m_slot_outputs;
+    bool m_transient_aliasing = false;
+    float m_render_scale = 1.0f;
+    std::set<Slot> m_external_slots;
+
+    struct ReleasedState {
+        vk::ImageLayout layout;
+        vk::PipelineStageFlags2 stage;
+        vk::AccessFlags2 access;
+    };
+    std::map<Slot, ReleasedState> m_released_slots;
+    std::shared_ptr<RenderTargetPool> m_render_targets;
+    std::shared_ptr<GpuProfiler> m_profiler;
+
+    // Command buffers of a frame slot on one queue, reused once
+    // the slot's previous frame completed
+    struct QueueCommands {
+        CommandPool pool;
+        std::vector<vk::CommandBuffer> buffers;
+        size_t used = 0;
+        SubmitTicket last;
+
+        vk::CommandBuffer next();
+    };
+    struct AsyncCompute {
+        std::shared_ptr<const Device> device;
+        // Graphics, then compute
+        std::array<Queue *, 2> queues;
+        std::vector<std::array<QueueCommands, 2>> frames;
+        // Last submission of the previous frame on each queue
+        std::array<SubmitTicket, 2> last;
+        // Reused by execute_async()
+        std::vector<SubmitTicket> tickets;
+        std::vector<vk::SemaphoreSubmitInfo> waits;
+    };
+    std::unique_ptr<AsyncCompute> m_async;
+    // Declared before the passes, whose images it backs
+    std::unique_ptr<TransientImageAllocator> m_transient_images;
     std::vector<std::unique_ptr<RenderPass>> m_passes;
 };
 
@@ -5,6 +5,7 @@
 #include "VulkanWrapper/Pipeline/Pipeline.h"
 #include "VulkanWrapper/RenderPass/RenderPass.h"
 #include <optional>
+#include <span>
 
 namespace vw {
 
@@ -60,12 +61,30 @@ class ScreenSpacePass : public RenderPass {
         std::optional<DescriptorSet> descriptor_set = std::nullopt,
         const void *push_constants = nullptr,
         size_t push_constants_size = 0) {
+        render_fullscreen(cmd, extent, std::span(&color_attachment, 1),
+                          depth_attachment, pipeline,
+                          std::move(descriptor_set), push_constants,
+                          push_constants_size);
+    }
+
+    /**
+     * @brief Render a fullscreen quad to several color attachments,
+     * in the order of the pipeline's color formats
+     */
+    void render_fullscreen(
+        vk::CommandBuffer cmd, vk::Extent2D extent,
+        std::span<const vk::RenderingAttachmentInfo> color_attachments,
+        const vk::RenderingAttachmentInfo *depth_attachment,
+        const Pipeline &pipeline,
+        std::optional<DescriptorSet> descriptor_set = std::nullopt,
+        const void *push_constants = nullptr,
+        size_t push_constants_size = 0) {
 
         vk::RenderingInfo rendering_info =
             vk::RenderingInfo()
                 .setRenderArea(vk::Rect2D({0, 0}, extent))
                 .setLayerCount(1)
-                .setColorAttachments(color_attachment);
+                .setColorAttachments(color_attachments);
 
         if (depth_attachment) {
             rendering_info.setPDepthAttachment(depth_attachment);
@@ -21,6 +21,8 @@ enum class Slot {
     AmbientOcclusion,
     Sky,
     IndirectLight,
+    // Radiance reconstructed at the output resolution
+    Upscaled,
 
     // Final
     ToneMapped,
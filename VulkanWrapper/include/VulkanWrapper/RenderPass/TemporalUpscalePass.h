@@ -0,0 +1,145 @@
+#pragma once
+
+#include "VulkanWrapper/Descriptors/DescriptorPool.h"
+#include "VulkanWrapper/Descriptors/DescriptorSetLayout.h"
+#include "VulkanWrapper/Image/Sampler.h"
+#include "VulkanWrapper/Pipeline/Pipeline.h"
+#include "VulkanWrapper/RenderPass/ScreenSpacePass.h"
+#include <array>
+#include <filesystem>
+
+namespace vw {
+
+/**
+ * @brief Temporal upscaler reconstructing the output resolution
+ *        from jittered frames rendered at a lower one
+ *
+ * The passes before it render at the scale of
+ * RenderPipeline::set_render_scale(), with their projection
+ * offset by a sub-pixel jitter() every frame, see
+ * jittered_projection(). The pass composes the radiance of the
+ * light buffers, sky + direct + indirect * intensity, and blends
+ * it with its history, reprojected from the depth buffer and
+ * the view-projection of the previous frame. The history is
+ * clamped to the color range of the neighbourhood of the pixel
+ * in the current frame, which rejects disoccluded content.
+ *
+ * Reprojection only follows the camera: moving objects ghost
+ * within the clamped range.
+ *
+ * Inputs: Slot::Sky, Slot::DirectLight, optionally
+ *         Slot::IndirectLight, and Slot::Depth
+ * Output: Slot::Upscaled, at the output resolution
+ */
+class TemporalUpscalePass : public ScreenSpacePass {
+  public:
+    struct PushConstants {
+        // Previous view-projection times the inverse of the
+        // current one, both without jitter
+        glm::mat4 reprojection;
+        // From the output UV to the used area of the inputs
+        glm::vec2 input_uv_scale;
+        // Jitter of the frame, in input UV
+        glm::vec2 input_uv_jitter;
+        float indirect_intensity;
+        // Weight of the current frame; 1 discards the history
+        float blend_factor;
+    };
+
+    // Length of the jitter sequence
+    static constexpr uint32_t jitter_phase_count = 8;
+
+    TemporalUpscalePass(
+        std::shared_ptr<Device> device,
+        std::shared_ptr<Allocator> allocator,
+        const std::filesystem::path &shader_dir,
+        vk::Format output_format =
+            vk::Format::eR16G16B16A16Sfloat,
+        bool indirect_enabled = true);
+
+    std::vector<Slot> input_slots() const override;
+    std::vector<Slot> output_slots() const override {
+        return {Slot::Upscaled};
+    }
+
+    PassResolution resolution() const override {
+        return PassResolution::Output;
+    }
+
+    std::string_view name() const override {
+        return "TemporalUpscalePass";
+    }
+
+    void execute(vk::CommandBuffer cmd,
+                 Barrier::ResourceTracker &tracker,
+                 Width width, Height height,
+                 size_t frame_index) override;
+
+    /// Discard the history (call on camera cut)
+    void reset_accumulation() override;
+
+    /**
+     * @brief Sub-pixel offset of the next frame, in render
+     *        pixels within [-0.5, 0.5]
+     *
+     * A Halton (2, 3) sequence of jitter_phase_count phases,
+     * advanced by execute().
+     */
+    glm::vec2 jitter() const { return jitter_at(m_frame); }
+
+    /// Offset of the `frame`-th frame since construction
+    static glm::vec2 jitter_at(uint32_t frame);
+
+    /**
+     * @brief `projection` offset by `jitter` render pixels on
+     *        an image of `render_extent`
+     *
+     * Use it to render the inputs of the frame, and give the
+     * unjittered view-projection to set_view_projection().
+     */
+    static glm::mat4 jittered_projection(const glm::mat4 &projection,
+                                         glm::vec2 jitter,
+                                         vk::Extent2D render_extent);
+
+    /// View-projection of the next frame, without jitter
+    void set_view_projection(const glm::mat4 &view_projection);
+
+    void set_indirect_intensity(float intensity) {
+        m_indirect_intensity = intensity;
+    }
+
+    /// Weight of the current frame in the history, 0.1 by
+    /// default: lower is smoother but slower to react
+    void set_blend_factor(float blend_factor) {
+        m_blend_factor = blend_factor;
+    }
+
+  private:
+    // Written in turn: one holds the previous frame
+    struct History {
+        std::shared_ptr<const Image> image;
+        std::shared_ptr<const ImageView> view;
+    };
+
+    void create_history(vk::Extent2D extent);
+
+    vk::Format m_output_format;
+    bool m_indirect_enabled;
+
+    float m_indirect_intensity = 0.0f;
+    float m_blend_factor = 0.1f;
+    glm::mat4 m_view_projection{1.0f};
+    glm::mat4 m_previous_view_projection{1.0f};
+
+    uint32_t m_frame = 0;
+    bool m_history_valid = false;
+    std::array<History, 2> m_history;
+
+    // Resources
+    std::shared_ptr<const Sampler> m_sampler;
+    std::shared_ptr<DescriptorSetLayout> m_descriptor_layout;
+    std::shared_ptr<const Pipeline> m_pipeline;
+    DescriptorPool m_descriptor_pool;
+};
+
+} // namespace vw
@@ -44,7 +44,8 @@ enum class ToneMappingOperator : int32_t {
  * mapping to produce displayable LDR output.
  *
  * Inputs: Slot::Sky, Slot::DirectLight, optionally
- *         Slot::IndirectLight
+ *         Slot::IndirectLight; or Slot::Upscaled after a
+ *         TemporalUpscalePass, see set_upscaled_input()
  * Outputs: Slot::ToneMapped
  *
  * @note Gamma correction is NOT applied by this pass. Use sRGB
@@ -56,6 +57,8 @@ class ToneMappingPass : public ScreenSpacePass {
      * @brief Push constants for tone mapping configuration
      */
     struct PushConstants {
+        // From the fragment UV to the used area of the inputs
+        glm::vec2 input_uv_scale;
         float exposure;
         int32_t operator_id;
         float white_point;
@@ -119,6 +122,11 @@ class ToneMappingPass : public ScreenSpacePass {
         return "ToneMappingPass";
     }
 
+    // Runs at the output resolution, after any upscaler
+    PassResolution resolution() const override {
+        return PassResolution::Output;
+    }
+
     // -- Getters / setters --
     ToneMappingOperator get_operator() const {
         return m_current_operator;
@@ -158,6 +166,19 @@ class ToneMappingPass : public ScreenSpacePass {
         m_indirect_enabled = enabled;
     }
 
+    /**
+     * @brief Read the radiance composed by a TemporalUpscalePass
+     *
+     * The pass then reads Slot::Upscaled, which already holds
+     * sky, direct and indirect light, instead of the light
+     * buffers. Set before the pipeline first executes, as the
+     * slots are compiled once.
+     */
+    bool is_upscaled_input() const { return m_upscaled_input; }
+    void set_upscaled_input(bool upscaled) {
+        m_upscaled_input = upscaled;
+    }
+
   private:
     struct CompiledShaders {
         std::shared_ptr<const ShaderModule> vertex;
@@ -170,8 +191,21 @@ class ToneMappingPass : public ScreenSpacePass {
     create_descriptor_pool(CompiledShaders shaders);
     void create_black_fallback_image();
 
+    // Renders into the render extent of `output`
+    void tone_map(vk::CommandBuffer cmd,
+                  Barrier::ResourceTracker &tracker,
+                  const CachedImage &output,
+                  glm::vec2 input_uv_scale,
+                  std::shared_ptr<const ImageView> sky_view,
+                  std::shared_ptr<const ImageView> direct_light_view,
+                  std::shared_ptr<const ImageView> indirect_view,
+                  float indirect_intensity,
+                  ToneMappingOperator tone_operator, float exposure,
+                  float white_point, float luminance_scale);
+
     vk::Format m_output_format;
     bool m_indirect_enabled;
+    bool m_upscaled_input = false;
 
     // Default parameters
     ToneMappingOperator m_current_operator =
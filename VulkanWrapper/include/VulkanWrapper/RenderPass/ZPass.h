@@ -5,10 +5,12 @@
 #include "VulkanWrapper/Pipeline/Pipeline.h"
 #include "VulkanWrapper/RenderPass/RenderPass.h"
 #include <filesystem>
+#include <span>
 
 namespace vw {
 
 class BufferBase;
+class ParallelCommandRecorder;
 
 namespace rt {
 class RayTracedScene;
@@ -22,6 +24,8 @@ class RayTracedScene;
  * execute() and cached for reuse.
  *
  * The UBO and scene are provided via setters before execute().
+ * With a parallel recorder, the instances are drawn from secondary
+ * command buffers recorded on its threads.
  */
 class ZPass : public RenderPass {
   public:
@@ -45,7 +49,19 @@ class ZPass : public RenderPass {
     /// Set the scene containing mesh instances to render
     void set_scene(const rt::RayTracedScene &scene);
 
+    /// Record the draws on the threads of `recorder`, or on
+    /// the calling thread when null
+    void set_parallel_recorder(
+        std::shared_ptr<ParallelCommandRecorder> recorder);
+
   private:
+    // Binds the pipeline and the dynamic state, then draws
+    // `instances`
+    void record_draws(
+        vk::CommandBuffer cmd, vk::DescriptorSet descriptor_set,
+        vk::Extent2D extent,
+        std::span<const Model::MeshInstance> instances) const;
+
     vk::Format m_depth_format;
     std::shared_ptr<DescriptorSetLayout> m_descriptor_layout;
     std::shared_ptr<const Pipeline> m_pipeline;
@@ -53,6 +69,7 @@ class ZPass : public RenderPass {
 
     const BufferBase *m_uniform_buffer = nullptr;
     const rt::RayTracedScene *m_scene = nullptr;
+    std::shared_ptr<ParallelCommandRecorder> m_recorder;
 };
 
 } // namespace vw
@@ -0,0 +1,43 @@
+#pragma once
+#include "VulkanWrapper/3rd_party.h"
+#include "VulkanWrapper/fwd.h"
+#include <memory>
+#include <vector>
+
+namespace vw {
+
+/**
+ * Recycles device-only events used for split barriers.
+ *
+ * An event is acquired before being set on the device, and retired in the
+ * frame whose command buffer waits on it and resets it. It becomes
+ * available again once begin_frame() has been called `frames_in_flight`
+ * times, when the caller has waited for that frame to complete. Not
+ * thread-safe.
+ */
+class EventPool {
+  public:
+    EventPool(std::shared_ptr<const Device> device,
+              uint32_t frames_in_flight);
+
+    [[nodiscard]] vk::Event acquire();
+
+    /** @brief The event is waited on and reset by the current frame */
+    void retire(vk::Event event);
+
+    /** @brief Starts a new frame, recycling the events it made safe */
+    void begin_frame();
+
+    /** @brief Number of events created so far */
+    [[nodiscard]] std::size_t size() const noexcept { return m_events.size(); }
+
+  private:
+    std::shared_ptr<const Device> m_device;
+    std::vector<vk::UniqueEvent> m_events;
+    std::vector<vk::Event> m_available;
+    // Retired events, per frame slot
+    std::vector<std::vector<vk::Event>> m_retired;
+    std::size_t m_frame_slot = 0;
+};
+
+} // namespace vw
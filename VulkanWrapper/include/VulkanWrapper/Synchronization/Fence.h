@@ -12,6 +12,7 @@ class Fence : public ObjectWithUniqueHandle<vk::UniqueFence> {
   public:
     void wait() const;
     void reset() const;
+    [[nodiscard]] bool is_signaled() const;
 
     Fence(const Fence &) = delete;
     Fence(Fence &&) noexcept = default;
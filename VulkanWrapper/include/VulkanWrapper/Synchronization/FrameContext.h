@@ -0,0 +1,100 @@
+#pragma once
+#include "VulkanWrapper/3rd_party.h"
+#include "VulkanWrapper/Command/CommandPool.h"
+#include "VulkanWrapper/fwd.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
+#include <memory>
+#include <vector>
+
+namespace vw {
+
+/**
+ * Paces the CPU against the GPU with a fixed number of frames in flight,
+ * so that frame N+1 is recorded while the GPU executes frame N.
+ *
+ * Each frame slot has its own command pool, reset rather than reallocated
+ * when the slot comes around again, once the submission of the frame that
+ * last used it completed. Resources given to defer_destruction() are kept
+ * alive until the submission of the current frame completed, instead of
+ * waiting for the device to be idle before destroying them. Not
+ * thread-safe.
+ */
+class FrameContext {
+  public:
+    static constexpr uint32_t default_frames_in_flight = 2;
+
+    FrameContext(std::shared_ptr<const Device> device, Queue &queue,
+                 uint32_t frames_in_flight = default_frames_in_flight);
+
+    /** @brief Waits for every frame in flight */
+    ~FrameContext();
+
+    FrameContext(const FrameContext &) = delete;
+    FrameContext &operator=(const FrameContext &) = delete;
+
+    /**
+     * Starts a frame: waits for the frame that last used the slot,
+     * releases its deferred resources and resets its command pool.
+     * @return The command buffer of the frame, begun
+     */
+    vk::CommandBuffer begin_frame();
+
+    /**
+     * Ends the command buffer of the frame and submits it, along with the
+     * command buffers enqueued on the queue.
+     */
+    SubmitTicket
+    end_frame(std::span<const vk::SemaphoreSubmitInfo> waits = {},
+              std::span<const vk::SemaphoreSubmitInfo> signals = {});
+
+    /**
+     * A command buffer from the pool of the current frame, valid until
+     * the slot comes around again. The caller records and submits it
+     * before end_frame().
+     */
+    vk::CommandBuffer allocate_command_buffer();
+
+    /**
+     * Keeps `resource` alive until the frame being recorded, or the next
+     * one outside of a frame, completed on the device.
+     */
+    void defer_destruction(std::shared_ptr<const void> resource);
+
+    /**
+     * Waits for every frame in flight and releases the deferred
+     * resources.
+     */
+    void wait_idle();
+
+    /** @brief Slot of the current frame, in [0, frames_in_flight) */
+    [[nodiscard]] uint32_t frame_index() const noexcept {
+        return m_frame_index;
+    }
+    [[nodiscard]] uint32_t frames_in_flight() const noexcept {
+        return static_cast<uint32_t>(m_frames.size());
+    }
+    /** @brief Number of frames begun so far */
+    [[nodiscard]] uint64_t frame_number() const noexcept {
+        return m_frame_number;
+    }
+
+  private:
+    struct Frame {
+        CommandPool pool;
+        std::vector<vk::CommandBuffer> command_buffers;
+        std::size_t used_command_buffers = 0;
+        SubmitTicket ticket;
+        std::vector<std::shared_ptr<const void>> deferred;
+    };
+
+    std::shared_ptr<const Device> m_device;
+    Queue *m_queue;
+    std::vector<Frame> m_frames;
+    uint32_t m_frame_index = 0;
+    uint64_t m_frame_number = 0;
+    bool m_recording = false;
+    // Deferred outside of a frame, handed to the next one
+    std::vector<std::shared_ptr<const void>> m_deferred;
+};
+
+} // namespace vw
@@ -2,18 +2,28 @@
 #include "VulkanWrapper/3rd_party.h"
 #include "VulkanWrapper/fwd.h"
 #include "VulkanWrapper/Memory/IntervalSet.h"
-#include <unordered_map>
+#include "VulkanWrapper/Utils/FlatHandleMap.h"
+#include <map>
+#include <memory>
 #include <variant>
 #include <vector>
 
 namespace vw::Barrier {
 
+// Image and buffer states may name the queue family using the resource.
+// Resources created with exclusive sharing and used from several families
+// give it in every request, so that the tracker transfers their ownership.
+// The default, ignored, never transfers it.
+
 struct ImageState {
     vk::Image image;
     vk::ImageSubresourceRange subresourceRange;
     vk::ImageLayout layout;
     vk::PipelineStageFlags2 stage;
     vk::AccessFlags2 access;
+    uint32_t queue_family = vk::QueueFamilyIgnored;
+
+    bool operator==(const ImageState &) const = default;
 };
 
 struct BufferState {
@@ -22,12 +32,17 @@ struct BufferState {
     vk::DeviceSize size;
     vk::PipelineStageFlags2 stage;
     vk::AccessFlags2 access;
+    uint32_t queue_family = vk::QueueFamilyIgnored;
+
+    bool operator==(const BufferState &) const = default;
 };
 
 struct AccelerationStructureState {
     vk::AccelerationStructureKHR handle;
     vk::PipelineStageFlags2 stage;
     vk::AccessFlags2 access;
+
+    bool operator==(const AccelerationStructureState &) const = default;
 };
 
 using ResourceState =
@@ -35,12 +50,135 @@ using ResourceState =
 
 class ResourceTracker {
   public:
+    static constexpr std::size_t default_global_barrier_threshold = 8;
+
+    /**
+     * Barrier counters, accumulated over every flush() since
+     * construction or the last reset_statistics().
+     */
+    struct Statistics {
+        /** @brief Barriers generated by request() */
+        std::size_t requested_barriers = 0;
+        /** @brief Barriers recorded after merging */
+        std::size_t emitted_barriers = 0;
+        /** @brief Buffer barriers folded into a global memory barrier */
+        std::size_t folded_buffer_barriers = 0;
+        /** @brief Calls to flush() that recorded a pipeline barrier */
+        std::size_t pipeline_barrier_count = 0;
+        /** @brief Barriers recorded in events by release() */
+        std::size_t split_barriers = 0;
+        /** @brief Queue family ownership transfers of image or buffer
+         * ranges */
+        std::size_t ownership_transfers = 0;
+
+        [[nodiscard]] std::size_t merged_barriers() const noexcept {
+            return requested_barriers - emitted_barriers;
+        }
+    };
+
     ResourceTracker() = default;
 
+    /**
+     * Creates a shard, to record passes on another thread than the one
+     * owning this tracker. A shard does not assume anything about the
+     * resources it has not seen: their first use is kept as a requirement
+     * instead of producing a barrier, and merge() resolves it against the
+     * state left by the previous passes.
+     */
+    [[nodiscard]] static ResourceTracker create_shard();
+
+    /**
+     * Makes room for `count` images and `count` buffers, so that tracking
+     * them does not grow the state tables.
+     */
+    void reserve(std::size_t count);
+
     void track(const ResourceState &state);
+
+    /**
+     * Makes the resource ready for `state`. When it comes from another
+     * queue family than the one owning the resource, the barrier becomes
+     * an ownership transfer: flush() records its acquire half, and
+     * flush_releases() its release half for the owning family.
+     */
     void request(const ResourceState &state);
+
+    /**
+     * Records the pending barriers in a single pipeline barrier. Image
+     * barriers sharing image, layouts, masks and queue families are merged
+     * into unified subresource ranges, and buffer barriers into unified
+     * ranges. When at least the global barrier threshold of buffer
+     * barriers remain, they are folded into one global memory barrier.
+     */
     void flush(vk::CommandBuffer commandBuffer);
 
+    /**
+     * Records the ownership releases of the resources requested from other
+     * families than `queue_family`, which owns them, on `commandBuffer`
+     * from that family. Its submission must come before the one of the
+     * acquires, which waits on a semaphore it signals.
+     */
+    void flush_releases(vk::CommandBuffer commandBuffer,
+                        uint32_t queue_family);
+
+    /** @brief Whether flush_releases() would record for `queue_family` */
+    [[nodiscard]] bool
+    has_pending_releases(uint32_t queue_family) const noexcept;
+
+    /**
+     * Queue family given to the image and buffer requests that name none,
+     * i.e. the family of the queue the next commands are submitted to.
+     * RenderPipeline::execute_async() switches it between its queues, so
+     * that passes need not know where they run. Ignored by default.
+     */
+    void set_queue_family(uint32_t queue_family) noexcept;
+
+    /**
+     * Stitches `shard` after the requests made so far, as if its requests
+     * had been made on this tracker: the barriers its first uses need are
+     * left pending, to be flushed before the commands of the shard, and
+     * the states it left become the tracked ones.
+     *
+     * Merging the shards of consecutive passes in pass order gives the
+     * final states of a serial recording. A resource read at the start of
+     * a shard and written later in it waits for the previous readers with
+     * its own barrier, instead of folding them in the shard's one. The
+     * shard must have been flushed; it is left empty.
+     */
+    void merge(ResourceTracker &&shard);
+
+    /**
+     * Makes release() split barriers in two, with events taken from
+     * `events`. Call EventPool::begin_frame() once per frame.
+     */
+    void enable_split_barriers(std::shared_ptr<EventPool> events);
+
+    /**
+     * Starts the transition of a resource to `next`, the state its
+     * consumer will request, right after the commands producing it.
+     *
+     * The pending barriers are flushed, then the barriers to `next` are
+     * recorded in an event set on `commandBuffer`. The next request() of
+     * the resource waits on the event at its flush(), so that the
+     * transition overlaps with the commands recorded in between. A request
+     * of exactly `next` needs no further barrier. Every released resource
+     * must be requested before it is released again.
+     *
+     * Without split barriers, for acceleration structures and for
+     * ownership transfers, which events cannot carry, this is
+     * request(next).
+     */
+    void release(vk::CommandBuffer commandBuffer, const ResourceState &next);
+
+    /**
+     * Number of buffer barriers from which flush() emits one global memory
+     * barrier instead. 0 never folds them.
+     */
+    void set_global_barrier_threshold(std::size_t threshold) noexcept;
+
+    [[nodiscard]] const Statistics &statistics() const noexcept;
+    void reset_statistics() noexcept;
+
   private:
     friend class ResourceTrackerTest;
 
@@ -48,39 +186,40 @@ class ResourceTracker {
         vk::ImageLayout layout = vk::ImageLayout::eUndefined;
         vk::PipelineStageFlags2 stage = vk::PipelineStageFlagBits2::eNone;
         vk::AccessFlags2 access = vk::AccessFlagBits2::eNone;
+        uint32_t queue_family = vk::QueueFamilyIgnored;
+        // In a shard, set while the range is in the state of its first use
+        bool first_use = false;
+        // Scope that readers not covered by `stage` and `access`, which
+        // the last barrier synchronized, wait for: the last write, and the
+        // stages after a layout or queue family transition
+        vk::PipelineStageFlags2 write_stage = vk::PipelineStageFlagBits2::eNone;
+        vk::AccessFlags2 write_access = vk::AccessFlagBits2::eNone;
+
+        bool operator==(const InternalImageState &) const = default;
     };
 
     struct InternalBufferState {
         vk::PipelineStageFlags2 stage = vk::PipelineStageFlagBits2::eNone;
         vk::AccessFlags2 access = vk::AccessFlagBits2::eNone;
+        uint32_t queue_family = vk::QueueFamilyIgnored;
+        bool first_use = false;
+        // See InternalImageState
+        vk::PipelineStageFlags2 write_stage = vk::PipelineStageFlagBits2::eNone;
+        vk::AccessFlags2 write_access = vk::AccessFlagBits2::eNone;
+
+        bool operator==(const InternalBufferState &) const = default;
     };
 
     struct InternalAccelerationStructureState {
         vk::PipelineStageFlags2 stage = vk::PipelineStageFlagBits2::eNone;
         vk::AccessFlags2 access = vk::AccessFlagBits2::eNone;
+        vk::PipelineStageFlags2 write_stage = vk::PipelineStageFlagBits2::eNone;
+        vk::AccessFlags2 write_access = vk::AccessFlagBits2::eNone;
     };
 
-    struct HandleHash {
-        std::size_t
-        operator()(const vk::AccelerationStructureKHR &handle) const {
-            return std::hash<uint64_t>()(
-                (uint64_t)(VkAccelerationStructureKHR)handle);
-        }
-    };
-
-    struct BufferHandleHash {
-        std::size_t operator()(const vk::Buffer &buffer) const {
-            return std::hash<uint64_t>()((uint64_t)(VkBuffer)buffer);
-        }
-    };
-
-    struct ImageHandleHash {
-        std::size_t operator()(const vk::Image &image) const {
-            return std::hash<uint64_t>()((uint64_t)(VkImage)image);
-        }
-    };
-
-    // Group intervals by state: vector<pair<IntervalSet, State>>
+    // Group intervals by state: vector<pair<IntervalSet, State>>. A
+    // resource used as a whole has a single group holding one interval,
+    // which request() updates in place.
     struct BufferIntervalSetState {
         BufferIntervalSet intervals;
         InternalBufferState state;
@@ -91,38 +230,87 @@ class ResourceTracker {
         InternalImageState state;
     };
 
-    std::unordered_map<vk::Buffer, std::vector<BufferIntervalSetState>,
-                       BufferHandleHash>
+    FlatHandleMap<vk::Buffer, std::vector<BufferIntervalSetState>>
         m_buffer_states;
-    std::unordered_map<vk::Image, std::vector<ImageIntervalSetState>,
-                       ImageHandleHash>
+    FlatHandleMap<vk::Image, std::vector<ImageIntervalSetState>>
         m_image_states;
-    std::unordered_map<vk::AccelerationStructureKHR,
-                       InternalAccelerationStructureState, HandleHash>
+    FlatHandleMap<vk::AccelerationStructureKHR,
+                  InternalAccelerationStructureState>
         m_as_states;
 
     std::vector<vk::ImageMemoryBarrier2> m_pending_image_barriers;
     std::vector<vk::BufferMemoryBarrier2> m_pending_buffer_barriers;
     std::vector<vk::MemoryBarrier2> m_pending_memory_barriers;
 
+    // Release halves of ownership transfers, by source queue family
+    struct PendingReleases {
+        std::vector<vk::ImageMemoryBarrier2> image_barriers;
+        std::vector<vk::BufferMemoryBarrier2> buffer_barriers;
+    };
+    std::map<uint32_t, PendingReleases> m_pending_releases;
+
+    // Barriers recorded in an event by release(), until the resource is
+    // requested and the event waited on
+    struct SplitBarrier {
+        vk::Event event;
+        ResourceState next;
+        std::vector<vk::ImageMemoryBarrier2> image_barriers;
+        std::vector<vk::BufferMemoryBarrier2> buffer_barriers;
+    };
+
+    std::shared_ptr<EventPool> m_events;
+    std::vector<SplitBarrier> m_released;
+    std::vector<SplitBarrier> m_pending_waits;
+
+    // First uses of a shard that a later barrier of the shard depends on,
+    // and those of acceleration structures
+    bool m_shard = false;
+    std::vector<ResourceState> m_first_uses;
+
+    uint32_t m_queue_family = vk::QueueFamilyIgnored;
+
+    std::size_t m_global_barrier_threshold =
+        default_global_barrier_threshold;
+    Statistics m_statistics;
+
+    // `queue_family`, or the one of set_queue_family() when ignored
+    uint32_t requested_family(uint32_t queue_family) const noexcept;
+
+    // Merges the pending barriers in place, updating the statistics
+    void merge_pending_barriers();
+
+    // Moves the release of the resource of `state`, if any, to the pending
+    // waits. Returns true when it already transitioned it to `state`.
+    bool wait_released(const ResourceState &state);
+    void wait_pending_events(vk::CommandBuffer commandBuffer);
+
     void track_image(vk::Image image,
                      vk::ImageSubresourceRange subresourceRange,
-                     vk::ImageLayout layout, vk::PipelineStageFlags2 stage,
-                     vk::AccessFlags2 access);
+                     const InternalImageState &state);
     void track_buffer(vk::Buffer buffer, vk::DeviceSize offset,
-                      vk::DeviceSize size, vk::PipelineStageFlags2 stage,
-                      vk::AccessFlags2 access);
+                      vk::DeviceSize size, const InternalBufferState &state);
     void track_acceleration_structure(vk::AccelerationStructureKHR handle,
                                       vk::PipelineStageFlags2 stage,
                                       vk::AccessFlags2 access);
 
+    // Whether moving from `current` to `requested` is a hazard: a layout
+    // change, a write on either side or an ownership transfer. Reads in
+    // the same layout and queue family are not, but still wait for the
+    // last write when its barrier did not cover them.
+    static bool needs_barrier(const InternalImageState &current,
+                              const InternalImageState &requested);
+    static bool needs_barrier(const InternalBufferState &current,
+                              const InternalBufferState &requested);
+
+    // With `force`, a barrier is emitted even between reads
     void request_image(vk::Image image,
                        vk::ImageSubresourceRange subresourceRange,
-                       vk::ImageLayout layout, vk::PipelineStageFlags2 stage,
-                       vk::AccessFlags2 access);
+                       const InternalImageState &requested,
+                       bool force = false);
     void request_buffer(vk::Buffer buffer, vk::DeviceSize offset,
-                        vk::DeviceSize size, vk::PipelineStageFlags2 stage,
-                        vk::AccessFlags2 access);
+                        vk::DeviceSize size,
+                        const InternalBufferState &requested,
+                        bool force = false);
     void request_acceleration_structure(vk::AccelerationStructureKHR handle,
                                         vk::PipelineStageFlags2 stage,
                                         vk::AccessFlags2 access);
@@ -0,0 +1,39 @@
+#pragma once
+#include "VulkanWrapper/3rd_party.h"
+#include "VulkanWrapper/fwd.h"
+#include "VulkanWrapper/Utils/ObjectWithHandle.h"
+
+namespace vw {
+
+/**
+ * Semaphore carrying a monotonically increasing 64-bit value. Queue
+ * submissions signal and wait on given values, and the host can query or
+ * wait for them without a fence. Requires
+ * DeviceFinder::with_timeline_semaphore().
+ */
+class TimelineSemaphore : public ObjectWithUniqueHandle<vk::UniqueSemaphore> {
+  public:
+    TimelineSemaphore(std::shared_ptr<const Device> device,
+                      uint64_t initial_value = 0);
+
+    /** @brief Last value signaled on the device */
+    [[nodiscard]] uint64_t value() const;
+
+    /** @brief Blocks until the semaphore reaches `value` */
+    void wait(uint64_t value) const;
+
+    /** @brief Signals `value` from the host */
+    void signal(uint64_t value) const;
+
+    /**
+     * @brief Describes a wait or a signal of `value` at `stage`, for
+     * Queue::submit2()
+     */
+    [[nodiscard]] vk::SemaphoreSubmitInfo
+    submit_info(uint64_t value, vk::PipelineStageFlags2 stage) const noexcept;
+
+  private:
+    std::shared_ptr<const Device> m_device;
+};
+
+} // namespace vw
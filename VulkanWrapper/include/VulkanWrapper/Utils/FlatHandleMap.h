@@ -0,0 +1,149 @@
+#pragma once
+#include "VulkanWrapper/3rd_party.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace vw {
+
+/**
+ * Open-addressing hash map keyed by Vulkan handles.
+ *
+ * Entries live in a single array probed linearly, so lookups touch one or
+ * two cache lines and inserting allocates only when the table grows. The
+ * null handle marks empty entries and cannot be used as a key. Entries are
+ * never erased individually; pointers to values are invalidated when the
+ * table grows.
+ */
+template <typename Handle, typename Value> class FlatHandleMap {
+  public:
+    FlatHandleMap() = default;
+
+    [[nodiscard]] Value *find(Handle handle) noexcept {
+        if (m_entries.empty()) {
+            return nullptr;
+        }
+        const auto key = raw(handle);
+        for (auto index = slot(key);; index = (index + 1) & mask()) {
+            auto &entry = m_entries[index];
+            if (entry.key == key) {
+                return &entry.value;
+            }
+            if (entry.key == 0) {
+                return nullptr;
+            }
+        }
+    }
+
+    [[nodiscard]] const Value *find(Handle handle) const noexcept {
+        return const_cast<FlatHandleMap *>(this)->find(handle);
+    }
+
+    [[nodiscard]] bool contains(Handle handle) const noexcept {
+        return find(handle) != nullptr;
+    }
+
+    /** @brief Returns the value of `handle`, default-constructed if new */
+    Value &operator[](Handle handle) {
+        if ((m_size + 1) * 4 > m_entries.size() * 3) {
+            grow(std::max<std::size_t>(m_entries.size() * 2, 16));
+        }
+        const auto key = raw(handle);
+        for (auto index = slot(key);; index = (index + 1) & mask()) {
+            auto &entry = m_entries[index];
+            if (entry.key == key) {
+                return entry.value;
+            }
+            if (entry.key == 0) {
+                entry.key = key;
+                ++m_size;
+                return entry.value;
+            }
+        }
+    }
+
+    /** @brief Makes room for `count` handles without growing */
+    void reserve(std::size_t count) {
+        const auto capacity =
+            std::max<std::size_t>(std::bit_ceil(count * 4 / 3 + 1), 16);
+        if (capacity > m_entries.size()) {
+            grow(capacity);
+        }
+    }
+
+    /** @brief Calls `function(handle, value)` for every entry */
+    template <typename Function> void for_each(Function &&function) {
+        for (auto &entry : m_entries) {
+            if (entry.key != 0) {
+                function(from_raw(entry.key), entry.value);
+            }
+        }
+    }
+
+    template <typename Function>
+    void for_each(Function &&function) const {
+        for (const auto &entry : m_entries) {
+            if (entry.key != 0) {
+                function(from_raw(entry.key), entry.value);
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+    void clear() noexcept {
+        m_entries.clear();
+        m_size = 0;
+    }
+
+  private:
+    using CType = typename Handle::CType;
+
+    struct Entry {
+        uint64_t key = 0;
+        Value value{};
+    };
+
+    static uint64_t raw(Handle handle) noexcept {
+        return (uint64_t)(static_cast<CType>(handle));
+    }
+
+    static Handle from_raw(uint64_t key) noexcept {
+        return Handle((CType)key);
+    }
+
+    [[nodiscard]] std::size_t mask() const noexcept {
+        return m_entries.size() - 1;
+    }
+
+    // Fibonacci hashing: handles are often aligned pointers whose low bits
+    // are all zero
+    [[nodiscard]] std::size_t slot(uint64_t key) const noexcept {
+        const auto shift = 64 - std::countr_zero(m_entries.size());
+        return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >>
+                                        shift);
+    }
+
+    void grow(std::size_t capacity) {
+        auto entries = std::exchange(m_entries, std::vector<Entry>(capacity));
+        for (auto &entry : entries) {
+            if (entry.key == 0) {
+                continue;
+            }
+            for (auto index = slot(entry.key);; index = (index + 1) & mask()) {
+                if (m_entries[index].key == 0) {
+                    m_entries[index] = std::move(entry);
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector<Entry> m_entries;
+    std::size_t m_size = 0;
+};
+
+} // namespace vw
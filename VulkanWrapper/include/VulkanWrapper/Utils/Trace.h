@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vw::trace {
+
+/** @brief Zones a thread buffers before collect() drains them */
+inline constexpr std::size_t thread_buffer_capacity = 4'096;
+
+/** @brief Thread of the GPU zones recorded by GpuProfiler */
+inline constexpr uint32_t gpu_thread = 0xFFFF'FFFF;
+
+/**
+ * A timed region of code, in nanoseconds of now(). The name is not
+ * copied: VW_TRACE_ZONE() uses string literals, and dynamic names go
+ * through intern().
+ */
+struct Zone {
+    std::string_view name;
+    uint64_t begin_ns = 0;
+    uint64_t end_ns = 0;
+    uint32_t thread = 0;
+};
+
+/** @brief Nanoseconds of the steady clock, the time base of zones */
+[[nodiscard]] uint64_t now() noexcept;
+
+/** @brief Small index of the calling thread, in order of first use */
+[[nodiscard]] uint32_t thread_index() noexcept;
+
+/**
+ * Appends `zone` to the buffer of the calling thread without locking,
+ * except for the first zone of a thread, which registers its buffer. The
+ * zone is dropped when the buffer is full.
+ */
+void record(const Zone &zone) noexcept;
+
+/** @brief A copy of `name` that lives as long as the program */
+[[nodiscard]] std::string_view intern(std::string_view name);
+
+/**
+ * Drains the zones every thread recorded since the last call, sorted by
+ * start time. Buffers of exited threads are freed once drained.
+ */
+[[nodiscard]] std::vector<Zone> collect();
+
+/** @brief Zones dropped so far because a buffer was full */
+[[nodiscard]] uint64_t dropped_count() noexcept;
+
+/**
+ * Chrome trace event JSON, loadable in chrome://tracing and Perfetto.
+ * Times are relative to the first zone; GPU zones get their own track.
+ */
+[[nodiscard]] std::string to_chrome_json(std::span<const Zone> zones);
+
+/** @brief Records a zone from its construction to its destruction */
+class ScopedZone {
+  public:
+    explicit ScopedZone(std::string_view name) noexcept
+        : m_name{name}
+        , m_begin{now()} {}
+
+    ~ScopedZone() {
+        record({.name = m_name,
+                .begin_ns = m_begin,
+                .end_ns = now(),
+                .thread = thread_index()});
+    }
+
+    ScopedZone(const ScopedZone &) = delete;
+    ScopedZone &operator=(const ScopedZone &) = delete;
+
+  private:
+    std::string_view m_name;
+    uint64_t m_begin;
+};
+
+} // namespace vw::trace
+
+#define VW_TRACE_CONCAT_IMPL(a, b) a##b
+#define VW_TRACE_CONCAT(a, b) VW_TRACE_CONCAT_IMPL(a, b)
+
+/**
+ * Times the rest of the enclosing scope under `name`, a string literal.
+ * Compiles to nothing unless the library is built with VW_ENABLE_TRACING.
+ */
+#ifdef VW_ENABLE_TRACING
+#define VW_TRACE_ZONE(name)                                                    \
+    const ::vw::trace::ScopedZone VW_TRACE_CONCAT(vw_trace_zone_, __LINE__) {  \
+        name                                                                   \
+    }
+#else
+#define VW_TRACE_ZONE(name) static_cast<void>(0)
+#endif
@@ -14,7 +14,27 @@ class Device {
 
   public:
     Queue &graphicsQueue();
+
+    /**
+     * The queue from a transfer-only family if DeviceFinder created one,
+     * otherwise the graphics queue.
+     */
+    Queue &transfer_queue();
+    [[nodiscard]] bool has_dedicated_transfer_queue() const noexcept;
+
+    /**
+     * The queue from a compute family without graphics if DeviceFinder
+     * created one, otherwise the graphics queue.
+     */
+    Queue &compute_queue();
+    [[nodiscard]] bool has_dedicated_compute_queue() const noexcept;
     [[nodiscard]] const PresentQueue &presentQueue() const;
+
+    /**
+     * Whether VK_EXT_memory_budget is enabled. DeviceFinder enables it
+     * whenever the device supports it.
+     */
+    [[nodiscard]] bool has_memory_budget() const noexcept;
     void wait_idle() const;
     [[nodiscard]] vk::PhysicalDevice physical_device() const;
     [[nodiscard]] vk::Device handle() const;
@@ -26,8 +46,9 @@ class Device {
 
   private:
     Device(vk::UniqueDevice device, vk::PhysicalDevice physicalDevice,
-           std::vector<Queue> queues,
-           std::optional<PresentQueue> presentQueue) noexcept;
+           std::vector<Queue> queues, std::optional<Queue> transferQueue,
+           std::optional<Queue> computeQueue,
+           std::optional<PresentQueue> presentQueue, bool memoryBudget);
 
     std::shared_ptr<DeviceImpl> m_impl;
 };
@@ -16,6 +16,31 @@ class DeviceFinder {
     DeviceFinder &with_dynamic_rendering() noexcept;
     DeviceFinder &with_descriptor_indexing() noexcept;
     DeviceFinder &with_scalar_block_layout() noexcept;
+    DeviceFinder &with_timeline_semaphore() noexcept;
+
+    /**
+     * Keeps the devices supporting pipeline-statistics queries, for
+     * GpuProfiler, and enables them.
+     */
+    DeviceFinder &with_pipeline_statistics_query() noexcept;
+
+    /**
+     * Also creates a queue from a transfer-only family when the device has
+     * one, reachable through Device::transfer_queue(). Devices without
+     * such a family are kept, and their transfer queue falls back to the
+     * graphics queue. Enables timeline semaphores, which uploads on the
+     * transfer queue are synchronized with.
+     */
+    DeviceFinder &with_transfer_queue() noexcept;
+
+    /**
+     * Also creates a queue from a compute family without graphics when the
+     * device has one, reachable through Device::compute_queue(), for
+     * RenderPipeline::use_async_compute(). Devices without such a family
+     * are kept, and their compute queue falls back to the graphics queue.
+     * Enables timeline semaphores, which the queues are joined with.
+     */
+    DeviceFinder &with_compute_queue() noexcept;
 
     std::shared_ptr<Device> build();
     std::optional<PhysicalDevice> get() noexcept;
@@ -37,7 +62,15 @@ class DeviceFinder {
         std::optional<int> presentationFamilyIndex;
         std::vector<const char *> extensions;
     };
+
+    static std::optional<int>
+    find_transfer_family(const PhysicalDeviceInformation &information);
+    static std::optional<int>
+    find_compute_family(const PhysicalDeviceInformation &information);
+
     std::vector<PhysicalDeviceInformation> m_physicalDevicesInformation;
+    bool m_transfer_queue = false;
+    bool m_compute_queue = false;
 
     vk::StructureChain<vk::PhysicalDeviceFeatures2,
                        vk::PhysicalDeviceSynchronization2Features,
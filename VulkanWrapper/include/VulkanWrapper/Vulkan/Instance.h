@@ -16,6 +16,7 @@ class Instance {
     Instance &operator=(const Instance &) = delete;
 
     [[nodiscard]] vk::Instance handle() const noexcept;
+    [[nodiscard]] ApiVersion api_version() const noexcept;
 
     [[nodiscard]] DeviceFinder findGpu() const noexcept;
 
@@ -6,6 +6,42 @@
 
 namespace vw {
 
+/**
+ * Completion of a submission: the value the timeline semaphore of its
+ * queue reaches once it executed. Cheap to copy; a default-constructed
+ * ticket is always complete.
+ */
+struct SubmitTicket {
+    const Queue *queue = nullptr;
+    uint64_t value = 0;
+
+    /** @brief Blocks until the submission completed */
+    void wait() const;
+    [[nodiscard]] bool is_complete() const;
+
+    /**
+     * Wait on the submission, for another submission: its work at
+     * `stage` and later waits for this one.
+     */
+    [[nodiscard]] vk::SemaphoreSubmitInfo
+    wait_info(vk::PipelineStageFlags2 stage) const noexcept;
+};
+
+/**
+ * One submission of a batched Queue::submit().
+ */
+struct SubmitBatch {
+    std::span<const vk::CommandBuffer> command_buffers;
+    std::span<const vk::SemaphoreSubmitInfo> waits;
+    std::span<const vk::SemaphoreSubmitInfo> signals;
+};
+
+/**
+ * Submissions use vkQueueSubmit2 and signal the timeline semaphore owned by
+ * the queue, so that they are waited on through a SubmitTicket instead of
+ * a fence. Requires DeviceFinder::with_synchronization_2(). Not
+ * thread-safe.
+ */
 class Queue {
     friend class DeviceFinder;
     friend class Device;
@@ -15,18 +51,73 @@ class Queue {
     void
     enqueue_command_buffers(std::span<const vk::CommandBuffer> command_buffers);
 
+    /**
+     * Submits `batches` in order with a single vkQueueSubmit2. The ticket
+     * completes once all of them executed.
+     */
+    SubmitTicket submit(std::span<const SubmitBatch> batches);
+
+    /** @brief Submits the enqueued command buffers as one batch */
+    SubmitTicket
+    submit_enqueued(std::span<const vk::SemaphoreSubmitInfo> waits = {},
+                    std::span<const vk::SemaphoreSubmitInfo> signals = {});
+
+    /**
+     * Legacy submission of the enqueued command buffers with binary
+     * semaphores. The returned fence blocks on destruction until the
+     * submission completed: prefer submit_enqueued().
+     */
     Fence submit(std::span<const vk::PipelineStageFlags> waitStage,
                  std::span<const vk::Semaphore> waitSemaphores,
                  std::span<const vk::Semaphore> signalSemaphores);
 
+    /**
+     * Legacy submission of the enqueued command buffers, signaling a fence
+     * as well: prefer submit_enqueued().
+     */
+    Fence submit2(std::span<const vk::SemaphoreSubmitInfo> waits,
+                  std::span<const vk::SemaphoreSubmitInfo> signals);
+
+    /** @brief Ticket of the last submission */
+    [[nodiscard]] SubmitTicket last_submission() const noexcept {
+        return {this, m_submitted_value};
+    }
+
+    /** @brief Value of the last submission that completed */
+    [[nodiscard]] uint64_t completed_value() const;
+
+    /** @brief Blocks until the submission of `value` completed */
+    void wait(uint64_t value) const;
+
+    [[nodiscard]] vk::Semaphore timeline() const noexcept {
+        return *m_timeline;
+    }
+
+    [[nodiscard]] uint32_t family_index() const noexcept {
+        return m_family_index;
+    }
+    [[nodiscard]] vk::QueueFlags flags() const noexcept {
+        return m_queueFlags;
+    }
+
   private:
-    Queue(vk::Queue queue, vk::QueueFlags type) noexcept;
+    Queue(vk::Queue queue, vk::QueueFlags type, uint32_t family_index) noexcept;
+
+    // Called by Device once created: creates the timeline semaphore
+    void set_device(vk::Device device);
+
+    SubmitTicket submit_batches(std::span<const SubmitBatch> batches,
+                                vk::Fence fence);
 
     std::vector<vk::CommandBuffer> m_command_buffers;
 
     vk::Device m_device;
     vk::Queue m_queue;
     vk::QueueFlags m_queueFlags;
+    uint32_t m_family_index;
+
+    vk::UniqueSemaphore m_timeline;
+    uint64_t m_submitted_value = 0;
 };
 
 } // namespace vw
@@ -32,6 +32,11 @@ class RayTracingPipeline;
 
 class Semaphore;
 class Fence;
+class TimelineSemaphore;
+class EventPool;
+class FrameContext;
+class ParallelCommandRecorder;
+class GpuProfiler;
 
 class Allocator;
 class BufferBase;
@@ -9,11 +9,12 @@ CommandPool::CommandPool(std::shared_ptr<const Device> device,
     : ObjectWithUniqueHandle<vk::UniqueCommandPool>(std::move(pool))
     , m_device(std::move(device)) {}
 
-std::vector<vk::CommandBuffer> CommandPool::allocate(std::size_t number) {
+std::vector<vk::CommandBuffer>
+CommandPool::allocate(std::size_t number, vk::CommandBufferLevel level) {
     const auto info = vk::CommandBufferAllocateInfo()
                           .setCommandPool(handle())
                           .setCommandBufferCount(number)
-                          .setLevel(vk::CommandBufferLevel::ePrimary);
+                          .setLevel(level);
 
     auto commandBuffers =
         check_vk(m_device->handle().allocateCommandBuffers(info),
@@ -22,6 +23,11 @@ std::vector<vk::CommandBuffer> CommandPool::allocate(std::size_t number) {
     return commandBuffers;
 }
 
+void CommandPool::reset() {
+    check_vk(m_device->handle().resetCommandPool(handle()),
+             "Failed to reset command pool");
+}
+
 CommandPoolBuilder::CommandPoolBuilder(std::shared_ptr<const Device> device)
     : m_device{std::move(device)} {}
 
@@ -30,9 +36,16 @@ CommandPoolBuilder &CommandPoolBuilder::with_reset_command_buffer() {
     return *this;
 }
 
+CommandPoolBuilder &
+CommandPoolBuilder::with_queue_family(uint32_t family_index) {
+    m_queue_family_index = family_index;
+    return *this;
+}
+
 CommandPool CommandPoolBuilder::build() {
-    auto info =
-        vk::CommandPoolCreateInfo().setQueueFamilyIndex(0).setFlags(m_flags);
+    auto info = vk::CommandPoolCreateInfo()
+                    .setQueueFamilyIndex(m_queue_family_index)
+                    .setFlags(m_flags);
 
     auto pool = check_vk(m_device->handle().createCommandPoolUnique(info),
                          "Failed to create command pool");
@@ -0,0 +1,287 @@
+#include "VulkanWrapper/Command/GpuProfiler.h"
+
+#include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Utils/Trace.h"
+#include "VulkanWrapper/Vulkan/Device.h"
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <span>
+
+namespace vw {
+
+namespace {
+
+constexpr auto statistics_flags =
+    vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices |
+    vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+    vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+    vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations |
+    vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+
+// Number of counters in `statistics_flags`
+constexpr uint32_t statistics_count = 5;
+
+} // namespace
+
+GpuProfiler::GpuProfiler(std::shared_ptr<const Device> device,
+                         uint32_t frames_in_flight, uint32_t max_scopes,
+                         bool pipeline_statistics, uint32_t queue_family)
+    : m_device{std::move(device)}
+    , m_max_scopes{max_scopes}
+    , m_pipeline_statistics{pipeline_statistics} {
+    if (frames_in_flight == 0 || max_scopes == 0) {
+        throw LogicException::invalid_state(
+            "GPU profiling needs a frame in flight and a scope");
+    }
+
+    const auto physical_device = m_device->physical_device();
+    const auto families = physical_device.getQueueFamilyProperties();
+    const auto valid_bits = queue_family < families.size()
+                                ? families[queue_family].timestampValidBits
+                                : 0;
+    if (valid_bits == 0) {
+        throw LogicException::invalid_state(
+            "The queue family does not support timestamps");
+    }
+    m_timestamp_mask =
+        valid_bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << valid_bits) - 1;
+    m_timestamp_period =
+        physical_device.getProperties().limits.timestampPeriod;
+
+    m_slots.resize(frames_in_flight);
+    for (auto &slot : m_slots) {
+        slot.timestamps = check_vk(
+            m_device->handle().createQueryPoolUnique(
+                vk::QueryPoolCreateInfo()
+                    .setQueryType(vk::QueryType::eTimestamp)
+                    .setQueryCount(2 * max_scopes + 1)),
+            "Failed to create timestamp query pool");
+        if (m_pipeline_statistics) {
+            slot.statistics = check_vk(
+                m_device->handle().createQueryPoolUnique(
+                    vk::QueryPoolCreateInfo()
+                        .setQueryType(vk::QueryType::ePipelineStatistics)
+                        .setQueryCount(max_scopes)
+                        .setPipelineStatistics(statistics_flags)),
+                "Failed to create pipeline statistics query pool");
+        }
+    }
+}
+
+void GpuProfiler::begin_frame(vk::CommandBuffer cmd) {
+    if (m_scope_open) {
+        throw LogicException::invalid_state(
+            "A GPU profiler scope is still open");
+    }
+
+    m_frame_slot = (m_frame_slot + 1) % m_slots.size();
+    auto &slot = m_slots[m_frame_slot];
+    if (slot.scope_count != 0) {
+        read_back(slot);
+        slot.scope_count = 0;
+    }
+
+    cmd.resetQueryPool(*slot.timestamps, 0, 2 * m_max_scopes + 1);
+    if (m_pipeline_statistics) {
+        cmd.resetQueryPool(*slot.statistics, 0, m_max_scopes);
+    }
+#ifdef VW_ENABLE_TRACING
+    // The last query anchors the frame on the CPU timeline
+    slot.cpu_begin_ns = trace::now();
+    cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eTopOfPipe,
+                        *slot.timestamps, 2 * m_max_scopes);
+#endif
+    m_frame_begun = true;
+}
+
+void GpuProfiler::begin_scope(vk::CommandBuffer cmd, std::string_view name) {
+    auto &slot = m_slots[m_frame_slot];
+    if (!m_frame_begun) {
+        throw LogicException::invalid_state(
+            "GpuProfiler::begin_frame() must be called before a scope");
+    }
+    if (m_scope_open) {
+        throw LogicException::invalid_state("GPU profiler scopes do not nest");
+    }
+    if (slot.scope_count == m_max_scopes) {
+        throw LogicException::invalid_state(
+            "Too many GPU profiler scopes in a frame");
+    }
+
+    const auto index = slot.scope_count;
+    if (index == slot.names.size()) {
+        slot.names.emplace_back(name);
+    } else {
+        slot.names[index].assign(name);
+    }
+
+    cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eTopOfPipe,
+                        *slot.timestamps, 2 * index);
+    if (m_pipeline_statistics) {
+        cmd.beginQuery(*slot.statistics, index, {});
+    }
+    m_scope_open = true;
+}
+
+void GpuProfiler::end_scope(vk::CommandBuffer cmd) {
+    if (!m_scope_open) {
+        throw LogicException::invalid_state("No GPU profiler scope is open");
+    }
+
+    auto &slot = m_slots[m_frame_slot];
+    const auto index = slot.scope_count++;
+    if (m_pipeline_statistics) {
+        cmd.endQuery(*slot.statistics, index);
+    }
+    cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eBottomOfPipe,
+                        *slot.timestamps, 2 * index + 1);
+    m_scope_open = false;
+}
+
+void GpuProfiler::read_back(FrameSlot &slot) {
+    const auto count = slot.scope_count;
+    const auto statistics_offset = 2 * count;
+    m_results.resize(statistics_offset + statistics_count * count);
+
+    // Without eWait, a frame that is not complete yet is dropped
+    const auto result = m_device->handle().getQueryPoolResults(
+        *slot.timestamps, 0, 2 * count, 2 * count * sizeof(uint64_t),
+        m_results.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+    if (result == vk::Result::eNotReady) {
+        return;
+    }
+    check_vk(result, "Failed to read timestamps");
+
+    if (m_pipeline_statistics) {
+        const auto statistics_result = m_device->handle().getQueryPoolResults(
+            *slot.statistics, 0, count,
+            statistics_count * count * sizeof(uint64_t),
+            m_results.data() + statistics_offset,
+            statistics_count * sizeof(uint64_t),
+            vk::QueryResultFlagBits::e64);
+        if (statistics_result == vk::Result::eNotReady) {
+            return;
+        }
+        check_vk(statistics_result, "Failed to read pipeline statistics");
+    }
+
+#ifdef VW_ENABLE_TRACING
+    trace_scopes(slot);
+#endif
+
+    for (uint32_t i = 0; i < count; ++i) {
+        auto &scope = history(slot.names[i]);
+        const auto ticks =
+            (m_results[2 * i + 1] - m_results[2 * i]) & m_timestamp_mask;
+        scope.samples[scope.next] =
+            double(ticks) * m_timestamp_period / 1'000'000.0;
+        scope.next = (scope.next + 1) % window_size;
+        scope.count = std::min(scope.count + 1, window_size);
+
+        if (m_pipeline_statistics) {
+            const auto *counters =
+                m_results.data() + statistics_offset + statistics_count * i;
+            scope.statistics = {.input_assembly_vertices = counters[0],
+                                .vertex_shader_invocations = counters[1],
+                                .clipping_primitives = counters[2],
+                                .fragment_shader_invocations = counters[3],
+                                .compute_shader_invocations = counters[4]};
+        }
+    }
+}
+
+void GpuProfiler::trace_scopes(const FrameSlot &slot) {
+    uint64_t anchor = 0;
+    const auto result = m_device->handle().getQueryPoolResults(
+        *slot.timestamps, 2 * m_max_scopes, 1, sizeof(anchor), &anchor,
+        sizeof(anchor), vk::QueryResultFlagBits::e64);
+    if (result != vk::Result::eSuccess) {
+        return;
+    }
+
+    const auto to_cpu = [&](uint64_t timestamp) {
+        const auto ticks = (timestamp - anchor) & m_timestamp_mask;
+        return slot.cpu_begin_ns + uint64_t(double(ticks) * m_timestamp_period);
+    };
+    for (uint32_t i = 0; i < slot.scope_count; ++i) {
+        trace::record({.name = trace::intern(slot.names[i]),
+                       .begin_ns = to_cpu(m_results[2 * i]),
+                       .end_ns = to_cpu(m_results[2 * i + 1]),
+                       .thread = trace::gpu_thread});
+    }
+}
+
+GpuProfiler::History &GpuProfiler::history(std::string_view name) {
+    auto it = std::ranges::find(m_history, name, &History::name);
+    if (it != m_history.end()) {
+        return *it;
+    }
+    return m_history.emplace_back(History{.name = std::string(name)});
+}
+
+std::vector<ScopeTiming> GpuProfiler::timings() const {
+    std::vector<ScopeTiming> timings;
+    timings.reserve(m_history.size());
+    for (const auto &scope : m_history) {
+        const auto samples = std::span(scope.samples).first(scope.count);
+        double total = 0.0;
+        for (auto sample : samples) {
+            total += sample;
+        }
+        timings.push_back({.name = scope.name,
+                           .sample_count = scope.count,
+                           .min_ms = std::ranges::min(samples),
+                           .avg_ms = total / double(scope.count),
+                           .max_ms = std::ranges::max(samples),
+                           .statistics = scope.statistics});
+    }
+    return timings;
+}
+
+std::string GpuProfiler::to_csv() const {
+    std::string csv =
+        "name,samples,min_ms,avg_ms,max_ms,input_assembly_vertices,"
+        "vertex_shader_invocations,clipping_primitives,"
+        "fragment_shader_invocations,compute_shader_invocations\n";
+    auto out = std::back_inserter(csv);
+    for (const auto &timing : timings()) {
+        const auto &statistics = timing.statistics;
+        std::format_to(out, "{},{},{},{},{},{},{},{},{},{}\n", timing.name,
+                       timing.sample_count, timing.min_ms, timing.avg_ms,
+                       timing.max_ms, statistics.input_assembly_vertices,
+                       statistics.vertex_shader_invocations,
+                       statistics.clipping_primitives,
+                       statistics.fragment_shader_invocations,
+                       statistics.compute_shader_invocations);
+    }
+    return csv;
+}
+
+std::string GpuProfiler::to_json() const {
+    std::string json = R"({"scopes":[)";
+    auto out = std::back_inserter(json);
+    const auto scopes = timings();
+    for (std::size_t i = 0; i < scopes.size(); ++i) {
+        const auto &timing = scopes[i];
+        const auto &statistics = timing.statistics;
+        std::format_to(
+            out,
+            R"({}{{"name":"{}","samples":{},"min_ms":{},"avg_ms":{},)"
+            R"("max_ms":{},"statistics":{{"input_assembly_vertices":{},)"
+            R"("vertex_shader_invocations":{},"clipping_primitives":{},)"
+            R"("fragment_shader_invocations":{},)"
+            R"("compute_shader_invocations":{}}}}})",
+            i == 0 ? "" : ",", timing.name, timing.sample_count,
+            timing.min_ms, timing.avg_ms, timing.max_ms,
+            statistics.input_assembly_vertices,
+            statistics.vertex_shader_invocations,
+            statistics.clipping_primitives,
+            statistics.fragment_shader_invocations,
+            statistics.compute_shader_invocations);
+    }
+    json += "]}";
+    return json;
+}
+
+} // namespace vw
@@ -0,0 +1,154 @@
+#include "VulkanWrapper/Command/ParallelCommandRecorder.h"
+
+#include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Utils/Trace.h"
+#include "VulkanWrapper/Vulkan/Device.h"
+#include <algorithm>
+
+namespace vw {
+
+ParallelCommandRecorder::ParallelCommandRecorder(
+    std::shared_ptr<const Device> device, uint32_t thread_count,
+    uint32_t frames_in_flight, uint32_t queue_family)
+    : m_device{std::move(device)} {
+    if (thread_count == 0 || frames_in_flight == 0) {
+        throw LogicException::invalid_state(
+            "Parallel recording needs a thread and a frame in flight");
+    }
+
+    m_recorders.resize(thread_count);
+    for (auto &recorder : m_recorders) {
+        for (uint32_t i = 0; i < frames_in_flight; ++i) {
+            recorder.slots.push_back(
+                {.pool = CommandPoolBuilder(m_device)
+                             .with_queue_family(queue_family)
+                             .build()});
+        }
+    }
+
+    // The calling thread records the first chunk
+    for (std::size_t i = 1; i < thread_count; ++i) {
+        m_workers.emplace_back(
+            [this, i](std::stop_token stop) { work(i, std::move(stop)); });
+    }
+}
+
+ParallelCommandRecorder::~ParallelCommandRecorder() = default;
+
+std::vector<vk::CommandBuffer> ParallelCommandRecorder::record(
+    const vk::CommandBufferInheritanceRenderingInfo &rendering,
+    std::size_t count, const RecordFunction &record) {
+    std::vector<vk::CommandBuffer> recorded(m_recorders.size());
+    const Job job{.rendering = &rendering,
+                  .record = &record,
+                  .count = count,
+                  .recorded = &recorded};
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_job = &job;
+        m_running = m_workers.size();
+        m_error = nullptr;
+        ++m_generation;
+    }
+    m_job_ready.notify_all();
+
+    std::exception_ptr error;
+    try {
+        record_chunk(0, job);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    {
+        std::unique_lock lock(m_mutex);
+        m_job_done.wait(lock, [this] { return m_running == 0; });
+        m_job = nullptr;
+        if (!error) {
+            error = m_error;
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    std::erase(recorded, vk::CommandBuffer{});
+    return recorded;
+}
+
+void ParallelCommandRecorder::begin_frame() {
+    m_frame_slot = (m_frame_slot + 1) % m_recorders.front().slots.size();
+    for (auto &recorder : m_recorders) {
+        auto &slot = recorder.slots[m_frame_slot];
+        if (slot.used != 0) {
+            slot.pool.reset();
+            slot.used = 0;
+        }
+    }
+}
+
+void ParallelCommandRecorder::record_chunk(std::size_t thread_index,
+                                           const Job &job) {
+    VW_TRACE_ZONE("ParallelCommandRecorder::record_chunk");
+    const auto threads = m_recorders.size();
+    const auto first = job.count * thread_index / threads;
+    const auto last = job.count * (thread_index + 1) / threads;
+    if (first == last) {
+        return;
+    }
+
+    auto &slot = m_recorders[thread_index].slots[m_frame_slot];
+    if (slot.used == slot.command_buffers.size()) {
+        slot.command_buffers.push_back(
+            slot.pool.allocate(1, vk::CommandBufferLevel::eSecondary)[0]);
+    }
+    const auto cmd_buffer = slot.command_buffers[slot.used++];
+
+    const auto inheritance =
+        vk::CommandBufferInheritanceInfo().setPNext(job.rendering);
+    std::ignore = cmd_buffer.begin(
+        vk::CommandBufferBeginInfo()
+            .setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit |
+                      vk::CommandBufferUsageFlagBits::eRenderPassContinue)
+            .setPInheritanceInfo(&inheritance));
+    (*job.record)(cmd_buffer, first, last);
+    std::ignore = cmd_buffer.end();
+
+    (*job.recorded)[thread_index] = cmd_buffer;
+}
+
+void ParallelCommandRecorder::work(std::size_t thread_index,
+                                   std::stop_token stop) {
+    uint64_t generation = 0;
+    while (true) {
+        const Job *job = nullptr;
+        {
+            std::unique_lock lock(m_mutex);
+            if (!m_job_ready.wait(lock, stop, [&] {
+                    return m_generation != generation;
+                })) {
+                return;
+            }
+            generation = m_generation;
+            job = m_job;
+        }
+
+        std::exception_ptr error;
+        try {
+            record_chunk(thread_index, *job);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            if (error && !m_error) {
+                m_error = error;
+            }
+            --m_running;
+        }
+        m_job_done.notify_one();
+    }
+}
+
+} // namespace vw
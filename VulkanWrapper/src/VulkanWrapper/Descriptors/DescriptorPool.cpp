@@ -2,6 +2,7 @@
 
 #include "VulkanWrapper/Descriptors/DescriptorSetLayout.h"
 #include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Utils/Trace.h"
 #include "VulkanWrapper/Vulkan/Device.h"
 
 namespace vw {
@@ -42,6 +43,7 @@ DescriptorPool::layout() const noexcept {
 
 DescriptorSet DescriptorPool::allocate_set(
     const DescriptorAllocator &descriptorAllocator) noexcept {
+    VW_TRACE_ZONE("DescriptorPool::allocate_set");
     auto it = m_sets.find(descriptorAllocator);
     if (it != m_sets.end()) {
         return it->second;
@@ -96,6 +98,7 @@ vk::DescriptorSet DescriptorPool::allocate_descriptor_set_from_last_pool() {
 }
 
 DescriptorSet DescriptorPool::allocate_set() {
+    VW_TRACE_ZONE("DescriptorPool::allocate_set");
     auto set = allocate_descriptor_set_from_last_pool();
     return DescriptorSet(set, {});
 }
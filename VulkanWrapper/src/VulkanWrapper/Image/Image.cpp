@@ -37,7 +37,7 @@ Image::Image(vk::Image image, Width width, Height height, Depth depth,
 
 Image::~Image() {
     if (m_allocator) {
-        vmaDestroyImage(m_allocator->handle(), handle(), m_allocation);
+        m_allocator->destroy_image(handle(), m_allocation);
     }
 }
 
@@ -45,6 +45,8 @@ MipLevel Image::mip_levels() const noexcept { return m_mip_levels; }
 
 vk::Format Image::format() const noexcept { return m_format; }
 
+vk::ImageUsageFlags Image::usage() const noexcept { return m_usage; }
+
 vk::ImageSubresourceRange
 Image::mip_level_range(MipLevel mip_level) const noexcept {
     return vk::ImageSubresourceRange()
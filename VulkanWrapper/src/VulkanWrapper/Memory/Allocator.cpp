@@ -3,6 +3,7 @@
 #include "VulkanWrapper/Image/Image.h"
 #include "VulkanWrapper/Memory/Buffer.h"
 #include "VulkanWrapper/Utils/Alignment.h"
+#include "VulkanWrapper/Utils/Error.h"
 #include "VulkanWrapper/Vulkan/Device.h"
 #include "VulkanWrapper/Vulkan/Instance.h"
 #include <exception>
@@ -14,11 +15,23 @@ MipLevel mip_level_from_size(Width width, Height height, Depth depth) {
     auto size = std::max({uint32_t(width), uint32_t(height), uint32_t(depth)});
     return static_cast<MipLevel>(uint32_t(std::log2(size)) + 1);
 }
+
+// The category travels in the VMA user data of the allocation
+void *category_user_data(AllocationCategory category) {
+    return reinterpret_cast<void *>(static_cast<std::uintptr_t>(category));
+}
+
+AllocationCategory category_from_user_data(void *user_data) {
+    return static_cast<AllocationCategory>(
+        reinterpret_cast<std::uintptr_t>(user_data));
+}
 } // namespace
 
-Allocator::Impl::Impl(std::shared_ptr<const Device> dev, VmaAllocator alloc)
+Allocator::Impl::Impl(std::shared_ptr<const Device> dev, VmaAllocator alloc,
+                      bool synchronized)
     : device{std::move(dev)}
-    , allocator{alloc} {}
+    , allocator{alloc}
+    , internally_synchronized{synchronized} {}
 
 Allocator::Impl::~Impl() {
     if (allocator != VK_NULL_HANDLE) {
@@ -27,20 +40,129 @@ Allocator::Impl::~Impl() {
 }
 
 Allocator::Allocator(std::shared_ptr<const Device> device,
-                     VmaAllocator allocator)
-    : m_impl{std::make_shared<Impl>(std::move(device), allocator)} {}
+                     VmaAllocator allocator, bool internally_synchronized)
+    : m_impl{std::make_shared<Impl>(std::move(device), allocator,
+                                    internally_synchronized)} {}
 
 VmaAllocator Allocator::handle() const noexcept { return m_impl->allocator; }
 
+bool Allocator::is_internally_synchronized() const noexcept {
+    return m_impl->internally_synchronized;
+}
+
 IndexBuffer Allocator::allocate_index_buffer(VkDeviceSize size) const {
     return Buffer<unsigned, false, IndexBufferUsage>{allocate_buffer(
         size * sizeof(unsigned), false, vk::BufferUsageFlags(IndexBufferUsage),
         vk::SharingMode::eExclusive)};
 }
 
-std::shared_ptr<const Image>
-Allocator::create_image_2D(Width width, Height height, bool mipmap,
-                           vk::Format format, vk::ImageUsageFlags usage) const {
+void Allocator::track(VmaAllocation allocation) const noexcept {
+    VmaAllocationInfo info{};
+    vmaGetAllocationInfo(m_impl->allocator, allocation, &info);
+    auto &counters = m_impl->counters[static_cast<std::size_t>(
+        category_from_user_data(info.pUserData))];
+
+    ++counters.allocation_count;
+    const auto bytes = counters.bytes += info.size;
+    auto peak = counters.peak_bytes.load(std::memory_order_relaxed);
+    while (peak < bytes &&
+           !counters.peak_bytes.compare_exchange_weak(peak, bytes)) {
+    }
+}
+
+void Allocator::untrack(VmaAllocation allocation) const noexcept {
+    if (allocation == VK_NULL_HANDLE) {
+        return;
+    }
+    VmaAllocationInfo info{};
+    vmaGetAllocationInfo(m_impl->allocator, allocation, &info);
+    auto &counters = m_impl->counters[static_cast<std::size_t>(
+        category_from_user_data(info.pUserData))];
+
+    --counters.allocation_count;
+    counters.bytes -= info.size;
+}
+
+VmaAllocation
+Allocator::allocate_memory(const vk::MemoryRequirements &requirements,
+                           AllocationCategory category) const {
+    VmaAllocationCreateInfo allocation_info{};
+    allocation_info.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    allocation_info.pUserData = category_user_data(category);
+
+    const VkMemoryRequirements vk_requirements = requirements;
+    VmaAllocation allocation = nullptr;
+    check_vma(vmaAllocateMemory(m_impl->allocator, &vk_requirements,
+                                &allocation_info, &allocation, nullptr),
+              "Failed to allocate memory");
+    track(allocation);
+    return allocation;
+}
+
+void Allocator::free_memory(VmaAllocation allocation) const noexcept {
+    untrack(allocation);
+    vmaFreeMemory(m_impl->allocator, allocation);
+}
+
+void Allocator::destroy_buffer(vk::Buffer buffer,
+                               VmaAllocation allocation) const noexcept {
+    untrack(allocation);
+    vmaDestroyBuffer(m_impl->allocator, buffer, allocation);
+}
+
+void Allocator::destroy_image(vk::Image image,
+                              VmaAllocation allocation) const noexcept {
+    untrack(allocation);
+    vmaDestroyImage(m_impl->allocator, image, allocation);
+}
+
+std::vector<HeapBudget> Allocator::heap_budgets() const {
+    const VkPhysicalDeviceMemoryProperties *properties = nullptr;
+    vmaGetMemoryProperties(m_impl->allocator, &properties);
+
+    std::vector<VmaBudget> budgets(properties->memoryHeapCount);
+    vmaGetHeapBudgets(m_impl->allocator, budgets.data());
+
+    std::vector<HeapBudget> heaps;
+    heaps.reserve(budgets.size());
+    for (uint32_t i = 0; i < budgets.size(); ++i) {
+        const auto &budget = budgets[i];
+        const auto &heap = properties->memoryHeaps[i];
+        heaps.push_back(
+            HeapBudget{.heap_index = i,
+                       .flags = vk::MemoryHeapFlags(heap.flags),
+                       .size = heap.size,
+                       .budget = budget.budget,
+                       .usage = budget.usage,
+                       .block_bytes = budget.statistics.blockBytes,
+                       .allocation_bytes = budget.statistics.allocationBytes,
+                       .block_count = budget.statistics.blockCount,
+                       .allocation_count = budget.statistics.allocationCount});
+    }
+    return heaps;
+}
+
+CategoryUsage
+Allocator::category_usage(AllocationCategory category) const noexcept {
+    const auto &counters =
+        m_impl->counters[static_cast<std::size_t>(category)];
+    return CategoryUsage{.allocation_count = counters.allocation_count.load(),
+                         .bytes = counters.bytes.load(),
+                         .peak_bytes = counters.peak_bytes.load()};
+}
+
+MemoryReport Allocator::memory_report() const {
+    MemoryReport report{.heaps = heap_budgets(), .categories = {}};
+    for (std::size_t i = 0; i < allocation_category_count; ++i) {
+        report.categories[i] = category_usage(AllocationCategory(i));
+    }
+    return report;
+}
+
+std::shared_ptr<const Image> Allocator::create_image_2D(
+    Width width, Height height, bool mipmap, vk::Format format,
+    vk::ImageUsageFlags usage,
+    std::optional<AllocationCategory> category) const {
     const auto mip_levels = [&] {
         if (mipmap)
             return mip_level_from_size(width, height, Depth(1));
@@ -61,24 +183,35 @@ Allocator::create_image_2D(Width width, Height height, bool mipmap,
 
     VmaAllocationCreateInfo allocation_info{};
     allocation_info.usage = VMA_MEMORY_USAGE_AUTO;
+    allocation_info.pUserData = category_user_data(
+        category.value_or(infer_allocation_category(usage)));
     VmaAllocation allocation = nullptr;
     VkImage image = nullptr;
-    vmaCreateImage(m_impl->allocator, &create_info, &allocation_info, &image,
-                   &allocation, nullptr);
+    check_vma(vmaCreateImage(m_impl->allocator, &create_info,
+                             &allocation_info, &image, &allocation, nullptr),
+              "Failed to create image");
+    track(allocation);
     return std::make_shared<const Image>(vk::Image(image), width, height,
                                          Depth(1), mip_levels, format, usage,
                                          shared_from_this(), allocation);
 }
 
-BufferBase Allocator::allocate_buffer(VkDeviceSize size, bool host_visible,
-                                      vk::BufferUsageFlags usage,
-                                      vk::SharingMode sharing_mode) const {
+BufferBase
+Allocator::allocate_buffer(VkDeviceSize size, bool host_visible,
+                           vk::BufferUsageFlags usage,
+                           vk::SharingMode sharing_mode,
+                           std::optional<AllocationCategory> category) const {
     VmaAllocationCreateInfo allocation_info{};
     if (host_visible) {
+        // Host-visible buffers stay mapped for their whole lifetime so that
+        // per-frame writes do not pay for a map/unmap pair.
         allocation_info.flags =
-            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+            VMA_ALLOCATION_CREATE_MAPPED_BIT;
     }
     allocation_info.usage = VMA_MEMORY_USAGE_AUTO;
+    allocation_info.pUserData = category_user_data(
+        category.value_or(infer_allocation_category(usage, host_visible)));
 
     VkBufferCreateInfo buffer_info =
         vk::BufferCreateInfo().setUsage(usage).setSize(size).setSharingMode(
@@ -86,12 +219,16 @@ BufferBase Allocator::allocate_buffer(VkDeviceSize size, bool host_visible,
 
     VmaAllocation allocation = nullptr;
     VkBuffer buffer = nullptr;
-    vmaCreateBufferWithAlignment(m_impl->allocator, &buffer_info,
-                                 &allocation_info, DefaultBufferAlignment,
-                                 &buffer, &allocation, nullptr);
+    VmaAllocationInfo allocation_result{};
+    check_vma(vmaCreateBufferWithAlignment(
+                  m_impl->allocator, &buffer_info, &allocation_info,
+                  DefaultBufferAlignment, &buffer, &allocation,
+                  &allocation_result),
+              "Failed to create buffer");
+    track(allocation);
 
     return BufferBase{m_impl->device, shared_from_this(), buffer, allocation,
-                      size};
+                      size, allocation_result.pMappedData};
 }
 
 AllocatorBuilder::AllocatorBuilder(std::shared_ptr<const Instance> instance,
@@ -99,20 +236,35 @@ AllocatorBuilder::AllocatorBuilder(std::shared_ptr<const Instance> instance,
     : m_instance{std::move(instance)}
     , m_device{std::move(device)} {}
 
+AllocatorBuilder &AllocatorBuilder::with_internal_synchronization() noexcept {
+    m_internally_synchronized = true;
+    return *this;
+}
+
 std::shared_ptr<Allocator> AllocatorBuilder::build() {
     VmaAllocatorCreateInfo info{};
-    info.flags = VMA_ALLOCATOR_CREATE_EXTERNALLY_SYNCHRONIZED_BIT |
-                 VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+    info.flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+    if (!m_internally_synchronized) {
+        info.flags |= VMA_ALLOCATOR_CREATE_EXTERNALLY_SYNCHRONIZED_BIT;
+    }
+    // VMA queries the budget through vkGetPhysicalDeviceMemoryProperties2,
+    // core since Vulkan 1.1
+    if (m_device->has_memory_budget() &&
+        m_instance->api_version() >= ApiVersion::e11) {
+        info.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
     info.device = m_device->handle();
     info.instance = m_instance->handle();
     info.physicalDevice = m_device->physical_device();
+    info.vulkanApiVersion = m_instance->api_version();
 
     VmaAllocator allocator = nullptr;
     if (vk::Result(vmaCreateAllocator(&info, &allocator)) !=
         vk::Result::eSuccess)
         std::terminate();
 
-    return std::shared_ptr<Allocator>(new Allocator(m_device, allocator));
+    return std::shared_ptr<Allocator>(
+        new Allocator(m_device, allocator, m_internally_synchronized));
 }
 
 } // namespace vw
@@ -0,0 +1,264 @@
+#include "VulkanWrapper/Memory/AsyncUploader.h"
+
+#include "VulkanWrapper/Image/Image.h"
+#include "VulkanWrapper/Memory/Barrier.h"
+#include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Vulkan/Device.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
+#include <cstring>
+
+namespace vw {
+
+constexpr vk::DeviceSize BUFFER_COPY_ALIGNMENT = 4;
+constexpr vk::DeviceSize IMAGE_COPY_ALIGNMENT = 16;
+constexpr vk::DeviceSize RGBA8_TEXEL_SIZE = 4;
+
+static Queue &transfer_queue(const Device &device) {
+    return const_cast<Device &>(device).transfer_queue();
+}
+
+static Queue &graphics_queue(const Device &device) {
+    return const_cast<Device &>(device).graphicsQueue();
+}
+
+AsyncUploader::AsyncUploader(std::shared_ptr<const Device> device,
+                             std::shared_ptr<const Allocator> allocator,
+                             vk::DeviceSize ring_size)
+    : m_device{device}
+    , m_transfer_family{transfer_queue(*device).family_index()}
+    , m_graphics_family{graphics_queue(*device).family_index()}
+    , m_command_pool(CommandPoolBuilder(device)
+                         .with_reset_command_buffer()
+                         .with_queue_family(m_transfer_family)
+                         .build())
+    , m_semaphore(device)
+    , m_ring(std::move(allocator), ring_size) {}
+
+bool AsyncUploader::has_pending() const noexcept {
+    return !m_pending_buffer_copies.empty() ||
+           !m_pending_image_copies.empty();
+}
+
+void AsyncUploader::recycle_command_buffers(std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        m_free_command_buffers.push_back(m_in_flight_command_buffers.front());
+        m_in_flight_command_buffers.pop_front();
+    }
+}
+
+StagingRing::Region AsyncUploader::acquire(vk::DeviceSize size,
+                                           vk::DeviceSize alignment) {
+    while (true) {
+        recycle_command_buffers(m_ring.retire());
+        if (auto region = m_ring.try_allocate(size, alignment)) {
+            return *region;
+        }
+        if (has_pending()) {
+            submit_locked();
+            continue;
+        }
+        // Every batch has a ticket, so there is always one to wait on
+        m_ring.wait_oldest();
+        recycle_command_buffers(1);
+    }
+}
+
+void AsyncUploader::upload_bytes(std::span<const std::byte> data,
+                                 vk::Buffer dst, vk::DeviceSize dst_offset) {
+    std::scoped_lock lock(m_mutex);
+    while (!data.empty()) {
+        const auto size = std::min<vk::DeviceSize>(data.size(),
+                                                   m_ring.capacity());
+        auto region = acquire(size, BUFFER_COPY_ALIGNMENT);
+        std::memcpy(region.data.data(), data.data(), size);
+        m_ring.flush(region);
+
+        m_pending_buffer_copies.push_back(
+            {.dst = dst,
+             .region = vk::BufferCopy2()
+                           .setSrcOffset(region.offset)
+                           .setDstOffset(dst_offset)
+                           .setSize(size)});
+
+        data = data.subspan(size);
+        dst_offset += size;
+    }
+}
+
+void AsyncUploader::upload_image(std::span<const std::byte> pixels,
+                                 std::shared_ptr<const Image> image) {
+    const auto extent = image->extent3D();
+    const auto row_size = vk::DeviceSize(extent.width) * RGBA8_TEXEL_SIZE;
+    if (pixels.size() != row_size * extent.height) {
+        throw LogicException::out_of_range("pixel data size", pixels.size(),
+                                           row_size * extent.height);
+    }
+    const auto rows_per_chunk = uint32_t(
+        std::min<vk::DeviceSize>(m_ring.capacity() / row_size, extent.height));
+    if (rows_per_chunk == 0) {
+        throw LogicException::out_of_range("image row size", row_size,
+                                           m_ring.capacity());
+    }
+
+    std::scoped_lock lock(m_mutex);
+    for (uint32_t y = 0; y < extent.height; y += rows_per_chunk) {
+        const auto rows = std::min(rows_per_chunk, extent.height - y);
+        const auto size = rows * row_size;
+        auto region = acquire(size, IMAGE_COPY_ALIGNMENT);
+        std::memcpy(region.data.data(), pixels.data() + y * row_size, size);
+        m_ring.flush(region);
+
+        m_pending_image_copies.push_back(
+            {.image = image,
+             .region =
+                 vk::BufferImageCopy2()
+                     .setBufferOffset(region.offset)
+                     .setImageOffset(vk::Offset3D(0, int32_t(y), 0))
+                     .setImageExtent(vk::Extent3D(extent.width, rows, 1))
+                     .setImageSubresource(image->mip_level_layer(MipLevel(0))),
+             .first_chunk = y == 0,
+             .last_chunk = y + rows == extent.height});
+    }
+}
+
+void AsyncUploader::record_pending(vk::CommandBuffer cmd_buffer) {
+    const bool transfer_ownership = uses_dedicated_queue();
+
+    std::vector<vk::ImageMemoryBarrier2> image_barriers;
+    for (const auto &copy : m_pending_image_copies) {
+        if (copy.first_chunk) {
+            image_barriers.push_back(
+                image_barrier_undefined_to_transfer_dst(*copy.image));
+        }
+    }
+    execute_image_barriers(cmd_buffer, image_barriers);
+
+    for (const auto &copy : m_pending_buffer_copies) {
+        cmd_buffer.copyBuffer2(vk::CopyBufferInfo2()
+                                   .setSrcBuffer(m_ring.buffer())
+                                   .setDstBuffer(copy.dst)
+                                   .setRegions(copy.region));
+    }
+    for (const auto &copy : m_pending_image_copies) {
+        cmd_buffer.copyBufferToImage2(
+            vk::CopyBufferToImageInfo2()
+                .setSrcBuffer(m_ring.buffer())
+                .setDstImage(copy.image->handle())
+                .setDstImageLayout(vk::ImageLayout::eTransferDstOptimal)
+                .setRegions(copy.region));
+    }
+
+    // Without an ownership transfer, the timeline semaphore the consumer
+    // waits on makes the copies visible; only the layout has to change
+    image_barriers.clear();
+    std::vector<vk::BufferMemoryBarrier2> buffer_barriers;
+    for (const auto &copy : m_pending_image_copies) {
+        if (!copy.last_chunk) {
+            continue;
+        }
+        auto barrier = image_barrier_transfer_dst_to_sampled(*copy.image);
+        if (!transfer_ownership) {
+            image_barriers.push_back(barrier);
+            continue;
+        }
+        barrier.setSrcQueueFamilyIndex(m_transfer_family)
+            .setDstQueueFamilyIndex(m_graphics_family);
+        // The release only has a source scope, the acquire a destination
+        image_barriers.push_back(vk::ImageMemoryBarrier2(barrier)
+                                     .setDstStageMask({})
+                                     .setDstAccessMask({}));
+        m_acquires.image_acquires.push_back(
+            barrier.setSrcStageMask({}).setSrcAccessMask({}));
+    }
+    if (transfer_ownership) {
+        for (const auto &copy : m_pending_buffer_copies) {
+            const auto barrier =
+                vk::BufferMemoryBarrier2()
+                    .setBuffer(copy.dst)
+                    .setOffset(copy.region.dstOffset)
+                    .setSize(copy.region.size)
+                    .setSrcQueueFamilyIndex(m_transfer_family)
+                    .setDstQueueFamilyIndex(m_graphics_family);
+            buffer_barriers.push_back(
+                vk::BufferMemoryBarrier2(barrier)
+                    .setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+                    .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite));
+            m_acquires.buffer_acquires.push_back(
+                vk::BufferMemoryBarrier2(barrier)
+                    .setDstStageMask(
+                        vk::PipelineStageFlagBits2::eAllCommands)
+                    .setDstAccessMask(vk::AccessFlagBits2::eMemoryRead));
+        }
+    }
+    if (!image_barriers.empty() || !buffer_barriers.empty()) {
+        cmd_buffer.pipelineBarrier2(
+            vk::DependencyInfo()
+                .setBufferMemoryBarriers(buffer_barriers)
+                .setImageMemoryBarriers(image_barriers));
+    }
+
+    m_pending_buffer_copies.clear();
+    m_pending_image_copies.clear();
+}
+
+void AsyncUploader::submit_locked() {
+    vk::CommandBuffer cmd_buffer;
+    if (m_free_command_buffers.empty()) {
+        cmd_buffer = m_command_pool.allocate(1)[0];
+    } else {
+        cmd_buffer = m_free_command_buffers.back();
+        m_free_command_buffers.pop_back();
+    }
+
+    vk::CommandBufferBeginInfo info(
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+    std::ignore = cmd_buffer.begin(&info);
+    record_pending(cmd_buffer);
+    std::ignore = cmd_buffer.end();
+
+    // A signal covers every earlier submission on the queue, so waiting on
+    // the last value also waits for batches submitted early
+    const auto signal = m_semaphore.submit_info(
+        ++m_last_value, vk::PipelineStageFlagBits2::eAllCommands);
+    // Submitted alone: on the graphics queue fallback, command buffers
+    // enqueued by the renderer are not taken along
+    const SubmitBatch batch{.command_buffers = {&cmd_buffer, 1},
+                            .signals = {&signal, 1}};
+    m_ring.close_batch(transfer_queue(*m_device).submit({&batch, 1}));
+    m_in_flight_command_buffers.push_back(cmd_buffer);
+}
+
+AsyncUploader::UploadBatch AsyncUploader::submit() {
+    std::scoped_lock lock(m_mutex);
+    if (has_pending()) {
+        submit_locked();
+    }
+    auto batch = std::exchange(m_acquires, {});
+    batch.value = m_last_value;
+    return batch;
+}
+
+vk::SemaphoreSubmitInfo
+AsyncUploader::wait_info(uint64_t value,
+                         vk::PipelineStageFlags2 stage) const noexcept {
+    return m_semaphore.submit_info(value, stage);
+}
+
+void AsyncUploader::record_acquire(vk::CommandBuffer cmd_buffer,
+                                   const UploadBatch &batch) {
+    if (batch.buffer_acquires.empty() && batch.image_acquires.empty()) {
+        return;
+    }
+    cmd_buffer.pipelineBarrier2(
+        vk::DependencyInfo()
+            .setBufferMemoryBarriers(batch.buffer_acquires)
+            .setImageMemoryBarriers(batch.image_acquires));
+}
+
+void AsyncUploader::wait(uint64_t value) const { m_semaphore.wait(value); }
+
+bool AsyncUploader::is_complete(uint64_t value) const {
+    return m_semaphore.value() >= value;
+}
+
+} // namespace vw
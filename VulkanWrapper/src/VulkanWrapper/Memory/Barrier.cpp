@@ -10,100 +10,105 @@ void executeMemoryBarrier(vk::CommandBuffer cmd_buffer,
     cmd_buffer.pipelineBarrier2(dependency);
 }
 
-void execute_image_barrier_undefined_to_transfer_dst(
-    vk::CommandBuffer cmd_buffer, const std::shared_ptr<const Image> &image) {
-
-    const auto range = image->full_range();
-    const auto img_barrier =
-        vk::ImageMemoryBarrier2()
-            .setSubresourceRange(range)
-            .setSrcAccessMask(vk::AccessFlagBits2::eNone)
-            .setSrcStageMask(vk::PipelineStageFlagBits2::eNone)
-            .setDstAccessMask(vk::AccessFlagBits2::eTransferWrite)
-            .setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
-            .setOldLayout(vk::ImageLayout::eUndefined)
-            .setNewLayout(vk::ImageLayout::eTransferDstOptimal)
-            .setImage(image->handle());
+vk::ImageMemoryBarrier2
+image_barrier_undefined_to_transfer_dst(const Image &image) {
+    return vk::ImageMemoryBarrier2()
+        .setSubresourceRange(image.full_range())
+        .setSrcAccessMask(vk::AccessFlagBits2::eNone)
+        .setSrcStageMask(vk::PipelineStageFlagBits2::eNone)
+        .setDstAccessMask(vk::AccessFlagBits2::eTransferWrite)
+        .setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
+        .setOldLayout(vk::ImageLayout::eUndefined)
+        .setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+        .setImage(image.handle());
+}
 
-    const auto dependency_info =
-        vk::DependencyInfo().setImageMemoryBarriers(img_barrier);
+vk::ImageMemoryBarrier2 image_barrier_transfer_dst_to_src(const Image &image,
+                                                          MipLevel mip_level) {
+    return vk::ImageMemoryBarrier2()
+        .setSubresourceRange(image.mip_level_range(mip_level))
+        .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+        .setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+        .setDstAccessMask(vk::AccessFlagBits2::eTransferRead)
+        .setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
+        .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+        .setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
+        .setImage(image.handle());
+}
 
-    cmd_buffer.pipelineBarrier2(dependency_info);
+vk::ImageMemoryBarrier2
+image_barrier_transfer_src_to_sampled(const Image &image) {
+    return vk::ImageMemoryBarrier2()
+        .setSubresourceRange(image.full_range())
+        .setSrcAccessMask(vk::AccessFlagBits2::eTransferRead)
+        .setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+        .setDstAccessMask(vk::AccessFlagBits2::eShaderRead)
+        .setDstStageMask(vk::PipelineStageFlagBits2::eFragmentShader)
+        .setOldLayout(vk::ImageLayout::eTransferSrcOptimal)
+        .setNewLayout(vk::ImageLayout::eReadOnlyOptimal)
+        .setImage(image.handle());
 }
 
-void execute_image_barrier_undefined_to_general(
-    vk::CommandBuffer cmd_buffer, const std::shared_ptr<const Image> &image) {
-    const auto range = image->full_range();
-    const auto img_barrier =
-        vk::ImageMemoryBarrier2()
-            .setSubresourceRange(range)
-            .setSrcAccessMask(vk::AccessFlagBits2::eNone)
-            .setSrcStageMask(vk::PipelineStageFlagBits2::eNone)
-            .setDstAccessMask(vk::AccessFlagBits2::eShaderStorageWrite)
-            .setDstStageMask(vk::PipelineStageFlagBits2::eRayTracingShaderKHR)
-            .setOldLayout(vk::ImageLayout::eUndefined)
-            .setNewLayout(vk::ImageLayout::eGeneral)
-            .setImage(image->handle());
+vk::ImageMemoryBarrier2
+image_barrier_transfer_dst_to_sampled(const Image &image) {
+    return vk::ImageMemoryBarrier2()
+        .setSubresourceRange(image.full_range())
+        .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+        .setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+        .setDstAccessMask(vk::AccessFlagBits2::eShaderRead)
+        .setDstStageMask(vk::PipelineStageFlagBits2::eFragmentShader)
+        .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+        .setNewLayout(vk::ImageLayout::eReadOnlyOptimal)
+        .setImage(image.handle());
+}
 
+void execute_image_barriers(vk::CommandBuffer cmd_buffer,
+                            std::span<const vk::ImageMemoryBarrier2> barriers) {
+    if (barriers.empty()) {
+        return;
+    }
     const auto dependency_info =
-        vk::DependencyInfo().setImageMemoryBarriers(img_barrier);
-
+        vk::DependencyInfo().setImageMemoryBarriers(barriers);
     cmd_buffer.pipelineBarrier2(dependency_info);
 }
 
-void execute_image_barrier_transfer_dst_to_sampled(
+void execute_image_barrier_undefined_to_transfer_dst(
     vk::CommandBuffer cmd_buffer, const std::shared_ptr<const Image> &image) {
-    const auto range = image->full_range();
-    const auto img_barrier =
-        vk::ImageMemoryBarrier2()
-            .setSubresourceRange(range)
-            .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
-            .setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
-            .setDstAccessMask(vk::AccessFlagBits2::eShaderRead)
-            .setDstStageMask(vk::PipelineStageFlagBits2::eFragmentShader)
-            .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
-            .setNewLayout(vk::ImageLayout::eReadOnlyOptimal)
-            .setImage(image->handle());
-
-    const auto dependency_info =
-        vk::DependencyInfo().setImageMemoryBarriers(img_barrier);
+    executeMemoryBarrier(cmd_buffer,
+                         image_barrier_undefined_to_transfer_dst(*image));
+}
 
-    cmd_buffer.pipelineBarrier2(dependency_info);
+void execute_image_barrier_transfer_dst_to_sampled(
+    vk::CommandBuffer cmd_buffer, const std::shared_ptr<const Image> &image) {
+    executeMemoryBarrier(cmd_buffer,
+                         image_barrier_transfer_dst_to_sampled(*image));
 }
 
 void execute_image_barrier_transfer_src_to_dst(
     vk::CommandBuffer cmd_buffer, const std::shared_ptr<const Image> &image) {
-    const auto range = image->full_range();
-    const auto img_barrier =
-        vk::ImageMemoryBarrier2()
-            .setSubresourceRange(range)
-            .setSrcAccessMask(vk::AccessFlagBits2::eTransferRead)
-            .setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
-            .setDstAccessMask(vk::AccessFlagBits2::eShaderRead)
-            .setDstStageMask(vk::PipelineStageFlagBits2::eFragmentShader)
-            .setOldLayout(vk::ImageLayout::eTransferSrcOptimal)
-            .setNewLayout(vk::ImageLayout::eReadOnlyOptimal)
-            .setImage(image->handle());
-
-    const auto dependency_info =
-        vk::DependencyInfo().setImageMemoryBarriers(img_barrier);
-
-    cmd_buffer.pipelineBarrier2(dependency_info);
+    executeMemoryBarrier(cmd_buffer,
+                         image_barrier_transfer_src_to_sampled(*image));
 }
 
 void execute_image_barrier_transfer_dst_to_src(
     vk::CommandBuffer cmd_buffer, const std::shared_ptr<const Image> &image,
     MipLevel mip_level) {
-    const auto range = image->mip_level_range(mip_level);
+    executeMemoryBarrier(cmd_buffer,
+                         image_barrier_transfer_dst_to_src(*image, mip_level));
+}
+
+void execute_image_barrier_undefined_to_general(
+    vk::CommandBuffer cmd_buffer, const std::shared_ptr<const Image> &image) {
+    const auto range = image->full_range();
     const auto img_barrier =
         vk::ImageMemoryBarrier2()
             .setSubresourceRange(range)
-            .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
-            .setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
-            .setDstAccessMask(vk::AccessFlagBits2::eTransferRead)
-            .setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
-            .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
-            .setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
+            .setSrcAccessMask(vk::AccessFlagBits2::eNone)
+            .setSrcStageMask(vk::PipelineStageFlagBits2::eNone)
+            .setDstAccessMask(vk::AccessFlagBits2::eShaderStorageWrite)
+            .setDstStageMask(vk::PipelineStageFlagBits2::eRayTracingShaderKHR)
+            .setOldLayout(vk::ImageLayout::eUndefined)
+            .setNewLayout(vk::ImageLayout::eGeneral)
             .setImage(image->handle());
 
     const auto dependency_info =
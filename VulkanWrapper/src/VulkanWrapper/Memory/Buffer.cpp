@@ -8,10 +8,10 @@ namespace vw {
 BufferBase::BufferBase(std::shared_ptr<const Device> device,
                        std::shared_ptr<const Allocator> allocator,
                        vk::Buffer buffer, VmaAllocation allocation,
-                       VkDeviceSize size)
+                       VkDeviceSize size, void *mapped_data)
     : ObjectWithHandle<vk::Buffer>{buffer}
     , m_data{std::make_unique<Data>(std::move(device), std::move(allocator),
-                                    allocation, size)} {}
+                                    allocation, size, mapped_data)} {}
 
 VkDeviceSize BufferBase::size_bytes() const noexcept {
     return m_data->m_size_in_bytes;
@@ -38,6 +38,12 @@ void BufferBase::write_bytes(const void *data, VkDeviceSize size,
         throw LogicException::out_of_range("buffer copy", offset + size,
                                            m_data->m_size_in_bytes);
     }
+    if (m_data->m_mapped_data) {
+        std::memcpy(static_cast<std::byte *>(m_data->m_mapped_data) + offset,
+                    data, size);
+        flush_bytes(offset, size);
+        return;
+    }
     check_vma(vmaCopyMemoryToAllocation(m_data->m_allocator->handle(), data,
                                         m_data->m_allocation, offset, size),
               "Failed to copy memory to allocation");
@@ -45,6 +51,15 @@ void BufferBase::write_bytes(const void *data, VkDeviceSize size,
 
 std::vector<std::byte> BufferBase::read_bytes(VkDeviceSize offset,
                                               VkDeviceSize size) const {
+    if (offset + size > m_data->m_size_in_bytes) {
+        throw LogicException::out_of_range("buffer read", offset + size,
+                                           m_data->m_size_in_bytes);
+    }
+    if (m_data->m_mapped_data) {
+        invalidate_bytes(offset, size);
+        const auto bytes = mapped_bytes().subspan(offset, size);
+        return std::vector<std::byte>(bytes.begin(), bytes.end());
+    }
     std::vector<std::byte> result(size);
     check_vma(vmaCopyAllocationToMemory(m_data->m_allocator->handle(),
                                         m_data->m_allocation, offset,
@@ -53,10 +68,42 @@ std::vector<std::byte> BufferBase::read_bytes(VkDeviceSize offset,
     return result;
 }
 
+bool BufferBase::is_mapped() const noexcept {
+    return m_data && m_data->m_mapped_data != nullptr;
+}
+
+std::span<std::byte> BufferBase::mapped_bytes() noexcept {
+    if (!is_mapped()) {
+        return {};
+    }
+    return {static_cast<std::byte *>(m_data->m_mapped_data),
+            m_data->m_size_in_bytes};
+}
+
+std::span<const std::byte> BufferBase::mapped_bytes() const noexcept {
+    if (!is_mapped()) {
+        return {};
+    }
+    return {static_cast<const std::byte *>(m_data->m_mapped_data),
+            m_data->m_size_in_bytes};
+}
+
+void BufferBase::flush_bytes(VkDeviceSize offset, VkDeviceSize size) const {
+    check_vma(vmaFlushAllocation(m_data->m_allocator->handle(),
+                                 m_data->m_allocation, offset, size),
+              "Failed to flush allocation");
+}
+
+void BufferBase::invalidate_bytes(VkDeviceSize offset,
+                                  VkDeviceSize size) const {
+    check_vma(vmaInvalidateAllocation(m_data->m_allocator->handle(),
+                                      m_data->m_allocation, offset, size),
+              "Failed to invalidate allocation");
+}
+
 BufferBase::~BufferBase() {
     if (m_data) {
-        vmaDestroyBuffer(m_data->m_allocator->handle(), handle(),
-                         m_data->m_allocation);
+        m_data->m_allocator->destroy_buffer(handle(), m_data->m_allocation);
     }
 }
 
@@ -0,0 +1,50 @@
+#include "VulkanWrapper/Memory/FrameRingAllocator.h"
+
+#include "VulkanWrapper/Memory/AllocateBufferUtils.h"
+#include <bit>
+
+namespace vw {
+
+static vk::DeviceSize align_frame_size(vk::DeviceSize size,
+                                       vk::DeviceSize alignment) {
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+FrameRingAllocator::FrameRingAllocator(
+    std::shared_ptr<const Allocator> allocator, vk::DeviceSize frame_size,
+    uint32_t frame_count, vk::DeviceSize min_alignment)
+    : m_min_alignment(min_alignment)
+    , m_frame_tickets(frame_count) {
+    if (frame_count == 0) {
+        throw LogicException::invalid_state(
+            "FrameRingAllocator needs at least one frame");
+    }
+    if (!std::has_single_bit(min_alignment)) {
+        throw LogicException::invalid_state(
+            "FrameRingAllocator alignment must be a power of two");
+    }
+    m_frame_size = align_frame_size(frame_size, min_alignment);
+    m_buffer = std::make_shared<TransientBuffer>(
+        create_buffer<TransientBuffer>(*allocator, m_frame_size * frame_count));
+    m_mapped = m_buffer->mapped_bytes().data();
+}
+
+void FrameRingAllocator::begin_frame() {
+    m_frame_index = (m_frame_index + 1) % frame_count();
+    auto &ticket = m_frame_tickets[m_frame_index];
+    if (ticket.queue) {
+        ticket.wait();
+        ticket = {};
+    }
+    m_frame_begin = m_frame_index * m_frame_size;
+    m_cursor = 0;
+}
+
+void FrameRingAllocator::end_frame(SubmitTicket ticket) {
+    if (m_cursor != 0) {
+        m_buffer->flush_bytes(m_frame_begin, m_cursor);
+    }
+    m_frame_tickets[m_frame_index] = ticket;
+}
+
+} // namespace vw
@@ -0,0 +1,92 @@
+#include "VulkanWrapper/Memory/MemoryReport.h"
+
+#include <format>
+#include <iterator>
+
+namespace vw {
+
+std::string_view to_string(AllocationCategory category) noexcept {
+    switch (category) {
+        using enum AllocationCategory;
+    case RenderTarget:
+        return "render_target";
+    case Texture:
+        return "texture";
+    case Mesh:
+        return "mesh";
+    case AccelerationStructure:
+        return "acceleration_structure";
+    case Staging:
+        return "staging";
+    case Other:
+        break;
+    }
+    return "other";
+}
+
+AllocationCategory
+infer_allocation_category(vk::ImageUsageFlags usage) noexcept {
+    constexpr auto render_target_usage =
+        vk::ImageUsageFlagBits::eColorAttachment |
+        vk::ImageUsageFlagBits::eDepthStencilAttachment |
+        vk::ImageUsageFlagBits::eStorage;
+    if (usage & render_target_usage) {
+        return AllocationCategory::RenderTarget;
+    }
+    if (usage & vk::ImageUsageFlagBits::eSampled) {
+        return AllocationCategory::Texture;
+    }
+    return AllocationCategory::Other;
+}
+
+AllocationCategory infer_allocation_category(vk::BufferUsageFlags usage,
+                                             bool host_visible) noexcept {
+    if (usage & vk::BufferUsageFlagBits::eAccelerationStructureStorageKHR) {
+        return AllocationCategory::AccelerationStructure;
+    }
+    if (usage & (vk::BufferUsageFlagBits::eVertexBuffer |
+                 vk::BufferUsageFlagBits::eIndexBuffer)) {
+        return AllocationCategory::Mesh;
+    }
+    if (host_visible && (usage & vk::BufferUsageFlagBits::eTransferSrc)) {
+        return AllocationCategory::Staging;
+    }
+    return AllocationCategory::Other;
+}
+
+vk::DeviceSize MemoryReport::total_bytes() const noexcept {
+    vk::DeviceSize total = 0;
+    for (const auto &usage : categories) {
+        total += usage.bytes;
+    }
+    return total;
+}
+
+std::string MemoryReport::to_json() const {
+    std::string json = R"({"heaps":[)";
+    auto out = std::back_inserter(json);
+    for (std::size_t i = 0; i < heaps.size(); ++i) {
+        const auto &heap = heaps[i];
+        std::format_to(
+            out,
+            R"({}{{"index":{},"device_local":{},"size":{},"budget":{},)"
+            R"("usage":{},"block_bytes":{},"allocation_bytes":{},)"
+            R"("block_count":{},"allocation_count":{}}})",
+            i == 0 ? "" : ",", heap.heap_index, heap.is_device_local(),
+            heap.size, heap.budget, heap.usage, heap.block_bytes,
+            heap.allocation_bytes, heap.block_count, heap.allocation_count);
+    }
+    json += R"(],"categories":{)";
+    for (std::size_t i = 0; i < categories.size(); ++i) {
+        const auto &usage = categories[i];
+        std::format_to(
+            out,
+            R"({}"{}":{{"allocation_count":{},"bytes":{},"peak_bytes":{}}})",
+            i == 0 ? "" : ",", to_string(AllocationCategory(i)),
+            usage.allocation_count, usage.bytes, usage.peak_bytes);
+    }
+    std::format_to(out, R"(}},"total_bytes":{}}})", total_bytes());
+    return json;
+}
+
+} // namespace vw
@@ -0,0 +1,106 @@
+#include "VulkanWrapper/Memory/RenderTargetPool.h"
+
+#include "VulkanWrapper/Image/Image.h"
+#include "VulkanWrapper/Image/ImageView.h"
+#include "VulkanWrapper/Memory/Allocator.h"
+#include "VulkanWrapper/Utils/Error.h"
+#include <algorithm>
+
+namespace vw {
+
+namespace {
+uint32_t round_up(uint32_t value, uint32_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+} // namespace
+
+RenderTargetPool::RenderTargetPool(std::shared_ptr<const Device> device,
+                                   std::shared_ptr<const Allocator> allocator,
+                                   uint32_t frames_in_flight,
+                                   uint32_t bucket_size)
+    : m_device{std::move(device)}
+    , m_allocator{std::move(allocator)}
+    , m_frames_in_flight{frames_in_flight}
+    , m_bucket_size{bucket_size} {
+    if (m_bucket_size == 0) {
+        throw LogicException::invalid_state(
+            "Render target bucket size must be positive");
+    }
+}
+
+vk::Extent2D RenderTargetPool::bucket(Width width,
+                                      Height height) const noexcept {
+    return {round_up(uint32_t(width), m_bucket_size),
+            round_up(uint32_t(height), m_bucket_size)};
+}
+
+RenderTargetPool::RenderTarget
+RenderTargetPool::acquire(vk::Format format, vk::ImageUsageFlags usage,
+                          Width width, Height height) {
+    const auto size = bucket(width, height);
+    const vk::Extent2D extent{uint32_t(width), uint32_t(height)};
+
+    std::lock_guard lock(m_mutex);
+    auto it = std::ranges::find_if(m_entries, [&](const Entry &entry) {
+        return !entry.in_use && entry.available_frame <= m_frame &&
+               entry.format == format && entry.usage == usage &&
+               entry.image->extent2D() == size;
+    });
+    if (it != m_entries.end()) {
+        it->in_use = true;
+        ++m_reuse_count;
+        return {it->image, it->view, extent};
+    }
+
+    auto image = m_allocator->create_image_2D(
+        Width(size.width), Height(size.height), false, format, usage,
+        AllocationCategory::RenderTarget);
+    auto view = ImageViewBuilder(m_device, image)
+                    .setImageType(vk::ImageViewType::e2D)
+                    .build();
+    m_entries.push_back(Entry{.image = image,
+                              .view = view,
+                              .format = format,
+                              .usage = usage,
+                              .in_use = true,
+                              .available_frame = 0});
+    ++m_allocation_count;
+    return {std::move(image), std::move(view), extent};
+}
+
+void RenderTargetPool::release(const std::shared_ptr<const Image> &image) {
+    std::lock_guard lock(m_mutex);
+    auto it = std::ranges::find(m_entries, image, &Entry::image);
+    if (it == m_entries.end() || !it->in_use) {
+        throw LogicException::invalid_state(
+            "Released image is not in use in the render target pool");
+    }
+    it->in_use = false;
+    it->available_frame = m_frame + m_frames_in_flight;
+}
+
+void RenderTargetPool::begin_frame() {
+    std::lock_guard lock(m_mutex);
+    ++m_frame;
+}
+
+std::size_t RenderTargetPool::trim() {
+    std::lock_guard lock(m_mutex);
+    return std::erase_if(m_entries, [&](const Entry &entry) {
+        return !entry.in_use && entry.available_frame <= m_frame;
+    });
+}
+
+RenderTargetPool::Statistics RenderTargetPool::statistics() const {
+    std::lock_guard lock(m_mutex);
+    const auto available =
+        std::ranges::count_if(m_entries, [&](const Entry &entry) {
+            return !entry.in_use && entry.available_frame <= m_frame;
+        });
+    return {.image_count = m_entries.size(),
+            .available_count = static_cast<std::size_t>(available),
+            .allocation_count = m_allocation_count,
+            .reuse_count = m_reuse_count};
+}
+
+} // namespace vw
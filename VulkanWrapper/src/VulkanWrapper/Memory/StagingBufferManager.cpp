@@ -7,45 +7,318 @@
 #include "VulkanWrapper/Image/Mipmap.h"
 #include "VulkanWrapper/Image/Sampler.h"
 #include "VulkanWrapper/Memory/Barrier.h"
-
-constexpr auto STAGING_BUFFER_SIZE = 1 << 22;
+#include "VulkanWrapper/Memory/IntervalSet.h"
+#include "VulkanWrapper/Vulkan/Device.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
+#include <map>
 
 namespace vw {
 
-static vk::DeviceSize compute_size(vk::DeviceSize size) {
-    const auto max_size =
-        double(std::max<vk::DeviceSize>(size, STAGING_BUFFER_SIZE));
-
-    return vk::DeviceSize(std::pow(2, std::ceil(std::log2(max_size))));
-}
+// Buffer copies have no offset rule; a small alignment keeps consecutive
+// uploads contiguous in the ring so that their copies can be merged
+constexpr vk::DeviceSize BUFFER_COPY_ALIGNMENT = 4;
+// Multiple of the RGBA8 texel size, as image copies require
+constexpr vk::DeviceSize IMAGE_COPY_ALIGNMENT = 16;
+constexpr vk::DeviceSize RGBA8_TEXEL_SIZE = 4;
 
 static CommandPool create_command_pool(std::shared_ptr<const Device> device) {
-    return CommandPoolBuilder(device).build();
+    return CommandPoolBuilder(device).with_reset_command_buffer().build();
 }
 
 StagingBufferManager::StagingBufferManager(
     std::shared_ptr<const Device> device,
-    std::shared_ptr<const Allocator> allocator)
+    std::shared_ptr<const Allocator> allocator, Queue &queue,
+    vk::DeviceSize ring_size)
     : m_device{device}
     , m_allocator{allocator}
+    , m_queue{&queue}
     , m_command_pool(create_command_pool(device))
-    , m_staging_buffers{allocator}
+    , m_ring(allocator, ring_size)
     , m_sampler(SamplerBuilder{device}.build()) {}
 
-vk::CommandBuffer StagingBufferManager::fill_command_buffer() {
-    auto cmd_buffer = m_command_pool.allocate(1)[0];
+bool StagingBufferManager::has_pending() const noexcept {
+    return !m_pending_buffer_copies.empty() ||
+           !m_pending_image_copies.empty();
+}
+
+void StagingBufferManager::recycle_command_buffers(std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        m_free_command_buffers.push_back(m_in_flight_command_buffers.front());
+        m_in_flight_command_buffers.pop_front();
+    }
+}
+
+void StagingBufferManager::retire() {
+    recycle_command_buffers(m_ring.retire());
+}
+
+void StagingBufferManager::wait_oldest() {
+    if (!m_ring.wait_oldest()) {
+        throw LogicException::invalid_state(
+            "Staging ring is full: call track_submission() with the "
+            "submission of the command buffers from fill_command_buffer()");
+    }
+    recycle_command_buffers(1);
+}
+
+StagingRing::Region StagingBufferManager::acquire(vk::DeviceSize size,
+                                                  vk::DeviceSize alignment) {
+    while (true) {
+        retire();
+        if (auto region = m_ring.try_allocate(size, alignment)) {
+            return *region;
+        }
+        if (has_pending()) {
+            // The open batch holds the space we need, hand it to the GPU
+            flush_locked();
+            continue;
+        }
+        wait_oldest();
+    }
+}
+
+void StagingBufferManager::record_buffer_copies(vk::CommandBuffer cmd_buffer) {
+    struct DstCopies {
+        vk::Buffer src;
+        vk::Buffer dst;
+        std::vector<vk::BufferCopy2> regions;
+        BufferIntervalSet written;
+    };
+    auto emit = [cmd_buffer](DstCopies &copies) {
+        if (copies.regions.empty()) {
+            return;
+        }
+        cmd_buffer.copyBuffer2(vk::CopyBufferInfo2()
+                                   .setSrcBuffer(copies.src)
+                                   .setDstBuffer(copies.dst)
+                                   .setRegions(copies.regions));
+        copies.regions.clear();
+        copies.written.clear();
+    };
+
+    auto wait_for_writes = [cmd_buffer](vk::Buffer dst) {
+        const auto barrier =
+            vk::BufferMemoryBarrier2()
+                .setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+                .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+                .setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
+                .setDstAccessMask(vk::AccessFlagBits2::eTransferWrite)
+                .setBuffer(dst)
+                .setOffset(0)
+                .setSize(vk::WholeSize);
+        cmd_buffer.pipelineBarrier2(
+            vk::DependencyInfo().setBufferMemoryBarriers(barrier));
+    };
+
+    std::map<std::pair<vk::Buffer, vk::Buffer>, DstCopies> per_pair;
+    for (const auto &copy : m_pending_buffer_copies) {
+        auto &copies = per_pair[{copy.src, copy.dst}];
+        copies.src = copy.src;
+        copies.dst = copy.dst;
+
+        const BufferInterval target(copy.region.dstOffset, copy.region.size);
+        if (copies.written.hasOverlap(target)) {
+            // Neither the regions of one copy command nor separate copy
+            // commands are ordered, so a rewrite of the same bytes goes
+            // into a later command, after a write-after-write barrier
+            emit(copies);
+            wait_for_writes(copy.dst);
+        }
+        copies.written.add(target);
+
+        auto *last = copies.regions.empty() ? nullptr : &copies.regions.back();
+        if (last &&
+            last->srcOffset + last->size == copy.region.srcOffset &&
+            last->dstOffset + last->size == copy.region.dstOffset) {
+            last->size += copy.region.size;
+            continue;
+        }
+        copies.regions.push_back(vk::BufferCopy2()
+                                     .setSrcOffset(copy.region.srcOffset)
+                                     .setDstOffset(copy.region.dstOffset)
+                                     .setSize(copy.region.size));
+    }
+    for (auto &[pair, copies] : per_pair) {
+        emit(copies);
+    }
+    m_pending_buffer_copies.clear();
+}
+
+void StagingBufferManager::record_image_copies(vk::CommandBuffer cmd_buffer) {
+    std::vector<vk::ImageMemoryBarrier2> barriers;
+    for (const auto &copy : m_pending_image_copies) {
+        if (copy.first_chunk) {
+            barriers.push_back(
+                image_barrier_undefined_to_transfer_dst(*copy.image));
+        }
+    }
+    execute_image_barriers(cmd_buffer, barriers);
+
+    // Chunks of one image were staged back to back; give each image a
+    // single copy command
+    std::vector<vk::BufferImageCopy2> regions;
+    for (std::size_t i = 0; i < m_pending_image_copies.size(); ++i) {
+        const auto &copy = m_pending_image_copies[i];
+        regions.push_back(vk::BufferImageCopy2()
+                              .setBufferOffset(copy.region.bufferOffset)
+                              .setImageOffset(copy.region.imageOffset)
+                              .setImageExtent(copy.region.imageExtent)
+                              .setImageSubresource(
+                                  copy.region.imageSubresource));
+        const bool image_ends =
+            i + 1 == m_pending_image_copies.size() ||
+            m_pending_image_copies[i + 1].image != copy.image ||
+            m_pending_image_copies[i + 1].src != copy.src;
+        if (image_ends) {
+            cmd_buffer.copyBufferToImage2(
+                vk::CopyBufferToImageInfo2()
+                    .setSrcBuffer(copy.src)
+                    .setDstImage(copy.image->handle())
+                    .setDstImageLayout(vk::ImageLayout::eTransferDstOptimal)
+                    .setRegions(regions));
+            regions.clear();
+        }
+    }
+
+    barriers.clear();
+    std::vector<std::shared_ptr<const Image>> mipmapped;
+    for (const auto &copy : m_pending_image_copies) {
+        if (!copy.last_chunk) {
+            continue;
+        }
+        if (copy.mipmaps) {
+            barriers.push_back(
+                image_barrier_transfer_dst_to_src(*copy.image, MipLevel(0)));
+            mipmapped.push_back(copy.image);
+        } else {
+            barriers.push_back(
+                image_barrier_transfer_dst_to_sampled(*copy.image));
+        }
+    }
+    execute_image_barriers(cmd_buffer, barriers);
+
+    if (!mipmapped.empty()) {
+        barriers.clear();
+        for (const auto &image : mipmapped) {
+            generate_mipmap(cmd_buffer, image);
+            barriers.push_back(image_barrier_transfer_src_to_sampled(*image));
+        }
+        execute_image_barriers(cmd_buffer, barriers);
+    }
+    m_pending_image_copies.clear();
+}
+
+vk::CommandBuffer StagingBufferManager::record_pending() {
+    vk::CommandBuffer cmd_buffer;
+    if (m_free_command_buffers.empty()) {
+        cmd_buffer = m_command_pool.allocate(1)[0];
+    } else {
+        cmd_buffer = m_free_command_buffers.back();
+        m_free_command_buffers.pop_back();
+    }
 
     vk::CommandBufferBeginInfo info(
         vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
 
     std::ignore = cmd_buffer.begin(&info);
-    for (auto &function : m_transfer_functions)
-        function(cmd_buffer);
+    record_buffer_copies(cmd_buffer);
+    record_image_copies(cmd_buffer);
     std::ignore = cmd_buffer.end();
 
+    m_in_flight_command_buffers.push_back(cmd_buffer);
     return cmd_buffer;
 }
 
+void StagingBufferManager::flush_locked() {
+    if (!has_pending()) {
+        return;
+    }
+    // Submitted alone: command buffers the caller enqueued on the queue
+    // keep their place
+    const auto cmd_buffer = record_pending();
+    const SubmitBatch batch{.command_buffers = {&cmd_buffer, 1}};
+    m_ring.close_batch(m_queue->submit({&batch, 1}));
+}
+
+vk::CommandBuffer StagingBufferManager::fill_command_buffer() {
+    std::scoped_lock lock(m_mutex);
+    auto cmd_buffer = record_pending();
+    m_ring.close_batch();
+    return cmd_buffer;
+}
+
+void StagingBufferManager::track_submission(SubmitTicket ticket) {
+    std::scoped_lock lock(m_mutex);
+    m_ring.set_ticket(ticket);
+}
+
+void StagingBufferManager::release_staging_memory() {
+    std::scoped_lock lock(m_mutex);
+    recycle_command_buffers(m_ring.retire_all());
+}
+
+void StagingBufferManager::flush() {
+    std::scoped_lock lock(m_mutex);
+    flush_locked();
+}
+
+void StagingBufferManager::wait_idle() {
+    std::scoped_lock lock(m_mutex);
+    flush_locked();
+    while (m_ring.batch_count() != 0) {
+        wait_oldest();
+    }
+}
+
+void StagingBufferManager::wait_for_space(vk::DeviceSize size) {
+    if (size > m_ring.capacity()) {
+        throw LogicException::out_of_range("staging size", size,
+                                           m_ring.capacity());
+    }
+    std::scoped_lock lock(m_mutex);
+    retire();
+    // With the stricter alignment, the region fits any kind of upload
+    while (!m_ring.can_allocate(size, IMAGE_COPY_ALIGNMENT)) {
+        if (has_pending()) {
+            flush_locked();
+            continue;
+        }
+        wait_oldest();
+    }
+}
+
+vk::DeviceSize StagingBufferManager::available_bytes() {
+    std::scoped_lock lock(m_mutex);
+    retire();
+    return m_ring.largest_free_region();
+}
+
+void StagingBufferManager::fill_buffer_bytes(std::span<const std::byte> data,
+                                             vk::Buffer dst,
+                                             vk::DeviceSize dst_offset) {
+    std::scoped_lock lock(m_mutex);
+    // The copy is recorded in the same batch as its staging region, so the
+    // data is written under the lock as well
+    while (!data.empty()) {
+        const auto size = std::min<vk::DeviceSize>(data.size(),
+                                                   m_ring.capacity());
+        auto region = acquire(size, BUFFER_COPY_ALIGNMENT);
+        std::memcpy(region.data.data(), data.data(), size);
+        m_ring.flush(region);
+
+        m_pending_buffer_copies.push_back(
+            {.src = region.buffer,
+             .dst = dst,
+             .region = vk::BufferCopy()
+                           .setSrcOffset(region.offset)
+                           .setDstOffset(dst_offset)
+                           .setSize(size)});
+
+        data = data.subspan(size);
+        dst_offset += size;
+    }
+}
+
 CombinedImage
 StagingBufferManager::stage_image_from_path(const std::filesystem::path &path,
                                             bool mipmaps) {
@@ -60,37 +333,43 @@ StagingBufferManager::stage_image_from_path(const std::filesystem::path &path,
                                               img_description.height, mipmaps,
                                               vk::Format::eR8G8B8A8Srgb, usage);
 
-    auto [staging_buffer, offset] =
-        m_staging_buffers.create_buffer(img_description.pixels.size());
-
-    auto function = [buffer = staging_buffer->handle(), offset, image,
-                     width = img_description.width,
-                     height = img_description.height,
-                     mipmaps](vk::CommandBuffer cmd_buffer) {
-        const auto region =
-            vk::BufferImageCopy()
-                .setBufferOffset(offset)
-                .setImageExtent(image->extent3D())
-                .setImageSubresource(image->mip_level_layer(MipLevel(0)));
+    const auto extent = image->extent3D();
+    const auto row_size = vk::DeviceSize(extent.width) * RGBA8_TEXEL_SIZE;
+    const auto rows_per_chunk =
+        uint32_t(std::min<vk::DeviceSize>(m_ring.capacity() / row_size,
+                                          extent.height));
+    if (rows_per_chunk == 0) {
+        throw LogicException::out_of_range("image row size", row_size,
+                                           m_ring.capacity());
+    }
 
-        execute_image_barrier_undefined_to_transfer_dst(cmd_buffer, image);
+    {
+        std::scoped_lock lock(m_mutex);
+        std::span<const std::byte> pixels = img_description.pixels;
+        for (uint32_t y = 0; y < extent.height; y += rows_per_chunk) {
+            const auto rows = std::min(rows_per_chunk, extent.height - y);
+            const auto size = rows * row_size;
+            auto region = acquire(size, IMAGE_COPY_ALIGNMENT);
+            std::memcpy(region.data.data(), pixels.data() + y * row_size,
+                        size);
+            m_ring.flush(region);
 
-        cmd_buffer.copyBufferToImage(buffer, image->handle(),
-                                     vk::ImageLayout::eTransferDstOptimal,
-                                     region);
+            const auto copy =
+                vk::BufferImageCopy()
+                    .setBufferOffset(region.offset)
+                    .setImageOffset(vk::Offset3D(0, int32_t(y), 0))
+                    .setImageExtent(vk::Extent3D(extent.width, rows, 1))
+                    .setImageSubresource(image->mip_level_layer(MipLevel(0)));
 
-        if (mipmaps) {
-            execute_image_barrier_transfer_dst_to_src(cmd_buffer, image,
-                                                      MipLevel(0));
-            generate_mipmap(cmd_buffer, image);
-            execute_image_barrier_transfer_src_to_dst(cmd_buffer, image);
-        } else {
-            execute_image_barrier_transfer_dst_to_sampled(cmd_buffer, image);
+            m_pending_image_copies.push_back(
+                {.src = region.buffer,
+                 .image = image,
+                 .region = copy,
+                 .first_chunk = y == 0,
+                 .last_chunk = y + rows == extent.height,
+                 .mipmaps = mipmaps});
         }
-    };
-
-    m_transfer_functions.emplace_back(function);
-    staging_buffer->write(img_description.pixels, offset);
+    }
 
     auto image_view = ImageViewBuilder(m_device, image)
                           .setImageType(vk::ImageViewType::e2D)
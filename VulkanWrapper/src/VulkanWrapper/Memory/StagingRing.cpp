@@ -0,0 +1,142 @@
+#include "VulkanWrapper/Memory/StagingRing.h"
+
+#include "VulkanWrapper/Memory/AllocateBufferUtils.h"
+#include <algorithm>
+
+namespace vw {
+
+namespace {
+constexpr vk::DeviceSize max_alignment = 256;
+
+vk::DeviceSize align_up(vk::DeviceSize value, vk::DeviceSize alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+StagingRing::StagingRing(std::shared_ptr<const Allocator> allocator,
+                         vk::DeviceSize capacity)
+    : m_buffer(create_buffer<RingBuffer>(*allocator,
+                                         align_up(capacity, max_alignment)))
+    , m_capacity(align_up(capacity, max_alignment)) {}
+
+StagingRing::~StagingRing() {
+    for (const auto &batch : m_batches) {
+        if (batch.ticket.queue) {
+            batch.ticket.wait();
+        }
+    }
+}
+
+std::optional<vk::DeviceSize>
+StagingRing::find_position(vk::DeviceSize size,
+                           vk::DeviceSize alignment) const {
+    if (size > m_capacity) {
+        throw LogicException::out_of_range("staging size", size, m_capacity);
+    }
+    // Nothing in flight: try_allocate() restarts at the beginning so that
+    // a region as large as the ring still fits
+    const bool empty = m_head == m_tail && m_batches.empty();
+    const auto head = empty ? 0 : m_head;
+    const auto tail = empty ? 0 : m_tail;
+
+    auto position = align_up(head, alignment);
+    const auto wrapped = position % m_capacity;
+    if (wrapped + size > m_capacity) {
+        // Regions never straddle the end of the buffer
+        position += m_capacity - wrapped;
+    }
+    if (position + size - tail > m_capacity) {
+        return std::nullopt;
+    }
+    return position;
+}
+
+std::optional<StagingRing::Region>
+StagingRing::try_allocate(vk::DeviceSize size, vk::DeviceSize alignment) {
+    const auto position = find_position(size, alignment);
+    if (!position) {
+        return std::nullopt;
+    }
+    if (m_head == m_tail && m_batches.empty()) {
+        m_head = m_tail = 0;
+    }
+
+    m_head = *position + size;
+    const auto offset = *position % m_capacity;
+    return Region{.buffer = m_buffer.handle(),
+                  .offset = offset,
+                  .data = m_buffer.mapped_bytes().subspan(offset, size)};
+}
+
+bool StagingRing::can_allocate(vk::DeviceSize size,
+                               vk::DeviceSize alignment) const {
+    return find_position(size, alignment).has_value();
+}
+
+vk::DeviceSize StagingRing::largest_free_region() const noexcept {
+    if (m_head == m_tail && m_batches.empty()) {
+        return m_capacity;
+    }
+    if (used_bytes() == m_capacity) {
+        return 0;
+    }
+    const auto head = m_head % m_capacity;
+    const auto tail = m_tail % m_capacity;
+    if (head < tail) {
+        return tail - head;
+    }
+    // The free space is split by the end of the buffer
+    return std::max(m_capacity - head, tail);
+}
+
+void StagingRing::flush(const Region &region) const {
+    m_buffer.flush_bytes(region.offset, region.data.size());
+}
+
+void StagingRing::close_batch(SubmitTicket ticket) {
+    m_batches.push_back(Batch{.end = m_head, .ticket = ticket});
+}
+
+void StagingRing::set_ticket(SubmitTicket ticket) {
+    for (auto it = m_batches.rbegin();
+         it != m_batches.rend() && !it->ticket.queue; ++it) {
+        it->ticket = ticket;
+    }
+}
+
+void StagingRing::recycle_front() {
+    m_tail = m_batches.front().end;
+    m_batches.pop_front();
+}
+
+std::size_t StagingRing::retire() {
+    std::size_t retired = 0;
+    while (!m_batches.empty() && m_batches.front().ticket.queue &&
+           m_batches.front().ticket.is_complete()) {
+        recycle_front();
+        ++retired;
+    }
+    return retired;
+}
+
+bool StagingRing::wait_oldest() {
+    if (m_batches.empty() || !m_batches.front().ticket.queue) {
+        return false;
+    }
+    m_batches.front().ticket.wait();
+    recycle_front();
+    return true;
+}
+
+std::size_t StagingRing::retire_all() {
+    const auto retired = m_batches.size();
+    while (!m_batches.empty()) {
+        if (m_batches.front().ticket.queue) {
+            m_batches.front().ticket.wait();
+        }
+        recycle_front();
+    }
+    return retired;
+}
+
+} // namespace vw
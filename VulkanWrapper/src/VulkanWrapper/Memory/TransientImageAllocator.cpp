@@ -0,0 +1,182 @@
+#include "VulkanWrapper/Memory/TransientImageAllocator.h"
+
+#include "VulkanWrapper/Image/Image.h"
+#include "VulkanWrapper/Memory/Allocator.h"
+#include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Vulkan/Device.h"
+#include <algorithm>
+
+namespace vw {
+
+namespace {
+vk::DeviceSize align_up(vk::DeviceSize value, vk::DeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+TransientImageAllocator::Block::Block(
+    std::shared_ptr<const Allocator> allocator, VmaAllocation allocation,
+    vk::DeviceSize size, uint32_t memory_type)
+    : allocator{std::move(allocator)}
+    , allocation{allocation}
+    , size{size}
+    , memory_type{memory_type} {}
+
+TransientImageAllocator::Block::~Block() { allocator->free_memory(allocation); }
+
+std::optional<vk::DeviceSize> TransientImageAllocator::Block::find_offset(
+    const vk::MemoryRequirements &requirements,
+    ImageLifetime lifetime) const noexcept {
+    if ((requirements.memoryTypeBits & (1U << memory_type)) == 0) {
+        return std::nullopt;
+    }
+
+    // Candidates: the start of the block and the end of every image alive
+    // at the same time, tried from the lowest
+    std::vector<vk::DeviceSize> candidates{0};
+    for (const auto &placement : placements) {
+        if (placement.lifetime.overlaps(lifetime)) {
+            candidates.push_back(align_up(placement.offset + placement.size,
+                                          requirements.alignment));
+        }
+    }
+    std::ranges::sort(candidates);
+
+    for (auto offset : candidates) {
+        if (offset + requirements.size > size) {
+            break;
+        }
+        const bool free = std::ranges::none_of(placements, [&](auto &other) {
+            return other.lifetime.overlaps(lifetime) &&
+                   offset < other.offset + other.size &&
+                   other.offset < offset + requirements.size;
+        });
+        if (free) {
+            return offset;
+        }
+    }
+    return std::nullopt;
+}
+
+TransientImageAllocator::TransientImageAllocator(
+    std::shared_ptr<const Device> device,
+    std::shared_ptr<const Allocator> allocator)
+    : m_device{std::move(device)}
+    , m_allocator{std::move(allocator)} {}
+
+TransientImageAllocator::AliasedImage
+TransientImageAllocator::create_image(const GroupKey &group,
+                                      ImageLifetime lifetime,
+                                      vk::Format format,
+                                      vk::ImageUsageFlags usage) {
+    std::erase_if(m_groups, [&](const auto &entry) {
+        return entry.first.frame_index == group.frame_index &&
+               entry.first != group;
+    });
+    auto &blocks = m_groups[group];
+    std::erase_if(m_largest_images, [&](const auto &entry) {
+        return std::ranges::none_of(m_groups, [&](const auto &other) {
+            return entry.first ==
+                   std::pair(other.first.width, other.first.height);
+        });
+    });
+
+    const auto create_info =
+        vk::ImageCreateInfo()
+            .setExtent(vk::Extent3D(group.width, group.height, 1))
+            .setMipLevels(1)
+            .setArrayLayers(1)
+            .setInitialLayout(vk::ImageLayout::eUndefined)
+            .setImageType(vk::ImageType::e2D)
+            .setSamples(vk::SampleCountFlagBits::e1)
+            .setFormat(format)
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setUsage(usage);
+    const auto handle = check_vk(m_device->handle().createImage(create_info),
+                                 "Failed to create transient image");
+    auto image = std::make_unique<Image>(
+        handle, Width(group.width), Height(group.height), Depth(1),
+        MipLevel(1), format, usage, m_allocator, nullptr);
+
+    const auto requirements =
+        m_device->handle().getImageMemoryRequirements(handle);
+    auto &largest = m_largest_images[{group.width, group.height}];
+    largest = std::max(largest, requirements.size);
+
+    std::shared_ptr<Block> block;
+    vk::DeviceSize offset = 0;
+    for (const auto &candidate : blocks) {
+        if (auto found = candidate->find_offset(requirements, lifetime)) {
+            block = candidate;
+            offset = *found;
+            break;
+        }
+    }
+    if (!block) {
+        auto block_requirements = requirements;
+        block_requirements.size = largest;
+        const auto allocation = m_allocator->allocate_memory(
+            block_requirements, AllocationCategory::RenderTarget);
+        VmaAllocationInfo info{};
+        vmaGetAllocationInfo(m_allocator->handle(), allocation, &info);
+        block = blocks.emplace_back(std::make_shared<Block>(
+            m_allocator, allocation, largest, info.memoryType));
+    }
+
+    check_vma(vmaBindImageMemory2(m_allocator->handle(), block->allocation,
+                                  offset, handle, nullptr),
+              "Failed to bind transient image memory");
+    block->placements.push_back(Placement{.image = handle,
+                                          .offset = offset,
+                                          .size = requirements.size,
+                                          .lifetime = lifetime});
+
+    // The image gives its place back when destroyed
+    std::shared_ptr<const Image> shared(
+        image.release(),
+        [weak = std::weak_ptr<Block>(block), handle](const Image *image) {
+            if (auto owner = weak.lock()) {
+                std::erase_if(owner->placements, [&](const auto &placement) {
+                    return placement.image == handle;
+                });
+            }
+            delete image;
+        });
+    return {.image = std::move(shared), .memory = std::move(block)};
+}
+
+bool TransientImageAllocator::shares_memory(vk::Image image) const noexcept {
+    for (const auto &[key, blocks] : m_groups) {
+        for (const auto &block : blocks) {
+            const auto &placements = block->placements;
+            auto it = std::ranges::find(placements, image, &Placement::image);
+            if (it == placements.end()) {
+                continue;
+            }
+            return std::ranges::any_of(placements, [&](auto &other) {
+                return other.image != image &&
+                       other.offset < it->offset + it->size &&
+                       it->offset < other.offset + other.size;
+            });
+        }
+    }
+    return false;
+}
+
+TransientImageAllocator::Statistics
+TransientImageAllocator::statistics() const noexcept {
+    Statistics statistics;
+    for (const auto &[key, blocks] : m_groups) {
+        statistics.block_count += blocks.size();
+        for (const auto &block : blocks) {
+            statistics.allocated_bytes += block->size;
+            statistics.image_count += block->placements.size();
+            for (const auto &placement : block->placements) {
+                statistics.requested_bytes += placement.size;
+            }
+        }
+    }
+    return statistics;
+}
+
+} // namespace vw
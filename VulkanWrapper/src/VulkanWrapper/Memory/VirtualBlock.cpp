@@ -0,0 +1,74 @@
+#include "VulkanWrapper/Memory/VirtualBlock.h"
+
+#include "VulkanWrapper/Utils/Error.h"
+
+namespace vw {
+
+VirtualBlock::VirtualBlock(vk::DeviceSize size)
+    : m_size{size} {
+    VmaVirtualBlockCreateInfo info{};
+    info.size = size;
+    check_vma(vmaCreateVirtualBlock(&info, &m_block),
+              "Failed to create virtual block");
+}
+
+VirtualBlock::VirtualBlock(VirtualBlock &&other) noexcept
+    : m_block{std::exchange(other.m_block, VK_NULL_HANDLE)}
+    , m_size{other.m_size} {}
+
+VirtualBlock &VirtualBlock::operator=(VirtualBlock &&other) noexcept {
+    if (this != &other) {
+        if (m_block != VK_NULL_HANDLE) {
+            vmaClearVirtualBlock(m_block);
+            vmaDestroyVirtualBlock(m_block);
+        }
+        m_block = std::exchange(other.m_block, VK_NULL_HANDLE);
+        m_size = other.m_size;
+    }
+    return *this;
+}
+
+VirtualBlock::~VirtualBlock() {
+    if (m_block != VK_NULL_HANDLE) {
+        // Owners may drop the block with live ranges (e.g. on shutdown)
+        vmaClearVirtualBlock(m_block);
+        vmaDestroyVirtualBlock(m_block);
+    }
+}
+
+std::optional<VirtualBlock::Allocation>
+VirtualBlock::allocate(vk::DeviceSize size, vk::DeviceSize alignment) {
+    VmaVirtualAllocationCreateInfo info{};
+    info.size = size;
+    info.alignment = alignment;
+    info.flags = VMA_VIRTUAL_ALLOCATION_CREATE_STRATEGY_MIN_TIME_BIT;
+
+    Allocation allocation{};
+    if (vmaVirtualAllocate(m_block, &info, &allocation.handle,
+                           &allocation.offset) != VK_SUCCESS) {
+        return std::nullopt;
+    }
+    return allocation;
+}
+
+void VirtualBlock::free(VmaVirtualAllocation allocation) {
+    vmaVirtualFree(m_block, allocation);
+}
+
+void VirtualBlock::clear() { vmaClearVirtualBlock(m_block); }
+
+bool VirtualBlock::empty() const {
+    return vmaIsVirtualBlockEmpty(m_block) == VK_TRUE;
+}
+
+VirtualBlock::Statistics VirtualBlock::statistics() const {
+    VmaDetailedStatistics stats{};
+    vmaCalculateVirtualBlockStatistics(m_block, &stats);
+    return {.allocation_count = stats.statistics.allocationCount,
+            .used_size = stats.statistics.allocationBytes,
+            .free_region_count = stats.unusedRangeCount,
+            .largest_free_region =
+                stats.unusedRangeCount == 0 ? 0 : stats.unusedRangeSizeMax};
+}
+
+} // namespace vw
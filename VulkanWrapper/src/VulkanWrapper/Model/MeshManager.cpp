@@ -8,10 +8,10 @@
 namespace vw::Model {
 
 MeshManager::MeshManager(std::shared_ptr<const Device> device,
-                         std::shared_ptr<Allocator> allocator)
-    : m_staging_buffer_manager{std::make_shared<StagingBufferManager>(
-          device, allocator)}
-    , m_vertex_buffer{allocator}
+                         std::shared_ptr<Allocator> allocator, Queue &queue)
+    : m_allocator{allocator}
+    , m_staging_buffer_manager{std::make_shared<StagingBufferManager>(
+          device, allocator, queue)}
     , m_full_vertex_buffer{allocator}
     , m_index_buffer{allocator}
     , m_material_manager{device, allocator, m_staging_buffer_manager} {
@@ -23,14 +23,39 @@ MeshManager::MeshManager(std::shared_ptr<const Device> device,
     m_material_manager.register_handler<Material::ColoredMaterialHandler>();
 }
 
-void MeshManager::add_mesh(std::vector<FullVertex3D> vertices,
-                           std::vector<uint32_t> indices,
-                           Material::Material material) {
-    auto [full_vertex_buffer, vertex_offset] =
+std::shared_ptr<Vertex3DBuffer> MeshManager::position_buffer(
+    const FullVertexBufferList::BufferInfo &full_vertices) {
+    auto &buffer = m_position_buffers[full_vertices.buffer_id];
+    if (!buffer) {
+        buffer = std::make_shared<Vertex3DBuffer>(
+            create_buffer<Vertex3DBuffer>(*m_allocator,
+                                          full_vertices.buffer->size()));
+    }
+    return buffer;
+}
+
+MeshManager::MeshId
+MeshManager::add_mesh(std::vector<FullVertex3D> vertices,
+                      std::vector<uint32_t> indices,
+                      Material::Material material) {
+    // One vertex range serves both vertex buffers
+    auto vertex_allocation =
         m_full_vertex_buffer.create_buffer(vertices.size());
-    auto [index_buffer, first_index] =
-        m_index_buffer.create_buffer(indices.size());
-    auto vertex_buffer = m_vertex_buffer.create_buffer(vertices.size()).buffer;
+    IndexBufferList::BufferInfo index_allocation;
+    std::shared_ptr<Vertex3DBuffer> vertex_buffer;
+    try {
+        index_allocation = m_index_buffer.create_buffer(indices.size());
+        vertex_buffer = position_buffer(vertex_allocation);
+    } catch (...) {
+        m_full_vertex_buffer.release(vertex_allocation);
+        m_index_buffer.release(index_allocation);
+        throw;
+    }
+
+    const auto &full_vertex_buffer = vertex_allocation.buffer;
+    const auto &index_buffer = index_allocation.buffer;
+    const auto vertex_offset = vertex_allocation.offset;
+    const auto first_index = index_allocation.offset;
 
     auto position_vertices = vertices |
                              std::views::transform([](const FullVertex3D &v) {
@@ -38,9 +63,12 @@ void MeshManager::add_mesh(std::vector<FullVertex3D> vertices,
                              }) |
                              std::ranges::to<std::vector>();
 
+    const MeshId id = m_mesh_indices.size();
     m_meshes.emplace_back(vertex_buffer, full_vertex_buffer, index_buffer,
                           material, indices.size(), vertex_offset, first_index,
                           position_vertices.size());
+    m_allocations.push_back({id, vertex_allocation, index_allocation});
+    m_mesh_indices.push_back(m_meshes.size() - 1);
 
     m_staging_buffer_manager->fill_buffer<Vertex3D>(
         position_vertices, *vertex_buffer, vertex_offset);
@@ -48,6 +76,32 @@ void MeshManager::add_mesh(std::vector<FullVertex3D> vertices,
         vertices, *full_vertex_buffer, vertex_offset);
     m_staging_buffer_manager->fill_buffer<uint32_t>(indices, *index_buffer,
                                                     first_index);
+    return id;
+}
+
+std::size_t MeshManager::mesh_index(MeshId id) const {
+    if (id >= m_mesh_indices.size() || m_mesh_indices[id] == no_mesh) {
+        throw LogicException::out_of_range("mesh", id, m_mesh_indices.size());
+    }
+    return m_mesh_indices[id];
+}
+
+void MeshManager::remove_mesh(MeshId id) {
+    const auto index = mesh_index(id);
+    const auto &allocation = m_allocations[index];
+    m_full_vertex_buffer.release(allocation.vertices);
+    m_index_buffer.release(allocation.indices);
+    m_mesh_indices[id] = no_mesh;
+
+    // The last mesh fills the hole
+    const auto last = m_meshes.size() - 1;
+    if (index != last) {
+        m_meshes[index] = std::move(m_meshes[last]);
+        m_allocations[index] = std::move(m_allocations[last]);
+        m_mesh_indices[m_allocations[index].id] = index;
+    }
+    m_meshes.pop_back();
+    m_allocations.pop_back();
 }
 
 void MeshManager::read_file(const std::filesystem::path &path) {
@@ -59,6 +113,10 @@ vk::CommandBuffer MeshManager::fill_command_buffer() {
     return m_staging_buffer_manager->fill_command_buffer();
 }
 
+void MeshManager::release_staging_memory() {
+    m_staging_buffer_manager->release_staging_memory();
+}
+
 const std::vector<Mesh> &MeshManager::meshes() const noexcept {
     return m_meshes;
 }
@@ -44,7 +44,9 @@ BottomLevelAccelerationStructureList::AccelerationStructureBufferList::
 BottomLevelAccelerationStructureList::ScratchBufferList::BufferInfo
 BottomLevelAccelerationStructureList::allocate_scratch_buffer(
     vk::DeviceSize size) {
-    return m_scratch_buffer_list.create_buffer(size);
+    auto info = m_scratch_buffer_list.create_buffer(size);
+    m_pending_scratch_buffers.push_back(info);
+    return info;
 }
 
 BottomLevelAccelerationStructure &BottomLevelAccelerationStructureList::add(
@@ -73,6 +75,13 @@ void BottomLevelAccelerationStructureList::submit_and_wait() {
     queue.enqueue_command_buffer(m_command_buffer);
     queue.submit({}, {}, {});
     m_device->wait_idle();
+
+    // Scratch memory is only needed while the builds execute
+    for (const auto &scratch : m_pending_scratch_buffers) {
+        m_scratch_buffer_list.release(scratch);
+    }
+    m_pending_scratch_buffers.clear();
+    m_scratch_buffer_list.trim();
 }
 
 BottomLevelAccelerationStructureBuilder::
@@ -4,7 +4,9 @@
 #include "VulkanWrapper/Memory/AllocateBufferUtils.h"
 #include "VulkanWrapper/Model/Mesh.h"
 #include "VulkanWrapper/Synchronization/Fence.h"
+#include "VulkanWrapper/Synchronization/FrameContext.h"
 #include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Utils/Trace.h"
 #include "VulkanWrapper/Vulkan/Device.h"
 #include "VulkanWrapper/Vulkan/Queue.h"
 #include <algorithm>
@@ -302,9 +304,21 @@ void RayTracedScene::build_blas() {
     m_blas_list->submit_and_wait();
 }
 
+void RayTracedScene::set_frame_context(
+    std::shared_ptr<FrameContext> frames) {
+    m_frames = std::move(frames);
+}
+
 void RayTracedScene::build_tlas() {
+    VW_TRACE_ZONE("RayTracedScene::build_tlas");
     if (m_tlas.has_value()) {
-        m_device->wait_idle();
+        if (m_frames) {
+            m_frames->defer_destruction(
+                std::make_shared<as::TopLevelAccelerationStructure>(
+                    std::move(*m_tlas)));
+        } else {
+            m_device->wait_idle();
+        }
         m_tlas.reset();
     }
 
@@ -348,8 +362,7 @@ void RayTracedScene::build_tlas() {
 
     auto &queue = const_cast<Device &>(*m_device).graphicsQueue();
     queue.enqueue_command_buffer(command_buffer);
-    queue.submit({}, {}, {});
-    m_device->wait_idle();
+    queue.submit_enqueued().wait();
 }
 
 void RayTracedScene::build_geometry_buffer() {
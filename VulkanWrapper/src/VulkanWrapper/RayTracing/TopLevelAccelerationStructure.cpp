@@ -18,6 +18,11 @@ TopLevelAccelerationStructure::device_address() const noexcept {
     return m_device_address;
 }
 
+const AccelerationStructureBuffer &
+TopLevelAccelerationStructure::buffer() const noexcept {
+    return m_buffer;
+}
+
 TopLevelAccelerationStructureBuilder::TopLevelAccelerationStructureBuilder(
     std::shared_ptr<const Device> device,
     std::shared_ptr<const Allocator> allocator)
@@ -98,6 +98,12 @@ AmbientOcclusionPass::output_slots() const {
     return {Slot::AmbientOcclusion};
 }
 
+std::vector<Slot>
+AmbientOcclusionPass::persistent_slots() const {
+    // Samples accumulate across frames
+    return {Slot::AmbientOcclusion};
+}
+
 void AmbientOcclusionPass::execute(
     vk::CommandBuffer cmd,
     Barrier::ResourceTracker &tracker, Width width,
@@ -105,7 +111,8 @@ void AmbientOcclusionPass::execute(
 
     // Get input views from predecessor passes
     auto depth_view = get_input(Slot::Depth).view;
-    auto position_view = get_input(Slot::Position).view;
+    const auto &position = get_input(Slot::Position);
+    auto position_view = position.view;
     auto normal_view = get_input(Slot::Normal).view;
     auto tangent_view = get_input(Slot::Tangent).view;
     auto bitangent_view =
@@ -233,7 +240,8 @@ void AmbientOcclusionPass::execute(
     PushConstants constants{
         .aoRadius = m_ao_radius,
         .sampleIndex = static_cast<int32_t>(
-            m_frame_count % DUAL_SAMPLE_COUNT)};
+            m_frame_count % DUAL_SAMPLE_COUNT),
+        .inputUvScale = position.uv_scale()};
 
     // Set blend constants for progressive accumulation
     // blend_factor = 1/(frameCount+1) gives equal weight
@@ -1,5 +1,6 @@
 #include "VulkanWrapper/RenderPass/DirectLightPass.h"
 
+#include "VulkanWrapper/Command/ParallelCommandRecorder.h"
 #include "VulkanWrapper/Descriptors/DescriptorAllocator.h"
 #include "VulkanWrapper/Descriptors/Vertex.h"
 #include "VulkanWrapper/Memory/Buffer.h"
@@ -11,6 +12,7 @@
 #include "VulkanWrapper/RayTracing/RayTracedScene.h"
 #include "VulkanWrapper/Shader/ShaderCompiler.h"
 #include "VulkanWrapper/Synchronization/ResourceTracker.h"
+#include "VulkanWrapper/Utils/Trace.h"
 
 #include <cassert>
 #include <glm/glm.hpp>
@@ -172,6 +174,11 @@ void DirectLightPass::set_frame_count(uint32_t count) {
     m_frame_count = count;
 }
 
+void DirectLightPass::set_parallel_recorder(
+    std::shared_ptr<ParallelCommandRecorder> recorder) {
+    m_recorder = std::move(recorder);
+}
+
 void DirectLightPass::execute(
     vk::CommandBuffer cmd,
     Barrier::ResourceTracker &tracker,
@@ -218,9 +225,9 @@ void DirectLightPass::execute(
     vk::Extent2D extent{static_cast<uint32_t>(width),
                         static_cast<uint32_t>(height)};
 
-    // Write sky parameters to UBO
-    auto sky_gpu = m_sky_params.to_gpu();
-    m_sky_params_buffer.write(std::span(&sky_gpu, 1), 0);
+    // Write sky parameters directly into the mapped UBO
+    m_sky_params_buffer.as_span()[0] = m_sky_params.to_gpu();
+    m_sky_params_buffer.flush(0, 1);
 
     // Create descriptor set
     DescriptorAllocator descriptor_allocator;
@@ -266,6 +273,18 @@ void DirectLightPass::execute(
         tracker.request(resource);
     }
 
+    // Takes the TLAS back from an async compute pass tracing it,
+    // e.g. IndirectLightPass, before this pass and
+    // AmbientOcclusionPass query it
+    const auto &tlas_buffer = m_ray_traced_scene->tlas().buffer();
+    tracker.request(Barrier::BufferState{
+        .buffer = tlas_buffer.handle(),
+        .offset = 0,
+        .size = tlas_buffer.size_bytes(),
+        .stage = vk::PipelineStageFlagBits2::eFragmentShader,
+        .access =
+            vk::AccessFlagBits2::eAccelerationStructureReadKHR});
+
     // Request states for all output images
     std::array<const CachedImage *, 7> cached_images = {
         &albedo,   &normal,       &tangent,
@@ -346,17 +365,6 @@ void DirectLightPass::execute(
             .setColorAttachments(color_attachments)
             .setPDepthAttachment(&depth_attachment);
 
-    cmd.beginRendering(rendering_info);
-
-    // Set viewport and scissor
-    vk::Viewport viewport(
-        0.0f, 0.0f,
-        static_cast<float>(extent.width),
-        static_cast<float>(extent.height), 0.0f, 1.0f);
-    vk::Rect2D scissor({0, 0}, extent);
-    cmd.setViewport(0, 1, &viewport);
-    cmd.setScissor(0, 1, &scissor);
-
     // Bind uniform buffer descriptor set (set 0)
     auto uniform_descriptor_handle =
         descriptor_set.handle();
@@ -370,12 +378,68 @@ void DirectLightPass::execute(
             break;
     }
 
+    const auto &instances =
+        m_ray_traced_scene->scene().instances();
+
+    if (!m_recorder) {
+        cmd.beginRendering(rendering_info);
+        record_draws(cmd, uniform_descriptor_handle,
+                     texture_ds, extent, instances);
+        cmd.endRendering();
+        return;
+    }
+
+    rendering_info.setFlags(
+        vk::RenderingFlagBits::eContentsSecondaryCommandBuffers);
+    std::array color_formats = {
+        m_formats.albedo,       m_formats.normal,
+        m_formats.tangent,      m_formats.bitangent,
+        m_formats.position,     m_formats.direct_light,
+        m_formats.indirect_ray};
+    const auto inheritance =
+        vk::CommandBufferInheritanceRenderingInfo()
+            .setColorAttachmentFormats(color_formats)
+            .setDepthAttachmentFormat(m_formats.depth)
+            .setRasterizationSamples(
+                vk::SampleCountFlagBits::e1);
+    auto secondaries = m_recorder->record(
+        inheritance, instances.size(),
+        [&](vk::CommandBuffer secondary, std::size_t first,
+            std::size_t last) {
+            record_draws(secondary, uniform_descriptor_handle,
+                         texture_ds, extent,
+                         std::span(instances).subspan(
+                             first, last - first));
+        });
+
+    cmd.beginRendering(rendering_info);
+    if (!secondaries.empty()) {
+        cmd.executeCommands(secondaries);
+    }
+    cmd.endRendering();
+}
+
+void DirectLightPass::record_draws(
+    vk::CommandBuffer cmd,
+    vk::DescriptorSet uniform_descriptor_handle,
+    std::optional<vk::DescriptorSet> texture_ds,
+    vk::Extent2D extent,
+    std::span<const Model::MeshInstance> instances) const {
+    VW_TRACE_ZONE("DirectLightPass::record_draws");
+    // Set viewport and scissor
+    vk::Viewport viewport(
+        0.0f, 0.0f,
+        static_cast<float>(extent.width),
+        static_cast<float>(extent.height), 0.0f, 1.0f);
+    vk::Rect2D scissor({0, 0}, extent);
+    cmd.setViewport(0, 1, &viewport);
+    cmd.setScissor(0, 1, &scissor);
+
     // Draw all mesh instances grouped by material type
     Model::Material::MaterialTypeTag current_tag{
         0xFFFFFFFF};
 
-    const auto &scene = m_ray_traced_scene->scene();
-    for (const auto &instance : scene.instances()) {
+    for (const auto &instance : instances) {
         auto material_type =
             instance.mesh.material_type_tag();
 
@@ -427,8 +491,6 @@ void DirectLightPass::execute(
                 instance.transform);
         }
     }
-
-    cmd.endRendering();
 }
 
 } // namespace vw
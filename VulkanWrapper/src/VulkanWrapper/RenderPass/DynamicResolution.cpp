@@ -0,0 +1,70 @@
+#include "VulkanWrapper/RenderPass/DynamicResolution.h"
+
+#include "VulkanWrapper/Utils/Error.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vw {
+
+DynamicResolution::DynamicResolution(double budget_ms, float min_scale,
+                                     float max_scale)
+    : m_budget_ms(budget_ms)
+    , m_min_scale(min_scale)
+    , m_max_scale(max_scale)
+    , m_scale(max_scale) {
+    if (!(min_scale > 0.0f && min_scale <= max_scale &&
+          max_scale <= 1.0f)) {
+        throw LogicException::invalid_state(
+            "Dynamic resolution needs 0 < min_scale <= "
+            "max_scale <= 1");
+    }
+    set_budget_ms(budget_ms);
+}
+
+void DynamicResolution::set_budget_ms(double budget_ms) {
+    if (!(budget_ms > 0.0)) {
+        throw LogicException::invalid_state(
+            "Dynamic resolution needs a positive frame budget");
+    }
+    m_budget_ms = budget_ms;
+}
+
+float DynamicResolution::update(double frame_ms) {
+    m_average_ms = m_average_ms == 0.0
+                       ? frame_ms
+                       : m_average_ms +
+                             smoothing * (frame_ms - m_average_ms);
+
+    const double lowest_ms = m_budget_ms * (1.0 - headroom);
+    if (m_average_ms >= lowest_ms && m_average_ms <= m_budget_ms) {
+        return m_scale;
+    }
+
+    // The cost follows the pixel count
+    const auto wanted =
+        m_average_ms > 0.0
+            ? static_cast<float>(m_scale *
+                                 std::sqrt(lowest_ms / m_average_ms))
+            : m_max_scale;
+    const auto stepped =
+        std::clamp(wanted, m_scale - max_step, m_scale + max_step);
+
+    // Move by at least one step, unless at a bound
+    auto quantized = std::round(stepped / scale_step) * scale_step;
+    if (quantized == m_scale) {
+        quantized += wanted > m_scale ? scale_step : -scale_step;
+    }
+    const auto scale = std::clamp(quantized, m_min_scale, m_max_scale);
+
+    // Expected cost at the new scale, so that the frames still
+    // rendered at the old one do not push it further
+    if (m_average_ms > 0.0) {
+        const auto ratio = static_cast<double>(scale) / m_scale;
+        m_average_ms *= ratio * ratio;
+    }
+    m_scale = scale;
+    return m_scale;
+}
+
+} // namespace vw
@@ -143,7 +143,8 @@ void IndirectLightPass::execute(
     Width width, Height height, size_t /*frame_index*/) {
 
     // Get input views from wired slots
-    auto position_view = get_input(Slot::Position).view;
+    const auto &position = get_input(Slot::Position);
+    auto position_view = position.view;
     auto normal_view = get_input(Slot::Normal).view;
     auto albedo_view = get_input(Slot::Albedo).view;
     auto ao_view = get_input(Slot::AmbientOcclusion).view;
@@ -238,6 +239,17 @@ void IndirectLightPass::execute(
         tracker.request(resource);
     }
 
+    // The TLAS descriptor only gets a memory barrier: request the
+    // buffer backing it too, for its queue family ownership
+    const auto &tlas_buffer = m_tlas->buffer();
+    tracker.request(Barrier::BufferState{
+        .buffer = tlas_buffer.handle(),
+        .offset = 0,
+        .size = tlas_buffer.size_bytes(),
+        .stage = vk::PipelineStageFlagBits2::eRayTracingShaderKHR,
+        .access =
+            vk::AccessFlagBits2::eAccelerationStructureReadKHR});
+
     // Track texture resources for per-material hit shaders
     for (const auto &resource :
          m_material_manager->texture_manager()
@@ -277,12 +289,14 @@ void IndirectLightPass::execute(
         vk::PipelineBindPoint::eRayTracingKHR,
         m_pipeline->handle_layout(), 0, desc_sets, {});
 
-    // Push constants
+    // Push constants. The G-buffer is sampled over its whole
+    // image, of which the launch covers the top-left area.
+    const auto gbuffer_size = position.image->extent2D();
     IndirectLightPushConstants constants{
         .sky = m_sky_params.to_gpu(),
         .frame_count = m_frame_count,
-        .width = static_cast<uint32_t>(width),
-        .height = static_cast<uint32_t>(height)};
+        .width = gbuffer_size.width,
+        .height = gbuffer_size.height};
 
     constexpr auto rt_stages =
         vk::ShaderStageFlagBits::eRaygenKHR |
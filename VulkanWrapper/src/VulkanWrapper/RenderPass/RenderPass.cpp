@@ -1,5 +1,7 @@
 #include "VulkanWrapper/RenderPass/RenderPass.h"
 
+#include "VulkanWrapper/Synchronization/ResourceTracker.h"
+#include <iterator>
 #include <stdexcept>
 
 namespace vw {
@@ -9,6 +11,14 @@ RenderPass::RenderPass(std::shared_ptr<Device> device,
     : m_device(std::move(device))
     , m_allocator(std::move(allocator)) {}
 
+RenderPass::~RenderPass() {
+    for (const auto &[key, entry] : m_image_cache) {
+        if (entry.pool) {
+            entry.pool->release(entry.cached.image);
+        }
+    }
+}
+
 const CachedImage &
 RenderPass::get_or_create_image(Slot slot, Width width, Height height,
                                 size_t frame_index, vk::Format format,
@@ -17,48 +27,139 @@ RenderPass::get_or_create_image(Slot slot, Width width, Height height,
                  static_cast<uint32_t>(height), frame_index};
 
     // Check if image already exists
+    m_latest_keys.insert_or_assign(slot, key);
+
     auto it = m_image_cache.find(key);
     if (it != m_image_cache.end()) {
-        return it->second;
+        discard_if_aliased(it->second.cached);
+        return it->second.cached;
     }
 
-    // Remove images with different dimensions to avoid memory overhead
-    std::erase_if(m_image_cache, [&](const auto &entry) {
-        return entry.first.slot == slot &&
-               (entry.first.width != key.width ||
-                entry.first.height != key.height);
+    // Remove the image of this frame index with different dimensions
+    // to avoid memory overhead: the previous frame with this index is
+    // done with it. Other frame indices may still be in flight and
+    // resize when they come back. Pooled images whose size bucket
+    // still fits only need a new extent.
+    std::vector<std::pair<ImageKey, CacheEntry>> resized;
+    std::erase_if(m_image_cache, [&](auto &entry) {
+        auto &[other_key, other] = entry;
+        if (other_key.slot != slot ||
+            other_key.frame_index != frame_index ||
+            (other_key.width == key.width &&
+             other_key.height == key.height)) {
+            return false;
+        }
+        const auto &image = *other.cached.image;
+        if (other.pool && other.pool == m_render_targets &&
+            image.extent2D() == other.pool->bucket(width, height) &&
+            image.format() == format && image.usage() == usage) {
+            other.cached.extent = vk::Extent2D{key.width, key.height};
+            resized.emplace_back(key, std::move(other));
+        } else if (other.pool) {
+            other.pool->release(other.cached.image);
+        }
+        return true;
     });
+    m_image_cache.insert(std::make_move_iterator(resized.begin()),
+                         std::make_move_iterator(resized.end()));
 
-    // Create new image
-    auto image =
-        m_allocator->create_image_2D(width, height, false, format, usage);
+    auto inserted_it = m_image_cache.find(key);
+    if (inserted_it == m_image_cache.end()) {
+        inserted_it =
+            m_image_cache
+                .emplace(key, create_image(slot, width, height,
+                                           frame_index, format, usage))
+                .first;
+    }
+
+    discard_if_aliased(inserted_it->second.cached);
+    return inserted_it->second.cached;
+}
+
+RenderPass::CacheEntry
+RenderPass::create_image(Slot slot, Width width, Height height,
+                         size_t frame_index, vk::Format format,
+                         vk::ImageUsageFlags usage) {
+    std::shared_ptr<const Image> image;
+    std::shared_ptr<const void> memory;
+
+    const ImageLifetime *lifetime = nullptr;
+    if (m_transient.allocator && m_transient.lifetimes) {
+        auto it = m_transient.lifetimes->find(slot);
+        if (it != m_transient.lifetimes->end()) {
+            lifetime = &it->second;
+        }
+    }
+
+    if (lifetime) {
+        auto aliased = m_transient.allocator->create_image(
+            {frame_index, static_cast<uint32_t>(width),
+             static_cast<uint32_t>(height)},
+            *lifetime, format, usage);
+        image = std::move(aliased.image);
+        memory = std::move(aliased.memory);
+    } else if (m_render_targets) {
+        auto target =
+            m_render_targets->acquire(format, usage, width, height);
+        return {{std::move(target.image), std::move(target.view),
+                 nullptr, target.extent},
+                m_render_targets};
+    } else {
+        image = m_allocator->create_image_2D(width, height, false,
+                                             format, usage);
+    }
 
     auto view = ImageViewBuilder(m_device, image)
                     .setImageType(vk::ImageViewType::e2D)
                     .build();
 
-    auto [inserted_it, success] = m_image_cache.emplace(
-        key, CachedImage{std::move(image), std::move(view)});
+    return {{std::move(image), std::move(view), std::move(memory)},
+            nullptr};
+}
 
-    return inserted_it->second;
+void RenderPass::discard_if_aliased(const CachedImage &cached) {
+    if (!cached.memory || !m_transient.tracker ||
+        !m_transient.allocator->shares_memory(
+            cached.image->handle())) {
+        return;
+    }
+    // Another image used the memory since the last frame: drop the
+    // content and wait for every earlier access before the first
+    // write, which also covers the other image's last reads
+    m_transient.tracker->track(Barrier::ImageState{
+        .image = cached.image->handle(),
+        .subresourceRange = cached.image->full_range(),
+        .layout = vk::ImageLayout::eUndefined,
+        .stage = vk::PipelineStageFlagBits2::eAllCommands,
+        .access = vk::AccessFlagBits2::eMemoryRead |
+                  vk::AccessFlagBits2::eMemoryWrite});
 }
 
 std::vector<std::pair<Slot, CachedImage>>
 RenderPass::result_images() const {
-    // Collect unique slots, returning the most recent entry per slot
-    std::map<Slot, CachedImage> per_slot;
-    for (const auto &[key, cached] : m_image_cache) {
-        per_slot.insert_or_assign(key.slot, cached);
-    }
-
+    // The most recent entry per slot
     std::vector<std::pair<Slot, CachedImage>> result;
-    result.reserve(per_slot.size());
-    for (auto &[slot, cached] : per_slot) {
-        result.emplace_back(slot, std::move(cached));
+    result.reserve(m_latest_keys.size());
+    for (const auto &[slot, key] : m_latest_keys) {
+        result.emplace_back(slot, m_image_cache.at(key).cached);
     }
     return result;
 }
 
+const CachedImage *RenderPass::result_image(Slot slot) const {
+    // Same entry as result_images()
+    auto it = m_latest_keys.find(slot);
+    if (it == m_latest_keys.end()) {
+        return nullptr;
+    }
+    return &m_image_cache.at(it->second).cached;
+}
+
+void RenderPass::set_render_target_pool(
+    std::shared_ptr<RenderTargetPool> pool) {
+    m_render_targets = std::move(pool);
+}
+
 void RenderPass::set_input(Slot slot, CachedImage image) {
     m_inputs.insert_or_assign(slot, std::move(image));
 }
@@ -1,6 +1,14 @@
 #include "VulkanWrapper/RenderPass/RenderPipeline.h"
 
+#include "VulkanWrapper/Command/GpuProfiler.h"
+#include "VulkanWrapper/Synchronization/ResourceTracker.h"
+#include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Utils/Trace.h"
+
+#include <algorithm>
+#include <cmath>
 #include <map>
+#include <optional>
 #include <set>
 #include <string>
 
@@ -32,6 +40,8 @@ std::string slot_to_string(Slot slot) {
         return "Sky";
     case Slot::IndirectLight:
         return "IndirectLight";
+    case Slot::Upscaled:
+        return "Upscaled";
     case Slot::ToneMapped:
         return "ToneMapped";
     default:
@@ -40,6 +50,11 @@ std::string slot_to_string(Slot slot) {
     }
 }
 
+// Index of a queue in AsyncCompute::queues and frames
+size_t queue_index(PassQueue queue) {
+    return queue == PassQueue::Graphics ? 0 : 1;
+}
+
 } // namespace
 
 RenderPipeline::ValidationResult
@@ -69,28 +84,550 @@ RenderPipeline::validate() const {
     return {errors.empty(), std::move(errors)};
 }
 
+const RenderPipeline::PassGraph &RenderPipeline::graph() const {
+    return compiled().graph;
+}
+
+const RenderPipeline::Compiled &RenderPipeline::compiled() const {
+    if (m_compiled) {
+        return *m_compiled;
+    }
+
+    Compiled compiled{.graph = compile_graph()};
+    compiled.segments = compile_segments(compiled.graph);
+
+    std::map<Slot, size_t> dense;
+    const auto index_of = [&](Slot slot) {
+        return std::pair{slot,
+                         dense.try_emplace(slot, dense.size())
+                             .first->second};
+    };
+    compiled.slots.reserve(m_passes.size());
+    for (const auto &pass : m_passes) {
+        auto &slots = compiled.slots.emplace_back();
+        for (auto slot : pass->input_slots()) {
+            slots.inputs.push_back(index_of(slot));
+        }
+        for (auto slot : pass->output_slots()) {
+            slots.outputs.push_back(index_of(slot));
+        }
+    }
+    compiled.slot_count = dense.size();
+
+    for (const auto &[slot, lifetime] :
+         slot_lifetimes(compiled.graph)) {
+        if (lifetime.transient) {
+            compiled.transient_lifetimes.emplace(slot,
+                                                 lifetime.passes);
+        }
+    }
+
+    return m_compiled.emplace(std::move(compiled));
+}
+
+RenderPipeline::PassGraph RenderPipeline::compile_graph() const {
+    const auto count = m_passes.size();
+    PassGraph graph;
+    graph.dependencies.resize(count);
+    graph.culled.assign(count, true);
+
+    // Producers of the inputs of each pass, which keep it alive
+    std::vector<std::vector<size_t>> producers(count);
+    std::map<Slot, size_t> last_producer;
+    std::map<Slot, std::vector<size_t>> readers;
+    // Inputs without an earlier producer read the previous frame's
+    // content, left by the last producer of the slot
+    std::vector<std::pair<size_t, Slot>> previous_frame_reads;
+
+    const auto depend = [&](size_t pass, size_t on) {
+        auto &dependencies = graph.dependencies[pass];
+        if (on != pass &&
+            std::ranges::find(dependencies, on) == dependencies.end()) {
+            dependencies.push_back(on);
+        }
+    };
+
+    for (size_t i = 0; i < count; ++i) {
+        const auto &pass = *m_passes[i];
+        for (auto slot : pass.input_slots()) {
+            if (auto it = last_producer.find(slot);
+                it != last_producer.end() && it->second != i) {
+                depend(i, it->second);
+                producers[i].push_back(it->second);
+            } else if (it == last_producer.end()) {
+                previous_frame_reads.emplace_back(i, slot);
+            }
+            readers[slot].push_back(i);
+        }
+
+        // Overwriting a slot waits for its previous uses
+        for (auto slot : pass.output_slots()) {
+            if (auto it = last_producer.find(slot);
+                it != last_producer.end()) {
+                depend(i, it->second);
+            }
+            for (auto reader : readers[slot]) {
+                depend(i, reader);
+            }
+            readers[slot].clear();
+            last_producer[slot] = i;
+        }
+    }
+
+    for (auto [pass, slot] : previous_frame_reads) {
+        if (auto it = last_producer.find(slot);
+            it != last_producer.end() && it->second != pass) {
+            producers[pass].push_back(it->second);
+        }
+    }
+
+    // Walk back from the outputs of the pipeline
+    std::vector<size_t> live;
+    const auto keep = [&](size_t pass) {
+        if (graph.culled[pass]) {
+            graph.culled[pass] = false;
+            live.push_back(pass);
+        }
+    };
+    for (size_t i = 0; i < count; ++i) {
+        if (m_passes[i]->output_slots().empty()) {
+            keep(i);
+        }
+    }
+    if (count != 0) {
+        keep(count - 1);
+    }
+    for (auto slot : m_external_slots) {
+        if (auto it = last_producer.find(slot);
+            it != last_producer.end()) {
+            keep(it->second);
+        }
+    }
+    for (size_t i = 0; i < live.size(); ++i) {
+        for (auto producer : producers[live[i]]) {
+            keep(producer);
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (graph.culled[i]) {
+            graph.dependencies[i].clear();
+        } else {
+            std::erase_if(graph.dependencies[i], [&](size_t pass) {
+                return graph.culled[pass];
+            });
+        }
+    }
+
+    // Dependencies always come earlier in insertion order, so a
+    // pass is always ready
+    std::vector<size_t> position(count, count);
+    while (graph.order.size() < live.size()) {
+        std::optional<size_t> best;
+        size_t best_latest = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (graph.culled[i] || position[i] != count) {
+                continue;
+            }
+            // One past the position of the latest dependency
+            size_t latest = 0;
+            bool ready = true;
+            for (auto dependency : graph.dependencies[i]) {
+                if (position[dependency] == count) {
+                    ready = false;
+                    break;
+                }
+                latest = std::max(latest, position[dependency] + 1);
+            }
+            if (ready && (!best || latest < best_latest)) {
+                best = i;
+                best_latest = latest;
+            }
+        }
+        position[*best] = graph.order.size();
+        graph.order.push_back(*best);
+    }
+
+    return graph;
+}
+
+const std::vector<RenderPipeline::QueueSegment> &
+RenderPipeline::queue_segments() const {
+    return compiled().segments;
+}
+
+std::vector<RenderPipeline::QueueSegment>
+RenderPipeline::compile_segments(const PassGraph &graph) const {
+    const auto count = m_passes.size();
+    constexpr auto none = static_cast<size_t>(-1);
+
+    // Outputs read after the pipeline stay on the graphics queue
+    std::vector<PassQueue> queue(count, PassQueue::Graphics);
+    std::map<Slot, size_t> last_producer;
+    for (size_t i = 0; i < count; ++i) {
+        for (auto slot : m_passes[i]->output_slots()) {
+            last_producer[slot] = i;
+        }
+    }
+    for (size_t i = 0; i + 1 < count; ++i) {
+        queue[i] = m_passes[i]->preferred_queue();
+    }
+    for (auto slot : m_external_slots) {
+        if (auto it = last_producer.find(slot);
+            it != last_producer.end()) {
+            queue[it->second] = PassQueue::Graphics;
+        }
+    }
+
+    std::vector<QueueSegment> segments;
+    // Segment being filled on each queue, not yet submitted
+    std::array<std::optional<QueueSegment>, 2> open;
+    std::vector<size_t> segment_of(count, none);
+    const auto close = [&](size_t q) {
+        if (!open[q]) {
+            return;
+        }
+        for (auto pass : open[q]->passes) {
+            segment_of[pass] = segments.size();
+        }
+        segments.push_back(std::move(*open[q]));
+        open[q].reset();
+    };
+
+    for (auto pass : graph.order) {
+        const auto q = queue_index(queue[pass]);
+        const auto other = 1 - q;
+
+        // The other queue submits what this pass waits for
+        std::optional<size_t> wait;
+        for (auto dependency : graph.dependencies[pass]) {
+            if (queue_index(queue[dependency]) != other) {
+                continue;
+            }
+            if (segment_of[dependency] == none) {
+                close(other);
+            }
+            wait = std::max(wait.value_or(0), segment_of[dependency]);
+        }
+
+        if (wait && open[q] &&
+            (open[q]->waits.empty() || open[q]->waits.back() < *wait)) {
+            close(q);
+        }
+        if (!open[q]) {
+            open[q] = QueueSegment{.queue = queue[pass]};
+            if (wait) {
+                open[q]->waits.push_back(*wait);
+            }
+        }
+        open[q]->passes.push_back(pass);
+    }
+
+    // The frame completes with the last graphics segment
+    const auto compute = queue_index(PassQueue::Compute);
+    const auto graphics = queue_index(PassQueue::Graphics);
+    if (open[compute]) {
+        close(compute);
+        if (!open[graphics]) {
+            open[graphics] = QueueSegment{.queue = PassQueue::Graphics};
+        }
+        open[graphics]->waits.push_back(segments.size() - 1);
+    }
+    close(graphics);
+    return segments;
+}
+
+std::map<Slot, RenderPipeline::SlotLifetime>
+RenderPipeline::slot_lifetimes() const {
+    return slot_lifetimes(graph());
+}
+
+std::map<Slot, RenderPipeline::SlotLifetime>
+RenderPipeline::slot_lifetimes(const PassGraph &graph) const {
+    std::map<Slot, SlotLifetime> lifetimes;
+
+    const auto &order = graph.order;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const auto &pass = *m_passes[order[i]];
+
+        for (auto slot : pass.input_slots()) {
+            auto it = lifetimes.find(slot);
+            if (it != lifetimes.end()) {
+                it->second.passes.last = i;
+            }
+        }
+
+        const auto inputs = pass.input_slots();
+        for (auto slot : pass.output_slots()) {
+            // Read by its producer: the previous frame's content
+            // matters
+            const bool read_back =
+                std::ranges::find(inputs, slot) != inputs.end();
+            auto [it, inserted] = lifetimes.try_emplace(
+                slot, SlotLifetime{{i, i}, !read_back});
+            if (!inserted) {
+                it->second.transient = false;
+            }
+        }
+
+        for (auto slot : pass.persistent_slots()) {
+            if (auto it = lifetimes.find(slot); it != lifetimes.end()) {
+                it->second.transient = false;
+            }
+        }
+    }
+
+    for (auto &[slot, lifetime] : lifetimes) {
+        if (m_external_slots.contains(slot) ||
+            lifetime.passes.last == lifetime.passes.first) {
+            lifetime.transient = false;
+        }
+    }
+    return lifetimes;
+}
+
+void RenderPipeline::enable_transient_aliasing() {
+    m_transient_aliasing = true;
+}
+
+void RenderPipeline::mark_external(Slot slot) {
+    m_external_slots.insert(slot);
+    m_compiled.reset();
+}
+
+void RenderPipeline::release_after_producer(
+    Slot slot, vk::ImageLayout layout, vk::PipelineStageFlags2 stage,
+    vk::AccessFlags2 access) {
+    m_released_slots.insert_or_assign(
+        slot, ReleasedState{layout, stage, access});
+}
+
+void RenderPipeline::use_render_target_pool(
+    std::shared_ptr<RenderTargetPool> pool) {
+    m_render_targets = std::move(pool);
+    for (auto &pass : m_passes) {
+        pass->set_render_target_pool(m_render_targets);
+    }
+}
+
+void RenderPipeline::use_gpu_profiler(
+    std::shared_ptr<GpuProfiler> profiler) {
+    m_profiler = std::move(profiler);
+}
+
+vk::CommandBuffer RenderPipeline::QueueCommands::next() {
+    if (used == buffers.size()) {
+        buffers.push_back(pool.allocate(1)[0]);
+    }
+    return buffers[used++];
+}
+
+void RenderPipeline::use_async_compute(
+    std::shared_ptr<const Device> device, Queue &graphics,
+    Queue &compute, uint32_t frames_in_flight) {
+    auto async = std::make_unique<AsyncCompute>();
+    async->queues = {&graphics, &compute};
+    for (uint32_t i = 0; i < frames_in_flight; ++i) {
+        const auto commands = [&](const Queue &queue) {
+            return QueueCommands{
+                .pool = CommandPoolBuilder(device)
+                            .with_queue_family(queue.family_index())
+                            .build()};
+        };
+        async->frames.push_back({commands(graphics), commands(compute)});
+    }
+    async->device = std::move(device);
+    m_async = std::move(async);
+}
+
+TransientImageAllocator::Statistics
+RenderPipeline::aliasing_statistics() const {
+    if (!m_transient_images) {
+        return {};
+    }
+    return m_transient_images->statistics();
+}
+
 void RenderPipeline::execute(vk::CommandBuffer cmd,
                              Barrier::ResourceTracker &tracker,
                              Width width, Height height,
                              size_t frame_index) {
-    std::map<Slot, CachedImage> slot_outputs;
+    VW_TRACE_ZONE("RenderPipeline::execute");
+    const auto &compiled = this->compiled();
+    m_slot_outputs.assign(compiled.slot_count, nullptr);
+    if (m_render_targets) {
+        m_render_targets->begin_frame();
+    }
 
-    for (auto &pass : m_passes) {
-        // Wire inputs from preceding passes' outputs
-        for (auto slot : pass->input_slots()) {
-            auto it = slot_outputs.find(slot);
-            if (it != slot_outputs.end()) {
-                pass->set_input(slot, it->second);
+    const bool aliasing = m_transient_aliasing && !m_passes.empty() &&
+                          !compiled.transient_lifetimes.empty();
+    if (aliasing && !m_transient_images) {
+        const auto &first = *m_passes.front();
+        m_transient_images = std::make_unique<TransientImageAllocator>(
+            first.m_device, first.m_allocator);
+    }
+
+    for (auto index : compiled.graph.order) {
+        execute_pass(cmd, tracker, index, width, height, frame_index,
+                     aliasing, m_profiler != nullptr, true);
+    }
+}
+
+SubmitTicket RenderPipeline::execute_async(
+    Barrier::ResourceTracker &tracker, Width width, Height height,
+    size_t frame_index,
+    std::span<const vk::SemaphoreSubmitInfo> waits,
+    std::span<const vk::SemaphoreSubmitInfo> signals) {
+    VW_TRACE_ZONE("RenderPipeline::execute_async");
+    if (!m_async) {
+        throw LogicException::invalid_state(
+            "execute_async() needs use_async_compute()");
+    }
+    if (m_transient_aliasing) {
+        throw LogicException::invalid_state(
+            "Transient aliasing cannot be used with async compute");
+    }
+    const auto &compiled = this->compiled();
+    m_slot_outputs.assign(compiled.slot_count, nullptr);
+    if (m_render_targets) {
+        m_render_targets->begin_frame();
+    }
+
+    auto &async = *m_async;
+    auto &frame = async.frames[frame_index % async.frames.size()];
+    for (auto &commands : frame) {
+        commands.last.wait();
+        commands.pool.reset();
+        commands.used = 0;
+    }
+
+    constexpr auto all_commands = vk::PipelineStageFlagBits2::eAllCommands;
+    const auto &segments = compiled.segments;
+    async.tickets.assign(segments.size(), SubmitTicket{});
+    std::array<bool, 2> started{};
+    for (size_t s = 0; s < segments.size(); ++s) {
+        const auto &segment = segments[s];
+        const auto q = queue_index(segment.queue);
+        const auto other = 1 - q;
+        auto &queue = *async.queues[q];
+        const bool graphics = segment.queue == PassQueue::Graphics;
+
+        auto cmd = frame[q].next();
+        std::ignore = cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        if (graphics && m_profiler && !started[q]) {
+            m_profiler->begin_frame(cmd);
+        }
+        tracker.set_queue_family(queue.family_index());
+        for (auto index : segment.passes) {
+            execute_pass(cmd, tracker, index, width, height,
+                         frame_index, false,
+                         graphics && m_profiler != nullptr, false);
+        }
+        std::ignore = cmd.end();
+
+        async.waits.clear();
+        // Acquires of resources the other queue owns wait for
+        // their release there
+        auto &other_queue = *async.queues[other];
+        if (tracker.has_pending_releases(other_queue.family_index())) {
+            auto release = frame[other].next();
+            std::ignore = release.begin(vk::CommandBufferBeginInfo().setFlags(
+                vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+            tracker.flush_releases(release, other_queue.family_index());
+            std::ignore = release.end();
+            const SubmitBatch batch{.command_buffers = {&release, 1}};
+            async.waits.push_back(
+                other_queue.submit({&batch, 1}).wait_info(all_commands));
+        }
+        for (auto wait : segment.waits) {
+            async.waits.push_back(
+                async.tickets[wait].wait_info(all_commands));
+        }
+        if (!started[q]) {
+            // The previous frame's passes on the other queue
+            if (async.last[other].queue) {
+                async.waits.push_back(
+                    async.last[other].wait_info(all_commands));
+            }
+            if (graphics) {
+                async.waits.append_range(waits);
             }
+            started[q] = true;
+        }
+
+        const bool last = s + 1 == segments.size();
+        const SubmitBatch batch{
+            .command_buffers = {&cmd, 1},
+            .waits = async.waits,
+            .signals = last ? signals
+                            : std::span<const vk::SemaphoreSubmitInfo>{}};
+        async.tickets[s] = queue.submit({&batch, 1});
+    }
+    tracker.set_queue_family(vk::QueueFamilyIgnored);
+
+    for (size_t q = 0; q < 2; ++q) {
+        async.last[q] = async.queues[q]->last_submission();
+        frame[q].last = async.last[q];
+    }
+    return async.tickets.empty() ? SubmitTicket{} : async.tickets.back();
+}
+
+void RenderPipeline::execute_pass(vk::CommandBuffer cmd,
+                                  Barrier::ResourceTracker &tracker,
+                                  size_t index, Width width,
+                                  Height height, size_t frame_index,
+                                  bool aliasing, bool profiled,
+                                  bool release) {
+    const auto &compiled = *m_compiled;
+    auto &pass = *m_passes[index];
+    const auto &slots = compiled.slots[index];
+    if (aliasing) {
+        pass.m_transient = {m_transient_images.get(), &tracker,
+                            &compiled.transient_lifetimes};
+    }
+
+    // Wire inputs from preceding passes' outputs
+    for (const auto &[slot, dense] : slots.inputs) {
+        if (const auto *cached = m_slot_outputs[dense]) {
+            pass.set_input(slot, *cached);
         }
+    }
 
-        pass->execute(cmd, tracker, width, height, frame_index);
+    if (pass.resolution() == PassResolution::Render) {
+        const auto extent = render_extent(width, height);
+        width = Width(extent.width);
+        height = Height(extent.height);
+    }
 
-        // Collect outputs
-        for (auto &[slot, cached] : pass->result_images()) {
-            slot_outputs.insert_or_assign(slot,
-                                          std::move(cached));
+    if (profiled) {
+        m_profiler->begin_scope(cmd, pass.name());
+    }
+    pass.execute(cmd, tracker, width, height, frame_index);
+    if (profiled) {
+        m_profiler->end_scope(cmd);
+    }
+    pass.m_transient = {};
+
+    // Collect outputs
+    for (const auto &[slot, dense] : slots.outputs) {
+        const auto *cached = pass.result_image(slot);
+        if (!cached) {
+            continue;
         }
+        if (auto it = m_released_slots.find(slot);
+            release && it != m_released_slots.end()) {
+            const auto &state = it->second;
+            tracker.release(
+                cmd, Barrier::ImageState{
+                         .image = cached->image->handle(),
+                         .subresourceRange =
+                             cached->image->full_range(),
+                         .layout = state.layout,
+                         .stage = state.stage,
+                         .access = state.access});
+        }
+        m_slot_outputs[dense] = cached;
     }
 }
 
@@ -100,6 +637,39 @@ void RenderPipeline::reset_accumulation() {
     }
 }
 
+void RenderPipeline::set_render_scale(float scale) {
+    if (!(scale > 0.0f && scale <= 1.0f)) {
+        throw LogicException::invalid_state(
+            "Render scale must be in (0, 1], got " +
+            std::to_string(scale));
+    }
+    if (scale == m_render_scale) {
+        return;
+    }
+    m_render_scale = scale;
+    // The history of these passes is at the previous size
+    for (auto &pass : m_passes) {
+        if (pass->resolution() == PassResolution::Render) {
+            pass->reset_accumulation();
+        }
+    }
+}
+
+float RenderPipeline::render_scale() const {
+    return m_render_scale;
+}
+
+vk::Extent2D RenderPipeline::render_extent(Width width,
+                                           Height height) const {
+    const auto scaled = [&](auto size) {
+        return std::max(
+            1u, static_cast<uint32_t>(std::lround(
+                    static_cast<float>(size) * m_render_scale)));
+    };
+    return {scaled(static_cast<uint32_t>(width)),
+            scaled(static_cast<uint32_t>(height))};
+}
+
 RenderPass &RenderPipeline::pass(size_t index) {
     return *m_passes[index];
 }
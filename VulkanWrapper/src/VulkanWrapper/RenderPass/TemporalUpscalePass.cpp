@@ -0,0 +1,246 @@
+#include "VulkanWrapper/RenderPass/TemporalUpscalePass.h"
+
+#include "VulkanWrapper/Descriptors/DescriptorAllocator.h"
+#include "VulkanWrapper/Image/CombinedImage.h"
+#include "VulkanWrapper/Image/ImageView.h"
+#include "VulkanWrapper/Memory/Allocator.h"
+#include "VulkanWrapper/Pipeline/PipelineLayout.h"
+#include "VulkanWrapper/Pipeline/ShaderModule.h"
+#include "VulkanWrapper/Shader/ShaderCompiler.h"
+#include "VulkanWrapper/Synchronization/ResourceTracker.h"
+#include "VulkanWrapper/Vulkan/Device.h"
+
+namespace vw {
+
+// Matches the std430 layout of temporal_upscale.frag
+static_assert(sizeof(TemporalUpscalePass::PushConstants) == 88);
+
+namespace {
+
+// Radical inverse of `index` in `base`, in [0, 1)
+float halton(uint32_t index, uint32_t base) {
+    float result = 0.0f;
+    float fraction = 1.0f;
+    while (index > 0) {
+        fraction /= static_cast<float>(base);
+        result += fraction * static_cast<float>(index % base);
+        index /= base;
+    }
+    return result;
+}
+
+} // namespace
+
+TemporalUpscalePass::TemporalUpscalePass(
+    std::shared_ptr<Device> device,
+    std::shared_ptr<Allocator> allocator,
+    const std::filesystem::path &shader_dir,
+    vk::Format output_format, bool indirect_enabled)
+    : ScreenSpacePass(std::move(device), std::move(allocator))
+    , m_output_format(output_format)
+    , m_indirect_enabled(indirect_enabled)
+    , m_sampler(create_default_sampler())
+    , m_descriptor_layout(
+          DescriptorSetLayoutBuilder(m_device)
+              .with_combined_image(
+                  vk::ShaderStageFlagBits::eFragment,
+                  1) // binding 0: sky
+              .with_combined_image(
+                  vk::ShaderStageFlagBits::eFragment,
+                  1) // binding 1: direct light
+              .with_combined_image(
+                  vk::ShaderStageFlagBits::eFragment,
+                  1) // binding 2: indirect light
+              .with_combined_image(
+                  vk::ShaderStageFlagBits::eFragment,
+                  1) // binding 3: depth
+              .with_combined_image(
+                  vk::ShaderStageFlagBits::eFragment,
+                  1) // binding 4: history
+              .build())
+    , m_pipeline([&] {
+        ShaderCompiler compiler;
+        auto vertex_shader = compiler.compile_file_to_module(
+            m_device, shader_dir / "fullscreen.vert");
+        auto fragment_shader = compiler.compile_file_to_module(
+            m_device,
+            shader_dir / "post-process" / "temporal_upscale.frag");
+
+        auto layout =
+            PipelineLayoutBuilder(m_device)
+                .with_descriptor_set_layout(m_descriptor_layout)
+                .with_push_constant_range(vk::PushConstantRange(
+                    vk::ShaderStageFlagBits::eFragment, 0,
+                    sizeof(PushConstants)))
+                .build();
+
+        // The output, then the history of the next frame
+        return GraphicsPipelineBuilder(m_device, std::move(layout))
+            .add_shader(vk::ShaderStageFlagBits::eVertex,
+                        std::move(vertex_shader))
+            .add_shader(vk::ShaderStageFlagBits::eFragment,
+                        std::move(fragment_shader))
+            .with_dynamic_viewport_scissor()
+            .with_topology(vk::PrimitiveTopology::eTriangleStrip)
+            .with_cull_mode(vk::CullModeFlagBits::eNone)
+            .add_color_attachment(m_output_format)
+            .add_color_attachment(m_output_format)
+            .build();
+    }())
+    , m_descriptor_pool(
+          DescriptorPoolBuilder(m_device, m_descriptor_layout)
+              .build()) {}
+
+std::vector<Slot> TemporalUpscalePass::input_slots() const {
+    if (m_indirect_enabled) {
+        return {Slot::Sky, Slot::DirectLight, Slot::IndirectLight,
+                Slot::Depth};
+    }
+    return {Slot::Sky, Slot::DirectLight, Slot::Depth};
+}
+
+void TemporalUpscalePass::execute(vk::CommandBuffer cmd,
+                                  Barrier::ResourceTracker &tracker,
+                                  Width width, Height height,
+                                  size_t frame_index) {
+    const auto &output = get_or_create_image(
+        Slot::Upscaled, width, height, frame_index, m_output_format,
+        vk::ImageUsageFlagBits::eColorAttachment |
+            vk::ImageUsageFlagBits::eSampled |
+            vk::ImageUsageFlagBits::eTransferSrc);
+
+    const vk::Extent2D extent{static_cast<uint32_t>(width),
+                              static_cast<uint32_t>(height)};
+    if (!m_history[0].image ||
+        m_history[0].image->extent2D() != extent) {
+        create_history(extent);
+    }
+    const auto &read = m_history[m_frame % 2];
+    const auto &write = m_history[(m_frame + 1) % 2];
+
+    const auto &direct = get_input(Slot::DirectLight);
+    auto sky_view = get_input(Slot::Sky).view;
+    auto depth_view = get_input(Slot::Depth).view;
+
+    // Without indirect light, the direct light is bound in its
+    // place with a zero intensity
+    auto indirect_view = direct.view;
+    float indirect_intensity = 0.0f;
+    if (m_indirect_enabled) {
+        indirect_view = get_input(Slot::IndirectLight).view;
+        indirect_intensity = m_indirect_intensity;
+    }
+
+    DescriptorAllocator descriptor_allocator;
+    descriptor_allocator.add_combined_image(
+        0, CombinedImage(sky_view, m_sampler),
+        vk::PipelineStageFlagBits2::eFragmentShader,
+        vk::AccessFlagBits2::eShaderRead);
+    descriptor_allocator.add_combined_image(
+        1, CombinedImage(direct.view, m_sampler),
+        vk::PipelineStageFlagBits2::eFragmentShader,
+        vk::AccessFlagBits2::eShaderRead);
+    descriptor_allocator.add_combined_image(
+        2, CombinedImage(indirect_view, m_sampler),
+        vk::PipelineStageFlagBits2::eFragmentShader,
+        vk::AccessFlagBits2::eShaderRead);
+    descriptor_allocator.add_combined_image(
+        3, CombinedImage(depth_view, m_sampler),
+        vk::PipelineStageFlagBits2::eFragmentShader,
+        vk::AccessFlagBits2::eShaderRead);
+    descriptor_allocator.add_combined_image(
+        4, CombinedImage(read.view, m_sampler),
+        vk::PipelineStageFlagBits2::eFragmentShader,
+        vk::AccessFlagBits2::eShaderRead);
+
+    auto descriptor_set =
+        m_descriptor_pool.allocate_set(descriptor_allocator);
+
+    for (const auto &resource : descriptor_set.resources()) {
+        tracker.request(resource);
+    }
+    for (const auto *view : {output.view.get(), write.view.get()}) {
+        tracker.request(Barrier::ImageState{
+            .image = view->image()->handle(),
+            .subresourceRange = view->subresource_range(),
+            .layout = vk::ImageLayout::eColorAttachmentOptimal,
+            .stage =
+                vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+            .access = vk::AccessFlagBits2::eColorAttachmentWrite});
+    }
+    tracker.flush(cmd);
+
+    const std::array attachments{
+        vk::RenderingAttachmentInfo()
+            .setImageView(output.view->handle())
+            .setImageLayout(vk::ImageLayout::eColorAttachmentOptimal)
+            .setLoadOp(vk::AttachmentLoadOp::eDontCare)
+            .setStoreOp(vk::AttachmentStoreOp::eStore),
+        vk::RenderingAttachmentInfo()
+            .setImageView(write.view->handle())
+            .setImageLayout(vk::ImageLayout::eColorAttachmentOptimal)
+            .setLoadOp(vk::AttachmentLoadOp::eDontCare)
+            .setStoreOp(vk::AttachmentStoreOp::eStore)};
+
+    // The inputs may come from larger pooled images
+    const auto input_size = direct.image->extent2D();
+    const glm::vec2 image_size(input_size.width, input_size.height);
+
+    PushConstants constants{
+        .reprojection = m_previous_view_projection *
+                        glm::inverse(m_view_projection),
+        .input_uv_scale = direct.uv_scale(),
+        .input_uv_jitter = jitter() / image_size,
+        .indirect_intensity = indirect_intensity,
+        .blend_factor = m_history_valid ? m_blend_factor : 1.0f};
+
+    render_fullscreen(cmd, extent, attachments, nullptr, *m_pipeline,
+                      descriptor_set, &constants, sizeof(constants));
+
+    m_previous_view_projection = m_view_projection;
+    m_history_valid = true;
+    ++m_frame;
+}
+
+void TemporalUpscalePass::reset_accumulation() {
+    m_history_valid = false;
+}
+
+glm::vec2 TemporalUpscalePass::jitter_at(uint32_t frame) {
+    // Index 0 of the sequence is the origin: start at 1
+    const auto index = frame % jitter_phase_count + 1;
+    return {halton(index, 2) - 0.5f, halton(index, 3) - 0.5f};
+}
+
+glm::mat4 TemporalUpscalePass::jittered_projection(
+    const glm::mat4 &projection, glm::vec2 jitter,
+    vk::Extent2D render_extent) {
+    // A pixel spans 2 / extent in normalized device coordinates
+    const glm::vec2 offset =
+        2.0f * jitter /
+        glm::vec2(render_extent.width, render_extent.height);
+    return glm::translate(glm::mat4(1.0f),
+                          glm::vec3(offset, 0.0f)) *
+           projection;
+}
+
+void TemporalUpscalePass::set_view_projection(
+    const glm::mat4 &view_projection) {
+    m_view_projection = view_projection;
+}
+
+void TemporalUpscalePass::create_history(vk::Extent2D extent) {
+    for (auto &history : m_history) {
+        history.image = m_allocator->create_image_2D(
+            Width(extent.width), Height(extent.height), false,
+            m_output_format,
+            vk::ImageUsageFlagBits::eColorAttachment |
+                vk::ImageUsageFlagBits::eSampled);
+        history.view = ImageViewBuilder(m_device, history.image)
+                           .setImageType(vk::ImageViewType::e2D)
+                           .build();
+    }
+    m_history_valid = false;
+}
+
+} // namespace vw
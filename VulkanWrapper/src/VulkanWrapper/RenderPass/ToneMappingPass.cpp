@@ -7,6 +7,9 @@
 
 namespace vw {
 
+// Matches the std430 layout of tonemap.frag
+static_assert(sizeof(ToneMappingPass::PushConstants) == 28);
+
 ToneMappingPass::ToneMappingPass(
     std::shared_ptr<Device> device,
     std::shared_ptr<Allocator> allocator,
@@ -22,6 +25,9 @@ ToneMappingPass::ToneMappingPass(
 }
 
 std::vector<Slot> ToneMappingPass::input_slots() const {
+    if (m_upscaled_input) {
+        return {Slot::Upscaled};
+    }
     if (m_indirect_enabled) {
         return {Slot::Sky, Slot::DirectLight,
                 Slot::IndirectLight};
@@ -41,9 +47,20 @@ void ToneMappingPass::execute(vk::CommandBuffer cmd,
             vk::ImageUsageFlagBits::eSampled |
             vk::ImageUsageFlagBits::eTransferSrc);
 
+    // The upscaled radiance stands for the direct light, with
+    // the black image as sky and no indirect light
+    if (m_upscaled_input) {
+        const auto &upscaled = get_input(Slot::Upscaled);
+        tone_map(cmd, tracker, cached, upscaled.uv_scale(),
+                 m_black_image_view, upscaled.view, nullptr, 0.0f,
+                 m_current_operator, m_exposure, m_white_point,
+                 m_luminance_scale);
+        return;
+    }
+
     // Get input views from wired slots
     auto sky_view = get_input(Slot::Sky).view;
-    auto direct_light_view = get_input(Slot::DirectLight).view;
+    const auto &direct_light = get_input(Slot::DirectLight);
 
     // IndirectLight is optional
     std::shared_ptr<const ImageView> indirect_view;
@@ -55,11 +72,10 @@ void ToneMappingPass::execute(vk::CommandBuffer cmd,
         }
     }
 
-    execute_to_view(cmd, tracker, cached.view, sky_view,
-                    direct_light_view, indirect_view,
-                    m_indirect_intensity, m_current_operator,
-                    m_exposure, m_white_point,
-                    m_luminance_scale);
+    tone_map(cmd, tracker, cached, direct_light.uv_scale(), sky_view,
+             direct_light.view, indirect_view, m_indirect_intensity,
+             m_current_operator, m_exposure, m_white_point,
+             m_luminance_scale);
 }
 
 void ToneMappingPass::execute_to_view(
@@ -71,8 +87,27 @@ void ToneMappingPass::execute_to_view(
     float indirect_intensity,
     ToneMappingOperator tone_operator, float exposure,
     float white_point, float luminance_scale) {
+    // The whole output, from whole inputs
+    tone_map(cmd, tracker,
+             CachedImage{.image = output_view->image(),
+                         .view = output_view},
+             glm::vec2(1.0f), std::move(sky_view),
+             std::move(direct_light_view), std::move(indirect_view),
+             indirect_intensity, tone_operator, exposure, white_point,
+             luminance_scale);
+}
 
-    vk::Extent2D extent = output_view->image()->extent2D();
+void ToneMappingPass::tone_map(
+    vk::CommandBuffer cmd, Barrier::ResourceTracker &tracker,
+    const CachedImage &output, glm::vec2 input_uv_scale,
+    std::shared_ptr<const ImageView> sky_view,
+    std::shared_ptr<const ImageView> direct_light_view,
+    std::shared_ptr<const ImageView> indirect_view,
+    float indirect_intensity,
+    ToneMappingOperator tone_operator, float exposure,
+    float white_point, float luminance_scale) {
+    const auto &output_view = output.view;
+    const vk::Extent2D extent = output.render_extent();
 
     // Use fallback black image if no indirect light provided
     auto effective_indirect_view =
@@ -96,6 +131,18 @@ void ToneMappingPass::execute_to_view(
     auto descriptor_set =
         m_descriptor_pool.allocate_set(descriptor_allocator);
 
+    // The black image was left in shader read layout by its
+    // clear: keep the tracker from discarding it
+    if (sky_view == m_black_image_view ||
+        effective_indirect_view == m_black_image_view) {
+        tracker.track(Barrier::ImageState{
+            .image = m_black_image->handle(),
+            .subresourceRange = m_black_image->full_range(),
+            .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+            .stage = vk::PipelineStageFlagBits2::eFragmentShader,
+            .access = vk::AccessFlagBits2::eShaderRead});
+    }
+
     // Request resource states for barriers
     for (const auto &resource : descriptor_set.resources()) {
         tracker.request(resource);
@@ -126,6 +173,7 @@ void ToneMappingPass::execute_to_view(
 
     // Push constants
     PushConstants constants{
+        .input_uv_scale = input_uv_scale,
         .exposure = exposure,
         .operator_id = static_cast<int32_t>(tone_operator),
         .white_point = white_point,
@@ -1,5 +1,6 @@
 #include "VulkanWrapper/RenderPass/ZPass.h"
 
+#include "VulkanWrapper/Command/ParallelCommandRecorder.h"
 #include "VulkanWrapper/Descriptors/DescriptorAllocator.h"
 #include "VulkanWrapper/Descriptors/Vertex.h"
 #include "VulkanWrapper/Memory/Buffer.h"
@@ -7,6 +8,7 @@
 #include "VulkanWrapper/RayTracing/RayTracedScene.h"
 #include "VulkanWrapper/Shader/ShaderCompiler.h"
 #include "VulkanWrapper/Synchronization/ResourceTracker.h"
+#include "VulkanWrapper/Utils/Trace.h"
 
 #include <cassert>
 #include <glm/glm.hpp>
@@ -66,6 +68,11 @@ void ZPass::set_scene(const rt::RayTracedScene &scene) {
     m_scene = &scene;
 }
 
+void ZPass::set_parallel_recorder(
+    std::shared_ptr<ParallelCommandRecorder> recorder) {
+    m_recorder = std::move(recorder);
+}
+
 void ZPass::execute(vk::CommandBuffer cmd,
                     Barrier::ResourceTracker &tracker,
                     Width width, Height height,
@@ -119,8 +126,43 @@ void ZPass::execute(vk::CommandBuffer cmd,
             .setLayerCount(1)
             .setPDepthAttachment(&depth_attachment);
 
+    const auto &instances = m_scene->scene().instances();
+    auto descriptor_handle = descriptor_set.handle();
+
+    if (!m_recorder) {
+        cmd.beginRendering(rendering_info);
+        record_draws(cmd, descriptor_handle, extent, instances);
+        cmd.endRendering();
+        return;
+    }
+
+    rendering_info.setFlags(
+        vk::RenderingFlagBits::eContentsSecondaryCommandBuffers);
+    const auto inheritance =
+        vk::CommandBufferInheritanceRenderingInfo()
+            .setDepthAttachmentFormat(m_depth_format)
+            .setRasterizationSamples(vk::SampleCountFlagBits::e1);
+    auto secondaries = m_recorder->record(
+        inheritance, instances.size(),
+        [&](vk::CommandBuffer secondary, std::size_t first,
+            std::size_t last) {
+            record_draws(
+                secondary, descriptor_handle, extent,
+                std::span(instances).subspan(first, last - first));
+        });
+
     cmd.beginRendering(rendering_info);
+    if (!secondaries.empty()) {
+        cmd.executeCommands(secondaries);
+    }
+    cmd.endRendering();
+}
 
+void ZPass::record_draws(
+    vk::CommandBuffer cmd, vk::DescriptorSet descriptor_set,
+    vk::Extent2D extent,
+    std::span<const Model::MeshInstance> instances) const {
+    VW_TRACE_ZONE("ZPass::record_draws");
     // Set viewport and scissor
     vk::Viewport viewport(0.0f, 0.0f,
                           static_cast<float>(extent.width),
@@ -134,19 +176,15 @@ void ZPass::execute(vk::CommandBuffer cmd,
     cmd.bindPipeline(vk::PipelineBindPoint::eGraphics,
                      m_pipeline->handle());
 
-    auto descriptor_handle = descriptor_set.handle();
     cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
                            m_pipeline->layout().handle(), 0, 1,
-                           &descriptor_handle, 0, nullptr);
+                           &descriptor_set, 0, nullptr);
 
     // Draw all mesh instances
-    const auto &scene = m_scene->scene();
-    for (const auto &instance : scene.instances()) {
+    for (const auto &instance : instances) {
         instance.mesh.draw_zpass(
             cmd, m_pipeline->layout(), instance.transform);
     }
-
-    cmd.endRendering();
 }
 
 } // namespace vw
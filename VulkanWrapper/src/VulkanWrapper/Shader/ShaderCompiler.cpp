@@ -2,6 +2,7 @@
 
 #include "VulkanWrapper/Pipeline/ShaderModule.h"
 #include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Utils/Trace.h"
 #include <fstream>
 #include <map>
 #include <set>
@@ -246,6 +247,7 @@ ShaderCompiler &ShaderCompiler::set_optimize(bool enable) {
 ShaderCompilationResult
 ShaderCompiler::compile(std::string_view source, vk::ShaderStageFlagBits stage,
                         std::string_view sourceName) const {
+    VW_TRACE_ZONE("ShaderCompiler::compile");
     shaderc::CompileOptions options;
 
     // Set target environment
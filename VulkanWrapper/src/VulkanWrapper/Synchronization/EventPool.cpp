@@ -0,0 +1,38 @@
+#include "VulkanWrapper/Synchronization/EventPool.h"
+
+#include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Vulkan/Device.h"
+
+namespace vw {
+
+EventPool::EventPool(std::shared_ptr<const Device> device,
+                     uint32_t frames_in_flight)
+    : m_device{std::move(device)}
+    , m_retired(frames_in_flight + 1) {}
+
+vk::Event EventPool::acquire() {
+    if (!m_available.empty()) {
+        const auto event = m_available.back();
+        m_available.pop_back();
+        return event;
+    }
+    const auto info =
+        vk::EventCreateInfo().setFlags(vk::EventCreateFlagBits::eDeviceOnly);
+    auto event = check_vk(m_device->handle().createEventUnique(info),
+                          "Failed to create event");
+    return m_events.emplace_back(std::move(event)).get();
+}
+
+void EventPool::retire(vk::Event event) {
+    m_retired[m_frame_slot].push_back(event);
+}
+
+void EventPool::begin_frame() {
+    m_frame_slot = (m_frame_slot + 1) % m_retired.size();
+    // Retired frames_in_flight frames ago: the reset has executed
+    auto &retired = m_retired[m_frame_slot];
+    m_available.insert(m_available.end(), retired.begin(), retired.end());
+    retired.clear();
+}
+
+} // namespace vw
@@ -15,6 +15,10 @@ void Fence::wait() const {
 
 void Fence::reset() const { std::ignore = m_device.resetFences(handle()); }
 
+bool Fence::is_signaled() const {
+    return m_device.getFenceStatus(handle()) == vk::Result::eSuccess;
+}
+
 Fence::~Fence() {
     if (handle() != vk::Fence()) {
         wait();
@@ -0,0 +1,99 @@
+#include "VulkanWrapper/Synchronization/FrameContext.h"
+
+#include "VulkanWrapper/Utils/Error.h"
+
+namespace vw {
+
+FrameContext::FrameContext(std::shared_ptr<const Device> device,
+                           Queue &queue, uint32_t frames_in_flight)
+    : m_device{std::move(device)}
+    , m_queue{&queue} {
+    if (frames_in_flight == 0) {
+        throw LogicException::invalid_state(
+            "A frame context needs at least one frame in flight");
+    }
+    m_frames.reserve(frames_in_flight);
+    for (uint32_t i = 0; i < frames_in_flight; ++i) {
+        m_frames.push_back(
+            Frame{.pool = CommandPoolBuilder(m_device)
+                              .with_queue_family(queue.family_index())
+                              .build()});
+    }
+}
+
+FrameContext::~FrameContext() { wait_idle(); }
+
+vk::CommandBuffer FrameContext::begin_frame() {
+    if (m_recording) {
+        throw LogicException::invalid_state(
+            "begin_frame() called before end_frame()");
+    }
+
+    m_frame_index = static_cast<uint32_t>(m_frame_number % m_frames.size());
+    ++m_frame_number;
+
+    auto &frame = m_frames[m_frame_index];
+    frame.ticket.wait();
+    frame.deferred = std::exchange(m_deferred, {});
+    frame.pool.reset();
+    frame.used_command_buffers = 0;
+    m_recording = true;
+
+    const auto cmd = allocate_command_buffer();
+    std::ignore = cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    return cmd;
+}
+
+SubmitTicket
+FrameContext::end_frame(std::span<const vk::SemaphoreSubmitInfo> waits,
+                        std::span<const vk::SemaphoreSubmitInfo> signals) {
+    if (!m_recording) {
+        throw LogicException::invalid_state(
+            "end_frame() called without begin_frame()");
+    }
+
+    auto &frame = m_frames[m_frame_index];
+    const auto cmd = frame.command_buffers.front();
+    std::ignore = cmd.end();
+
+    m_queue->enqueue_command_buffer(cmd);
+    frame.ticket = m_queue->submit_enqueued(waits, signals);
+    m_recording = false;
+    return frame.ticket;
+}
+
+vk::CommandBuffer FrameContext::allocate_command_buffer() {
+    if (!m_recording) {
+        throw LogicException::invalid_state(
+            "Command buffers are allocated within a frame");
+    }
+
+    auto &frame = m_frames[m_frame_index];
+    if (frame.used_command_buffers == frame.command_buffers.size()) {
+        frame.command_buffers.push_back(frame.pool.allocate(1).front());
+    }
+    return frame.command_buffers[frame.used_command_buffers++];
+}
+
+void FrameContext::defer_destruction(std::shared_ptr<const void> resource) {
+    if (m_recording) {
+        m_frames[m_frame_index].deferred.push_back(std::move(resource));
+    } else {
+        m_deferred.push_back(std::move(resource));
+    }
+}
+
+void FrameContext::wait_idle() {
+    for (uint32_t i = 0; i < m_frames.size(); ++i) {
+        auto &frame = m_frames[i];
+        frame.ticket.wait();
+        // The frame being recorded may still use its resources
+        if (!m_recording || i != m_frame_index) {
+            frame.deferred.clear();
+        }
+    }
+    m_deferred.clear();
+}
+
+} // namespace vw
@@ -1,17 +1,214 @@
 #include "VulkanWrapper/Synchronization/ResourceTracker.h"
 
+#include "VulkanWrapper/Synchronization/EventPool.h"
+#include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Utils/Trace.h"
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
 namespace vw::Barrier {
 
+namespace {
+
+auto barrier_key(const vk::ImageMemoryBarrier2 &barrier) {
+    return std::tuple{
+        reinterpret_cast<uint64_t>(static_cast<VkImage>(barrier.image)),
+        barrier.oldLayout,
+        barrier.newLayout,
+        static_cast<uint64_t>(barrier.srcStageMask),
+        static_cast<uint64_t>(barrier.srcAccessMask),
+        static_cast<uint64_t>(barrier.dstStageMask),
+        static_cast<uint64_t>(barrier.dstAccessMask),
+        barrier.srcQueueFamilyIndex,
+        barrier.dstQueueFamilyIndex};
+}
+
+auto barrier_key(const vk::BufferMemoryBarrier2 &barrier) {
+    return std::tuple{
+        reinterpret_cast<uint64_t>(static_cast<VkBuffer>(barrier.buffer)),
+        static_cast<uint64_t>(barrier.srcStageMask),
+        static_cast<uint64_t>(barrier.srcAccessMask),
+        static_cast<uint64_t>(barrier.dstStageMask),
+        static_cast<uint64_t>(barrier.dstAccessMask),
+        barrier.srcQueueFamilyIndex,
+        barrier.dstQueueFamilyIndex};
+}
+
+auto barrier_key(const vk::MemoryBarrier2 &barrier) {
+    return std::tuple{static_cast<uint64_t>(barrier.srcStageMask),
+                      static_cast<uint64_t>(barrier.srcAccessMask),
+                      static_cast<uint64_t>(barrier.dstStageMask),
+                      static_cast<uint64_t>(barrier.dstAccessMask)};
+}
+
+// Union of two ranges when it is exactly a range: a bounding box would
+// also cover subresources that are in another state
+std::optional<vk::ImageSubresourceRange>
+exact_union(const vk::ImageSubresourceRange &a,
+            const vk::ImageSubresourceRange &b) {
+    const bool same_mips =
+        a.baseMipLevel == b.baseMipLevel && a.levelCount == b.levelCount;
+    const bool same_layers = a.baseArrayLayer == b.baseArrayLayer &&
+                             a.layerCount == b.layerCount;
+    if (same_mips && same_layers) {
+        auto merged = a;
+        merged.aspectMask |= b.aspectMask;
+        return merged;
+    }
+    if (a.aspectMask != b.aspectMask || (!same_mips && !same_layers) ||
+        a.levelCount == vk::RemainingMipLevels ||
+        b.levelCount == vk::RemainingMipLevels ||
+        a.layerCount == vk::RemainingArrayLayers ||
+        b.layerCount == vk::RemainingArrayLayers) {
+        return std::nullopt;
+    }
+    auto merged = ImageInterval(a).merge(ImageInterval(b));
+    if (!merged) {
+        return std::nullopt;
+    }
+    return merged->range;
+}
+
+std::optional<BufferInterval> exact_union(const vk::BufferMemoryBarrier2 &a,
+                                          const vk::BufferMemoryBarrier2 &b) {
+    if (a.size == vk::WholeSize || b.size == vk::WholeSize) {
+        if (a.offset == b.offset && a.size == b.size) {
+            return BufferInterval(a.offset, a.size);
+        }
+        return std::nullopt;
+    }
+    return BufferInterval(a.offset, a.size)
+        .merge(BufferInterval(b.offset, b.size));
+}
+
+// Sorts the barriers so that mergeable ones are next to each other, then
+// merges each barrier into a previous compatible one while their ranges
+// combine, until nothing changes. Works in place: flush() does not
+// allocate.
+template <typename T, typename Merge>
+void merge_barriers(std::vector<T> &barriers, Merge &&merge) {
+    std::ranges::sort(barriers, {}, [](const T &barrier) {
+        return barrier_key(barrier);
+    });
+
+    bool merged_any = true;
+    while (merged_any) {
+        merged_any = false;
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < barriers.size(); ++i) {
+            bool merged = false;
+            for (std::size_t j = kept; j-- > 0;) {
+                if (barrier_key(barriers[j]) != barrier_key(barriers[i])) {
+                    break;
+                }
+                if (merge(barriers[j], barriers[i])) {
+                    merged = true;
+                    break;
+                }
+            }
+            if (!merged) {
+                barriers[kept++] = barriers[i];
+            }
+            merged_any |= merged;
+        }
+        barriers.resize(kept);
+    }
+}
+
+// The write accesses of `access`
+vk::AccessFlags2 writes_of(vk::AccessFlags2 access) {
+    constexpr auto writes = vk::AccessFlagBits2::eMemoryWrite |
+                            vk::AccessFlagBits2::eShaderWrite |
+                            vk::AccessFlagBits2::eShaderStorageWrite |
+                            vk::AccessFlagBits2::eColorAttachmentWrite |
+                            vk::AccessFlagBits2::eDepthStencilAttachmentWrite |
+                            vk::AccessFlagBits2::eTransferWrite |
+                            vk::AccessFlagBits2::eHostWrite |
+                            vk::AccessFlagBits2::eAccelerationStructureWriteKHR;
+    return access & writes;
+}
+
+bool has_write(vk::AccessFlags2 access) {
+    return writes_of(access) != vk::AccessFlagBits2::eNone;
+}
+
+bool transfers_ownership(uint32_t current, uint32_t requested) {
+    return current != vk::QueueFamilyIgnored &&
+           requested != vk::QueueFamilyIgnored && current != requested;
+}
+
+// A request without a family does not change the owner of the resource
+uint32_t owner_after(uint32_t current, uint32_t requested) {
+    return requested == vk::QueueFamilyIgnored ? current : requested;
+}
+
+// The release half of an ownership transfer only has a source scope, the
+// acquire half only a destination scope
+template <typename T> T release_half(T barrier) {
+    barrier.dstStageMask = vk::PipelineStageFlagBits2::eNone;
+    barrier.dstAccessMask = vk::AccessFlagBits2::eNone;
+    return barrier;
+}
+
+template <typename T> T acquire_half(T barrier) {
+    barrier.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+    barrier.srcAccessMask = vk::AccessFlagBits2::eNone;
+    return barrier;
+}
+
+// Identifies the resource of a state, whatever its range
+std::pair<std::size_t, uint64_t> resource_key(const ResourceState &state) {
+    const auto handle = std::visit(
+        [](const auto &arg) -> uint64_t {
+            using T = std::decay_t<decltype(arg)>;
+            if constexpr (std::is_same_v<T, ImageState>) {
+                return (uint64_t)(static_cast<VkImage>(arg.image));
+            } else if constexpr (std::is_same_v<T, BufferState>) {
+                return (uint64_t)(static_cast<VkBuffer>(arg.buffer));
+            } else {
+                return (uint64_t)(
+                    static_cast<VkAccelerationStructureKHR>(arg.handle));
+            }
+        },
+        state);
+    return {state.index(), handle};
+}
+
+} // namespace
+
+ResourceTracker ResourceTracker::create_shard() {
+    ResourceTracker shard;
+    shard.m_shard = true;
+    return shard;
+}
+
+void ResourceTracker::reserve(std::size_t count) {
+    m_image_states.reserve(count);
+    m_buffer_states.reserve(count);
+}
+
 void ResourceTracker::track(const ResourceState &state) {
     std::visit(
         [this](auto &&arg) {
             using T = std::decay_t<decltype(arg)>;
+            // Whoever wrote the resource before is unknown: readers that
+            // the tracked state does not cover wait for its stages
             if constexpr (std::is_same_v<T, ImageState>) {
-                track_image(arg.image, arg.subresourceRange, arg.layout,
-                            arg.stage, arg.access);
+                track_image(arg.image, arg.subresourceRange,
+                            {.layout = arg.layout,
+                             .stage = arg.stage,
+                             .access = arg.access,
+                             .queue_family = arg.queue_family,
+                             .write_stage = arg.stage,
+                             .write_access = writes_of(arg.access)});
             } else if constexpr (std::is_same_v<T, BufferState>) {
-                track_buffer(arg.buffer, arg.offset, arg.size, arg.stage,
-                             arg.access);
+                track_buffer(arg.buffer, arg.offset, arg.size,
+                             {.stage = arg.stage,
+                              .access = arg.access,
+                              .queue_family = arg.queue_family,
+                              .write_stage = arg.stage,
+                              .write_access = writes_of(arg.access)});
             } else if constexpr (std::is_same_v<T,
                                                 AccelerationStructureState>) {
                 track_acceleration_structure(arg.handle, arg.stage, arg.access);
@@ -21,15 +218,20 @@ void ResourceTracker::track(const ResourceState &state) {
 }
 
 void ResourceTracker::request(const ResourceState &state) {
+    if (wait_released(state)) {
+        return;
+    }
     std::visit(
         [this](auto &&arg) {
             using T = std::decay_t<decltype(arg)>;
             if constexpr (std::is_same_v<T, ImageState>) {
-                request_image(arg.image, arg.subresourceRange, arg.layout,
-                              arg.stage, arg.access);
+                request_image(arg.image, arg.subresourceRange,
+                              {arg.layout, arg.stage, arg.access,
+                               requested_family(arg.queue_family)});
             } else if constexpr (std::is_same_v<T, BufferState>) {
-                request_buffer(arg.buffer, arg.offset, arg.size, arg.stage,
-                               arg.access);
+                request_buffer(arg.buffer, arg.offset, arg.size,
+                               {arg.stage, arg.access,
+                                requested_family(arg.queue_family)});
             } else if constexpr (std::is_same_v<T,
                                                 AccelerationStructureState>) {
                 request_acceleration_structure(arg.handle, arg.stage,
@@ -41,24 +243,28 @@ void ResourceTracker::request(const ResourceState &state) {
 
 void ResourceTracker::track_image(vk::Image image,
                                   vk::ImageSubresourceRange subresourceRange,
-                                  vk::ImageLayout initialLayout,
-                                  vk::PipelineStageFlags2 stage,
-                                  vk::AccessFlags2 access) {
+                                  const InternalImageState &state) {
     ImageInterval interval(subresourceRange);
-    InternalImageState state{initialLayout, stage, access};
 
     auto &stateSets = m_image_states[image];
 
-    // Find existing state group or create new one
+    // The tracked state replaces whatever was known about the range. Find
+    // an existing state group or create a new one
+    bool existing = false;
     for (auto &stateSet : stateSets) {
-        if (stateSet.state.layout == state.layout &&
-            stateSet.state.stage == state.stage &&
-            stateSet.state.access == state.access) {
-            // Add to existing state group
+        if (stateSet.state == state) {
             stateSet.intervals.add(interval);
-            return;
+            existing = true;
+        } else {
+            stateSet.intervals.remove(interval);
         }
     }
+    std::erase_if(stateSets, [](const ImageIntervalSetState &stateSet) {
+        return stateSet.intervals.empty();
+    });
+    if (existing) {
+        return;
+    }
 
     // Create new state group
     ImageIntervalSetState newStateSet;
@@ -69,22 +275,28 @@ void ResourceTracker::track_image(vk::Image image,
 
 void ResourceTracker::track_buffer(vk::Buffer buffer, vk::DeviceSize offset,
                                    vk::DeviceSize size,
-                                   vk::PipelineStageFlags2 stage,
-                                   vk::AccessFlags2 access) {
+                                   const InternalBufferState &state) {
     BufferInterval interval(offset, size);
-    InternalBufferState state{stage, access};
 
     auto &stateSets = m_buffer_states[buffer];
 
-    // Find existing state group or create new one
+    // The tracked state replaces whatever was known about the range. Find
+    // an existing state group or create a new one
+    bool existing = false;
     for (auto &stateSet : stateSets) {
-        if (stateSet.state.stage == state.stage &&
-            stateSet.state.access == state.access) {
-            // Add to existing state group
+        if (stateSet.state == state) {
             stateSet.intervals.add(interval);
-            return;
+            existing = true;
+        } else {
+            stateSet.intervals.remove(interval);
         }
     }
+    std::erase_if(stateSets, [](const BufferIntervalSetState &stateSet) {
+        return stateSet.intervals.empty();
+    });
+    if (existing) {
+        return;
+    }
 
     // Create new state group
     BufferIntervalSetState newStateSet;
@@ -96,29 +308,145 @@ void ResourceTracker::track_buffer(vk::Buffer buffer, vk::DeviceSize offset,
 void ResourceTracker::track_acceleration_structure(
     vk::AccelerationStructureKHR handle, vk::PipelineStageFlags2 stage,
     vk::AccessFlags2 access) {
-    m_as_states[handle] = {stage, access};
+    m_as_states[handle] = {stage, access, stage, writes_of(access)};
+}
+
+bool ResourceTracker::needs_barrier(const InternalImageState &current,
+                                    const InternalImageState &requested) {
+    return current.layout != requested.layout ||
+           current.layout == vk::ImageLayout::eUndefined ||
+           has_write(current.access) || has_write(requested.access) ||
+           transfers_ownership(current.queue_family, requested.queue_family);
+}
+
+bool ResourceTracker::needs_barrier(const InternalBufferState &current,
+                                    const InternalBufferState &requested) {
+    return has_write(current.access) || has_write(requested.access) ||
+           transfers_ownership(current.queue_family, requested.queue_family);
 }
 
 void ResourceTracker::request_image(vk::Image image,
                                     vk::ImageSubresourceRange subresourceRange,
-                                    vk::ImageLayout layout,
-                                    vk::PipelineStageFlags2 stage,
-                                    vk::AccessFlags2 access) {
+                                    const InternalImageState &requested,
+                                    bool force) {
     ImageInterval requestedInterval(subresourceRange);
+    const auto layout = requested.layout;
     auto &stateSets = m_image_states[image];
 
+    const auto make_barrier = [&](const InternalImageState &current,
+                                  const vk::ImageSubresourceRange &range) {
+        if (current.first_use) {
+            m_first_uses.push_back(ImageState{image, range, current.layout,
+                                              current.stage, current.access,
+                                              current.queue_family});
+        }
+        vk::ImageMemoryBarrier2 barrier;
+        barrier.srcStageMask = current.stage;
+        barrier.srcAccessMask = current.access;
+        barrier.dstStageMask = requested.stage;
+        barrier.dstAccessMask = requested.access;
+        barrier.oldLayout = current.layout;
+        barrier.newLayout = layout;
+        barrier.image = image;
+        barrier.subresourceRange = range;
+        // Undefined content is discarded, it needs no transfer
+        if (current.layout != vk::ImageLayout::eUndefined &&
+            transfers_ownership(current.queue_family,
+                                requested.queue_family)) {
+            barrier.srcQueueFamilyIndex = current.queue_family;
+            barrier.dstQueueFamilyIndex = requested.queue_family;
+            m_pending_releases[current.queue_family]
+                .image_barriers.push_back(release_half(barrier));
+            barrier = acquire_half(barrier);
+            ++m_statistics.ownership_transfers;
+        }
+        m_pending_image_barriers.push_back(barrier);
+    };
+
+    // After a barrier, the requested readers are synchronized with the
+    // write it waited for. The layout or queue family transition it made
+    // comes before the requested stages, which later readers wait for.
+    const auto after_barrier = [&](const InternalImageState &current) {
+        auto state = requested;
+        state.queue_family =
+            owner_after(current.queue_family, requested.queue_family);
+        if (has_write(requested.access)) {
+            state.write_stage = requested.stage;
+            state.write_access = requested.access;
+            return state;
+        }
+        if (has_write(current.access)) {
+            state.write_stage = current.stage;
+            state.write_access = current.access;
+        } else {
+            state.write_stage = current.write_stage;
+            state.write_access = current.write_access;
+        }
+        if (current.layout != layout ||
+            transfers_ownership(current.queue_family,
+                                requested.queue_family)) {
+            state.write_stage |= requested.stage;
+        }
+        return state;
+    };
+
+    // Reads in the same layout need no barrier between them: the readers
+    // accumulate in the tracked state, so that the next write waits for
+    // all of them. A reader the last barrier did not cover still waits
+    // for the last write.
+    const auto accumulate = [&](const InternalImageState &current,
+                                const vk::ImageSubresourceRange &range) {
+        const bool covered =
+            (current.stage | requested.stage) == current.stage &&
+            (current.access | requested.access) == current.access;
+        if (!covered &&
+            current.write_stage != vk::PipelineStageFlagBits2::eNone) {
+            auto writer = current;
+            writer.stage = current.write_stage;
+            writer.access = current.write_access;
+            make_barrier(writer, range);
+        }
+        auto state = current;
+        state.stage |= requested.stage;
+        state.access |= requested.access;
+        state.queue_family =
+            owner_after(current.queue_family, requested.queue_family);
+        return state;
+    };
+
+    const auto apply = [&](const InternalImageState &current,
+                           const vk::ImageSubresourceRange &range) {
+        if (force || needs_barrier(current, requested)) {
+            make_barrier(current, range);
+            return after_barrier(current);
+        }
+        return accumulate(current, range);
+    };
+
+    // Common case: the resource has one known state over exactly the
+    // requested range. Update it in place.
+    if (stateSets.size() == 1 && stateSets[0].intervals.size() == 1 &&
+        stateSets[0].intervals.intervals()[0] == requestedInterval) {
+        auto &current = stateSets[0].state;
+        current = apply(current, subresourceRange);
+        return;
+    }
+
     // Track parts of the requested interval that are not covered by existing
     // states
     std::vector<ImageInterval> remainingIntervals;
     remainingIntervals.push_back(requestedInterval);
 
+    // States of the parts, tracked once the request is applied
+    std::vector<std::pair<ImageInterval, InternalImageState>> updated;
+
     // Check all state groups for overlaps
     for (auto &stateSet : stateSets) {
         auto overlapping =
             stateSet.intervals.findOverlapping(requestedInterval);
 
         if (!overlapping.empty()) {
-            auto &currentState = stateSet.state;
+            const auto currentState = stateSet.state;
 
             // Generate barriers for each overlapping interval
             for (const auto &overlap : overlapping) {
@@ -137,23 +465,8 @@ void ResourceTracker::request_image(vk::Image image,
                 }
                 remainingIntervals = std::move(nextRemaining);
 
-                if (currentState.layout != layout ||
-                    currentState.stage != stage ||
-                    currentState.access != access ||
-                    currentState.layout == vk::ImageLayout::eUndefined) {
-
-                    vk::ImageMemoryBarrier2 barrier;
-                    barrier.srcStageMask = currentState.stage;
-                    barrier.srcAccessMask = currentState.access;
-                    barrier.dstStageMask = stage;
-                    barrier.dstAccessMask = access;
-                    barrier.oldLayout = currentState.layout;
-                    barrier.newLayout = layout;
-                    barrier.image = image;
-                    barrier.subresourceRange = intersection->range;
-
-                    m_pending_image_barriers.push_back(barrier);
-                }
+                updated.emplace_back(
+                    *intersection, apply(currentState, intersection->range));
             }
 
             // Remove overlapping intervals from old state
@@ -167,38 +480,144 @@ void ResourceTracker::request_image(vk::Image image,
         // Only generate barrier if we are transitioning to a specific layout
         // (Undefined -> Undefined doesn't need a barrier, but Undefined ->
         // Something does)
-        if (layout != vk::ImageLayout::eUndefined) {
-            vk::ImageMemoryBarrier2 barrier;
-            barrier.srcStageMask = vk::PipelineStageFlagBits2::eNone;
-            barrier.srcAccessMask = vk::AccessFlagBits2::eNone;
-            barrier.dstStageMask = stage;
-            barrier.dstAccessMask = access;
-            barrier.oldLayout = vk::ImageLayout::eUndefined;
-            barrier.newLayout = layout;
-            barrier.image = image;
-            barrier.subresourceRange = interval.range;
-
-            m_pending_image_barriers.push_back(barrier);
+        if (!m_shard && layout != vk::ImageLayout::eUndefined) {
+            make_barrier(InternalImageState{}, interval.range);
+            updated.emplace_back(interval,
+                                 after_barrier(InternalImageState{}));
         }
     }
 
     // Add to new state group
-    track_image(image, subresourceRange, layout, stage, access);
+    track_image(image, subresourceRange, requested);
+    for (const auto &[interval, state] : updated) {
+        track_image(image, interval.range, state);
+    }
+
+    // A shard leaves untracked parts to merge(): they start in the state of
+    // their first use
+    if (m_shard) {
+        auto firstUse = requested;
+        firstUse.first_use = true;
+        for (const auto &interval : remainingIntervals) {
+            track_image(image, interval.range, firstUse);
+        }
+    }
 }
 
 void ResourceTracker::request_buffer(vk::Buffer buffer, vk::DeviceSize offset,
                                      vk::DeviceSize size,
-                                     vk::PipelineStageFlags2 stage,
-                                     vk::AccessFlags2 access) {
+                                     const InternalBufferState &requested,
+                                     bool force) {
     BufferInterval requestedInterval(offset, size);
     auto &stateSets = m_buffer_states[buffer];
 
-    // Check if new access has any write
-    const bool newHasWrite = (access & (vk::AccessFlagBits2::eMemoryWrite |
-                                        vk::AccessFlagBits2::eShaderWrite |
-                                        vk::AccessFlagBits2::eTransferWrite |
-                                        vk::AccessFlagBits2::eHostWrite)) !=
-                             vk::AccessFlagBits2::eNone;
+    const auto make_barrier = [&](const InternalBufferState &current,
+                                  const BufferInterval &interval) {
+        if (current.first_use) {
+            m_first_uses.push_back(BufferState{
+                buffer, interval.offset, interval.size, current.stage,
+                current.access, current.queue_family});
+        }
+        vk::BufferMemoryBarrier2 barrier;
+        barrier.srcStageMask = current.stage;
+        barrier.srcAccessMask = current.access;
+        barrier.dstStageMask = requested.stage;
+        barrier.dstAccessMask = requested.access;
+        barrier.buffer = buffer;
+        barrier.offset = interval.offset;
+        barrier.size = interval.size;
+        if (transfers_ownership(current.queue_family,
+                                requested.queue_family)) {
+            barrier.srcQueueFamilyIndex = current.queue_family;
+            barrier.dstQueueFamilyIndex = requested.queue_family;
+            m_pending_releases[current.queue_family]
+                .buffer_barriers.push_back(release_half(barrier));
+            barrier = acquire_half(barrier);
+            ++m_statistics.ownership_transfers;
+        }
+        m_pending_buffer_barriers.push_back(barrier);
+    };
+
+    // See request_image()
+    const auto after_barrier = [&](const InternalBufferState &current) {
+        auto state = requested;
+        state.queue_family =
+            owner_after(current.queue_family, requested.queue_family);
+        if (has_write(requested.access)) {
+            state.write_stage = requested.stage;
+            state.write_access = requested.access;
+            return state;
+        }
+        if (has_write(current.access)) {
+            state.write_stage = current.stage;
+            state.write_access = current.access;
+        } else {
+            state.write_stage = current.write_stage;
+            state.write_access = current.write_access;
+        }
+        if (transfers_ownership(current.queue_family,
+                                requested.queue_family)) {
+            state.write_stage |= requested.stage;
+        }
+        return state;
+    };
+
+    // Read-after-read needs no barrier: the readers accumulate in the
+    // tracked state, so that the next write waits for all of them. A
+    // reader the last barrier did not cover still waits for the last
+    // write.
+    const auto accumulate = [&](const InternalBufferState &current,
+                                const BufferInterval &interval) {
+        const bool covered =
+            (current.stage | requested.stage) == current.stage &&
+            (current.access | requested.access) == current.access;
+        if (!covered &&
+            current.write_stage != vk::PipelineStageFlagBits2::eNone) {
+            auto writer = current;
+            writer.stage = current.write_stage;
+            writer.access = current.write_access;
+            make_barrier(writer, interval);
+        }
+        auto state = current;
+        state.stage |= requested.stage;
+        state.access |= requested.access;
+        state.queue_family =
+            owner_after(current.queue_family, requested.queue_family);
+        return state;
+    };
+
+    const auto apply = [&](const InternalBufferState &current,
+                           const BufferInterval &interval) {
+        if (force || needs_barrier(current, requested)) {
+            make_barrier(current, interval);
+            return after_barrier(current);
+        }
+        return accumulate(current, interval);
+    };
+
+    // Common case: the buffer has one known state over exactly the
+    // requested range. Update it in place.
+    if (stateSets.size() == 1 && stateSets[0].intervals.size() == 1 &&
+        stateSets[0].intervals.intervals()[0] == requestedInterval) {
+        auto &current = stateSets[0].state;
+        current = apply(current, requestedInterval);
+        return;
+    }
+
+    // A shard leaves untracked parts to merge(): they start in the state of
+    // their first use
+    BufferIntervalSet untracked;
+    if (m_shard) {
+        untracked.add(requestedInterval);
+        for (const auto &stateSet : stateSets) {
+            for (const auto &interval : stateSet.intervals.intervals()) {
+                untracked.remove(interval);
+            }
+        }
+    }
+
+    // States of the parts, tracked once the request is applied
+    std::vector<std::pair<BufferInterval, InternalBufferState>> updated;
 
     // Check all state groups for overlaps
     bool foundOverlap = false;
@@ -208,39 +627,19 @@ void ResourceTracker::request_buffer(vk::Buffer buffer, vk::DeviceSize offset,
 
         if (!overlapping.empty()) {
             foundOverlap = true;
-            auto &currentState = stateSet.state;
-
-            // Check if current state has any write access
-            const bool currentHasWrite =
-                (currentState.access & (vk::AccessFlagBits2::eMemoryWrite |
-                                        vk::AccessFlagBits2::eShaderWrite |
-                                        vk::AccessFlagBits2::eTransferWrite |
-                                        vk::AccessFlagBits2::eHostWrite)) !=
-                vk::AccessFlagBits2::eNone;
-
-            // Need barrier if: WAW, WAR, or RAW (not RAR)
-            const bool needBarrier = currentHasWrite || newHasWrite;
-
-            if (needBarrier) {
-                // Generate barriers for each overlapping interval
-                for (const auto &overlap : overlapping) {
-                    // Intersect with requested interval to only barrier what's
-                    // needed
-                    auto intersection = overlap.intersect(requestedInterval);
-                    if (!intersection)
-                        continue;
-
-                    vk::BufferMemoryBarrier2 barrier;
-                    barrier.srcStageMask = currentState.stage;
-                    barrier.srcAccessMask = currentState.access;
-                    barrier.dstStageMask = stage;
-                    barrier.dstAccessMask = access;
-                    barrier.buffer = buffer;
-                    barrier.offset = intersection->offset;
-                    barrier.size = intersection->size;
-
-                    m_pending_buffer_barriers.push_back(barrier);
-                }
+            const auto currentState = stateSet.state;
+
+            // Barrier on WAW, WAR and RAW, and on RAR not covered by the
+            // last barrier
+            for (const auto &overlap : overlapping) {
+                // Intersect with requested interval to only barrier what's
+                // needed
+                auto intersection = overlap.intersect(requestedInterval);
+                if (!intersection)
+                    continue;
+
+                updated.emplace_back(*intersection,
+                                     apply(currentState, *intersection));
             }
 
             // Remove overlapping intervals from old state
@@ -248,47 +647,41 @@ void ResourceTracker::request_buffer(vk::Buffer buffer, vk::DeviceSize offset,
         }
     }
 
-    // If no overlap found (untracked), assume undefined state and generate full
-    // barrier if needed Actually, for buffers, untracked usually means we don't
-    // know the state. User requested: "When a buffer is requested, if there is
-    // no entry for this buffer, we should assume full memory barrier."
-    if (!foundOverlap) {
-        // Full memory barrier for the requested range
-        // We assume the previous state could be anything (Undefined is not
-        // quite right for buffers, but effectively we need to wait for
-        // everything) However, we can't really put "Undefined" stage/access for
-        // buffers in a useful way that matches "Full Memory Barrier" logic
-        // without using AllCommands/AllRead/AllWrite.
-
-        // Let's use AllCommands -> Target Stage, MemoryRead|Write -> Target
-        // Access Or simply srcStage=AllCommands, srcAccess=MemoryWrite?
-
-        vk::BufferMemoryBarrier2 barrier;
-        barrier.srcStageMask = vk::PipelineStageFlagBits2::eAllCommands;
-        barrier.srcAccessMask = vk::AccessFlagBits2::eMemoryWrite |
-                                vk::AccessFlagBits2::eMemoryRead;
-        // Wait, if we don't know previous state, we must assume worst case: it
-        // was written to by any stage.
-
-        barrier.dstStageMask = stage;
-        barrier.dstAccessMask = access;
-        barrier.buffer = buffer;
-        barrier.offset = offset;
-        barrier.size = size;
-
-        m_pending_buffer_barriers.push_back(barrier);
+    // If no overlap found (untracked), we don't know the state: assume the
+    // buffer was written to by any stage and emit a full barrier
+    if (!foundOverlap && !m_shard) {
+        const InternalBufferState unknown{
+            vk::PipelineStageFlagBits2::eAllCommands,
+            vk::AccessFlagBits2::eMemoryWrite |
+                vk::AccessFlagBits2::eMemoryRead};
+        make_barrier(unknown, requestedInterval);
+        updated.emplace_back(requestedInterval, after_barrier(unknown));
     }
 
     // Add to new state group
-    track_buffer(buffer, offset, size, stage, access);
+    track_buffer(buffer, offset, size, requested);
+    for (const auto &[interval, state] : updated) {
+        track_buffer(buffer, interval.offset, interval.size, state);
+    }
+    auto firstUse = requested;
+    firstUse.first_use = true;
+    for (const auto &interval : untracked.intervals()) {
+        track_buffer(buffer, interval.offset, interval.size, firstUse);
+    }
 }
 
 void ResourceTracker::request_acceleration_structure(
     vk::AccelerationStructureKHR handle, vk::PipelineStageFlags2 stage,
     vk::AccessFlags2 access) {
 
-    auto it = m_as_states.find(handle);
-    if (it == m_as_states.end()) {
+    auto *state = m_as_states.find(handle);
+    if (!state && m_shard) {
+        m_first_uses.push_back(
+            AccelerationStructureState{handle, stage, access});
+        m_as_states[handle] = {stage, access};
+        return;
+    }
+    if (!state) {
         // Untracked AS: Assume full memory barrier
         vk::MemoryBarrier2 barrier;
         barrier.srcStageMask = vk::PipelineStageFlagBits2::eAllCommands;
@@ -299,11 +692,12 @@ void ResourceTracker::request_acceleration_structure(
 
         m_pending_memory_barriers.push_back(barrier);
 
-        m_as_states[handle] = {stage, access};
+        m_as_states[handle] = {stage, access, barrier.srcStageMask,
+                               barrier.srcAccessMask};
         return;
     }
 
-    auto &currentState = it->second;
+    auto &currentState = *state;
 
     // Check if current state has any write access
     const bool currentHasWrite =
@@ -324,36 +718,369 @@ void ResourceTracker::request_acceleration_structure(
     // Don't need barrier for Read-after-Read (RAR)
     const bool needBarrier = currentHasWrite || newHasWrite;
 
-    if (needBarrier) {
+    const auto add_barrier = [&](vk::PipelineStageFlags2 srcStage,
+                                 vk::AccessFlags2 srcAccess) {
         vk::MemoryBarrier2 barrier;
-        barrier.srcStageMask = currentState.stage;
-        barrier.srcAccessMask = currentState.access;
+        barrier.srcStageMask = srcStage;
+        barrier.srcAccessMask = srcAccess;
         barrier.dstStageMask = stage;
         barrier.dstAccessMask = access;
 
         m_pending_memory_barriers.push_back(barrier);
+    };
+
+    if (needBarrier) {
+        add_barrier(currentState.stage, currentState.access);
 
+        // Later readers wait for the write this barrier waited for
+        if (newHasWrite) {
+            currentState.write_stage = stage;
+            currentState.write_access = access;
+        } else {
+            currentState.write_stage = currentState.stage;
+            currentState.write_access = currentState.access;
+        }
         currentState.stage = stage;
         currentState.access = access;
+        return;
+    }
+
+    // Readers accumulate, so that the next write waits for all of them.
+    // One the last barrier did not cover still waits for the last write.
+    const bool covered = (currentState.stage | stage) == currentState.stage &&
+                         (currentState.access | access) == currentState.access;
+    if (!covered &&
+        currentState.write_stage != vk::PipelineStageFlagBits2::eNone) {
+        add_barrier(currentState.write_stage, currentState.write_access);
     }
+    currentState.stage |= stage;
+    currentState.access |= access;
+}
+
+void ResourceTracker::merge_pending_barriers() {
+    const auto requested = m_pending_image_barriers.size() +
+                           m_pending_buffer_barriers.size() +
+                           m_pending_memory_barriers.size();
+
+    merge_barriers(m_pending_image_barriers,
+                   [](vk::ImageMemoryBarrier2 &into,
+                      const vk::ImageMemoryBarrier2 &barrier) {
+                       auto range = exact_union(into.subresourceRange,
+                                                barrier.subresourceRange);
+                       if (range) {
+                           into.subresourceRange = *range;
+                       }
+                       return range.has_value();
+                   });
+
+    merge_barriers(m_pending_buffer_barriers,
+                   [](vk::BufferMemoryBarrier2 &into,
+                      const vk::BufferMemoryBarrier2 &barrier) {
+                       auto interval = exact_union(into, barrier);
+                       if (interval) {
+                           into.offset = interval->offset;
+                           into.size = interval->size;
+                       }
+                       return interval.has_value();
+                   });
+
+    // Drivers typically implement buffer barriers as global ones: past a
+    // few of them, a single global barrier is as precise and cheaper to
+    // record. Queue family ownership transfers must stay buffer barriers.
+    const auto foldable = [](const vk::BufferMemoryBarrier2 &barrier) {
+        return barrier.srcQueueFamilyIndex == barrier.dstQueueFamilyIndex;
+    };
+    const auto foldable_count = static_cast<std::size_t>(
+        std::ranges::count_if(m_pending_buffer_barriers, foldable));
+    if (m_global_barrier_threshold != 0 &&
+        foldable_count >= m_global_barrier_threshold) {
+        vk::MemoryBarrier2 global;
+        for (const auto &barrier : m_pending_buffer_barriers) {
+            if (foldable(barrier)) {
+                global.srcStageMask |= barrier.srcStageMask;
+                global.srcAccessMask |= barrier.srcAccessMask;
+                global.dstStageMask |= barrier.dstStageMask;
+                global.dstAccessMask |= barrier.dstAccessMask;
+            }
+        }
+        std::erase_if(m_pending_buffer_barriers, foldable);
+        m_pending_memory_barriers.push_back(global);
+        m_statistics.folded_buffer_barriers += foldable_count;
+    }
+
+    // Identical global barriers are redundant
+    merge_barriers(
+        m_pending_memory_barriers,
+        [](vk::MemoryBarrier2 &, const vk::MemoryBarrier2 &) { return true; });
+
+    m_statistics.requested_barriers += requested;
+    m_statistics.emitted_barriers += m_pending_image_barriers.size() +
+                                     m_pending_buffer_barriers.size() +
+                                     m_pending_memory_barriers.size();
+}
+
+void ResourceTracker::merge(ResourceTracker &&shard) {
+    if (!shard.m_shard) {
+        throw LogicException::invalid_state("Only shards can be merged");
+    }
+    if (!shard.m_pending_image_barriers.empty() ||
+        !shard.m_pending_buffer_barriers.empty() ||
+        !shard.m_pending_memory_barriers.empty() ||
+        !shard.m_pending_waits.empty() || !shard.m_released.empty()) {
+        throw LogicException::invalid_state(
+            "Shard merged with barriers it did not flush");
+    }
+
+    // A barrier of the shard depends on these first uses: they must come
+    // after every previous access, readers included
+    for (const auto &state : shard.m_first_uses) {
+        if (wait_released(state)) {
+            continue;
+        }
+        std::visit(
+            [this](const auto &arg) {
+                using T = std::decay_t<decltype(arg)>;
+                if constexpr (std::is_same_v<T, ImageState>) {
+                    request_image(arg.image, arg.subresourceRange,
+                                  {arg.layout, arg.stage, arg.access,
+                                   arg.queue_family},
+                                  true);
+                } else if constexpr (std::is_same_v<T, BufferState>) {
+                    request_buffer(arg.buffer, arg.offset, arg.size,
+                                   {arg.stage, arg.access, arg.queue_family},
+                                   true);
+                } else {
+                    request_acceleration_structure(arg.handle, arg.stage,
+                                                   arg.access);
+                }
+            },
+            state);
+    }
+
+    // The other first uses are requested as they would have been on this
+    // tracker, then the states left by the shard replace the tracked ones
+    shard.m_image_states.for_each([this](vk::Image image,
+                                         const auto &stateSets) {
+        for (const auto &stateSet : stateSets) {
+            const auto &state = stateSet.state;
+            for (const auto &interval : stateSet.intervals.intervals()) {
+                if (state.first_use) {
+                    request(ImageState{image, interval.range, state.layout,
+                                       state.stage, state.access,
+                                       state.queue_family});
+                } else {
+                    track_image(image, interval.range, state);
+                }
+            }
+        }
+    });
+    shard.m_buffer_states.for_each([this](vk::Buffer buffer,
+                                          const auto &stateSets) {
+        for (const auto &stateSet : stateSets) {
+            const auto &state = stateSet.state;
+            for (const auto &interval : stateSet.intervals.intervals()) {
+                if (state.first_use) {
+                    request(BufferState{buffer, interval.offset, interval.size,
+                                        state.stage, state.access,
+                                        state.queue_family});
+                } else {
+                    track_buffer(buffer, interval.offset, interval.size,
+                                 state);
+                }
+            }
+        }
+    });
+    shard.m_as_states.for_each(
+        [this](vk::AccelerationStructureKHR handle, const auto &state) {
+            m_as_states[handle] = state;
+        });
+
+    for (auto &[family, releases] : shard.m_pending_releases) {
+        auto &into = m_pending_releases[family];
+        into.image_barriers.insert(into.image_barriers.end(),
+                                   releases.image_barriers.begin(),
+                                   releases.image_barriers.end());
+        into.buffer_barriers.insert(into.buffer_barriers.end(),
+                                    releases.buffer_barriers.begin(),
+                                    releases.buffer_barriers.end());
+    }
+
+    const auto &statistics = shard.m_statistics;
+    m_statistics.requested_barriers += statistics.requested_barriers;
+    m_statistics.emitted_barriers += statistics.emitted_barriers;
+    m_statistics.folded_buffer_barriers += statistics.folded_buffer_barriers;
+    m_statistics.pipeline_barrier_count += statistics.pipeline_barrier_count;
+    m_statistics.split_barriers += statistics.split_barriers;
+    m_statistics.ownership_transfers += statistics.ownership_transfers;
+
+    shard = create_shard();
+}
+
+void ResourceTracker::enable_split_barriers(
+    std::shared_ptr<EventPool> events) {
+    m_events = std::move(events);
+}
+
+void ResourceTracker::release(vk::CommandBuffer commandBuffer,
+                              const ResourceState &next) {
+    if (!m_events ||
+        std::holds_alternative<AccelerationStructureState>(next)) {
+        request(next);
+        return;
+    }
+
+    const auto key = resource_key(next);
+    if (std::ranges::any_of(m_released, [&](const SplitBarrier &split) {
+            return resource_key(split.next) == key;
+        })) {
+        throw LogicException::invalid_state(
+            "Resource released twice without being requested");
+    }
+
+    // Barriers requested so far come before the event
+    flush(commandBuffer);
+    request(next);
+    if (m_pending_image_barriers.empty() &&
+        m_pending_buffer_barriers.empty()) {
+        return;
+    }
+
+    // Events cannot transfer ownership: keep the acquire for flush()
+    const auto transfer = [](const auto &barrier) {
+        return barrier.srcQueueFamilyIndex != barrier.dstQueueFamilyIndex;
+    };
+    if (std::ranges::any_of(m_pending_image_barriers, transfer) ||
+        std::ranges::any_of(m_pending_buffer_barriers, transfer)) {
+        return;
+    }
+
+    SplitBarrier split{
+        .event = m_events->acquire(),
+        .next = next,
+        .image_barriers = std::exchange(m_pending_image_barriers, {}),
+        .buffer_barriers = std::exchange(m_pending_buffer_barriers, {})};
+
+    vk::DependencyInfo dependencyInfo;
+    dependencyInfo.setImageMemoryBarriers(split.image_barriers);
+    dependencyInfo.setBufferMemoryBarriers(split.buffer_barriers);
+    commandBuffer.setEvent2(split.event, dependencyInfo);
+
+    m_statistics.split_barriers +=
+        split.image_barriers.size() + split.buffer_barriers.size();
+    m_released.push_back(std::move(split));
+}
+
+bool ResourceTracker::wait_released(const ResourceState &state) {
+    const auto key = resource_key(state);
+    auto it = std::ranges::find_if(m_released, [&](const SplitBarrier &split) {
+        return resource_key(split.next) == key;
+    });
+    if (it == m_released.end()) {
+        return false;
+    }
+    const bool transitioned = it->next == state;
+    m_pending_waits.push_back(std::move(*it));
+    m_released.erase(it);
+    return transitioned;
+}
+
+void ResourceTracker::wait_pending_events(vk::CommandBuffer commandBuffer) {
+    if (m_pending_waits.empty()) {
+        return;
+    }
+
+    // Set and wait must be given the same dependency info
+    std::vector<vk::Event> events;
+    std::vector<vk::DependencyInfo> dependencyInfos;
+    for (const auto &split : m_pending_waits) {
+        events.push_back(split.event);
+        dependencyInfos.push_back(
+            vk::DependencyInfo()
+                .setImageMemoryBarriers(split.image_barriers)
+                .setBufferMemoryBarriers(split.buffer_barriers));
+    }
+    commandBuffer.waitEvents2(events, dependencyInfos);
+
+    // Reset once the waiting stages went past the wait
+    for (const auto &split : m_pending_waits) {
+        vk::PipelineStageFlags2 stages;
+        for (const auto &barrier : split.image_barriers) {
+            stages |= barrier.dstStageMask;
+        }
+        for (const auto &barrier : split.buffer_barriers) {
+            stages |= barrier.dstStageMask;
+        }
+        commandBuffer.resetEvent2(split.event, stages);
+        m_events->retire(split.event);
+    }
+    m_pending_waits.clear();
 }
 
 void ResourceTracker::flush(vk::CommandBuffer commandBuffer) {
+    VW_TRACE_ZONE("ResourceTracker::flush");
+    wait_pending_events(commandBuffer);
+
     if (m_pending_image_barriers.empty() && m_pending_buffer_barriers.empty() &&
         m_pending_memory_barriers.empty()) {
         return;
     }
 
+    merge_pending_barriers();
+
     vk::DependencyInfo dependencyInfo;
     dependencyInfo.setImageMemoryBarriers(m_pending_image_barriers);
     dependencyInfo.setBufferMemoryBarriers(m_pending_buffer_barriers);
     dependencyInfo.setMemoryBarriers(m_pending_memory_barriers);
 
     commandBuffer.pipelineBarrier2(dependencyInfo);
+    ++m_statistics.pipeline_barrier_count;
 
     m_pending_image_barriers.clear();
     m_pending_buffer_barriers.clear();
     m_pending_memory_barriers.clear();
 }
 
+void ResourceTracker::flush_releases(vk::CommandBuffer commandBuffer,
+                                     uint32_t queue_family) {
+    auto it = m_pending_releases.find(queue_family);
+    if (it == m_pending_releases.end()) {
+        return;
+    }
+
+    vk::DependencyInfo dependencyInfo;
+    dependencyInfo.setImageMemoryBarriers(it->second.image_barriers);
+    dependencyInfo.setBufferMemoryBarriers(it->second.buffer_barriers);
+    commandBuffer.pipelineBarrier2(dependencyInfo);
+    ++m_statistics.pipeline_barrier_count;
+
+    m_pending_releases.erase(it);
+}
+
+bool ResourceTracker::has_pending_releases(
+    uint32_t queue_family) const noexcept {
+    return m_pending_releases.contains(queue_family);
+}
+
+void ResourceTracker::set_queue_family(uint32_t queue_family) noexcept {
+    m_queue_family = queue_family;
+}
+
+uint32_t
+ResourceTracker::requested_family(uint32_t queue_family) const noexcept {
+    return queue_family == vk::QueueFamilyIgnored ? m_queue_family
+                                                  : queue_family;
+}
+
+void ResourceTracker::set_global_barrier_threshold(
+    std::size_t threshold) noexcept {
+    m_global_barrier_threshold = threshold;
+}
+
+const ResourceTracker::Statistics &
+ResourceTracker::statistics() const noexcept {
+    return m_statistics;
+}
+
+void ResourceTracker::reset_statistics() noexcept { m_statistics = {}; }
+
 } // namespace vw::Barrier
@@ -0,0 +1,56 @@
+#include "VulkanWrapper/Synchronization/TimelineSemaphore.h"
+
+#include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Vulkan/Device.h"
+
+namespace vw {
+
+namespace {
+vk::UniqueSemaphore create_timeline_semaphore(const Device &device,
+                                              uint64_t initial_value) {
+    auto type_info = vk::SemaphoreTypeCreateInfo()
+                         .setSemaphoreType(vk::SemaphoreType::eTimeline)
+                         .setInitialValue(initial_value);
+    const auto info = vk::SemaphoreCreateInfo().setPNext(&type_info);
+    return check_vk(device.handle().createSemaphoreUnique(info),
+                    "Failed to create timeline semaphore");
+}
+} // namespace
+
+TimelineSemaphore::TimelineSemaphore(std::shared_ptr<const Device> device,
+                                     uint64_t initial_value)
+    : ObjectWithUniqueHandle<vk::UniqueSemaphore>(
+          create_timeline_semaphore(*device, initial_value))
+    , m_device(std::move(device)) {}
+
+uint64_t TimelineSemaphore::value() const {
+    return check_vk(m_device->handle().getSemaphoreCounterValue(handle()),
+                    "Failed to get semaphore value");
+}
+
+void TimelineSemaphore::wait(uint64_t value) const {
+    const auto semaphore = handle();
+    const auto info =
+        vk::SemaphoreWaitInfo().setSemaphores(semaphore).setValues(value);
+    check_vk(m_device->handle().waitSemaphores(
+                 info, std::numeric_limits<uint64_t>::max()),
+             "Failed to wait for semaphore");
+}
+
+void TimelineSemaphore::signal(uint64_t value) const {
+    const auto info =
+        vk::SemaphoreSignalInfo().setSemaphore(handle()).setValue(value);
+    check_vk(m_device->handle().signalSemaphore(info),
+             "Failed to signal semaphore");
+}
+
+vk::SemaphoreSubmitInfo
+TimelineSemaphore::submit_info(uint64_t value,
+                               vk::PipelineStageFlags2 stage) const noexcept {
+    return vk::SemaphoreSubmitInfo()
+        .setSemaphore(handle())
+        .setValue(value)
+        .setStageMask(stage);
+}
+
+} // namespace vw
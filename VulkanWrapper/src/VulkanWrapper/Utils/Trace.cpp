@@ -0,0 +1,159 @@
+#include "VulkanWrapper/Utils/Trace.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <set>
+
+namespace vw::trace {
+
+namespace {
+
+// Single-producer single-consumer ring: the owning thread records, and
+// collect() drains under the registry mutex
+struct ThreadBuffer {
+    std::array<Zone, thread_buffer_capacity> zones;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::set<std::string, std::less<>> names;
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint32_t> thread_count{0};
+};
+
+// Leaked: threads may record after static destruction has begun
+Registry &registry() {
+    static auto *registry = new Registry;
+    return *registry;
+}
+
+ThreadBuffer *thread_buffer() noexcept {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        try {
+            auto created = std::make_shared<ThreadBuffer>();
+            std::lock_guard lock(registry().mutex);
+            registry().buffers.push_back(created);
+            buffer = std::move(created);
+        } catch (...) {
+            return nullptr;
+        }
+    }
+    return buffer.get();
+}
+
+void append_escaped(std::string &json, std::string_view text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            json += '\\';
+        }
+        json += c;
+    }
+}
+
+} // namespace
+
+uint64_t now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+uint32_t thread_index() noexcept {
+    thread_local const uint32_t index = registry().thread_count++;
+    return index;
+}
+
+void record(const Zone &zone) noexcept {
+    auto *buffer = thread_buffer();
+    if (!buffer) {
+        registry().dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const auto head = buffer->head.load(std::memory_order_relaxed);
+    if (head - buffer->tail.load(std::memory_order_acquire) ==
+        thread_buffer_capacity) {
+        registry().dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->zones[head % thread_buffer_capacity] = zone;
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+std::string_view intern(std::string_view name) {
+    auto &registry = trace::registry();
+    std::lock_guard lock(registry.mutex);
+    return *registry.names.emplace(name).first;
+}
+
+std::vector<Zone> collect() {
+    auto &registry = trace::registry();
+    std::vector<Zone> zones;
+    {
+        std::lock_guard lock(registry.mutex);
+        for (auto &buffer : registry.buffers) {
+            const auto tail = buffer->tail.load(std::memory_order_relaxed);
+            const auto head = buffer->head.load(std::memory_order_acquire);
+            for (auto i = tail; i != head; ++i) {
+                zones.push_back(buffer->zones[i % thread_buffer_capacity]);
+            }
+            buffer->tail.store(head, std::memory_order_release);
+        }
+        // Only the registry holds the buffers of exited threads
+        std::erase_if(registry.buffers, [](const auto &buffer) {
+            return buffer.use_count() == 1;
+        });
+    }
+
+    std::ranges::stable_sort(zones, {}, &Zone::begin_ns);
+    return zones;
+}
+
+uint64_t dropped_count() noexcept {
+    return registry().dropped.load(std::memory_order_relaxed);
+}
+
+std::string to_chrome_json(std::span<const Zone> zones) {
+    std::string json = R"({"traceEvents":[)";
+    auto out = std::back_inserter(json);
+
+    const auto origin = zones.empty()
+                            ? uint64_t{0}
+                            : std::ranges::min(zones, {}, &Zone::begin_ns)
+                                  .begin_ns;
+    const bool has_gpu = std::ranges::any_of(
+        zones, [](const Zone &zone) { return zone.thread == gpu_thread; });
+    if (has_gpu) {
+        std::format_to(out,
+                       R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},)"
+                       R"("args":{{"name":"GPU"}}}})",
+                       gpu_thread);
+    }
+
+    for (std::size_t i = 0; i < zones.size(); ++i) {
+        const auto &zone = zones[i];
+        json += (i == 0 && !has_gpu) ? R"({"name":")" : R"(,{"name":")";
+        append_escaped(json, zone.name);
+        std::format_to(out,
+                       R"(","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":1,)"
+                       R"("tid":{}}})",
+                       double(zone.begin_ns - origin) / 1'000.0,
+                       double(zone.end_ns - zone.begin_ns) / 1'000.0,
+                       zone.thread);
+    }
+    json += "]}";
+    return json;
+}
+
+} // namespace vw::trace
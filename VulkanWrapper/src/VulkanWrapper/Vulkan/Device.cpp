@@ -9,25 +9,60 @@ struct DeviceImpl {
     vk::UniqueDevice device;
     vk::PhysicalDevice physicalDevice;
     std::vector<Queue> queues;
+    std::optional<Queue> transferQueue;
+    std::optional<Queue> computeQueue;
     std::optional<PresentQueue> presentQueue;
+    bool memoryBudget;
 };
 
 Device::Device(vk::UniqueDevice device, vk::PhysicalDevice physicalDevice,
-               std::vector<Queue> queues,
-               std::optional<PresentQueue> presentQueue) noexcept
+               std::vector<Queue> queues, std::optional<Queue> transferQueue,
+               std::optional<Queue> computeQueue,
+               std::optional<PresentQueue> presentQueue, bool memoryBudget)
     : m_impl{std::make_shared<DeviceImpl>(
           DeviceImpl{.device = std::move(device),
                      .physicalDevice = physicalDevice,
                      .queues = std::move(queues),
-                     .presentQueue = std::move(presentQueue)})} {
+                     .transferQueue = std::move(transferQueue),
+                     .computeQueue = std::move(computeQueue),
+                     .presentQueue = std::move(presentQueue),
+                     .memoryBudget = memoryBudget})} {
     // Set the device for each queue
     for (auto &queue : m_impl->queues) {
-        queue.m_device = handle();
+        queue.set_device(handle());
+    }
+    if (m_impl->transferQueue) {
+        m_impl->transferQueue->set_device(handle());
+    }
+    if (m_impl->computeQueue) {
+        m_impl->computeQueue->set_device(handle());
     }
 }
 
 Queue &Device::graphicsQueue() { return m_impl->queues[0]; }
 
+Queue &Device::transfer_queue() {
+    if (m_impl->transferQueue) {
+        return *m_impl->transferQueue;
+    }
+    return graphicsQueue();
+}
+
+bool Device::has_dedicated_transfer_queue() const noexcept {
+    return m_impl->transferQueue.has_value();
+}
+
+Queue &Device::compute_queue() {
+    if (m_impl->computeQueue) {
+        return *m_impl->computeQueue;
+    }
+    return graphicsQueue();
+}
+
+bool Device::has_dedicated_compute_queue() const noexcept {
+    return m_impl->computeQueue.has_value();
+}
+
 const PresentQueue &Device::presentQueue() const {
     if (!m_impl->presentQueue) {
         throw LogicException::invalid_state(
@@ -36,6 +71,10 @@ const PresentQueue &Device::presentQueue() const {
     return m_impl->presentQueue.value();
 }
 
+bool Device::has_memory_budget() const noexcept {
+    return m_impl->memoryBudget;
+}
+
 void Device::wait_idle() const { std::ignore = m_impl->device->waitIdle(); }
 
 vk::PhysicalDevice Device::physical_device() const {
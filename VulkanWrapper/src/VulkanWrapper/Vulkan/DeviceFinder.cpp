@@ -170,6 +170,72 @@ DeviceFinder &DeviceFinder::with_scalar_block_layout() noexcept {
     return *this;
 }
 
+DeviceFinder &DeviceFinder::with_timeline_semaphore() noexcept {
+    m_features.get<vk::PhysicalDeviceVulkan12Features>().setTimelineSemaphore(
+        1U);
+    return *this;
+}
+
+DeviceFinder &DeviceFinder::with_pipeline_statistics_query() noexcept {
+    std::erase_if(m_physicalDevicesInformation,
+                  [](const PhysicalDeviceInformation &information) {
+                      return !information.device.device()
+                                  .getFeatures()
+                                  .pipelineStatisticsQuery;
+                  });
+    m_features.get<vk::PhysicalDeviceFeatures2>()
+        .features.setPipelineStatisticsQuery(1U);
+    return *this;
+}
+
+DeviceFinder &DeviceFinder::with_transfer_queue() noexcept {
+    m_transfer_queue = true;
+    with_timeline_semaphore();
+    return *this;
+}
+
+DeviceFinder &DeviceFinder::with_compute_queue() noexcept {
+    m_compute_queue = true;
+    with_timeline_semaphore();
+    return *this;
+}
+
+std::optional<int> DeviceFinder::find_transfer_family(
+    const PhysicalDeviceInformation &information) {
+    std::optional<int> best;
+    const auto &queues = information.queuesInformation;
+    for (int i = 0; i < queues.size(); ++i) {
+        const auto &queue = queues[i];
+        if (!(queue.flags & vk::QueueFlagBits::eTransfer) ||
+            (queue.flags & vk::QueueFlagBits::eGraphics) ||
+            queue.numberAsked >= queue.numberAvailable) {
+            continue;
+        }
+        // Pure transfer families usually map to the DMA engines
+        if (!(queue.flags & vk::QueueFlagBits::eCompute)) {
+            return i;
+        }
+        if (!best) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+std::optional<int> DeviceFinder::find_compute_family(
+    const PhysicalDeviceInformation &information) {
+    const auto &queues = information.queuesInformation;
+    for (int i = 0; i < queues.size(); ++i) {
+        const auto &queue = queues[i];
+        if ((queue.flags & vk::QueueFlagBits::eCompute) &&
+            !(queue.flags & vk::QueueFlagBits::eGraphics) &&
+            queue.numberAsked < queue.numberAvailable) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
 std::optional<PhysicalDevice> DeviceFinder::get() noexcept {
     if (m_physicalDevicesInformation.empty()) {
         return {};
@@ -208,26 +274,71 @@ std::shared_ptr<Device> DeviceFinder::build() {
         information.extensions.push_back("VK_KHR_portability_subset");
     }
 
+    // Optional: gives the allocator the heap budgets of the driver
+    const bool memoryBudget = information.availableExtensions.contains(
+        VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if (memoryBudget) {
+        information.extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
+    // Queue submits with vkQueueSubmit2: synchronization2 is core in
+    // Vulkan 1.3, older drivers expose it as an extension
+    if (information.availableExtensions.contains(
+            VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME) &&
+        std::ranges::find(information.extensions,
+                          std::string_view(
+                              VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME)) ==
+            information.extensions.end()) {
+        information.extensions.push_back(
+            VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+    }
+    m_features.get<vk::PhysicalDeviceSynchronization2Features>()
+        .setSynchronization2(1U);
+
     vk::DeviceCreateInfo info;
     std::vector<vk::DeviceQueueCreateInfo> queueInfos;
 
-    constexpr float priority = {1.0F};
+    // The compute queue is picked first: the transfer queue may share its
+    // family, then takes the next queue of it
+    std::optional<int> computeFamilyIndex;
+    if (m_compute_queue) {
+        computeFamilyIndex = find_compute_family(information);
+        if (computeFamilyIndex) {
+            ++information.queuesInformation[*computeFamilyIndex].numberAsked;
+        }
+    }
+    std::optional<int> transferFamilyIndex;
+    if (m_transfer_queue) {
+        transferFamilyIndex = find_transfer_family(information);
+    }
+    auto queuesToCreate = information.numberOfQueuesToCreate;
+    if (computeFamilyIndex) {
+        ++queuesToCreate[*computeFamilyIndex];
+    }
+    if (transferFamilyIndex) {
+        ++queuesToCreate[*transferFamilyIndex];
+    }
+
+    // One priority per queue of the largest family
+    int maxQueueCount = 1;
+    for (auto [familyIndex, queueCount] : queuesToCreate) {
+        maxQueueCount = std::max(maxQueueCount, queueCount);
+    }
+    const std::vector<float> priorities(maxQueueCount, 1.0F);
 
-    for (auto [familyIndex, queueCount] : information.numberOfQueuesToCreate) {
+    for (auto [familyIndex, queueCount] : queuesToCreate) {
         auto queueInfo = vk::DeviceQueueCreateInfo()
-                             .setQueuePriorities(priority)
+                             .setPQueuePriorities(priorities.data())
                              .setQueueFamilyIndex(familyIndex)
                              .setQueueCount(queueCount);
         queueInfos.push_back(queueInfo);
     }
 
     if (information.presentationFamilyIndex) {
-        if (information
-                .numberOfQueuesToCreate[*information.presentationFamilyIndex] ==
-            0) {
+        if (queuesToCreate[*information.presentationFamilyIndex] == 0) {
             auto queueInfo =
                 vk::DeviceQueueCreateInfo()
-                    .setQueuePriorities(priority)
+                    .setPQueuePriorities(priorities.data())
                     .setQueueFamilyIndex(*information.presentationFamilyIndex)
                     .setQueueCount(1);
             queueInfos.push_back(queueInfo);
@@ -240,6 +351,9 @@ std::shared_ptr<Device> DeviceFinder::build() {
     m_features.get<vk::PhysicalDeviceVulkan12Features>().setBufferDeviceAddress(
         1U);
 
+    // Every queue tracks its submissions with a timeline semaphore
+    with_timeline_semaphore();
+
     // Unlink ray tracing feature structures if ray tracing wasn't requested
     // This prevents validation errors about features in pNext without
     // extensions
@@ -270,11 +384,29 @@ std::shared_ptr<Device> DeviceFinder::build() {
     for (auto [familyIndex, queueCount] : information.numberOfQueuesToCreate) {
         for (int i = 0; i < queueCount; ++i) {
             Queue queue(device->getQueue(familyIndex, i),
-                        information.queuesInformation[familyIndex].flags);
+                        information.queuesInformation[familyIndex].flags,
+                        familyIndex);
             queues.push_back(std::move(queue));
         }
     }
 
+    // Dedicated queues come after those requested with with_queue()
+    auto nextQueueIndex = information.numberOfQueuesToCreate;
+    auto dedicatedQueue = [&](int familyIndex) {
+        return Queue(
+            device->getQueue(familyIndex, nextQueueIndex[familyIndex]++),
+            information.queuesInformation[familyIndex].flags, familyIndex);
+    };
+
+    std::optional<Queue> computeQueue;
+    if (computeFamilyIndex) {
+        computeQueue = dedicatedQueue(*computeFamilyIndex);
+    }
+    std::optional<Queue> transferQueue;
+    if (transferFamilyIndex) {
+        transferQueue = dedicatedQueue(*transferFamilyIndex);
+    }
+
     std::optional<PresentQueue> presentQueue;
 
     if (information.presentationFamilyIndex) {
@@ -282,9 +414,10 @@ std::shared_ptr<Device> DeviceFinder::build() {
             device->getQueue(*information.presentationFamilyIndex, 0));
     }
 
-    return std::shared_ptr<Device>(new Device(std::move(device),
-                                              information.device.device(),
-                                              std::move(queues), presentQueue));
+    return std::shared_ptr<Device>(
+        new Device(std::move(device), information.device.device(),
+                   std::move(queues), std::move(transferQueue),
+                   std::move(computeQueue), presentQueue, memoryBudget));
 }
 
 } // namespace vw
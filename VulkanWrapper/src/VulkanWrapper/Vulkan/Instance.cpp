@@ -56,6 +56,8 @@ Instance::Instance(vk::UniqueInstance instance,
 
 vk::Instance Instance::handle() const noexcept { return *m_impl->instance; }
 
+ApiVersion Instance::api_version() const noexcept { return m_impl->version; }
+
 DeviceFinder Instance::findGpu() const noexcept {
     auto supportVersion = [this](const PhysicalDevice &device) {
         return device.api_version() >= m_impl->version;
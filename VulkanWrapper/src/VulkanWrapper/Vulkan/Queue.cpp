@@ -1,12 +1,45 @@
 #include "VulkanWrapper/Vulkan/Queue.h"
 
 #include "VulkanWrapper/Synchronization/Fence.h"
+#include "VulkanWrapper/Utils/Error.h"
+#include <limits>
 
 namespace vw {
 
-Queue::Queue(vk::Queue queue, vk::QueueFlags type) noexcept
+void SubmitTicket::wait() const {
+    if (queue) {
+        queue->wait(value);
+    }
+}
+
+bool SubmitTicket::is_complete() const {
+    return !queue || queue->completed_value() >= value;
+}
+
+vk::SemaphoreSubmitInfo
+SubmitTicket::wait_info(vk::PipelineStageFlags2 stage) const noexcept {
+    return vk::SemaphoreSubmitInfo()
+        .setSemaphore(queue ? queue->timeline() : vk::Semaphore())
+        .setValue(value)
+        .setStageMask(stage);
+}
+
+Queue::Queue(vk::Queue queue, vk::QueueFlags type,
+             uint32_t family_index) noexcept
     : m_queue{queue}
-    , m_queueFlags{type} {}
+    , m_queueFlags{type}
+    , m_family_index{family_index} {}
+
+void Queue::set_device(vk::Device device) {
+    m_device = device;
+
+    auto type_info = vk::SemaphoreTypeCreateInfo()
+                         .setSemaphoreType(vk::SemaphoreType::eTimeline)
+                         .setInitialValue(0);
+    const auto info = vk::SemaphoreCreateInfo().setPNext(&type_info);
+    m_timeline = check_vk(m_device.createSemaphoreUnique(info),
+                          "Failed to create timeline semaphore");
+}
 
 void Queue::enqueue_command_buffer(vk::CommandBuffer command_buffer) {
     m_command_buffers.push_back(command_buffer);
@@ -19,23 +52,114 @@ void Queue::enqueue_command_buffers(
     }
 }
 
+SubmitTicket Queue::submit(std::span<const SubmitBatch> batches) {
+    return submit_batches(batches, {});
+}
+
+SubmitTicket
+Queue::submit_enqueued(std::span<const vk::SemaphoreSubmitInfo> waits,
+                       std::span<const vk::SemaphoreSubmitInfo> signals) {
+    const auto command_buffers = std::exchange(m_command_buffers, {});
+    const SubmitBatch batch{command_buffers, waits, signals};
+    return submit_batches(std::span(&batch, 1), {});
+}
+
 Fence Queue::submit(std::span<const vk::PipelineStageFlags> waitStages,
                     std::span<const vk::Semaphore> waitSemaphores,
                     std::span<const vk::Semaphore> signalSemaphores) {
-    auto fence = FenceBuilder(m_device).build();
+    std::vector<vk::SemaphoreSubmitInfo> waits;
+    waits.reserve(waitSemaphores.size());
+    for (std::size_t i = 0; i < waitSemaphores.size(); ++i) {
+        // Stage bits keep their values in vk::PipelineStageFlags2
+        waits.push_back(vk::SemaphoreSubmitInfo()
+                            .setSemaphore(waitSemaphores[i])
+                            .setStageMask(vk::PipelineStageFlags2(
+                                VkPipelineStageFlags(waitStages[i]))));
+    }
+
+    std::vector<vk::SemaphoreSubmitInfo> signals;
+    signals.reserve(signalSemaphores.size());
+    for (auto semaphore : signalSemaphores) {
+        signals.push_back(
+            vk::SemaphoreSubmitInfo().setSemaphore(semaphore).setStageMask(
+                vk::PipelineStageFlagBits2::eAllCommands));
+    }
 
-    std::vector<vk::CommandBuffer> cmd_buffers =
-        std::exchange(m_command_buffers, {});
+    return submit2(waits, signals);
+}
 
-    const auto infos = vk::SubmitInfo()
-                           .setCommandBuffers(cmd_buffers)
-                           .setWaitDstStageMask(waitStages)
-                           .setWaitSemaphores(waitSemaphores)
-                           .setSignalSemaphores(signalSemaphores);
+Fence Queue::submit2(std::span<const vk::SemaphoreSubmitInfo> waits,
+                     std::span<const vk::SemaphoreSubmitInfo> signals) {
+    auto fence = FenceBuilder(m_device).build();
 
-    std::ignore = m_queue.submit(infos, fence.handle());
+    const auto command_buffers = std::exchange(m_command_buffers, {});
+    const SubmitBatch batch{command_buffers, waits, signals};
+    std::ignore = submit_batches(std::span(&batch, 1), fence.handle());
 
     return fence;
 }
 
+SubmitTicket Queue::submit_batches(std::span<const SubmitBatch> batches,
+                                   vk::Fence fence) {
+    if (batches.empty()) {
+        // Nothing to execute, but the fence must still be signaled
+        if (fence) {
+            check_vk(m_queue.submit2({}, fence), "Failed to submit queue");
+        }
+        return last_submission();
+    }
+
+    std::size_t command_buffer_count = 0;
+    for (const auto &batch : batches) {
+        command_buffer_count += batch.command_buffers.size();
+    }
+
+    // Only the last submission signals the timeline: its signal waits for
+    // every command submitted before it
+    const auto timeline_signal =
+        vk::SemaphoreSubmitInfo()
+            .setSemaphore(*m_timeline)
+            .setValue(m_submitted_value + 1)
+            .setStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+    std::vector<vk::SemaphoreSubmitInfo> last_signals(
+        batches.back().signals.begin(), batches.back().signals.end());
+    last_signals.push_back(timeline_signal);
+
+    std::vector<vk::CommandBufferSubmitInfo> cmd_buffers;
+    cmd_buffers.reserve(command_buffer_count);
+    std::vector<vk::SubmitInfo2> infos;
+    infos.reserve(batches.size());
+    for (const auto &batch : batches) {
+        const auto first = cmd_buffers.size();
+        for (auto command_buffer : batch.command_buffers) {
+            cmd_buffers.emplace_back(command_buffer);
+        }
+        infos.push_back(vk::SubmitInfo2()
+                            .setCommandBufferInfoCount(
+                                uint32_t(batch.command_buffers.size()))
+                            .setPCommandBufferInfos(cmd_buffers.data() + first)
+                            .setWaitSemaphoreInfos(batch.waits)
+                            .setSignalSemaphoreInfos(batch.signals));
+    }
+    infos.back().setSignalSemaphoreInfos(last_signals);
+
+    check_vk(m_queue.submit2(infos, fence), "Failed to submit queue");
+
+    return {this, ++m_submitted_value};
+}
+
+uint64_t Queue::completed_value() const {
+    return check_vk(m_device.getSemaphoreCounterValue(*m_timeline),
+                    "Failed to get semaphore value");
+}
+
+void Queue::wait(uint64_t value) const {
+    const auto semaphore = *m_timeline;
+    const auto info =
+        vk::SemaphoreWaitInfo().setSemaphores(semaphore).setValues(value);
+    check_vk(m_device.waitSemaphores(info,
+                                     std::numeric_limits<uint64_t>::max()),
+             "Failed to wait for semaphore");
+}
+
 } // namespace vw
@@ -13,8 +13,8 @@ class BindlessMaterialManagerTest : public ::testing::Test {
   protected:
     void SetUp() override {
         auto &gpu = vw::tests::create_gpu();
-        m_staging = std::make_shared<vw::StagingBufferManager>(gpu.device,
-                                                               gpu.allocator);
+        m_staging = std::make_shared<vw::StagingBufferManager>(
+            gpu.device, gpu.allocator, gpu.queue());
         m_manager = std::make_unique<BindlessMaterialManager>(
             gpu.device, gpu.allocator, m_staging);
 
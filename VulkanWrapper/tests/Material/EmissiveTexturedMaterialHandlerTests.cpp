@@ -11,8 +11,8 @@ class EmissiveTexturedMaterialHandlerTest : public ::testing::Test {
   protected:
     void SetUp() override {
         auto &gpu = vw::tests::create_gpu();
-        m_staging = std::make_shared<vw::StagingBufferManager>(gpu.device,
-                                                               gpu.allocator);
+        m_staging = std::make_shared<vw::StagingBufferManager>(
+            gpu.device, gpu.allocator, gpu.queue());
         m_texture_manager = std::make_unique<BindlessTextureManager>(
             gpu.device, gpu.allocator, m_staging);
         m_handler = EmissiveTexturedMaterialHandler::Base::create<
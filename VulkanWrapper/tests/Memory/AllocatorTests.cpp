@@ -2,7 +2,12 @@
 #include "VulkanWrapper/Image/Image.h"
 #include "VulkanWrapper/Memory/AllocateBufferUtils.h"
 #include "VulkanWrapper/Vulkan/DeviceFinder.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <gtest/gtest.h>
+#include <thread>
+#include <vector>
 
 TEST(AllocatorTest, CreateAllocator) {
     auto &gpu = vw::tests::create_gpu();
@@ -175,3 +180,256 @@ TEST(AllocatorTest, CreateMultipleImages) {
 
     EXPECT_NE(image1->handle(), image2->handle());
 }
+
+TEST(AllocatorTest, DefaultAllocatorIsExternallySynchronized) {
+    auto &gpu = vw::tests::create_gpu();
+    EXPECT_FALSE(gpu.allocator->is_internally_synchronized());
+}
+
+TEST(AllocatorTest, InternallySynchronizedAllocator) {
+    auto &gpu = vw::tests::create_gpu();
+    auto allocator = vw::AllocatorBuilder(gpu.instance, gpu.device)
+                         .with_internal_synchronization()
+                         .build();
+
+    EXPECT_NE(allocator->handle(), nullptr);
+    EXPECT_TRUE(allocator->is_internally_synchronized());
+}
+
+TEST(AllocatorTest, ConcurrentBufferAllocationAndFree) {
+    auto &gpu = vw::tests::create_gpu();
+    auto allocator = vw::AllocatorBuilder(gpu.instance, gpu.device)
+                         .with_internal_synchronization()
+                         .build();
+
+    using HostBuffer = vw::Buffer<uint32_t, true, vw::StorageBufferUsage>;
+    using DeviceBuffer = vw::Buffer<uint32_t, false, vw::StorageBufferUsage>;
+
+    constexpr int thread_count = 8;
+    constexpr int iterations = 200;
+    std::atomic<int> failures{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            std::deque<HostBuffer> alive;
+            for (int i = 0; i < iterations; ++i) {
+                auto size = 16 + ((t * iterations + i) % 64) * 16;
+                alive.push_back(
+                    vw::create_buffer<HostBuffer>(*allocator, size));
+                auto device_buffer =
+                    vw::create_buffer<DeviceBuffer>(*allocator, size);
+
+                auto &buffer = alive.back();
+                buffer.write(uint32_t(t * iterations + i), 0);
+                if (buffer.read_as_vector(0, 1)[0] !=
+                    uint32_t(t * iterations + i)) {
+                    ++failures;
+                }
+                if (device_buffer.size() != size_t(size)) {
+                    ++failures;
+                }
+                // Free half of the buffers while others are still alive
+                if (i % 2 == 1) {
+                    alive.pop_front();
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(failures.load(), 0);
+}
+
+TEST(AllocatorTest, ConcurrentImageCreation) {
+    auto &gpu = vw::tests::create_gpu();
+    auto allocator = vw::AllocatorBuilder(gpu.instance, gpu.device)
+                         .with_internal_synchronization()
+                         .build();
+
+    constexpr int thread_count = 8;
+    constexpr int iterations = 32;
+    std::atomic<int> failures{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < iterations; ++i) {
+                auto image = allocator->create_image_2D(
+                    vw::Width{64}, vw::Height{64}, i % 2 == 0,
+                    vk::Format::eR8G8B8A8Unorm,
+                    vk::ImageUsageFlagBits::eSampled |
+                        vk::ImageUsageFlagBits::eTransferDst |
+                        vk::ImageUsageFlagBits::eTransferSrc);
+                if (!image || !image->handle()) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(failures.load(), 0);
+}
+
+TEST(AllocatorTest, CategoryIsInferredFromUsage) {
+    using vw::AllocationCategory;
+    EXPECT_EQ(vw::infer_allocation_category(
+                  vk::ImageUsageFlagBits::eColorAttachment |
+                  vk::ImageUsageFlagBits::eSampled),
+              AllocationCategory::RenderTarget);
+    EXPECT_EQ(vw::infer_allocation_category(
+                  vk::ImageUsageFlagBits::eSampled |
+                  vk::ImageUsageFlagBits::eTransferDst),
+              AllocationCategory::Texture);
+    EXPECT_EQ(vw::infer_allocation_category(
+                  vk::BufferUsageFlags(vw::VertexBufferUsage), false),
+              AllocationCategory::Mesh);
+    EXPECT_EQ(vw::infer_allocation_category(
+                  vk::BufferUsageFlags(vw::StagingBufferUsage), true),
+              AllocationCategory::Staging);
+    EXPECT_EQ(vw::infer_allocation_category(
+                  vk::BufferUsageFlags(vw::StagingBufferUsage), false),
+              AllocationCategory::Other);
+    EXPECT_EQ(
+        vw::infer_allocation_category(
+            vk::BufferUsageFlagBits::eAccelerationStructureStorageKHR |
+                vk::BufferUsageFlagBits::eShaderDeviceAddress,
+            false),
+        AllocationCategory::AccelerationStructure);
+}
+
+TEST(AllocatorTest, AccountingFollowsBufferLifetime) {
+    auto &gpu = vw::tests::create_gpu();
+    auto allocator = vw::AllocatorBuilder(gpu.instance, gpu.device).build();
+    using vw::AllocationCategory;
+
+    {
+        auto vertices = vw::allocate_vertex_buffer<float, false>(*allocator,
+                                                                 1024);
+        auto mesh = allocator->category_usage(AllocationCategory::Mesh);
+        EXPECT_EQ(mesh.allocation_count, 1);
+        EXPECT_GE(mesh.bytes, 1024 * sizeof(float));
+
+        auto moved = std::move(vertices);
+        EXPECT_EQ(
+            allocator->category_usage(AllocationCategory::Mesh)
+                .allocation_count,
+            1);
+    }
+
+    const auto mesh = allocator->category_usage(AllocationCategory::Mesh);
+    EXPECT_EQ(mesh.allocation_count, 0);
+    EXPECT_EQ(mesh.bytes, 0);
+    EXPECT_GE(mesh.peak_bytes, 1024 * sizeof(float));
+}
+
+TEST(AllocatorTest, ExplicitCategoryOverridesInference) {
+    auto &gpu = vw::tests::create_gpu();
+    auto allocator = vw::AllocatorBuilder(gpu.instance, gpu.device).build();
+    using vw::AllocationCategory;
+
+    auto image = allocator->create_image_2D(
+        vw::Width{64}, vw::Height{64}, false, vk::Format::eR8G8B8A8Unorm,
+        vk::ImageUsageFlagBits::eColorAttachment |
+            vk::ImageUsageFlagBits::eSampled,
+        AllocationCategory::Texture);
+    auto buffer = allocator->allocate_buffer(
+        256, false, vk::BufferUsageFlagBits::eStorageBuffer,
+        vk::SharingMode::eExclusive, AllocationCategory::AccelerationStructure);
+
+    EXPECT_EQ(allocator->category_usage(AllocationCategory::Texture)
+                  .allocation_count,
+              1);
+    EXPECT_EQ(allocator->category_usage(AllocationCategory::RenderTarget)
+                  .allocation_count,
+              0);
+    EXPECT_EQ(
+        allocator->category_usage(AllocationCategory::AccelerationStructure)
+            .allocation_count,
+        1);
+
+    image.reset();
+    EXPECT_EQ(allocator->category_usage(AllocationCategory::Texture).bytes, 0);
+}
+
+TEST(AllocatorTest, HeapBudgetsCoverEveryHeap) {
+    auto &gpu = vw::tests::create_gpu();
+    const auto heaps = gpu.allocator->heap_budgets();
+
+    ASSERT_FALSE(heaps.empty());
+    EXPECT_TRUE(std::ranges::any_of(
+        heaps, [](const auto &heap) { return heap.is_device_local(); }));
+    for (std::size_t i = 0; i < heaps.size(); ++i) {
+        EXPECT_EQ(heaps[i].heap_index, i);
+        EXPECT_GT(heaps[i].budget, 0);
+        EXPECT_GE(heaps[i].usage, heaps[i].block_bytes);
+    }
+}
+
+TEST(AllocatorTest, MemoryBudgetIsEnabledWhenSupported) {
+    auto &gpu = vw::tests::create_gpu();
+    const auto [result, extensions] =
+        gpu.device->physical_device().enumerateDeviceExtensionProperties();
+    ASSERT_EQ(result, vk::Result::eSuccess);
+
+    const bool supported = std::ranges::any_of(
+        extensions, [](const vk::ExtensionProperties &extension) {
+            return std::string_view(extension.extensionName) ==
+                   VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+        });
+    EXPECT_EQ(gpu.device->has_memory_budget(), supported);
+}
+
+TEST(AllocatorTest, MemoryReportAccountsForAllocations) {
+    auto &gpu = vw::tests::create_gpu();
+    auto allocator = vw::AllocatorBuilder(gpu.instance, gpu.device).build();
+    using StagingBuffer = vw::Buffer<std::byte, true, vw::StagingBufferUsage>;
+    auto staging = vw::create_buffer<StagingBuffer>(*allocator, 4096);
+
+    const auto report = allocator->memory_report();
+    EXPECT_EQ(report.category(vw::AllocationCategory::Staging)
+                  .allocation_count,
+              1);
+    EXPECT_EQ(report.total_bytes(),
+              report.category(vw::AllocationCategory::Staging).bytes);
+
+    vk::DeviceSize heap_allocation_bytes = 0;
+    for (const auto &heap : report.heaps) {
+        heap_allocation_bytes += heap.allocation_bytes;
+    }
+    EXPECT_GE(heap_allocation_bytes, 4096);
+}
+
+TEST(AllocatorTest, MemoryReportJsonListsHeapsAndCategories) {
+    vw::MemoryReport report;
+    report.heaps.push_back(vw::HeapBudget{
+        .heap_index = 0,
+        .flags = vk::MemoryHeapFlagBits::eDeviceLocal,
+        .size = 1024,
+        .budget = 800,
+        .usage = 100,
+        .block_bytes = 64,
+        .allocation_bytes = 32,
+        .block_count = 1,
+        .allocation_count = 2});
+    report.categories[std::size_t(vw::AllocationCategory::Mesh)] = {
+        .allocation_count = 2, .bytes = 32, .peak_bytes = 48};
+
+    const auto json = report.to_json();
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    EXPECT_NE(json.find(R"("device_local":true)"), std::string::npos);
+    EXPECT_NE(json.find(R"("budget":800)"), std::string::npos);
+    EXPECT_NE(
+        json.find(
+            R"("mesh":{"allocation_count":2,"bytes":32,"peak_bytes":48})"),
+        std::string::npos);
+    EXPECT_NE(json.find(R"("render_target":{)"), std::string::npos);
+    EXPECT_NE(json.find(R"("total_bytes":32})"), std::string::npos);
+    EXPECT_EQ(std::ranges::count(json, '{'), std::ranges::count(json, '}'));
+}
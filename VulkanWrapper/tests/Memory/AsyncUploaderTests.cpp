@@ -0,0 +1,207 @@
+#include "utils/create_gpu.hpp"
+#include "VulkanWrapper/Command/CommandPool.h"
+#include "VulkanWrapper/Image/Image.h"
+#include "VulkanWrapper/Memory/AllocateBufferUtils.h"
+#include "VulkanWrapper/Memory/AsyncUploader.h"
+#include "VulkanWrapper/Memory/Buffer.h"
+#include "VulkanWrapper/Synchronization/Fence.h"
+#include "VulkanWrapper/Vulkan/DeviceFinder.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+constexpr VkBufferUsageFlags DeviceBufferUsage =
+    VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+using DeviceBuffer = vw::Buffer<std::byte, false, DeviceBufferUsage>;
+using HostBuffer = vw::Buffer<std::byte, true, vw::StagingBufferUsage>;
+
+// Same as create_gpu(), with a transfer queue when the device has one
+vw::tests::GPU &create_transfer_gpu() {
+    static vw::tests::GPU *gpu = []() {
+        auto instance = vw::InstanceBuilder()
+                            .setDebug()
+                            .setApiVersion(vw::ApiVersion::e13)
+                            .build();
+
+        auto device = instance->findGpu()
+                          .with_queue(vk::QueueFlagBits::eGraphics)
+                          .with_synchronization_2()
+                          .with_transfer_queue()
+                          .build();
+
+        auto allocator = vw::AllocatorBuilder(instance, device).build();
+
+        return new vw::tests::GPU{std::move(instance), std::move(device),
+                                  std::move(allocator)};
+    }();
+
+    return *gpu;
+}
+
+std::vector<std::byte> make_bytes(std::size_t size) {
+    std::vector<std::byte> bytes(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        bytes[i] = std::byte(i * 7 + 3);
+    }
+    return bytes;
+}
+
+// Acquires the batch on the graphics queue and copies `source` back
+std::vector<std::byte> consume(vw::tests::GPU &gpu,
+                               vw::AsyncUploader &uploader,
+                               const vw::AsyncUploader::UploadBatch &batch,
+                               vk::Buffer source, std::size_t size) {
+    auto host = vw::create_buffer<HostBuffer>(*gpu.allocator, size);
+    auto pool = vw::CommandPoolBuilder(gpu.device).build();
+    auto cmd = pool.allocate(1)[0];
+
+    std::ignore = cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    vw::AsyncUploader::record_acquire(cmd, batch);
+    cmd.copyBuffer(source, host.handle(), vk::BufferCopy(0, 0, size));
+    std::ignore = cmd.end();
+
+    const auto wait = uploader.wait_info(
+        batch.value, vk::PipelineStageFlagBits2::eTransfer);
+    gpu.queue().enqueue_command_buffer(cmd);
+    gpu.queue().submit2(std::span(&wait, 1), {}).wait();
+
+    return host.read_as_vector(0, size);
+}
+
+} // namespace
+
+TEST(AsyncUploaderTest, UploadIsVisibleAfterTimelineWait) {
+    auto &gpu = create_transfer_gpu();
+    vw::AsyncUploader uploader(gpu.device, gpu.allocator);
+    auto buffer = vw::create_buffer<DeviceBuffer>(*gpu.allocator, 4096);
+    const auto data = make_bytes(4096);
+
+    uploader.upload(std::span<const std::byte>(data), buffer, 0);
+    const auto batch = uploader.submit();
+
+    EXPECT_EQ(batch.value, 1);
+    EXPECT_EQ(batch.buffer_acquires.empty(),
+              !uploader.uses_dedicated_queue());
+    EXPECT_EQ(consume(gpu, uploader, batch, buffer.handle(), data.size()),
+              data);
+    EXPECT_TRUE(uploader.is_complete(batch.value));
+}
+
+TEST(AsyncUploaderTest, DedicatedQueueComesFromAnotherFamily) {
+    auto &gpu = create_transfer_gpu();
+    if (!gpu.device->has_dedicated_transfer_queue()) {
+        GTEST_SKIP() << "No transfer-only queue family";
+    }
+    const auto &transfer = gpu.device->transfer_queue();
+    EXPECT_NE(transfer.family_index(), gpu.queue().family_index());
+    EXPECT_FALSE(transfer.flags() & vk::QueueFlagBits::eGraphics);
+}
+
+TEST(AsyncUploaderTest, FallsBackToGraphicsQueue) {
+    auto &gpu = vw::tests::create_gpu();
+    ASSERT_FALSE(gpu.device->has_dedicated_transfer_queue());
+    vw::AsyncUploader uploader(gpu.device, gpu.allocator);
+    auto buffer = vw::create_buffer<DeviceBuffer>(*gpu.allocator, 256);
+    const auto data = make_bytes(256);
+
+    uploader.upload(std::span<const std::byte>(data), buffer, 0);
+    const auto batch = uploader.submit();
+
+    EXPECT_FALSE(uploader.uses_dedicated_queue());
+    EXPECT_TRUE(batch.buffer_acquires.empty());
+    EXPECT_TRUE(batch.image_acquires.empty());
+    EXPECT_EQ(consume(gpu, uploader, batch, buffer.handle(), data.size()),
+              data);
+}
+
+TEST(AsyncUploaderTest, UploadsLargerThanRingAreChunked) {
+    auto &gpu = create_transfer_gpu();
+    vw::AsyncUploader uploader(gpu.device, gpu.allocator, 1024);
+    auto buffer = vw::create_buffer<DeviceBuffer>(*gpu.allocator, 8192);
+    const auto data = make_bytes(8192);
+
+    uploader.upload(std::span<const std::byte>(data), buffer, 0);
+    const auto batch = uploader.submit();
+
+    // Chunks submitted early are covered by the last value
+    EXPECT_GT(batch.value, 1);
+    EXPECT_EQ(consume(gpu, uploader, batch, buffer.handle(), data.size()),
+              data);
+}
+
+TEST(AsyncUploaderTest, EmptySubmitKeepsLastValue) {
+    auto &gpu = create_transfer_gpu();
+    vw::AsyncUploader uploader(gpu.device, gpu.allocator);
+    EXPECT_EQ(uploader.submit().value, 0);
+
+    auto buffer = vw::create_buffer<DeviceBuffer>(*gpu.allocator, 64);
+    const auto data = make_bytes(64);
+    uploader.upload(std::span<const std::byte>(data), buffer, 0);
+    const auto first = uploader.submit();
+    const auto second = uploader.submit();
+
+    EXPECT_EQ(second.value, first.value);
+    EXPECT_TRUE(second.buffer_acquires.empty());
+    uploader.wait(second.value);
+}
+
+TEST(AsyncUploaderTest, ImageUploadEndsReadOnly) {
+    auto &gpu = create_transfer_gpu();
+    vw::AsyncUploader uploader(gpu.device, gpu.allocator, 1024);
+    constexpr uint32_t size = 32;
+    auto image = gpu.allocator->create_image_2D(
+        vw::Width(size), vw::Height(size), false, vk::Format::eR8G8B8A8Unorm,
+        vk::ImageUsageFlagBits::eTransferDst |
+            vk::ImageUsageFlagBits::eTransferSrc);
+    const auto pixels = make_bytes(size * size * 4);
+
+    uploader.upload_image(pixels, image);
+    const auto batch = uploader.submit();
+    EXPECT_EQ(batch.image_acquires.size(),
+              uploader.uses_dedicated_queue() ? 1 : 0);
+
+    auto host = vw::create_buffer<HostBuffer>(*gpu.allocator, pixels.size());
+    auto pool = vw::CommandPoolBuilder(gpu.device).build();
+    auto cmd = pool.allocate(1)[0];
+    std::ignore = cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    vw::AsyncUploader::record_acquire(cmd, batch);
+    const auto to_src =
+        vk::ImageMemoryBarrier2()
+            .setSrcStageMask(vk::PipelineStageFlagBits2::eAllCommands)
+            .setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
+            .setDstAccessMask(vk::AccessFlagBits2::eTransferRead)
+            .setOldLayout(vk::ImageLayout::eReadOnlyOptimal)
+            .setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
+            .setImage(image->handle())
+            .setSubresourceRange(image->full_range());
+    cmd.pipelineBarrier2(vk::DependencyInfo().setImageMemoryBarriers(to_src));
+    cmd.copyImageToBuffer(
+        image->handle(), vk::ImageLayout::eTransferSrcOptimal, host.handle(),
+        vk::BufferImageCopy()
+            .setImageSubresource(image->mip_level_layer(vw::MipLevel(0)))
+            .setImageExtent(image->extent3D()));
+    std::ignore = cmd.end();
+
+    const auto wait = uploader.wait_info(
+        batch.value, vk::PipelineStageFlagBits2::eAllCommands);
+    gpu.queue().enqueue_command_buffer(cmd);
+    gpu.queue().submit2(std::span(&wait, 1), {}).wait();
+
+    EXPECT_EQ(host.read_as_vector(0, pixels.size()), pixels);
+}
+
+TEST(AsyncUploaderTest, MismatchedPixelSizeThrows) {
+    auto &gpu = create_transfer_gpu();
+    vw::AsyncUploader uploader(gpu.device, gpu.allocator);
+    auto image = gpu.allocator->create_image_2D(
+        vw::Width(4), vw::Height(4), false, vk::Format::eR8G8B8A8Unorm,
+        vk::ImageUsageFlagBits::eTransferDst);
+    const auto pixels = make_bytes(10);
+
+    EXPECT_THROW(uploader.upload_image(pixels, image), vw::LogicException);
+}
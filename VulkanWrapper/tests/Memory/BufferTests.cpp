@@ -2,8 +2,11 @@
 #include "VulkanWrapper/Memory/AllocateBufferUtils.h"
 #include "VulkanWrapper/Memory/Buffer.h"
 #include "VulkanWrapper/Memory/BufferList.h"
+#include <chrono>
 #include <cstring>
 #include <gtest/gtest.h>
+#include <thread>
+#include <utility>
 #include <vector>
 
 TEST(BufferTest, CreateUniformBuffer) {
@@ -160,6 +163,156 @@ TEST(BufferTest, WriteBytes) {
     }
 }
 
+TEST(BufferTest, HostVisibleBufferIsPersistentlyMapped) {
+    auto &gpu = vw::tests::create_gpu();
+    using HostUniformBuffer = vw::Buffer<float, true, vw::UniformBufferUsage>;
+    auto buffer = vw::create_buffer<HostUniformBuffer>(*gpu.allocator, 16);
+
+    EXPECT_TRUE(buffer.is_mapped());
+    EXPECT_EQ(buffer.mapped_bytes().size(), buffer.size_bytes());
+    EXPECT_EQ(buffer.as_span().size(), 16);
+}
+
+TEST(BufferTest, DeviceLocalBufferIsNotMapped) {
+    auto &gpu = vw::tests::create_gpu();
+    using UniformBuffer = vw::Buffer<float, false, vw::UniformBufferUsage>;
+    auto buffer = vw::create_buffer<UniformBuffer>(*gpu.allocator, 16);
+
+    EXPECT_FALSE(buffer.is_mapped());
+    EXPECT_TRUE(buffer.mapped_bytes().empty());
+}
+
+TEST(BufferTest, WriteThroughSpanIsVisibleToRead) {
+    auto &gpu = vw::tests::create_gpu();
+    using HostUniformBuffer = vw::Buffer<int32_t, true, vw::UniformBufferUsage>;
+    auto buffer = vw::create_buffer<HostUniformBuffer>(*gpu.allocator, 8);
+
+    auto view = buffer.as_span(2, 3);
+    view[0] = 7;
+    view[1] = 8;
+    view[2] = 9;
+    buffer.flush(2, 3);
+
+    auto retrieved = buffer.read_as_vector(2, 3);
+    EXPECT_EQ(retrieved, (std::vector<int32_t>{7, 8, 9}));
+}
+
+TEST(BufferTest, WriteIsVisibleThroughConstSpan) {
+    auto &gpu = vw::tests::create_gpu();
+    using HostUniformBuffer = vw::Buffer<float, true, vw::UniformBufferUsage>;
+    auto buffer = vw::create_buffer<HostUniformBuffer>(*gpu.allocator, 4);
+
+    std::vector<float> values = {1.0f, 2.0f, 3.0f, 4.0f};
+    buffer.write(std::span<const float>(values), 0);
+
+    const auto &const_buffer = buffer;
+    buffer.invalidate(0, 4);
+    std::span<const float> view = const_buffer.as_span();
+    ASSERT_EQ(view.size(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_FLOAT_EQ(view[i], values[i]);
+    }
+}
+
+TEST(BufferTest, SpanMovesWithBuffer) {
+    auto &gpu = vw::tests::create_gpu();
+    using HostUniformBuffer = vw::Buffer<float, true, vw::UniformBufferUsage>;
+    auto buffer1 = vw::create_buffer<HostUniformBuffer>(*gpu.allocator, 4);
+    auto *data = buffer1.as_span().data();
+
+    auto buffer2 = std::move(buffer1);
+    EXPECT_EQ(buffer2.as_span().data(), data);
+}
+
+TEST(BufferTest, SpanOutOfRangeThrows) {
+    auto &gpu = vw::tests::create_gpu();
+    using HostUniformBuffer = vw::Buffer<float, true, vw::UniformBufferUsage>;
+    auto buffer = vw::create_buffer<HostUniformBuffer>(*gpu.allocator, 4);
+
+    EXPECT_THROW(std::ignore = buffer.as_span(2, 3), vw::LogicException);
+}
+
+TEST(BufferTest, MappedAccessBenchmark) {
+    // Compares the unmapped copies buffers used before being persistently
+    // mapped, the write/read API, now copying through the mapping, and
+    // in-place access through the mapped span. Timings are reported, not
+    // asserted.
+    auto &gpu = vw::tests::create_gpu();
+    using HostStorageBuffer =
+        vw::Buffer<glm::mat4, true, vw::StorageBufferUsage>;
+    constexpr size_t count = 256;
+    constexpr int iterations = 1000;
+    constexpr VkDeviceSize size = count * sizeof(glm::mat4);
+    auto buffer = vw::create_buffer<HostStorageBuffer>(*gpu.allocator, count);
+
+    std::vector<glm::mat4> values(count, glm::mat4(1.0f));
+    std::vector<glm::mat4> copy(count);
+    using clock = std::chrono::steady_clock;
+
+    // Same buffer as create_buffer() made before, without
+    // VMA_ALLOCATION_CREATE_MAPPED_BIT: each copy maps and unmaps
+    VkBufferCreateInfo buffer_info{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    buffer_info.size = size;
+    buffer_info.usage =
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    VmaAllocationCreateInfo allocation_info{};
+    allocation_info.flags =
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+    allocation_info.usage = VMA_MEMORY_USAGE_AUTO;
+    VkBuffer unmapped_buffer = VK_NULL_HANDLE;
+    VmaAllocation unmapped = nullptr;
+    ASSERT_EQ(vmaCreateBuffer(gpu.allocator->handle(), &buffer_info,
+                              &allocation_info, &unmapped_buffer, &unmapped,
+                              nullptr),
+              VK_SUCCESS);
+
+    auto start = clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        values[0][0][0] = float(i);
+        ASSERT_EQ(vmaCopyMemoryToAllocation(gpu.allocator->handle(),
+                                            values.data(), unmapped, 0,
+                                            size),
+                  VK_SUCCESS);
+        ASSERT_EQ(vmaCopyAllocationToMemory(gpu.allocator->handle(),
+                                            unmapped, 0, copy.data(), size),
+                  VK_SUCCESS);
+        ASSERT_FLOAT_EQ(copy[0][0][0], float(i));
+    }
+    const auto unmapped_time = clock::now() - start;
+    vmaDestroyBuffer(gpu.allocator->handle(), unmapped_buffer, unmapped);
+
+    start = clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        values[0][0][0] = float(i);
+        buffer.write(std::span<const glm::mat4>(values), 0);
+        auto read = buffer.read_as_vector(0, count);
+        ASSERT_FLOAT_EQ(read[0][0][0], float(i));
+    }
+    const auto copy_time = clock::now() - start;
+
+    start = clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        auto view = buffer.as_span();
+        std::ranges::fill(view, glm::mat4(1.0f));
+        view[0][0][0] = float(i);
+        buffer.flush(0, count);
+        buffer.invalidate(0, count);
+        ASSERT_FLOAT_EQ(std::as_const(buffer).as_span()[0][0][0], float(i));
+    }
+    const auto mapped_time = clock::now() - start;
+
+    using us = std::chrono::microseconds;
+    RecordProperty(
+        "unmapped_copy_path_us",
+        std::to_string(std::chrono::duration_cast<us>(unmapped_time).count()));
+    RecordProperty(
+        "copy_path_us",
+        std::to_string(std::chrono::duration_cast<us>(copy_time).count()));
+    RecordProperty(
+        "mapped_path_us",
+        std::to_string(std::chrono::duration_cast<us>(mapped_time).count()));
+}
+
 // BufferList tests
 
 TEST(BufferListTest, FirstAllocationStartsAtZero) {
@@ -306,3 +459,196 @@ TEST(BufferListTest, AlignmentDoesNotOverlapPreviousAllocation) {
     EXPECT_EQ(info2.offset % 128, 0);
     EXPECT_GE(info2.offset, 200); // Must not overlap with first allocation
 }
+
+TEST(BufferListTest, ConcurrentAllocationsDoNotOverlap) {
+    auto &gpu = vw::tests::create_gpu();
+    auto allocator = vw::AllocatorBuilder(gpu.instance, gpu.device)
+                         .with_internal_synchronization()
+                         .build();
+    using StorageBufferList =
+        vw::BufferList<std::byte, false, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT>;
+    StorageBufferList list(allocator);
+
+    constexpr int thread_count = 8;
+    constexpr int iterations = 500;
+    constexpr std::size_t size = 4096;
+    std::vector<std::vector<StorageBufferList::BufferInfo>> results(
+        thread_count);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < iterations; ++i) {
+                results[t].push_back(list.create_buffer(size, 256));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::map<vk::Buffer, std::vector<std::size_t>> offsets_per_buffer;
+    for (const auto &per_thread : results) {
+        for (const auto &info : per_thread) {
+            EXPECT_EQ(info.offset % 256, 0);
+            offsets_per_buffer[info.buffer->handle()].push_back(info.offset);
+        }
+    }
+    for (auto &[buffer, offsets] : offsets_per_buffer) {
+        std::ranges::sort(offsets);
+        for (std::size_t i = 1; i < offsets.size(); ++i) {
+            EXPECT_GE(offsets[i], offsets[i - 1] + size);
+        }
+    }
+}
+
+TEST(BufferListTest, ReleasedRangeIsReused) {
+    auto &gpu = vw::tests::create_gpu();
+    using StorageBufferList =
+        vw::BufferList<std::byte, false, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT>;
+
+    StorageBufferList list(gpu.allocator);
+
+    auto info1 = list.create_buffer(100);
+    auto info2 = list.create_buffer(100);
+    list.release(info1);
+    auto info3 = list.create_buffer(100);
+
+    EXPECT_EQ(info3.buffer, info1.buffer);
+    EXPECT_EQ(info3.offset, info1.offset);
+    EXPECT_NE(info3.offset, info2.offset);
+}
+
+TEST(BufferListTest, LargeAllocationGetsDedicatedBuffer) {
+    auto &gpu = vw::tests::create_gpu();
+    using StorageBufferList =
+        vw::BufferList<std::byte, false, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT>;
+
+    StorageBufferList list(gpu.allocator);
+
+    auto small = list.create_buffer(100);
+    auto large =
+        list.create_buffer(StorageBufferList::default_buffer_size + 1);
+
+    EXPECT_NE(small.buffer, large.buffer);
+    EXPECT_EQ(large.offset, 0);
+    EXPECT_EQ(list.statistics().buffer_count, 2);
+}
+
+TEST(BufferListTest, StatisticsTrackUsage) {
+    auto &gpu = vw::tests::create_gpu();
+    using StorageBufferList =
+        vw::BufferList<std::byte, false, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT>;
+
+    StorageBufferList list(gpu.allocator);
+
+    auto info1 = list.create_buffer(100);
+    std::ignore = list.create_buffer(200);
+
+    auto stats = list.statistics();
+    EXPECT_EQ(stats.buffer_count, 1);
+    EXPECT_EQ(stats.allocation_count, 2);
+    EXPECT_EQ(stats.used_size, 300);
+    EXPECT_EQ(stats.total_size, StorageBufferList::default_buffer_size);
+
+    list.release(info1);
+    stats = list.statistics();
+    EXPECT_EQ(stats.allocation_count, 1);
+    EXPECT_EQ(stats.used_size, 200);
+}
+
+TEST(BufferListTest, TrimDestroysEmptyBuffers) {
+    auto &gpu = vw::tests::create_gpu();
+    using StorageBufferList =
+        vw::BufferList<std::byte, false, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT>;
+
+    StorageBufferList list(gpu.allocator);
+
+    auto small = list.create_buffer(100);
+    auto large =
+        list.create_buffer(StorageBufferList::default_buffer_size + 1);
+    list.release(large);
+
+    EXPECT_EQ(list.trim(), 1);
+    EXPECT_EQ(list.statistics().buffer_count, 1);
+
+    list.release(small);
+    EXPECT_EQ(list.trim(), 1);
+    EXPECT_EQ(list.statistics().buffer_count, 0);
+}
+
+TEST(BufferListTest, ReleaseAllKeepsBuffers) {
+    auto &gpu = vw::tests::create_gpu();
+    using StorageBufferList =
+        vw::BufferList<std::byte, false, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT>;
+
+    StorageBufferList list(gpu.allocator);
+
+    auto info1 = list.create_buffer(100);
+    std::ignore = list.create_buffer(100);
+    list.release_all();
+
+    auto stats = list.statistics();
+    EXPECT_EQ(stats.buffer_count, 1);
+    EXPECT_EQ(stats.allocation_count, 0);
+    EXPECT_EQ(list.create_buffer(100).offset, info1.offset);
+}
+
+TEST(BufferListTest, ReleaseForeignRangeThrows) {
+    auto &gpu = vw::tests::create_gpu();
+    using StorageBufferList =
+        vw::BufferList<std::byte, false, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT>;
+
+    StorageBufferList list(gpu.allocator);
+    StorageBufferList other(gpu.allocator);
+
+    auto info = other.create_buffer(100);
+
+    EXPECT_THROW(list.release(info), vw::LogicException);
+}
+
+TEST(BufferListTest, ReleaseAfterReleaseAllThrows) {
+    auto &gpu = vw::tests::create_gpu();
+    using StorageBufferList =
+        vw::BufferList<std::byte, false, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT>;
+
+    StorageBufferList list(gpu.allocator);
+
+    auto stale = list.create_buffer(100);
+    list.release_all();
+    auto live = list.create_buffer(100);
+
+    EXPECT_THROW(list.release(stale), vw::LogicException);
+    EXPECT_EQ(list.statistics().allocation_count, 1);
+    list.release(live);
+    EXPECT_EQ(list.statistics().allocation_count, 0);
+}
+
+TEST(BufferListTest, ReleaseAfterTrimThrows) {
+    auto &gpu = vw::tests::create_gpu();
+    using StorageBufferList =
+        vw::BufferList<std::byte, false, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT>;
+
+    StorageBufferList list(gpu.allocator);
+
+    auto info = list.create_buffer(100);
+    list.release_all();
+    EXPECT_EQ(list.trim(), 1);
+
+    EXPECT_THROW(list.release(info), vw::LogicException);
+}
+
+TEST(BufferListTest, BufferIdsAreNotReusedAfterTrim) {
+    auto &gpu = vw::tests::create_gpu();
+    using StorageBufferList =
+        vw::BufferList<std::byte, false, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT>;
+
+    StorageBufferList list(gpu.allocator);
+
+    auto first = list.create_buffer(100);
+    const auto first_id = first.buffer_id;
+    list.release(first);
+    EXPECT_EQ(list.trim(), 1);
+
+    EXPECT_NE(list.create_buffer(100).buffer_id, first_id);
+}
@@ -0,0 +1,159 @@
+#include "utils/create_gpu.hpp"
+#include "VulkanWrapper/Memory/Allocator.h"
+#include "VulkanWrapper/Memory/FrameRingAllocator.h"
+#include "VulkanWrapper/Memory/UniformBufferAllocator.h"
+#include <chrono>
+#include <cstring>
+#include <glm/glm.hpp>
+#include <gtest/gtest.h>
+
+TEST(FrameRingAllocatorTest, AllocationsAreAlignedAndSequential) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::FrameRingAllocator ring(gpu.allocator, 4096, 2);
+
+    auto a = ring.allocate<float>();
+    auto b = ring.allocate<glm::mat4>();
+    auto c = ring.allocate<float>(100);
+
+    ASSERT_TRUE(a && b && c);
+    EXPECT_EQ(a->offset, 0);
+    EXPECT_EQ(b->offset, 256);
+    EXPECT_EQ(c->offset, 512);
+    EXPECT_EQ(c->size, 512);
+    EXPECT_EQ(ring.used_size(), 1024);
+}
+
+TEST(FrameRingAllocatorTest, ExhaustedFrameReturnsNullopt) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::FrameRingAllocator ring(gpu.allocator, 1024, 2);
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.allocate<float>());
+    }
+    EXPECT_FALSE(ring.allocate<float>());
+}
+
+TEST(FrameRingAllocatorTest, FramesUseDisjointRegions) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::FrameRingAllocator ring(gpu.allocator, 1024, 3);
+
+    std::vector<vk::DeviceSize> first_offsets;
+    for (uint32_t frame = 0; frame < 3; ++frame) {
+        EXPECT_EQ(ring.frame_index(), frame);
+        first_offsets.push_back(ring.allocate<float>()->offset);
+        ring.end_frame();
+        ring.begin_frame();
+    }
+
+    EXPECT_EQ(first_offsets, (std::vector<vk::DeviceSize>{0, 1024, 2048}));
+    // The ring wrapped around: frame 0 is recycled from its start
+    EXPECT_EQ(ring.frame_index(), 0);
+    EXPECT_EQ(ring.used_size(), 0);
+    EXPECT_EQ(ring.allocate<float>()->offset, 0);
+}
+
+TEST(FrameRingAllocatorTest, WriteIsVisibleThroughBuffer) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::FrameRingAllocator ring(gpu.allocator, 4096, 2);
+
+    ring.begin_frame();
+    auto allocation = ring.allocate<glm::vec4>();
+    ASSERT_TRUE(allocation);
+    allocation->write(glm::vec4(1.0f, 2.0f, 3.0f, 4.0f));
+    ring.end_frame();
+
+    auto bytes = ring.buffer_ref()->read_as_vector(
+        static_cast<std::size_t>(allocation->offset), sizeof(glm::vec4));
+    glm::vec4 loaded;
+    std::memcpy(&loaded, bytes.data(), sizeof(glm::vec4));
+    EXPECT_EQ(loaded, glm::vec4(1.0f, 2.0f, 3.0f, 4.0f));
+}
+
+TEST(FrameRingAllocatorTest, DescriptorInfoMatchesAllocation) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::FrameRingAllocator ring(gpu.allocator, 4096, 2);
+
+    std::ignore = ring.allocate<float>();
+    auto allocation = ring.allocate<float>();
+    ASSERT_TRUE(allocation);
+
+    auto info = allocation->descriptor_info();
+    EXPECT_EQ(info.buffer, ring.buffer());
+    EXPECT_EQ(info.offset, allocation->offset);
+    EXPECT_EQ(info.range, allocation->size);
+    EXPECT_EQ(allocation->dynamic_offset(), 256);
+}
+
+TEST(FrameRingAllocatorTest, BeginFrameWaitsForTicket) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::FrameRingAllocator ring(gpu.allocator, 1024, 2);
+    auto &queue = gpu.queue();
+
+    for (int frame = 0; frame < 6; ++frame) {
+        ring.begin_frame();
+        ASSERT_TRUE(ring.allocate<float>());
+        ring.end_frame(queue.submit_enqueued());
+    }
+    SUCCEED();
+}
+
+TEST(FrameRingAllocatorTest, ZeroFramesThrows) {
+    auto &gpu = vw::tests::create_gpu();
+    EXPECT_THROW(vw::FrameRingAllocator(gpu.allocator, 1024, 0),
+                 vw::LogicException);
+}
+
+TEST(FrameRingAllocatorTest, NonPowerOfTwoAlignmentThrows) {
+    auto &gpu = vw::tests::create_gpu();
+    EXPECT_THROW(vw::FrameRingAllocator(gpu.allocator, 1024, 2, 96),
+                 vw::LogicException);
+    EXPECT_THROW(vw::FrameRingAllocator(gpu.allocator, 1024, 2, 0),
+                 vw::LogicException);
+}
+
+TEST(FrameRingAllocatorTest, TenThousandAllocationsPerFrameBenchmark) {
+    // Per-draw constants for 10k draws, over several frames. Compares the
+    // ring with the first-fit UniformBufferAllocator. Timings are
+    // reported, not asserted.
+    auto &gpu = vw::tests::create_gpu();
+    constexpr int allocations_per_frame = 10'000;
+    constexpr int frames = 8;
+    constexpr vk::DeviceSize frame_size = allocations_per_frame * 256;
+    using clock = std::chrono::steady_clock;
+
+    vw::FrameRingAllocator ring(gpu.allocator, frame_size, 3);
+    const glm::mat4 value(1.0f);
+
+    auto start = clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        ring.begin_frame();
+        for (int i = 0; i < allocations_per_frame; ++i) {
+            auto allocation = ring.allocate<glm::mat4>();
+            ASSERT_TRUE(allocation);
+            allocation->write(value);
+        }
+        ring.end_frame();
+    }
+    const auto ring_time = clock::now() - start;
+
+    vw::UniformBufferAllocator first_fit(gpu.allocator, frame_size);
+    start = clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        for (int i = 0; i < allocations_per_frame; ++i) {
+            auto chunk = first_fit.allocate<glm::mat4>();
+            ASSERT_TRUE(chunk);
+            chunk->write(value);
+        }
+        first_fit.clear();
+    }
+    const auto first_fit_time = clock::now() - start;
+
+    using us = std::chrono::microseconds;
+    RecordProperty(
+        "ring_us",
+        std::to_string(std::chrono::duration_cast<us>(ring_time).count()));
+    RecordProperty(
+        "first_fit_us",
+        std::to_string(
+            std::chrono::duration_cast<us>(first_fit_time).count()));
+}
@@ -0,0 +1,132 @@
+#include "utils/create_gpu.hpp"
+#include "VulkanWrapper/Image/Image.h"
+#include "VulkanWrapper/Image/ImageView.h"
+#include "VulkanWrapper/Memory/Allocator.h"
+#include "VulkanWrapper/Memory/RenderTargetPool.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr auto format = vk::Format::eR16G16B16A16Sfloat;
+constexpr auto usage = vk::ImageUsageFlagBits::eColorAttachment |
+                       vk::ImageUsageFlagBits::eSampled;
+
+vw::RenderTargetPool make_pool(uint32_t frames_in_flight,
+                               uint32_t bucket_size = 1) {
+    auto &gpu = vw::tests::create_gpu();
+    return vw::RenderTargetPool(gpu.device, gpu.allocator, frames_in_flight,
+                                bucket_size);
+}
+
+} // namespace
+
+TEST(RenderTargetPoolTest, BucketRoundsUp) {
+    auto pool = make_pool(2, 64);
+
+    EXPECT_EQ(pool.bucket(vw::Width{1000}, vw::Height{700}),
+              (vk::Extent2D{1024, 704}));
+    EXPECT_EQ(pool.bucket(vw::Width{64}, vw::Height{1}),
+              (vk::Extent2D{64, 64}));
+}
+
+TEST(RenderTargetPoolTest, DefaultBucketAbsorbsSmallResizes) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::RenderTargetPool pool(gpu.device, gpu.allocator, 2);
+
+    EXPECT_EQ(pool.bucket(vw::Width{1000}, vw::Height{700}),
+              pool.bucket(vw::Width{1020}, vw::Height{704}));
+}
+
+TEST(RenderTargetPoolTest, ZeroBucketSizeThrows) {
+    auto &gpu = vw::tests::create_gpu();
+    EXPECT_THROW(vw::RenderTargetPool(gpu.device, gpu.allocator, 2, 0),
+                 vw::LogicException);
+}
+
+TEST(RenderTargetPoolTest, AcquireRendersIntoSubRectOfBucket) {
+    auto pool = make_pool(2, 64);
+
+    auto target = pool.acquire(format, usage, vw::Width{1000},
+                               vw::Height{700});
+
+    EXPECT_EQ(target.image->extent2D(), (vk::Extent2D{1024, 704}));
+    EXPECT_EQ(target.extent, (vk::Extent2D{1000, 700}));
+    EXPECT_EQ(target.view->image(), target.image);
+}
+
+TEST(RenderTargetPoolTest, ReleasedImageWaitsForFramesInFlight) {
+    auto pool = make_pool(2);
+
+    auto first = pool.acquire(format, usage, vw::Width{256},
+                              vw::Height{256});
+    pool.release(first.image);
+
+    // Still used by frames in flight
+    auto second = pool.acquire(format, usage, vw::Width{256},
+                               vw::Height{256});
+    EXPECT_NE(second.image, first.image);
+
+    pool.begin_frame();
+    pool.begin_frame();
+    auto third = pool.acquire(format, usage, vw::Width{256},
+                              vw::Height{256});
+    EXPECT_EQ(third.image, first.image);
+
+    const auto statistics = pool.statistics();
+    EXPECT_EQ(statistics.allocation_count, 2u);
+    EXPECT_EQ(statistics.reuse_count, 1u);
+    EXPECT_EQ(statistics.image_count, 2u);
+}
+
+TEST(RenderTargetPoolTest, OnlyMatchingFormatUsageAndBucketAreReused) {
+    auto pool = make_pool(0, 64);
+
+    auto first = pool.acquire(format, usage, vw::Width{100},
+                              vw::Height{100});
+    pool.release(first.image);
+
+    auto other_format = pool.acquire(vk::Format::eR8G8B8A8Unorm, usage,
+                                     vw::Width{100}, vw::Height{100});
+    auto other_usage = pool.acquire(format, vk::ImageUsageFlagBits::eStorage,
+                                    vw::Width{100}, vw::Height{100});
+    auto other_bucket = pool.acquire(format, usage, vw::Width{200},
+                                     vw::Height{100});
+    auto same_bucket = pool.acquire(format, usage, vw::Width{120},
+                                    vw::Height{90});
+
+    EXPECT_NE(other_format.image, first.image);
+    EXPECT_NE(other_usage.image, first.image);
+    EXPECT_NE(other_bucket.image, first.image);
+    EXPECT_EQ(same_bucket.image, first.image);
+    EXPECT_EQ(same_bucket.extent, (vk::Extent2D{120, 90}));
+}
+
+TEST(RenderTargetPoolTest, ReleasingUnknownImageThrows) {
+    auto pool = make_pool(2);
+    auto &gpu = vw::tests::create_gpu();
+    auto image = gpu.allocator->create_image_2D(
+        vw::Width{16}, vw::Height{16}, false, format, usage);
+
+    EXPECT_THROW(pool.release(image), vw::LogicException);
+
+    auto target = pool.acquire(format, usage, vw::Width{16},
+                               vw::Height{16});
+    pool.release(target.image);
+    EXPECT_THROW(pool.release(target.image), vw::LogicException);
+}
+
+TEST(RenderTargetPoolTest, TrimDestroysAvailableImages) {
+    auto pool = make_pool(1);
+
+    auto kept = pool.acquire(format, usage, vw::Width{64}, vw::Height{64});
+    auto released = pool.acquire(format, usage, vw::Width{32},
+                                 vw::Height{32});
+    pool.release(released.image);
+
+    // Not yet safe to destroy
+    EXPECT_EQ(pool.trim(), 0u);
+    pool.begin_frame();
+    EXPECT_EQ(pool.statistics().available_count, 1u);
+    EXPECT_EQ(pool.trim(), 1u);
+    EXPECT_EQ(pool.statistics().image_count, 1u);
+}
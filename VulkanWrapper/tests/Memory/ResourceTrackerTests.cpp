@@ -1,4 +1,6 @@
 #include "VulkanWrapper/Synchronization/ResourceTracker.h"
+#include "VulkanWrapper/Utils/Error.h"
+#include <chrono>
 #include <gtest/gtest.h>
 
 using namespace vw;
@@ -34,14 +36,18 @@ class ResourceTrackerTest : public ::testing::Test {
     };
 
     std::vector<BufferStateInfo> getBufferStates(vk::Buffer buffer) {
+        return getBufferStates(tracker, buffer);
+    }
+
+    static std::vector<BufferStateInfo>
+    getBufferStates(const ResourceTracker &from, vk::Buffer buffer) {
         std::vector<BufferStateInfo> result;
-        if (tracker.m_buffer_states.find(buffer) ==
-            tracker.m_buffer_states.end()) {
+        const auto *stateSets = from.m_buffer_states.find(buffer);
+        if (!stateSets) {
             return result;
         }
 
-        const auto &stateSets = tracker.m_buffer_states[buffer];
-        for (const auto &stateSet : stateSets) {
+        for (const auto &stateSet : *stateSets) {
             for (const auto &interval : stateSet.intervals.intervals()) {
                 result.push_back(
                     {interval, stateSet.state.stage, stateSet.state.access});
@@ -64,14 +70,18 @@ class ResourceTrackerTest : public ::testing::Test {
     };
 
     std::vector<ImageStateInfo> getImageStates(vk::Image image) {
+        return getImageStates(tracker, image);
+    }
+
+    static std::vector<ImageStateInfo>
+    getImageStates(const ResourceTracker &from, vk::Image image) {
         std::vector<ImageStateInfo> result;
-        if (tracker.m_image_states.find(image) ==
-            tracker.m_image_states.end()) {
+        const auto *stateSets = from.m_image_states.find(image);
+        if (!stateSets) {
             return result;
         }
 
-        const auto &stateSets = tracker.m_image_states[image];
-        for (const auto &stateSet : stateSets) {
+        for (const auto &stateSet : *stateSets) {
             for (const auto &interval : stateSet.intervals.intervals()) {
                 result.push_back({interval, stateSet.state.layout,
                                   stateSet.state.stage, stateSet.state.access});
@@ -82,10 +92,37 @@ class ResourceTrackerTest : public ::testing::Test {
         return result;
     }
 
-    void clearPendingBarriers() {
-        tracker.m_pending_buffer_barriers.clear();
-        tracker.m_pending_image_barriers.clear();
-        tracker.m_pending_memory_barriers.clear();
+    const std::vector<vk::ImageMemoryBarrier2> &
+    getPendingImageReleases(uint32_t queue_family) {
+        return tracker.m_pending_releases[queue_family].image_barriers;
+    }
+
+    const std::vector<vk::BufferMemoryBarrier2> &
+    getPendingBufferReleases(uint32_t queue_family) {
+        return tracker.m_pending_releases[queue_family].buffer_barriers;
+    }
+
+    void mergePendingBarriers() { tracker.merge_pending_barriers(); }
+
+    void clearPendingBarriers() { clearPendingBarriers(tracker); }
+
+    // Stands for a flush() into a command buffer
+    static void clearPendingBarriers(ResourceTracker &from) {
+        from.m_pending_buffer_barriers.clear();
+        from.m_pending_image_barriers.clear();
+        from.m_pending_memory_barriers.clear();
+    }
+
+    struct PendingBarriers {
+        std::vector<vk::ImageMemoryBarrier2> images;
+        std::vector<vk::BufferMemoryBarrier2> buffers;
+    };
+
+    static PendingBarriers takePendingBarriers(ResourceTracker &from) {
+        PendingBarriers result{from.m_pending_image_barriers,
+                               from.m_pending_buffer_barriers};
+        clearPendingBarriers(from);
+        return result;
     }
 };
 
@@ -125,13 +162,20 @@ TEST_F(ResourceTrackerTest, Buffer_UntrackedRequest_GeneratesFullBarrier) {
 TEST_F(ResourceTrackerTest, Buffer_RAR_NoBarrier) {
     vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(0x100));
 
-    // Initial state: Shader Read
-    tracker.track(
+    // Initial state: Transfer Write, then read by both shader stages
+    tracker.track(BufferState{.buffer = buffer,
+                              .offset = 0,
+                              .size = 1024,
+                              .stage = vk::PipelineStageFlagBits2::eTransfer,
+                              .access = vk::AccessFlagBits2::eTransferWrite});
+    tracker.request(
         BufferState{.buffer = buffer,
                     .offset = 0,
                     .size = 1024,
-                    .stage = vk::PipelineStageFlagBits2::eFragmentShader,
+                    .stage = vk::PipelineStageFlagBits2::eVertexShader |
+                             vk::PipelineStageFlagBits2::eFragmentShader,
                     .access = vk::AccessFlagBits2::eShaderRead});
+    clearPendingBarriers();
 
     // Request: Vertex Shader Read (Read After Read)
     tracker.request(
@@ -141,19 +185,58 @@ TEST_F(ResourceTrackerTest, Buffer_RAR_NoBarrier) {
                     .stage = vk::PipelineStageFlagBits2::eVertexShader,
                     .access = vk::AccessFlagBits2::eShaderRead});
 
-    // RAR should not generate a barrier
+    // The barrier of the write covered it: RAR generates no barrier
     EXPECT_TRUE(getPendingBufferBarriers().empty());
 
-    // State should be updated (or merged/kept? Actually request updates state
-    // to new usage) Wait, if we request new state, the tracker updates the
-    // state to the NEW usage. So subsequent barriers will transition FROM this
-    // new state.
+    // Readers accumulate, so that the next write waits for both of them
     auto states = getBufferStates(buffer);
     ASSERT_EQ(states.size(), 1);
-    EXPECT_EQ(states[0].stage, vk::PipelineStageFlagBits2::eVertexShader);
+    EXPECT_EQ(states[0].stage, vk::PipelineStageFlagBits2::eFragmentShader |
+                                   vk::PipelineStageFlagBits2::eVertexShader);
     EXPECT_EQ(states[0].access, vk::AccessFlagBits2::eShaderRead);
 }
 
+TEST_F(ResourceTrackerTest, Buffer_UncoveredReaderWaitsForLastWrite) {
+    vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(0x100));
+    tracker.track(BufferState{.buffer = buffer,
+                              .offset = 0,
+                              .size = 1024,
+                              .stage = vk::PipelineStageFlagBits2::eTransfer,
+                              .access = vk::AccessFlagBits2::eTransferWrite});
+    tracker.request(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eVertexShader,
+                    .access = vk::AccessFlagBits2::eShaderRead});
+    clearPendingBarriers();
+
+    // The first barrier only made the write visible to the vertex shader
+    tracker.request(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                    .access = vk::AccessFlagBits2::eShaderStorageRead});
+
+    // It waits for the write, not for the other reader
+    auto barriers = getPendingBufferBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].srcStageMask,
+              vk::PipelineStageFlagBits2::eTransfer);
+    EXPECT_EQ(barriers[0].srcAccessMask,
+              vk::AccessFlagBits2::eTransferWrite);
+    EXPECT_EQ(barriers[0].dstStageMask,
+              vk::PipelineStageFlagBits2::eComputeShader);
+    EXPECT_EQ(barriers[0].dstAccessMask,
+              vk::AccessFlagBits2::eShaderStorageRead);
+
+    auto states = getBufferStates(buffer);
+    ASSERT_EQ(states.size(), 1);
+    EXPECT_EQ(states[0].stage, vk::PipelineStageFlagBits2::eVertexShader |
+                                   vk::PipelineStageFlagBits2::eComputeShader);
+}
+
 TEST_F(ResourceTrackerTest, Buffer_RAW_GeneratesBarrier) {
     vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(0x100));
 
@@ -369,6 +452,42 @@ TEST_F(ResourceTrackerTest, Image_LayoutTransition_GeneratesBarrier) {
     EXPECT_EQ(states[0].layout, vk::ImageLayout::eTransferDstOptimal);
 }
 
+TEST_F(ResourceTrackerTest, Image_TrackReplacesKnownState) {
+    vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x250));
+    vk::ImageSubresourceRange range{vk::ImageAspectFlagBits::eColor, 0, 1, 0,
+                                    1};
+
+    tracker.request(
+        ImageState{.image = image,
+                   .subresourceRange = range,
+                   .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                   .stage = vk::PipelineStageFlagBits2::eFragmentShader,
+                   .access = vk::AccessFlagBits2::eShaderRead});
+    clearPendingBarriers();
+
+    // Content discarded, e.g. because another image aliased the memory
+    tracker.track(ImageState{.image = image,
+                             .subresourceRange = range,
+                             .layout = vk::ImageLayout::eUndefined,
+                             .stage = vk::PipelineStageFlagBits2::eAllCommands,
+                             .access = vk::AccessFlagBits2::eMemoryWrite});
+    ASSERT_EQ(getImageStates(image).size(), 1);
+
+    tracker.request(
+        ImageState{.image = image,
+                   .subresourceRange = range,
+                   .layout = vk::ImageLayout::eColorAttachmentOptimal,
+                   .stage = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                   .access = vk::AccessFlagBits2::eColorAttachmentWrite});
+
+    auto barriers = getPendingImageBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].oldLayout, vk::ImageLayout::eUndefined);
+    EXPECT_EQ(barriers[0].srcStageMask,
+              vk::PipelineStageFlagBits2::eAllCommands);
+    EXPECT_EQ(barriers[0].srcAccessMask, vk::AccessFlagBits2::eMemoryWrite);
+}
+
 TEST_F(ResourceTrackerTest, Image_SameLayout_DifferentAccess_GeneratesBarrier) {
     vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x200));
     vk::ImageSubresourceRange range{vk::ImageAspectFlagBits::eColor, 0, 1, 0,
@@ -625,3 +744,1019 @@ TEST_F(ResourceTrackerTest, AS_Update_GeneratesBarrier) {
     EXPECT_EQ(barriers[0].dstAccessMask,
               vk::AccessFlagBits2::eAccelerationStructureWriteKHR);
 }
+
+TEST_F(ResourceTrackerTest, AS_UncoveredReaderWaitsForBuild) {
+    vk::AccelerationStructureKHR as = vk::AccelerationStructureKHR(
+        reinterpret_cast<VkAccelerationStructureKHR>(0x300));
+    const auto build =
+        vk::PipelineStageFlagBits2::eAccelerationStructureBuildKHR;
+    const auto read = vk::AccessFlagBits2::eAccelerationStructureReadKHR;
+    tracker.track(AccelerationStructureState{
+        .handle = as,
+        .stage = build,
+        .access = vk::AccessFlagBits2::eAccelerationStructureWriteKHR});
+    tracker.request(AccelerationStructureState{
+        .handle = as,
+        .stage = vk::PipelineStageFlagBits2::eRayTracingShaderKHR,
+        .access = read});
+    clearPendingBarriers();
+
+    // Ray queries from a fragment shader wait for the build too
+    tracker.request(AccelerationStructureState{
+        .handle = as,
+        .stage = vk::PipelineStageFlagBits2::eFragmentShader,
+        .access = read});
+    auto barriers = getPendingMemoryBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].srcStageMask, build);
+    EXPECT_EQ(barriers[0].srcAccessMask,
+              vk::AccessFlagBits2::eAccelerationStructureWriteKHR);
+    EXPECT_EQ(barriers[0].dstStageMask,
+              vk::PipelineStageFlagBits2::eFragmentShader);
+    clearPendingBarriers();
+
+    // The next build waits for both readers
+    tracker.request(AccelerationStructureState{
+        .handle = as,
+        .stage = vk::PipelineStageFlagBits2::eRayTracingShaderKHR,
+        .access = read});
+    EXPECT_TRUE(getPendingMemoryBarriers().empty());
+    tracker.request(AccelerationStructureState{
+        .handle = as,
+        .stage = build,
+        .access = vk::AccessFlagBits2::eAccelerationStructureWriteKHR});
+    barriers = getPendingMemoryBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].srcStageMask,
+              vk::PipelineStageFlagBits2::eRayTracingShaderKHR |
+                  vk::PipelineStageFlagBits2::eFragmentShader);
+}
+
+// =================================================================================================
+// Hazard Matrix Tests
+// =================================================================================================
+
+namespace {
+
+struct Access {
+    vk::ImageLayout layout;
+    vk::PipelineStageFlags2 stage;
+    vk::AccessFlags2 access;
+};
+
+const Access fragment_sample{vk::ImageLayout::eShaderReadOnlyOptimal,
+                             vk::PipelineStageFlagBits2::eFragmentShader,
+                             vk::AccessFlagBits2::eShaderSampledRead};
+const Access ray_tracing_sample{
+    vk::ImageLayout::eShaderReadOnlyOptimal,
+    vk::PipelineStageFlagBits2::eRayTracingShaderKHR,
+    vk::AccessFlagBits2::eShaderSampledRead};
+const Access general_read{vk::ImageLayout::eGeneral,
+                          vk::PipelineStageFlagBits2::eComputeShader,
+                          vk::AccessFlagBits2::eShaderStorageRead};
+const Access compute_write{vk::ImageLayout::eGeneral,
+                           vk::PipelineStageFlagBits2::eComputeShader,
+                           vk::AccessFlagBits2::eShaderStorageWrite};
+const Access color_write{vk::ImageLayout::eColorAttachmentOptimal,
+                         vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                         vk::AccessFlagBits2::eColorAttachmentWrite};
+
+struct HazardCase {
+    const char *name;
+    Access first;
+    Access second;
+    bool barrier;
+};
+
+class ImageHazardTest : public ResourceTrackerTest,
+                        public ::testing::WithParamInterface<HazardCase> {};
+
+ImageState imageState(vk::Image image, const Access &access) {
+    return ImageState{.image = image,
+                      .subresourceRange = {vk::ImageAspectFlagBits::eColor, 0,
+                                           1, 0, 1},
+                      .layout = access.layout,
+                      .stage = access.stage,
+                      .access = access.access};
+}
+
+} // namespace
+
+TEST_P(ImageHazardTest, BarrierOnHazard) {
+    const auto &hazard = GetParam();
+    vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x600));
+    tracker.track(imageState(image, hazard.first));
+
+    tracker.request(imageState(image, hazard.second));
+
+    EXPECT_EQ(getPendingImageBarriers().size(), hazard.barrier ? 1 : 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ResourceTrackerTest, ImageHazardTest,
+    ::testing::Values(
+        // The tracked read only covers the fragment stage
+        HazardCase{"ReadAfterReadSameLayout", fragment_sample,
+                   ray_tracing_sample, true},
+        HazardCase{"ReadAfterIdenticalRead", fragment_sample,
+                   fragment_sample, false},
+        HazardCase{"ReadAfterReadOtherLayout", fragment_sample,
+                   general_read, true},
+        HazardCase{"ReadAfterWriteSameLayout", compute_write, general_read,
+                   true},
+        HazardCase{"ReadAfterWriteOtherLayout", color_write,
+                   fragment_sample, true},
+        HazardCase{"WriteAfterReadSameLayout", general_read, compute_write,
+                   true},
+        HazardCase{"WriteAfterReadOtherLayout", fragment_sample,
+                   color_write, true},
+        HazardCase{"WriteAfterIdenticalWrite", compute_write, compute_write,
+                   true},
+        HazardCase{"WriteAfterWriteOtherLayout", color_write, compute_write,
+                   true}),
+    [](const auto &info) { return std::string(info.param.name); });
+
+TEST_F(ResourceTrackerTest, Image_ReadersAccumulateUntilNextWrite) {
+    vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x600));
+    tracker.track(imageState(image, color_write));
+
+    // Sampled by the raster pass, then by the ray tracing pass
+    tracker.request(imageState(image, fragment_sample));
+    ASSERT_EQ(getPendingImageBarriers().size(), 1);
+    clearPendingBarriers();
+
+    // The first barrier did not cover the ray tracing stage: it waits for
+    // the write, and for the layout transition done before the fragment
+    // shader
+    tracker.request(imageState(image, ray_tracing_sample));
+    auto barriers = getPendingImageBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].oldLayout, vk::ImageLayout::eShaderReadOnlyOptimal);
+    EXPECT_EQ(barriers[0].newLayout, vk::ImageLayout::eShaderReadOnlyOptimal);
+    EXPECT_EQ(barriers[0].srcStageMask,
+              vk::PipelineStageFlagBits2::eColorAttachmentOutput |
+                  vk::PipelineStageFlagBits2::eFragmentShader);
+    EXPECT_EQ(barriers[0].srcAccessMask,
+              vk::AccessFlagBits2::eColorAttachmentWrite);
+    EXPECT_EQ(barriers[0].dstStageMask,
+              vk::PipelineStageFlagBits2::eRayTracingShaderKHR);
+    clearPendingBarriers();
+
+    // Both readers are covered now
+    tracker.request(imageState(image, fragment_sample));
+    tracker.request(imageState(image, ray_tracing_sample));
+    ASSERT_TRUE(getPendingImageBarriers().empty());
+
+    auto states = getImageStates(image);
+    ASSERT_EQ(states.size(), 1);
+    EXPECT_EQ(states[0].layout, vk::ImageLayout::eShaderReadOnlyOptimal);
+    EXPECT_EQ(states[0].stage,
+              vk::PipelineStageFlagBits2::eFragmentShader |
+                  vk::PipelineStageFlagBits2::eRayTracingShaderKHR);
+
+    // The next write waits for every reader
+    tracker.request(imageState(image, color_write));
+    barriers = getPendingImageBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].srcStageMask,
+              vk::PipelineStageFlagBits2::eFragmentShader |
+                  vk::PipelineStageFlagBits2::eRayTracingShaderKHR);
+    EXPECT_EQ(barriers[0].srcAccessMask,
+              vk::AccessFlagBits2::eShaderSampledRead);
+    EXPECT_EQ(getImageStates(image)[0].stage,
+              vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+}
+
+TEST_F(ResourceTrackerTest, Image_ReadersAccumulateOnPartialRange) {
+    vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x600));
+    // Mips 0-1 sampled, mip 2 written
+    tracker.track(ImageState{
+        .image = image,
+        .subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, 2, 0, 1},
+        .layout = fragment_sample.layout,
+        .stage = fragment_sample.stage,
+        .access = fragment_sample.access});
+    tracker.track(ImageState{
+        .image = image,
+        .subresourceRange = {vk::ImageAspectFlagBits::eColor, 2, 1, 0, 1},
+        .layout = vk::ImageLayout::eTransferDstOptimal,
+        .stage = vk::PipelineStageFlagBits2::eTransfer,
+        .access = vk::AccessFlagBits2::eTransferWrite});
+
+    // Sample all three mips from the ray tracing stage
+    tracker.request(ImageState{
+        .image = image,
+        .subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, 3, 0, 1},
+        .layout = ray_tracing_sample.layout,
+        .stage = ray_tracing_sample.stage,
+        .access = ray_tracing_sample.access});
+
+    // The written mip transitions; the sampled ones only wait for the
+    // fragment stage their tracked state covers
+    auto barriers = getPendingImageBarriers();
+    ASSERT_EQ(barriers.size(), 2);
+    for (const auto &barrier : barriers) {
+        if (barrier.subresourceRange.baseMipLevel == 2) {
+            EXPECT_EQ(barrier.oldLayout,
+                      vk::ImageLayout::eTransferDstOptimal);
+        } else {
+            EXPECT_EQ(barrier.subresourceRange.levelCount, 2);
+            EXPECT_EQ(barrier.oldLayout, barrier.newLayout);
+            EXPECT_EQ(barrier.srcStageMask,
+                      vk::PipelineStageFlagBits2::eFragmentShader);
+            EXPECT_EQ(barrier.srcAccessMask, vk::AccessFlagBits2::eNone);
+        }
+    }
+
+    for (const auto &state : getImageStates(image)) {
+        if (state.interval.range.baseMipLevel == 2) {
+            EXPECT_EQ(state.stage,
+                      vk::PipelineStageFlagBits2::eRayTracingShaderKHR);
+        } else {
+            EXPECT_EQ(state.stage,
+                      vk::PipelineStageFlagBits2::eFragmentShader |
+                          vk::PipelineStageFlagBits2::eRayTracingShaderKHR);
+        }
+    }
+}
+
+TEST_F(ResourceTrackerTest, Buffer_ReadersAccumulateUntilNextWrite) {
+    vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(0x100));
+    tracker.track(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eVertexShader,
+                    .access = vk::AccessFlagBits2::eShaderRead});
+    tracker.request(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                    .access = vk::AccessFlagBits2::eShaderStorageRead});
+
+    // Only ordered after the tracked reader, without waiting for it
+    // again later
+    auto barriers = getPendingBufferBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].srcStageMask,
+              vk::PipelineStageFlagBits2::eVertexShader);
+    EXPECT_EQ(barriers[0].srcAccessMask, vk::AccessFlagBits2::eNone);
+    clearPendingBarriers();
+
+    tracker.request(BufferState{.buffer = buffer,
+                                .offset = 0,
+                                .size = 1024,
+                                .stage = vk::PipelineStageFlagBits2::eTransfer,
+                                .access = vk::AccessFlagBits2::eTransferWrite});
+
+    barriers = getPendingBufferBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].srcStageMask,
+              vk::PipelineStageFlagBits2::eVertexShader |
+                  vk::PipelineStageFlagBits2::eComputeShader);
+    EXPECT_EQ(barriers[0].srcAccessMask,
+              vk::AccessFlagBits2::eShaderRead |
+                  vk::AccessFlagBits2::eShaderStorageRead);
+}
+
+// =================================================================================================
+// Barrier Merging Tests
+// =================================================================================================
+
+namespace {
+
+ImageState colorAttachment(vk::Image image, uint32_t mip, uint32_t layer) {
+    return ImageState{
+        .image = image,
+        .subresourceRange = {vk::ImageAspectFlagBits::eColor, mip, 1, layer,
+                             1},
+        .layout = vk::ImageLayout::eColorAttachmentOptimal,
+        .stage = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        .access = vk::AccessFlagBits2::eColorAttachmentWrite};
+}
+
+BufferState shaderRead(vk::Buffer buffer, vk::DeviceSize offset,
+                       vk::DeviceSize size) {
+    return BufferState{.buffer = buffer,
+                       .offset = offset,
+                       .size = size,
+                       .stage = vk::PipelineStageFlagBits2::eFragmentShader,
+                       .access = vk::AccessFlagBits2::eShaderRead};
+}
+
+} // namespace
+
+TEST_F(ResourceTrackerTest, Merge_AdjacentMipsBecomeOneBarrier) {
+    vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x300));
+    for (uint32_t mip : {2U, 0U, 1U, 3U}) {
+        tracker.request(colorAttachment(image, mip, 0));
+    }
+    ASSERT_EQ(getPendingImageBarriers().size(), 4);
+
+    mergePendingBarriers();
+
+    auto barriers = getPendingImageBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].subresourceRange.baseMipLevel, 0);
+    EXPECT_EQ(barriers[0].subresourceRange.levelCount, 4);
+    EXPECT_EQ(barriers[0].subresourceRange.layerCount, 1);
+    EXPECT_EQ(tracker.statistics().requested_barriers, 4);
+    EXPECT_EQ(tracker.statistics().emitted_barriers, 1);
+    EXPECT_EQ(tracker.statistics().merged_barriers(), 3);
+}
+
+TEST_F(ResourceTrackerTest, Merge_DepthAndStencilAspectsCombine) {
+    vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x300));
+    for (auto aspect : {vk::ImageAspectFlagBits::eDepth,
+                        vk::ImageAspectFlagBits::eStencil}) {
+        tracker.request(ImageState{
+            .image = image,
+            .subresourceRange = {aspect, 0, 1, 0, 1},
+            .layout = vk::ImageLayout::eDepthStencilAttachmentOptimal,
+            .stage = vk::PipelineStageFlagBits2::eEarlyFragmentTests,
+            .access = vk::AccessFlagBits2::eDepthStencilAttachmentWrite});
+    }
+
+    mergePendingBarriers();
+
+    auto barriers = getPendingImageBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].subresourceRange.aspectMask,
+              vk::ImageAspectFlagBits::eDepth |
+                  vk::ImageAspectFlagBits::eStencil);
+}
+
+TEST_F(ResourceTrackerTest, Merge_NeverCoversUnrequestedSubresources) {
+    vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x300));
+    // Diagonal: the bounding box would include (mip 0, layer 1) and
+    // (mip 1, layer 0)
+    tracker.request(colorAttachment(image, 0, 0));
+    tracker.request(colorAttachment(image, 1, 1));
+
+    mergePendingBarriers();
+
+    EXPECT_EQ(getPendingImageBarriers().size(), 2);
+}
+
+TEST_F(ResourceTrackerTest, Merge_DifferentTransitionsStayApart) {
+    vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x300));
+    vk::Image other = vk::Image(reinterpret_cast<VkImage>(0x301));
+    tracker.request(colorAttachment(image, 0, 0));
+    tracker.request(colorAttachment(other, 1, 0));
+    tracker.request(ImageState{
+        .image = image,
+        .subresourceRange = {vk::ImageAspectFlagBits::eColor, 1, 1, 0, 1},
+        .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+        .stage = vk::PipelineStageFlagBits2::eFragmentShader,
+        .access = vk::AccessFlagBits2::eShaderRead});
+
+    mergePendingBarriers();
+
+    EXPECT_EQ(getPendingImageBarriers().size(), 3);
+    EXPECT_EQ(tracker.statistics().merged_barriers(), 0);
+}
+
+TEST_F(ResourceTrackerTest, Merge_AdjacentBufferRanges) {
+    vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(0x400));
+    tracker.set_global_barrier_threshold(0);
+    tracker.request(shaderRead(buffer, 256, 256));
+    tracker.request(shaderRead(buffer, 0, 256));
+    tracker.request(shaderRead(buffer, 1024, 256));
+
+    mergePendingBarriers();
+
+    auto barriers = getPendingBufferBarriers();
+    ASSERT_EQ(barriers.size(), 2);
+    EXPECT_EQ(barriers[0].offset, 0);
+    EXPECT_EQ(barriers[0].size, 512);
+    EXPECT_EQ(barriers[1].offset, 1024);
+    EXPECT_TRUE(getPendingMemoryBarriers().empty());
+}
+
+TEST_F(ResourceTrackerTest, Merge_ManyBufferBarriersFoldIntoGlobalBarrier) {
+    tracker.set_global_barrier_threshold(3);
+    for (uintptr_t handle = 0x400; handle < 0x403; ++handle) {
+        vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(handle));
+        tracker.request(shaderRead(buffer, 0, 64));
+    }
+    vk::Buffer vertices = vk::Buffer(reinterpret_cast<VkBuffer>(0x410));
+    tracker.request(BufferState{
+        .buffer = vertices,
+        .offset = 0,
+        .size = 64,
+        .stage = vk::PipelineStageFlagBits2::eVertexAttributeInput,
+        .access = vk::AccessFlagBits2::eVertexAttributeRead});
+
+    mergePendingBarriers();
+
+    EXPECT_TRUE(getPendingBufferBarriers().empty());
+    auto barriers = getPendingMemoryBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].srcStageMask,
+              vk::PipelineStageFlagBits2::eAllCommands);
+    EXPECT_EQ(barriers[0].dstStageMask,
+              vk::PipelineStageFlagBits2::eFragmentShader |
+                  vk::PipelineStageFlagBits2::eVertexAttributeInput);
+    EXPECT_EQ(barriers[0].dstAccessMask,
+              vk::AccessFlagBits2::eShaderRead |
+                  vk::AccessFlagBits2::eVertexAttributeRead);
+    EXPECT_EQ(tracker.statistics().folded_buffer_barriers, 4);
+    EXPECT_EQ(tracker.statistics().emitted_barriers, 1);
+}
+
+TEST_F(ResourceTrackerTest, Merge_FewBufferBarriersAreNotFolded) {
+    for (uintptr_t handle = 0x400; handle < 0x402; ++handle) {
+        vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(handle));
+        tracker.request(shaderRead(buffer, 0, 64));
+    }
+
+    mergePendingBarriers();
+
+    EXPECT_EQ(getPendingBufferBarriers().size(), 2);
+    EXPECT_TRUE(getPendingMemoryBarriers().empty());
+    EXPECT_EQ(tracker.statistics().folded_buffer_barriers, 0);
+}
+
+TEST_F(ResourceTrackerTest, Merge_IdenticalGlobalBarriersAreDeduplicated) {
+    for (uintptr_t handle = 0x500; handle < 0x503; ++handle) {
+        tracker.request(AccelerationStructureState{
+            .handle = vk::AccelerationStructureKHR(
+                reinterpret_cast<VkAccelerationStructureKHR>(handle)),
+            .stage = vk::PipelineStageFlagBits2::eRayTracingShaderKHR,
+            .access = vk::AccessFlagBits2::eAccelerationStructureReadKHR});
+    }
+
+    mergePendingBarriers();
+
+    EXPECT_EQ(getPendingMemoryBarriers().size(), 1);
+    tracker.reset_statistics();
+    EXPECT_EQ(tracker.statistics().requested_barriers, 0);
+}
+
+// =================================================================================================
+// Queue Family Ownership Tests
+// =================================================================================================
+
+namespace {
+constexpr uint32_t graphics_family = 0;
+constexpr uint32_t compute_family = 1;
+} // namespace
+
+TEST_F(ResourceTrackerTest, Image_RequestFromAnotherFamilyTransfersOwnership) {
+    vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x700));
+    const vk::ImageSubresourceRange range{vk::ImageAspectFlagBits::eColor,
+                                          0, 1, 0, 1};
+    tracker.track(ImageState{
+        .image = image,
+        .subresourceRange = range,
+        .layout = vk::ImageLayout::eColorAttachmentOptimal,
+        .stage = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        .access = vk::AccessFlagBits2::eColorAttachmentWrite,
+        .queue_family = graphics_family});
+
+    tracker.request(
+        ImageState{.image = image,
+                   .subresourceRange = range,
+                   .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                   .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                   .access = vk::AccessFlagBits2::eShaderSampledRead,
+                   .queue_family = compute_family});
+
+    // The acquire only waits on the destination side
+    auto acquires = getPendingImageBarriers();
+    ASSERT_EQ(acquires.size(), 1);
+    EXPECT_EQ(acquires[0].srcQueueFamilyIndex, graphics_family);
+    EXPECT_EQ(acquires[0].dstQueueFamilyIndex, compute_family);
+    EXPECT_EQ(acquires[0].srcStageMask, vk::PipelineStageFlagBits2::eNone);
+    EXPECT_EQ(acquires[0].dstStageMask,
+              vk::PipelineStageFlagBits2::eComputeShader);
+    EXPECT_EQ(acquires[0].newLayout,
+              vk::ImageLayout::eShaderReadOnlyOptimal);
+
+    // The release is recorded on the owning family
+    auto releases = getPendingImageReleases(graphics_family);
+    ASSERT_EQ(releases.size(), 1);
+    EXPECT_EQ(releases[0].srcQueueFamilyIndex, graphics_family);
+    EXPECT_EQ(releases[0].dstQueueFamilyIndex, compute_family);
+    EXPECT_EQ(releases[0].srcStageMask,
+              vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+    EXPECT_EQ(releases[0].srcAccessMask,
+              vk::AccessFlagBits2::eColorAttachmentWrite);
+    EXPECT_EQ(releases[0].dstStageMask, vk::PipelineStageFlagBits2::eNone);
+    EXPECT_EQ(releases[0].oldLayout, acquires[0].oldLayout);
+    EXPECT_EQ(releases[0].newLayout, acquires[0].newLayout);
+
+    EXPECT_EQ(tracker.statistics().ownership_transfers, 1);
+}
+
+TEST_F(ResourceTrackerTest, Image_ReadFromAnotherFamilyStillTransfers) {
+    vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x700));
+    const vk::ImageSubresourceRange range{vk::ImageAspectFlagBits::eColor,
+                                          0, 1, 0, 1};
+    tracker.track(
+        ImageState{.image = image,
+                   .subresourceRange = range,
+                   .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                   .stage = vk::PipelineStageFlagBits2::eFragmentShader,
+                   .access = vk::AccessFlagBits2::eShaderSampledRead,
+                   .queue_family = graphics_family});
+
+    tracker.request(
+        ImageState{.image = image,
+                   .subresourceRange = range,
+                   .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                   .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                   .access = vk::AccessFlagBits2::eShaderSampledRead,
+                   .queue_family = compute_family});
+
+    EXPECT_EQ(getPendingImageBarriers().size(), 1);
+    EXPECT_EQ(getPendingImageReleases(graphics_family).size(), 1);
+
+    // The compute family owns it now: reading it there again is free
+    tracker.request(
+        ImageState{.image = image,
+                   .subresourceRange = range,
+                   .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                   .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                   .access = vk::AccessFlagBits2::eShaderSampledRead,
+                   .queue_family = compute_family});
+    EXPECT_EQ(getPendingImageBarriers().size(), 1);
+}
+
+TEST_F(ResourceTrackerTest, Image_DiscardedContentNeedsNoTransfer) {
+    vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x700));
+    const vk::ImageSubresourceRange range{vk::ImageAspectFlagBits::eColor,
+                                          0, 1, 0, 1};
+    tracker.track(ImageState{.image = image,
+                             .subresourceRange = range,
+                             .layout = vk::ImageLayout::eUndefined,
+                             .stage = vk::PipelineStageFlagBits2::eNone,
+                             .access = vk::AccessFlagBits2::eNone,
+                             .queue_family = graphics_family});
+
+    tracker.request(
+        ImageState{.image = image,
+                   .subresourceRange = range,
+                   .layout = vk::ImageLayout::eGeneral,
+                   .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                   .access = vk::AccessFlagBits2::eShaderStorageWrite,
+                   .queue_family = compute_family});
+
+    auto barriers = getPendingImageBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].srcQueueFamilyIndex,
+              barriers[0].dstQueueFamilyIndex);
+    EXPECT_TRUE(getPendingImageReleases(graphics_family).empty());
+}
+
+TEST_F(ResourceTrackerTest, Buffer_RequestFromAnotherFamilyTransfersOwnership) {
+    vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(0x100));
+    tracker.track(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                    .access = vk::AccessFlagBits2::eShaderStorageWrite,
+                    .queue_family = compute_family});
+
+    tracker.request(
+        BufferState{.buffer = buffer,
+                    .offset = 256,
+                    .size = 256,
+                    .stage = vk::PipelineStageFlagBits2::eVertexAttributeInput,
+                    .access = vk::AccessFlagBits2::eVertexAttributeRead,
+                    .queue_family = graphics_family});
+
+    auto acquires = getPendingBufferBarriers();
+    ASSERT_EQ(acquires.size(), 1);
+    EXPECT_EQ(acquires[0].offset, 256);
+    EXPECT_EQ(acquires[0].size, 256);
+    EXPECT_EQ(acquires[0].srcQueueFamilyIndex, compute_family);
+    EXPECT_EQ(acquires[0].dstQueueFamilyIndex, graphics_family);
+    EXPECT_EQ(acquires[0].srcAccessMask, vk::AccessFlagBits2::eNone);
+
+    auto releases = getPendingBufferReleases(compute_family);
+    ASSERT_EQ(releases.size(), 1);
+    EXPECT_EQ(releases[0].srcAccessMask,
+              vk::AccessFlagBits2::eShaderStorageWrite);
+    EXPECT_EQ(releases[0].dstAccessMask, vk::AccessFlagBits2::eNone);
+
+    // The rest of the buffer stays with the compute family
+    auto states = getBufferStates(buffer);
+    ASSERT_EQ(states.size(), 3);
+    EXPECT_EQ(states[1].interval.offset, 256);
+    EXPECT_EQ(states[1].stage,
+              vk::PipelineStageFlagBits2::eVertexAttributeInput);
+}
+
+TEST_F(ResourceTrackerTest, IgnoredQueueFamilyNeverTransfers) {
+    vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(0x100));
+    tracker.track(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                    .access = vk::AccessFlagBits2::eShaderStorageWrite,
+                    .queue_family = compute_family});
+
+    tracker.request(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eVertexShader,
+                    .access = vk::AccessFlagBits2::eShaderRead});
+
+    auto barriers = getPendingBufferBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].srcQueueFamilyIndex,
+              barriers[0].dstQueueFamilyIndex);
+    EXPECT_EQ(tracker.statistics().ownership_transfers, 0);
+}
+
+TEST_F(ResourceTrackerTest, IgnoredQueueFamilyKeepsOwner) {
+    vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(0x100));
+    tracker.track(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                    .access = vk::AccessFlagBits2::eShaderStorageWrite,
+                    .queue_family = compute_family});
+
+    tracker.request(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                    .access = vk::AccessFlagBits2::eShaderStorageRead});
+
+    // The compute family still owns the buffer, so graphics must acquire it
+    tracker.request(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eVertexAttributeInput,
+                    .access = vk::AccessFlagBits2::eVertexAttributeRead,
+                    .queue_family = graphics_family});
+
+    auto releases = getPendingBufferReleases(compute_family);
+    ASSERT_EQ(releases.size(), 1);
+    EXPECT_EQ(releases[0].srcQueueFamilyIndex, compute_family);
+    EXPECT_EQ(releases[0].dstQueueFamilyIndex, graphics_family);
+
+    auto barriers = getPendingBufferBarriers();
+    ASSERT_FALSE(barriers.empty());
+    EXPECT_EQ(barriers.back().srcQueueFamilyIndex, compute_family);
+    EXPECT_EQ(barriers.back().dstQueueFamilyIndex, graphics_family);
+    EXPECT_EQ(tracker.statistics().ownership_transfers, 1);
+}
+
+TEST_F(ResourceTrackerTest, QueueFamilyFillsRequestsNamingNone) {
+    vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x700));
+    const vk::ImageSubresourceRange range{vk::ImageAspectFlagBits::eColor,
+                                          0, 1, 0, 1};
+    const ImageState sampled{
+        .image = image,
+        .subresourceRange = range,
+        .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+        .stage = vk::PipelineStageFlagBits2::eComputeShader,
+        .access = vk::AccessFlagBits2::eShaderSampledRead};
+    tracker.track(ImageState{
+        .image = image,
+        .subresourceRange = range,
+        .layout = vk::ImageLayout::eColorAttachmentOptimal,
+        .stage = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        .access = vk::AccessFlagBits2::eColorAttachmentWrite,
+        .queue_family = graphics_family});
+
+    tracker.set_queue_family(compute_family);
+    tracker.request(sampled);
+
+    auto acquires = getPendingImageBarriers();
+    ASSERT_EQ(acquires.size(), 1);
+    EXPECT_EQ(acquires[0].dstQueueFamilyIndex, compute_family);
+    EXPECT_TRUE(tracker.has_pending_releases(graphics_family));
+    EXPECT_FALSE(tracker.has_pending_releases(compute_family));
+
+    // Back to ignored, the compute family keeps the image
+    tracker.set_queue_family(vk::QueueFamilyIgnored);
+    tracker.request(sampled);
+    EXPECT_EQ(getPendingImageBarriers().size(), 1);
+    EXPECT_EQ(tracker.statistics().ownership_transfers, 1);
+}
+
+// =================================================================================================
+// Shard Tests
+// =================================================================================================
+
+TEST_F(ResourceTrackerTest, Shard_UntrackedRequestIsLeftToMerge) {
+    vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x800));
+    const vk::ImageSubresourceRange range{vk::ImageAspectFlagBits::eColor,
+                                          0, 1, 0, 1};
+    auto shard = ResourceTracker::create_shard();
+    shard.request(ImageState{
+        .image = image,
+        .subresourceRange = range,
+        .layout = vk::ImageLayout::eColorAttachmentOptimal,
+        .stage = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+        .access = vk::AccessFlagBits2::eColorAttachmentWrite});
+    EXPECT_TRUE(takePendingBarriers(shard).images.empty());
+
+    tracker.track(
+        ImageState{.image = image,
+                   .subresourceRange = range,
+                   .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                   .stage = vk::PipelineStageFlagBits2::eFragmentShader,
+                   .access = vk::AccessFlagBits2::eShaderSampledRead});
+    tracker.merge(std::move(shard));
+
+    auto barriers = getPendingImageBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].oldLayout, vk::ImageLayout::eShaderReadOnlyOptimal);
+    EXPECT_EQ(barriers[0].newLayout,
+              vk::ImageLayout::eColorAttachmentOptimal);
+    EXPECT_EQ(barriers[0].srcStageMask,
+              vk::PipelineStageFlagBits2::eFragmentShader);
+
+    auto states = getImageStates(image);
+    ASSERT_EQ(states.size(), 1);
+    EXPECT_EQ(states[0].layout, vk::ImageLayout::eColorAttachmentOptimal);
+}
+
+TEST_F(ResourceTrackerTest, Shard_MergeMatchesSerialRecording) {
+    vk::Image image = vk::Image(reinterpret_cast<VkImage>(0x800));
+    vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(0x900));
+    const vk::ImageSubresourceRange range{vk::ImageAspectFlagBits::eColor,
+                                          0, 1, 0, 1};
+
+    const std::vector<std::vector<ResourceState>> passes = {
+        {ImageState{.image = image,
+                    .subresourceRange = range,
+                    .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                    .stage = vk::PipelineStageFlagBits2::eFragmentShader,
+                    .access = vk::AccessFlagBits2::eShaderSampledRead},
+         BufferState{
+             .buffer = buffer,
+             .offset = 0,
+             .size = 512,
+             .stage = vk::PipelineStageFlagBits2::eVertexAttributeInput,
+             .access = vk::AccessFlagBits2::eVertexAttributeRead}},
+        {ImageState{
+             .image = image,
+             .subresourceRange = range,
+             .layout = vk::ImageLayout::eColorAttachmentOptimal,
+             .stage = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+             .access = vk::AccessFlagBits2::eColorAttachmentWrite},
+         BufferState{.buffer = buffer,
+                     .offset = 256,
+                     .size = 512,
+                     .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                     .access = vk::AccessFlagBits2::eShaderStorageWrite}},
+        {BufferState{.buffer = buffer,
+                     .offset = 0,
+                     .size = 1024,
+                     .stage = vk::PipelineStageFlagBits2::eTransfer,
+                     .access = vk::AccessFlagBits2::eTransferRead}}};
+
+    const auto track_initial_states = [&](ResourceTracker &into) {
+        into.track(ImageState{
+            .image = image,
+            .subresourceRange = range,
+            .layout = vk::ImageLayout::eColorAttachmentOptimal,
+            .stage = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+            .access = vk::AccessFlagBits2::eColorAttachmentWrite});
+        into.track(BufferState{.buffer = buffer,
+                               .offset = 0,
+                               .size = 1024,
+                               .stage = vk::PipelineStageFlagBits2::eTransfer,
+                               .access = vk::AccessFlagBits2::eTransferWrite});
+    };
+
+    ResourceTracker serial;
+    track_initial_states(serial);
+    std::vector<PendingBarriers> serialBarriers;
+    for (const auto &pass : passes) {
+        for (const auto &state : pass) {
+            serial.request(state);
+        }
+        serialBarriers.push_back(takePendingBarriers(serial));
+    }
+
+    // Every pass records on its own shard, then the shards merge in order
+    std::vector<ResourceTracker> shards;
+    for (const auto &pass : passes) {
+        shards.push_back(ResourceTracker::create_shard());
+        for (const auto &state : pass) {
+            shards.back().request(state);
+        }
+    }
+
+    track_initial_states(tracker);
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+        tracker.merge(std::move(shards[i]));
+        auto barriers = takePendingBarriers(tracker);
+        EXPECT_EQ(barriers.images, serialBarriers[i].images) << "pass " << i;
+        EXPECT_EQ(barriers.buffers, serialBarriers[i].buffers)
+            << "pass " << i;
+    }
+
+    auto serialImage = getImageStates(serial, image);
+    auto mergedImage = getImageStates(image);
+    ASSERT_EQ(mergedImage.size(), serialImage.size());
+    for (std::size_t i = 0; i < serialImage.size(); ++i) {
+        EXPECT_EQ(mergedImage[i].interval, serialImage[i].interval);
+        EXPECT_EQ(mergedImage[i].layout, serialImage[i].layout);
+        EXPECT_EQ(mergedImage[i].stage, serialImage[i].stage);
+        EXPECT_EQ(mergedImage[i].access, serialImage[i].access);
+    }
+
+    auto serialBuffer = getBufferStates(serial, buffer);
+    auto mergedBuffer = getBufferStates(buffer);
+    ASSERT_EQ(mergedBuffer.size(), serialBuffer.size());
+    for (std::size_t i = 0; i < serialBuffer.size(); ++i) {
+        EXPECT_EQ(mergedBuffer[i].interval, serialBuffer[i].interval);
+        EXPECT_EQ(mergedBuffer[i].stage, serialBuffer[i].stage);
+        EXPECT_EQ(mergedBuffer[i].access, serialBuffer[i].access);
+    }
+}
+
+TEST_F(ResourceTrackerTest, Shard_ReadOnlyFirstUseAccumulatesReaders) {
+    vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(0x900));
+    tracker.track(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eVertexShader,
+                    .access = vk::AccessFlagBits2::eShaderStorageRead});
+
+    auto shard = ResourceTracker::create_shard();
+    shard.request(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                    .access = vk::AccessFlagBits2::eShaderStorageRead});
+    tracker.merge(std::move(shard));
+
+    // Ordered after the tracked reader, as on the tracker itself
+    auto barriers = getPendingBufferBarriers();
+    ASSERT_EQ(barriers.size(), 1);
+    EXPECT_EQ(barriers[0].srcAccessMask, vk::AccessFlagBits2::eNone);
+    auto states = getBufferStates(buffer);
+    ASSERT_EQ(states.size(), 1);
+    EXPECT_EQ(states[0].stage, vk::PipelineStageFlagBits2::eVertexShader |
+                                   vk::PipelineStageFlagBits2::eComputeShader);
+}
+
+TEST_F(ResourceTrackerTest, Shard_WriteAfterFirstReadWaitsForPreviousReaders) {
+    vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(0x900));
+    tracker.track(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eVertexShader,
+                    .access = vk::AccessFlagBits2::eShaderStorageRead});
+
+    auto shard = ResourceTracker::create_shard();
+    shard.request(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                    .access = vk::AccessFlagBits2::eShaderStorageRead});
+    shard.request(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                    .access = vk::AccessFlagBits2::eShaderStorageWrite});
+
+    // The shard's barrier only knows about its own read
+    auto local = takePendingBarriers(shard).buffers;
+    ASSERT_EQ(local.size(), 1);
+    EXPECT_EQ(local[0].srcStageMask,
+              vk::PipelineStageFlagBits2::eComputeShader);
+
+    // So the merge orders the vertex shader reads before it
+    tracker.merge(std::move(shard));
+    auto boundary = getPendingBufferBarriers();
+    ASSERT_EQ(boundary.size(), 1);
+    EXPECT_EQ(boundary[0].srcStageMask,
+              vk::PipelineStageFlagBits2::eVertexShader);
+    EXPECT_EQ(boundary[0].dstStageMask,
+              vk::PipelineStageFlagBits2::eComputeShader);
+
+    auto states = getBufferStates(buffer);
+    ASSERT_EQ(states.size(), 1);
+    EXPECT_EQ(states[0].access, vk::AccessFlagBits2::eShaderStorageWrite);
+}
+
+TEST_F(ResourceTrackerTest, Shard_PartiallyTrackedBufferKeepsFirstUseOfRest) {
+    vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(0x900));
+    auto shard = ResourceTracker::create_shard();
+    shard.track(BufferState{.buffer = buffer,
+                            .offset = 0,
+                            .size = 256,
+                            .stage = vk::PipelineStageFlagBits2::eTransfer,
+                            .access = vk::AccessFlagBits2::eTransferWrite});
+    shard.request(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 1024,
+                    .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                    .access = vk::AccessFlagBits2::eShaderStorageRead});
+    ASSERT_EQ(takePendingBarriers(shard).buffers.size(), 1);
+
+    // Only the part the shard did not know about waits on the tracker
+    tracker.merge(std::move(shard));
+    auto boundary = getPendingBufferBarriers();
+    ASSERT_EQ(boundary.size(), 1);
+    EXPECT_EQ(boundary[0].offset, 256);
+    EXPECT_EQ(boundary[0].size, 768);
+}
+
+TEST_F(ResourceTrackerTest, Shard_MergeRequiresFlushedShard) {
+    ResourceTracker notShard;
+    EXPECT_THROW(tracker.merge(std::move(notShard)), LogicException);
+
+    vk::Buffer buffer = vk::Buffer(reinterpret_cast<VkBuffer>(0x900));
+    auto shard = ResourceTracker::create_shard();
+    shard.track(BufferState{.buffer = buffer,
+                            .offset = 0,
+                            .size = 256,
+                            .stage = vk::PipelineStageFlagBits2::eTransfer,
+                            .access = vk::AccessFlagBits2::eTransferWrite});
+    shard.request(
+        BufferState{.buffer = buffer,
+                    .offset = 0,
+                    .size = 256,
+                    .stage = vk::PipelineStageFlagBits2::eComputeShader,
+                    .access = vk::AccessFlagBits2::eShaderStorageRead});
+    EXPECT_THROW(tracker.merge(std::move(shard)), LogicException);
+}
+
+// =================================================================================================
+// Scalability
+// =================================================================================================
+
+TEST_F(ResourceTrackerTest, TenThousandResourcesBenchmark) {
+    // Every frame, 10k whole-image resources (e.g. bindless textures and
+    // render targets) alternate between being written and sampled. Timings
+    // are reported, not asserted.
+    constexpr uintptr_t resource_count = 10'000;
+    constexpr int frames = 16;
+    using clock = std::chrono::steady_clock;
+
+    const vk::ImageSubresourceRange range{vk::ImageAspectFlagBits::eColor, 0,
+                                          1, 0, 1};
+    const auto state = [&](uintptr_t index, bool write) {
+        vk::Image image = vk::Image(reinterpret_cast<VkImage>(index * 64));
+        if (write) {
+            return ImageState{
+                .image = image,
+                .subresourceRange = range,
+                .layout = vk::ImageLayout::eColorAttachmentOptimal,
+                .stage = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                .access = vk::AccessFlagBits2::eColorAttachmentWrite};
+        }
+        return ImageState{.image = image,
+                          .subresourceRange = range,
+                          .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                          .stage = vk::PipelineStageFlagBits2::eFragmentShader,
+                          .access = vk::AccessFlagBits2::eShaderRead};
+    };
+
+    tracker.reserve(resource_count);
+    const auto start = clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        for (uintptr_t i = 1; i <= resource_count; ++i) {
+            tracker.request(state(i, true));
+        }
+        mergePendingBarriers();
+        ASSERT_EQ(getPendingImageBarriers().size(), resource_count);
+        clearPendingBarriers();
+
+        for (uintptr_t i = 1; i <= resource_count; ++i) {
+            tracker.request(state(i, false));
+        }
+        mergePendingBarriers();
+        clearPendingBarriers();
+    }
+    const auto elapsed = clock::now() - start;
+
+    for (uintptr_t i = 1; i <= resource_count; i += 997) {
+        auto states = getImageStates(
+            vk::Image(reinterpret_cast<VkImage>(i * 64)));
+        ASSERT_EQ(states.size(), 1);
+        EXPECT_EQ(states[0].layout, vk::ImageLayout::eShaderReadOnlyOptimal);
+    }
+
+    const auto requests = 2.0 * frames * resource_count;
+    const auto seconds = std::chrono::duration<double>(elapsed).count();
+    RecordProperty("requests", std::to_string(int64_t(requests)));
+    RecordProperty("elapsed_us",
+                   std::to_string(int64_t(seconds * 1'000'000)));
+    RecordProperty("requests_per_second",
+                   std::to_string(int64_t(requests / seconds)));
+}
@@ -0,0 +1,151 @@
+#include "utils/create_gpu.hpp"
+#include "VulkanWrapper/Command/CommandPool.h"
+#include "VulkanWrapper/Image/Image.h"
+#include "VulkanWrapper/Synchronization/EventPool.h"
+#include "VulkanWrapper/Synchronization/Fence.h"
+#include "VulkanWrapper/Synchronization/ResourceTracker.h"
+#include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
+#include <gtest/gtest.h>
+
+using namespace vw::Barrier;
+
+namespace {
+
+class SplitBarrierTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        auto &gpu = vw::tests::create_gpu();
+        image = gpu.allocator->create_image_2D(
+            vw::Width(64), vw::Height(64), false,
+            vk::Format::eR8G8B8A8Unorm,
+            vk::ImageUsageFlagBits::eColorAttachment |
+                vk::ImageUsageFlagBits::eSampled);
+        events = std::make_shared<vw::EventPool>(gpu.device, 1);
+        cmd = pool.allocate(1)[0];
+        std::ignore = cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+
+        // A producer wrote the image
+        tracker.request(written());
+        tracker.flush(cmd);
+        tracker.reset_statistics();
+    }
+
+    // Ends the command buffer and waits for its execution
+    void submit() {
+        std::ignore = cmd.end();
+        auto &queue = vw::tests::create_gpu().queue();
+        queue.enqueue_command_buffer(cmd);
+        queue.submit({}, {}, {}).wait();
+    }
+
+    ImageState written() const {
+        return {.image = image->handle(),
+                .subresourceRange = image->full_range(),
+                .layout = vk::ImageLayout::eColorAttachmentOptimal,
+                .stage = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                .access = vk::AccessFlagBits2::eColorAttachmentWrite};
+    }
+
+    ImageState sampled() const {
+        return {.image = image->handle(),
+                .subresourceRange = image->full_range(),
+                .layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                .stage = vk::PipelineStageFlagBits2::eFragmentShader,
+                .access = vk::AccessFlagBits2::eShaderSampledRead};
+    }
+
+    vw::CommandPool pool =
+        vw::CommandPoolBuilder(vw::tests::create_gpu().device).build();
+    vk::CommandBuffer cmd;
+    std::shared_ptr<const vw::Image> image;
+    std::shared_ptr<vw::EventPool> events;
+    ResourceTracker tracker;
+};
+
+} // namespace
+
+TEST_F(SplitBarrierTest, ReleaseSetsEventWaitedByRequest) {
+    tracker.enable_split_barriers(events);
+
+    tracker.release(cmd, sampled());
+    EXPECT_EQ(tracker.statistics().split_barriers, 1);
+    EXPECT_EQ(events->size(), 1);
+
+    // The event already transitioned the image
+    tracker.request(sampled());
+    tracker.flush(cmd);
+    submit();
+
+    EXPECT_EQ(tracker.statistics().requested_barriers, 0);
+    EXPECT_EQ(tracker.statistics().pipeline_barrier_count, 0);
+}
+
+TEST_F(SplitBarrierTest, RequestOfAnotherStateCompletesTransition) {
+    tracker.enable_split_barriers(events);
+
+    tracker.release(cmd, sampled());
+    tracker.request(written());
+    tracker.flush(cmd);
+    submit();
+
+    EXPECT_EQ(tracker.statistics().split_barriers, 1);
+    EXPECT_EQ(tracker.statistics().pipeline_barrier_count, 1);
+}
+
+TEST_F(SplitBarrierTest, ReleaseWithoutHazardSetsNoEvent) {
+    tracker.request(sampled());
+    tracker.flush(cmd);
+    tracker.reset_statistics();
+    tracker.enable_split_barriers(events);
+
+    tracker.release(cmd, sampled());
+    tracker.request(sampled());
+    tracker.flush(cmd);
+    submit();
+
+    EXPECT_EQ(tracker.statistics().split_barriers, 0);
+    EXPECT_EQ(tracker.statistics().pipeline_barrier_count, 0);
+    EXPECT_EQ(events->size(), 0);
+}
+
+TEST_F(SplitBarrierTest, ReleaseWithoutSplitBarriersRequests) {
+
+    tracker.release(cmd, sampled());
+    tracker.flush(cmd);
+    submit();
+
+    EXPECT_EQ(tracker.statistics().split_barriers, 0);
+    EXPECT_EQ(tracker.statistics().pipeline_barrier_count, 1);
+}
+
+TEST_F(SplitBarrierTest, ReleaseTwiceWithoutRequestThrows) {
+    tracker.enable_split_barriers(events);
+
+    tracker.release(cmd, sampled());
+    EXPECT_THROW(tracker.release(cmd, written()), vw::LogicException);
+
+    tracker.request(sampled());
+    tracker.flush(cmd);
+    submit();
+}
+
+TEST_F(SplitBarrierTest, EventsAreRecycledAfterFramesInFlight) {
+    tracker.enable_split_barriers(events);
+    tracker.release(cmd, sampled());
+    tracker.request(sampled());
+    tracker.flush(cmd);
+    submit();
+
+    // Frames in flight may still wait on the retired event
+    events->begin_frame();
+    const auto fresh = events->acquire();
+    EXPECT_EQ(events->size(), 2);
+    events->retire(fresh);
+
+    // Once they completed, it is reused
+    events->begin_frame();
+    std::ignore = events->acquire();
+    EXPECT_EQ(events->size(), 2);
+}
@@ -6,11 +6,14 @@
 #include "VulkanWrapper/Synchronization/Fence.h"
 #include "VulkanWrapper/Vulkan/Queue.h"
 #include <gtest/gtest.h>
+#include <numeric>
+#include <thread>
 #include <vector>
 
 TEST(StagingBufferManagerTest, CreateStagingBufferManager) {
     auto &gpu = vw::tests::create_gpu();
-    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator);
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue());
     SUCCEED();
 }
 
@@ -18,7 +21,8 @@ TEST(StagingBufferManagerTest, TransferDataToDeviceBuffer) {
     auto &gpu = vw::tests::create_gpu();
 
     // Create StagingBufferManager
-    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator);
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue());
 
     // Create a device-only buffer with transfer destination and source
     // capability
@@ -79,7 +83,8 @@ TEST(StagingBufferManagerTest, TransferDataToDeviceBuffer) {
 
 TEST(StagingBufferManagerTest, TransferIntegerData) {
     auto &gpu = vw::tests::create_gpu();
-    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator);
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue());
 
     // Create a device-only buffer for integers
     constexpr VkBufferUsageFlags DeviceBufferUsage =
@@ -137,7 +142,8 @@ TEST(StagingBufferManagerTest, TransferIntegerData) {
 
 TEST(StagingBufferManagerTest, TransferDoubleData) {
     auto &gpu = vw::tests::create_gpu();
-    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator);
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue());
 
     // Create a device-only buffer for doubles
     constexpr VkBufferUsageFlags DeviceBufferUsage =
@@ -205,7 +211,8 @@ struct Vec3 {
 
 TEST(StagingBufferManagerTest, TransferSimpleStructData) {
     auto &gpu = vw::tests::create_gpu();
-    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator);
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue());
 
     // Create a device-only buffer for Vec3 structures
     constexpr VkBufferUsageFlags DeviceBufferUsage =
@@ -280,7 +287,8 @@ struct alignas(16) ParticleData {
 
 TEST(StagingBufferManagerTest, TransferComplexStructData) {
     auto &gpu = vw::tests::create_gpu();
-    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator);
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue());
 
     // Create a device-only buffer for ParticleData structures
     constexpr VkBufferUsageFlags DeviceBufferUsage =
@@ -347,7 +355,8 @@ TEST(StagingBufferManagerTest, TransferComplexStructData) {
 
 TEST(StagingBufferManagerTest, TransferWithOffset) {
     auto &gpu = vw::tests::create_gpu();
-    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator);
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue());
 
     // Create a device-only buffer
     constexpr VkBufferUsageFlags DeviceBufferUsage =
@@ -415,7 +424,8 @@ TEST(StagingBufferManagerTest, TransferWithOffset) {
 
 TEST(StagingBufferManagerTest, TransferMultipleSequential) {
     auto &gpu = vw::tests::create_gpu();
-    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator);
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue());
 
     // Create three device buffers
     constexpr VkBufferUsageFlags DeviceBufferUsage =
@@ -487,7 +497,8 @@ TEST(StagingBufferManagerTest, TransferMultipleSequential) {
 
 TEST(StagingBufferManagerTest, TransferLargeDataSet) {
     auto &gpu = vw::tests::create_gpu();
-    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator);
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue());
 
     // Create a large device buffer (1 million floats = ~4MB)
     constexpr size_t element_count = 1'000'000;
@@ -561,3 +572,308 @@ TEST(StagingBufferManagerTest, TransferLargeDataSet) {
             << "Mismatch at end index " << i;
     }
 }
+
+TEST(StagingBufferManagerTest, ConcurrentFillBuffer) {
+    auto &gpu = vw::tests::create_gpu();
+    auto allocator = vw::AllocatorBuilder(gpu.instance, gpu.device)
+                         .with_internal_synchronization()
+                         .build();
+    vw::StagingBufferManager staging_manager(gpu.device, allocator,
+                                             gpu.queue());
+
+    constexpr VkBufferUsageFlags DeviceBufferUsage =
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    using DeviceBuffer = vw::Buffer<uint32_t, false, DeviceBufferUsage>;
+
+    constexpr uint32_t thread_count = 8;
+    constexpr uint32_t uploads_per_thread = 64;
+    constexpr uint32_t element_count = 16;
+    auto device_buffer = vw::create_buffer<DeviceBuffer>(
+        *allocator, thread_count * uploads_per_thread * element_count);
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<uint32_t>> data(thread_count * uploads_per_thread);
+    for (uint32_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            for (uint32_t i = 0; i < uploads_per_thread; ++i) {
+                const uint32_t upload = t * uploads_per_thread + i;
+                auto &values = data[upload];
+                for (uint32_t e = 0; e < element_count; ++e) {
+                    values.push_back(upload * element_count + e);
+                }
+                staging_manager.fill_buffer(std::span<const uint32_t>(values),
+                                            device_buffer,
+                                            upload * element_count);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    auto &queue = gpu.queue();
+    queue.enqueue_command_buffer(staging_manager.fill_command_buffer());
+    queue.submit({}, {}, {}).wait();
+
+    const auto total = device_buffer.size();
+    using HostBuffer = vw::Buffer<uint32_t, true, vw::StagingBufferUsage>;
+    auto host_buffer = vw::create_buffer<HostBuffer>(*allocator, total);
+
+    auto cmd_pool = vw::CommandPoolBuilder(gpu.device).build();
+    auto readback_cmd = cmd_pool.allocate(1)[0];
+    std::ignore = readback_cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    readback_cmd.copyBuffer(
+        device_buffer.handle(), host_buffer.handle(),
+        vk::BufferCopy().setSize(total * sizeof(uint32_t)));
+    std::ignore = readback_cmd.end();
+    queue.enqueue_command_buffer(readback_cmd);
+    queue.submit({}, {}, {}).wait();
+
+    auto retrieved = host_buffer.read_as_vector(0, total);
+    for (uint32_t i = 0; i < total; ++i) {
+        EXPECT_EQ(retrieved[i], i) << "Mismatch at index " << i;
+    }
+}
+
+TEST(StagingBufferManagerTest, UploadAfterReleaseStagingMemory) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue());
+
+    constexpr VkBufferUsageFlags DeviceBufferUsage =
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    using DeviceBuffer = vw::Buffer<uint32_t, false, DeviceBufferUsage>;
+    auto device_buffer = vw::create_buffer<DeviceBuffer>(*gpu.allocator, 4);
+
+    auto &queue = gpu.queue();
+    auto upload = [&](const std::vector<uint32_t> &data) {
+        staging_manager.fill_buffer(std::span<const uint32_t>(data),
+                                    device_buffer, 0);
+        queue.enqueue_command_buffer(staging_manager.fill_command_buffer());
+        queue.submit({}, {}, {}).wait();
+        staging_manager.release_staging_memory();
+    };
+
+    upload({1, 2, 3, 4});
+    upload({5, 6, 7, 8});
+
+    using HostBuffer = vw::Buffer<uint32_t, true, vw::StagingBufferUsage>;
+    auto host_buffer = vw::create_buffer<HostBuffer>(*gpu.allocator, 4);
+
+    auto cmd_pool = vw::CommandPoolBuilder(gpu.device).build();
+    auto readback_cmd = cmd_pool.allocate(1)[0];
+    std::ignore = readback_cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    readback_cmd.copyBuffer(device_buffer.handle(), host_buffer.handle(),
+                            vk::BufferCopy().setSize(4 * sizeof(uint32_t)));
+    std::ignore = readback_cmd.end();
+    queue.enqueue_command_buffer(readback_cmd);
+    queue.submit({}, {}, {}).wait();
+
+    EXPECT_EQ(host_buffer.read_as_vector(0, 4),
+              (std::vector<uint32_t>{5, 6, 7, 8}));
+}
+
+namespace {
+constexpr VkBufferUsageFlags StreamedBufferUsage =
+    VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+using StreamedBuffer = vw::Buffer<uint32_t, false, StreamedBufferUsage>;
+
+std::vector<uint32_t> read_back(vw::tests::GPU &gpu,
+                                const StreamedBuffer &buffer) {
+    using HostBuffer = vw::Buffer<uint32_t, true, vw::StagingBufferUsage>;
+    auto host_buffer =
+        vw::create_buffer<HostBuffer>(*gpu.allocator, buffer.size());
+
+    auto cmd_pool = vw::CommandPoolBuilder(gpu.device).build();
+    auto cmd = cmd_pool.allocate(1)[0];
+    std::ignore = cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    cmd.copyBuffer(buffer.handle(), host_buffer.handle(),
+                   vk::BufferCopy().setSize(buffer.size_bytes()));
+    std::ignore = cmd.end();
+    gpu.queue().enqueue_command_buffer(cmd);
+    gpu.queue().submit({}, {}, {}).wait();
+
+    return host_buffer.read_as_vector(0, buffer.size());
+}
+} // namespace
+
+TEST(StagingBufferManagerTest, UploadLargerThanRingIsChunked) {
+    auto &gpu = vw::tests::create_gpu();
+    constexpr vk::DeviceSize ring_size = 4096;
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue(), ring_size);
+
+    constexpr uint32_t element_count = 10'000;
+    auto device_buffer =
+        vw::create_buffer<StreamedBuffer>(*gpu.allocator, element_count);
+    std::vector<uint32_t> data(element_count);
+    std::iota(data.begin(), data.end(), 0u);
+
+    staging_manager.fill_buffer(std::span<const uint32_t>(data),
+                                device_buffer, 0);
+    staging_manager.wait_idle();
+
+    EXPECT_EQ(staging_manager.available_bytes(), ring_size);
+    EXPECT_EQ(read_back(gpu, device_buffer), data);
+}
+
+TEST(StagingBufferManagerTest, StreamingStaysWithinRing) {
+    // Streams 1 MiB through a 64 KiB ring
+    auto &gpu = vw::tests::create_gpu();
+    constexpr vk::DeviceSize ring_size = 1 << 16;
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue(), ring_size);
+
+    constexpr uint32_t element_count = 1024;
+    constexpr uint32_t upload_count = 256;
+    auto device_buffer = vw::create_buffer<StreamedBuffer>(
+        *gpu.allocator, element_count * upload_count);
+
+    std::vector<uint32_t> expected;
+    for (uint32_t upload = 0; upload < upload_count; ++upload) {
+        std::vector<uint32_t> data(element_count);
+        std::iota(data.begin(), data.end(), upload * element_count);
+        staging_manager.fill_buffer(std::span<const uint32_t>(data),
+                                    device_buffer, upload * element_count);
+        expected.insert(expected.end(), data.begin(), data.end());
+    }
+    staging_manager.wait_idle();
+
+    EXPECT_EQ(read_back(gpu, device_buffer), expected);
+}
+
+TEST(StagingBufferManagerTest, WaitForSpaceFreesRing) {
+    auto &gpu = vw::tests::create_gpu();
+    constexpr vk::DeviceSize ring_size = 4096;
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue(), ring_size);
+    auto device_buffer = vw::create_buffer<StreamedBuffer>(*gpu.allocator, 512);
+
+    std::vector<uint32_t> data(512, 7);
+    staging_manager.fill_buffer(std::span<const uint32_t>(data),
+                                device_buffer, 0);
+    EXPECT_EQ(staging_manager.available_bytes(), ring_size - 2048);
+
+    staging_manager.wait_for_space(ring_size);
+
+    EXPECT_EQ(staging_manager.available_bytes(), ring_size);
+    EXPECT_THROW(staging_manager.wait_for_space(ring_size + 1),
+                 vw::LogicException);
+}
+
+TEST(StagingBufferManagerTest, FullRingWithUnreleasedCommandBufferThrows) {
+    auto &gpu = vw::tests::create_gpu();
+    constexpr vk::DeviceSize ring_size = 4096;
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue(), ring_size);
+    auto device_buffer =
+        vw::create_buffer<StreamedBuffer>(*gpu.allocator, 1024);
+
+    std::vector<uint32_t> data(1024, 1);
+    staging_manager.fill_buffer(std::span<const uint32_t>(data),
+                                device_buffer, 0);
+    auto &queue = gpu.queue();
+    queue.enqueue_command_buffer(staging_manager.fill_command_buffer());
+    queue.submit({}, {}, {}).wait();
+
+    EXPECT_THROW(staging_manager.fill_buffer(std::span<const uint32_t>(data),
+                                             device_buffer, 0),
+                 vw::LogicException);
+
+    staging_manager.release_staging_memory();
+    EXPECT_NO_THROW(staging_manager.fill_buffer(
+        std::span<const uint32_t>(data), device_buffer, 0));
+}
+
+TEST(StagingBufferManagerTest, TrackedCommandBufferIsRecycled) {
+    auto &gpu = vw::tests::create_gpu();
+    constexpr vk::DeviceSize ring_size = 4096;
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue(), ring_size);
+    auto device_buffer =
+        vw::create_buffer<StreamedBuffer>(*gpu.allocator, 1024);
+
+    std::vector<uint32_t> first(1024, 1);
+    staging_manager.fill_buffer(std::span<const uint32_t>(first),
+                                device_buffer, 0);
+    auto &queue = gpu.queue();
+    queue.enqueue_command_buffer(staging_manager.fill_command_buffer());
+    staging_manager.track_submission(queue.submit_enqueued());
+
+    // The full ring waits for the tracked submission instead of throwing
+    std::vector<uint32_t> second(1024, 2);
+    staging_manager.fill_buffer(std::span<const uint32_t>(second),
+                                device_buffer, 0);
+    staging_manager.wait_idle();
+
+    EXPECT_EQ(read_back(gpu, device_buffer), second);
+}
+
+TEST(StagingBufferManagerTest, WaitForSpaceCountsWrapPadding) {
+    auto &gpu = vw::tests::create_gpu();
+    constexpr vk::DeviceSize ring_size = 4096;
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue(), ring_size);
+    auto device_buffer =
+        vw::create_buffer<StreamedBuffer>(*gpu.allocator, 1024);
+
+    std::vector<uint32_t> data(512, 3);
+    staging_manager.fill_buffer(std::span<const uint32_t>(data),
+                                device_buffer, 0);
+    staging_manager.flush();
+    staging_manager.fill_buffer(
+        std::span<const uint32_t>(data).first(256), device_buffer, 512);
+    staging_manager.flush();
+
+    // Once the first batch is recycled, 3072 bytes are free but split by
+    // the end of the ring
+    staging_manager.wait_for_space(3072);
+    EXPECT_GE(staging_manager.available_bytes(), 3072);
+    staging_manager.wait_idle();
+}
+
+TEST(StagingBufferManagerTest, ManySmallUploadsAreCoalesced) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue());
+
+    // Odd-sized uploads, as vertex data of many small meshes would be
+    constexpr uint32_t upload_count = 2000;
+    constexpr uint32_t element_count = 3;
+    auto device_buffer = vw::create_buffer<StreamedBuffer>(
+        *gpu.allocator, upload_count * element_count);
+
+    std::vector<uint32_t> expected(upload_count * element_count);
+    std::iota(expected.begin(), expected.end(), 0u);
+    for (uint32_t upload = 0; upload < upload_count; ++upload) {
+        staging_manager.fill_buffer(
+            std::span<const uint32_t>(expected).subspan(
+                upload * element_count, element_count),
+            device_buffer, upload * element_count);
+    }
+    staging_manager.wait_idle();
+
+    EXPECT_EQ(read_back(gpu, device_buffer), expected);
+}
+
+TEST(StagingBufferManagerTest, OverlappingUploadsKeepSubmissionOrder) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::StagingBufferManager staging_manager(gpu.device, gpu.allocator,
+                                             gpu.queue());
+    auto device_buffer = vw::create_buffer<StreamedBuffer>(*gpu.allocator, 8);
+
+    std::vector<uint32_t> first(8, 1);
+    std::vector<uint32_t> second(4, 2);
+    staging_manager.fill_buffer(std::span<const uint32_t>(first),
+                                device_buffer, 0);
+    staging_manager.fill_buffer(std::span<const uint32_t>(second),
+                                device_buffer, 2);
+    staging_manager.wait_idle();
+
+    EXPECT_EQ(read_back(gpu, device_buffer),
+              (std::vector<uint32_t>{1, 1, 2, 2, 2, 2, 1, 1}));
+}
@@ -0,0 +1,112 @@
+#include "utils/create_gpu.hpp"
+#include "VulkanWrapper/Memory/Allocator.h"
+#include "VulkanWrapper/Memory/StagingRing.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
+#include <gtest/gtest.h>
+
+TEST(StagingRingTest, AllocationsAreSequential) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::StagingRing ring(gpu.allocator, 1024);
+
+    auto a = ring.try_allocate(100, 16);
+    auto b = ring.try_allocate(100, 16);
+
+    ASSERT_TRUE(a && b);
+    EXPECT_EQ(a->offset, 0);
+    EXPECT_EQ(b->offset, 112);
+    EXPECT_EQ(a->data.size(), 100);
+    EXPECT_EQ(ring.used_bytes(), 212);
+}
+
+TEST(StagingRingTest, FullRingRefusesAllocation) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::StagingRing ring(gpu.allocator, 1024);
+
+    ASSERT_TRUE(ring.try_allocate(1024, 16));
+    EXPECT_FALSE(ring.try_allocate(1, 16));
+}
+
+TEST(StagingRingTest, OversizedAllocationThrows) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::StagingRing ring(gpu.allocator, 1024);
+
+    EXPECT_THROW(std::ignore = ring.try_allocate(2048, 16),
+                 vw::LogicException);
+}
+
+TEST(StagingRingTest, BatchWithoutTicketIsOnlyRecycledByRetireAll) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::StagingRing ring(gpu.allocator, 1024);
+
+    ASSERT_TRUE(ring.try_allocate(1024, 16));
+    ring.close_batch();
+
+    EXPECT_EQ(ring.retire(), 0);
+    EXPECT_FALSE(ring.wait_oldest());
+    EXPECT_EQ(ring.retire_all(), 1);
+    EXPECT_EQ(ring.used_bytes(), 0);
+    EXPECT_TRUE(ring.try_allocate(1024, 16));
+}
+
+TEST(StagingRingTest, BatchWithTicketIsRecycled) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::StagingRing ring(gpu.allocator, 1024);
+
+    ASSERT_TRUE(ring.try_allocate(768, 16));
+    ring.close_batch(gpu.queue().submit_enqueued());
+    EXPECT_FALSE(ring.try_allocate(512, 16));
+
+    EXPECT_TRUE(ring.wait_oldest());
+    EXPECT_EQ(ring.batch_count(), 0);
+    EXPECT_TRUE(ring.try_allocate(512, 16));
+}
+
+TEST(StagingRingTest, RegionsDoNotStraddleTheEnd) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::StagingRing ring(gpu.allocator, 1024);
+
+    ASSERT_TRUE(ring.try_allocate(512, 16));
+    ring.close_batch(gpu.queue().submit_enqueued());
+    ASSERT_TRUE(ring.try_allocate(256, 16));
+    ring.close_batch(gpu.queue().submit_enqueued());
+    ASSERT_TRUE(ring.wait_oldest());
+
+    // 256 bytes remain before the end, so 384 bytes wrap to the start
+    auto wrapped = ring.try_allocate(384, 16);
+    ASSERT_TRUE(wrapped);
+    EXPECT_EQ(wrapped->offset, 0);
+}
+
+TEST(StagingRingTest, SetTicketTracksClosedBatches) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::StagingRing ring(gpu.allocator, 1024);
+
+    ASSERT_TRUE(ring.try_allocate(512, 16));
+    ring.close_batch();
+    ASSERT_TRUE(ring.try_allocate(512, 16));
+    ring.close_batch();
+    EXPECT_FALSE(ring.wait_oldest());
+
+    ring.set_ticket(gpu.queue().submit_enqueued());
+    EXPECT_TRUE(ring.wait_oldest());
+    EXPECT_TRUE(ring.wait_oldest());
+    EXPECT_EQ(ring.used_bytes(), 0);
+}
+
+TEST(StagingRingTest, FreeRegionCountsWrapPadding) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::StagingRing ring(gpu.allocator, 1024);
+    EXPECT_EQ(ring.largest_free_region(), 1024);
+
+    ASSERT_TRUE(ring.try_allocate(512, 16));
+    ring.close_batch(gpu.queue().submit_enqueued());
+    ASSERT_TRUE(ring.try_allocate(256, 16));
+    ring.close_batch(gpu.queue().submit_enqueued());
+    ASSERT_TRUE(ring.wait_oldest());
+
+    // 768 bytes are free, split by the end of the buffer
+    EXPECT_EQ(ring.capacity() - ring.used_bytes(), 768);
+    EXPECT_EQ(ring.largest_free_region(), 512);
+    EXPECT_TRUE(ring.can_allocate(512, 16));
+    EXPECT_FALSE(ring.can_allocate(768, 16));
+}
@@ -0,0 +1,154 @@
+#include "utils/create_gpu.hpp"
+#include "VulkanWrapper/Image/Image.h"
+#include "VulkanWrapper/Memory/TransientImageAllocator.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr auto color_usage = vk::ImageUsageFlagBits::eColorAttachment |
+                             vk::ImageUsageFlagBits::eSampled;
+
+vw::TransientImageAllocator::GroupKey group(size_t frame_index,
+                                            uint32_t size = 128) {
+    return {.frame_index = frame_index, .width = size, .height = size};
+}
+
+} // namespace
+
+TEST(TransientImageAllocatorTest, LifetimeOverlap) {
+    EXPECT_TRUE((vw::ImageLifetime{0, 2}.overlaps({2, 3})));
+    EXPECT_TRUE((vw::ImageLifetime{1, 4}.overlaps({2, 3})));
+    EXPECT_FALSE((vw::ImageLifetime{0, 1}.overlaps({2, 3})));
+}
+
+TEST(TransientImageAllocatorTest, DisjointLifetimesShareMemory) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::TransientImageAllocator allocator(gpu.device, gpu.allocator);
+
+    auto first = allocator.create_image(group(0), {0, 1},
+                                        vk::Format::eR8G8B8A8Unorm,
+                                        color_usage);
+    auto second = allocator.create_image(group(0), {2, 3},
+                                         vk::Format::eR8G8B8A8Unorm,
+                                         color_usage);
+
+    EXPECT_EQ(first.memory, second.memory);
+    EXPECT_TRUE(allocator.shares_memory(first.image->handle()));
+    EXPECT_TRUE(allocator.shares_memory(second.image->handle()));
+
+    const auto statistics = allocator.statistics();
+    EXPECT_EQ(statistics.image_count, 2u);
+    EXPECT_EQ(statistics.block_count, 1u);
+    EXPECT_EQ(statistics.requested_bytes, 2 * statistics.allocated_bytes);
+}
+
+TEST(TransientImageAllocatorTest, OverlappingLifetimesDoNotAlias) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::TransientImageAllocator allocator(gpu.device, gpu.allocator);
+
+    auto first = allocator.create_image(group(0), {0, 2},
+                                        vk::Format::eR8G8B8A8Unorm,
+                                        color_usage);
+    auto second = allocator.create_image(group(0), {1, 3},
+                                         vk::Format::eR8G8B8A8Unorm,
+                                         color_usage);
+
+    EXPECT_FALSE(allocator.shares_memory(first.image->handle()));
+    EXPECT_FALSE(allocator.shares_memory(second.image->handle()));
+    EXPECT_EQ(allocator.statistics().saved_bytes(), 0u);
+}
+
+TEST(TransientImageAllocatorTest, FramesDoNotAlias) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::TransientImageAllocator allocator(gpu.device, gpu.allocator);
+
+    auto first = allocator.create_image(group(0), {0, 1},
+                                        vk::Format::eR8G8B8A8Unorm,
+                                        color_usage);
+    auto second = allocator.create_image(group(1), {2, 3},
+                                         vk::Format::eR8G8B8A8Unorm,
+                                         color_usage);
+
+    EXPECT_NE(first.memory, second.memory);
+    EXPECT_EQ(allocator.statistics().block_count, 2u);
+}
+
+TEST(TransientImageAllocatorTest, ResizeDropsPreviousGroup) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::TransientImageAllocator allocator(gpu.device, gpu.allocator);
+
+    auto small = allocator.create_image(group(0, 64), {0, 1},
+                                        vk::Format::eR8G8B8A8Unorm,
+                                        color_usage);
+    auto large = allocator.create_image(group(0, 256), {0, 1},
+                                        vk::Format::eR8G8B8A8Unorm,
+                                        color_usage);
+
+    const auto statistics = allocator.statistics();
+    EXPECT_EQ(statistics.image_count, 1u);
+    // The old image keeps its memory alive until it is released
+    EXPECT_NE(small.memory, nullptr);
+    EXPECT_EQ(large.image->extent2D().width, 256u);
+}
+
+TEST(TransientImageAllocatorTest, MemoryIsAccountedAsRenderTarget) {
+    auto &gpu = vw::tests::create_gpu();
+    auto vma = vw::AllocatorBuilder(gpu.instance, gpu.device).build();
+    {
+        vw::TransientImageAllocator allocator(gpu.device, vma);
+        auto image = allocator.create_image(group(0), {0, 1},
+                                            vk::Format::eR8G8B8A8Unorm,
+                                            color_usage);
+        const auto usage =
+            vma->category_usage(vw::AllocationCategory::RenderTarget);
+        EXPECT_EQ(usage.allocation_count, 1u);
+        EXPECT_EQ(usage.bytes, allocator.statistics().allocated_bytes);
+    }
+    EXPECT_EQ(
+        vma->category_usage(vw::AllocationCategory::RenderTarget).bytes, 0u);
+}
+
+TEST(TransientImageAllocatorTest, BlocksFitTheLargestImage) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::TransientImageAllocator allocator(gpu.device, gpu.allocator);
+
+    // The first group learns that the second image is the largest
+    auto small = allocator.create_image(group(0), {0, 1},
+                                        vk::Format::eR8G8B8A8Unorm,
+                                        color_usage);
+    auto large = allocator.create_image(group(0), {2, 3},
+                                        vk::Format::eR32G32B32A32Sfloat,
+                                        color_usage);
+    ASSERT_EQ(allocator.statistics().block_count, 2u);
+
+    // The next frame places both in one block sized by the largest
+    auto next_small = allocator.create_image(group(1), {0, 1},
+                                             vk::Format::eR8G8B8A8Unorm,
+                                             color_usage);
+    auto next_large = allocator.create_image(
+        group(1), {2, 3}, vk::Format::eR32G32B32A32Sfloat, color_usage);
+
+    EXPECT_EQ(next_small.memory, next_large.memory);
+    EXPECT_TRUE(allocator.shares_memory(next_large.image->handle()));
+    EXPECT_EQ(allocator.statistics().block_count, 3u);
+}
+
+TEST(TransientImageAllocatorTest, DestroyedImageFreesItsPlace) {
+    auto &gpu = vw::tests::create_gpu();
+    vw::TransientImageAllocator allocator(gpu.device, gpu.allocator);
+
+    auto first = allocator.create_image(group(0), {0, 1},
+                                        vk::Format::eR8G8B8A8Unorm,
+                                        color_usage);
+    const auto memory = first.memory;
+    first = {};
+    EXPECT_EQ(allocator.statistics().image_count, 0u);
+
+    // An image alive at the same time now fits in the freed place
+    auto second = allocator.create_image(group(0), {0, 1},
+                                         vk::Format::eR8G8B8A8Unorm,
+                                         color_usage);
+    EXPECT_EQ(second.memory, memory);
+    EXPECT_FALSE(allocator.shares_memory(second.image->handle()));
+    EXPECT_EQ(allocator.statistics().block_count, 1u);
+}
@@ -0,0 +1,102 @@
+#include "VulkanWrapper/Memory/VirtualBlock.h"
+#include <gtest/gtest.h>
+
+using namespace vw;
+
+TEST(VirtualBlockTest, NewBlockIsEmpty) {
+    VirtualBlock block(1024);
+
+    EXPECT_TRUE(block.empty());
+    EXPECT_EQ(block.size(), 1024);
+    EXPECT_EQ(block.statistics().allocation_count, 0);
+}
+
+TEST(VirtualBlockTest, AllocationsDoNotOverlap) {
+    VirtualBlock block(1024);
+
+    auto a = block.allocate(100, 1);
+    auto b = block.allocate(100, 1);
+
+    ASSERT_TRUE(a);
+    ASSERT_TRUE(b);
+    EXPECT_FALSE(block.empty());
+    EXPECT_GE(std::max(a->offset, b->offset),
+              std::min(a->offset, b->offset) + 100);
+}
+
+TEST(VirtualBlockTest, AllocationRespectsAlignment) {
+    VirtualBlock block(4096);
+
+    std::ignore = block.allocate(10, 1);
+    auto aligned = block.allocate(10, 256);
+
+    ASSERT_TRUE(aligned);
+    EXPECT_EQ(aligned->offset % 256, 0);
+}
+
+TEST(VirtualBlockTest, AllocationTooLargeFails) {
+    VirtualBlock block(1024);
+
+    EXPECT_FALSE(block.allocate(2048, 1));
+}
+
+TEST(VirtualBlockTest, FreedRangeIsReused) {
+    VirtualBlock block(256);
+
+    auto a = block.allocate(256, 1);
+    ASSERT_TRUE(a);
+    EXPECT_FALSE(block.allocate(1, 1));
+
+    block.free(a->handle);
+    EXPECT_TRUE(block.empty());
+
+    auto b = block.allocate(256, 1);
+    ASSERT_TRUE(b);
+    EXPECT_EQ(b->offset, 0);
+}
+
+TEST(VirtualBlockTest, ClearFreesEverything) {
+    VirtualBlock block(1024);
+
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(block.allocate(64, 1));
+    }
+    EXPECT_EQ(block.statistics().allocation_count, 8);
+
+    block.clear();
+
+    EXPECT_TRUE(block.empty());
+    EXPECT_EQ(block.statistics().used_size, 0);
+}
+
+TEST(VirtualBlockTest, StatisticsTrackUsage) {
+    VirtualBlock block(1024);
+
+    auto a = block.allocate(100, 1);
+    auto b = block.allocate(200, 1);
+    ASSERT_TRUE(a);
+    ASSERT_TRUE(b);
+
+    auto stats = block.statistics();
+    EXPECT_EQ(stats.allocation_count, 2);
+    EXPECT_EQ(stats.used_size, 300);
+    EXPECT_LE(stats.largest_free_region, 1024 - 300);
+
+    block.free(a->handle);
+    stats = block.statistics();
+    EXPECT_EQ(stats.allocation_count, 1);
+    EXPECT_EQ(stats.used_size, 200);
+}
+
+TEST(VirtualBlockTest, MoveTransfersOwnership) {
+    VirtualBlock block(1024);
+    auto a = block.allocate(100, 1);
+    ASSERT_TRUE(a);
+
+    VirtualBlock moved = std::move(block);
+
+    EXPECT_FALSE(moved.empty());
+    EXPECT_EQ(moved.size(), 1024);
+    moved.free(a->handle);
+    EXPECT_TRUE(moved.empty());
+}
@@ -87,7 +87,8 @@ class MeshManagerTest : public ::testing::Test {
             GTEST_SKIP() << "Ray tracing not available";
         }
         m_mesh_manager =
-            std::make_unique<MeshManager>(gpu->device, gpu->allocator);
+            std::make_unique<MeshManager>(gpu->device, gpu->allocator,
+                                          gpu->device->graphicsQueue());
     }
 
     MeshManagerGPU *gpu = nullptr;
@@ -157,3 +158,55 @@ TEST_F(MeshManagerTest, FillCommandBufferWithMultipleMeshes) {
     auto cmd = m_mesh_manager->fill_command_buffer();
     EXPECT_TRUE(cmd);
 }
+
+TEST_F(MeshManagerTest, RemoveMeshShrinksList) {
+    m_mesh_manager->add_mesh(make_triangle_vertices(), make_triangle_indices(),
+                             make_dummy_material());
+    m_mesh_manager->add_mesh(make_quad_vertices(), make_quad_indices(),
+                             make_dummy_material());
+
+    m_mesh_manager->remove_mesh(0);
+
+    ASSERT_EQ(m_mesh_manager->meshes().size(), 1);
+    EXPECT_EQ(m_mesh_manager->meshes()[0].index_count(), 6);
+}
+
+TEST_F(MeshManagerTest, RemovedMeshRangesAreReused) {
+    m_mesh_manager->add_mesh(make_triangle_vertices(), make_triangle_indices(),
+                             make_dummy_material());
+    m_mesh_manager->add_mesh(make_quad_vertices(), make_quad_indices(),
+                             make_dummy_material());
+
+    m_mesh_manager->remove_mesh(0);
+    m_mesh_manager->add_mesh(make_triangle_vertices(), make_triangle_indices(),
+                             make_dummy_material());
+
+    const auto &reused = m_mesh_manager->meshes().back();
+    EXPECT_EQ(reused.vertex_offset(), 0);
+    EXPECT_EQ(reused.first_index(), 0);
+}
+
+TEST_F(MeshManagerTest, IdsStayValidAcrossRemoval) {
+    const auto first = m_mesh_manager->add_mesh(
+        make_triangle_vertices(), make_triangle_indices(),
+        make_dummy_material());
+    const auto second = m_mesh_manager->add_mesh(
+        make_quad_vertices(), make_quad_indices(), make_dummy_material());
+    const auto third = m_mesh_manager->add_mesh(
+        make_triangle_vertices(), make_triangle_indices(),
+        make_dummy_material());
+
+    m_mesh_manager->remove_mesh(first);
+
+    const auto &meshes = m_mesh_manager->meshes();
+    ASSERT_EQ(meshes.size(), 2);
+    EXPECT_EQ(meshes[m_mesh_manager->mesh_index(second)].index_count(), 6);
+    EXPECT_EQ(meshes[m_mesh_manager->mesh_index(third)].index_count(), 3);
+    EXPECT_THROW(std::ignore = m_mesh_manager->mesh_index(first),
+                 vw::LogicException);
+    EXPECT_THROW(m_mesh_manager->remove_mesh(first), vw::LogicException);
+}
+
+TEST_F(MeshManagerTest, RemoveMeshOutOfRangeThrows) {
+    EXPECT_THROW(m_mesh_manager->remove_mesh(0), vw::LogicException);
+}
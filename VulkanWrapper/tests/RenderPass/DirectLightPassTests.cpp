@@ -78,7 +78,7 @@ class DirectLightPassTest : public ::testing::Test {
     std::unique_ptr<DirectLightPass> create_pass() {
         auto staging =
             std::make_shared<StagingBufferManager>(
-                gpu->device, gpu->allocator);
+                gpu->device, gpu->allocator, gpu->queue());
         m_material_manager =
             std::make_unique<
                 Model::Material::BindlessMaterialManager>(
@@ -0,0 +1,85 @@
+#include "VulkanWrapper/RenderPass/DynamicResolution.h"
+#include "VulkanWrapper/Utils/Error.h"
+#include <cmath>
+#include <gtest/gtest.h>
+
+namespace {
+
+// Frame time of a GPU spending `full_ms` at full resolution
+double frame_ms(double full_ms, float scale) {
+    return full_ms * scale * scale;
+}
+
+float run(vw::DynamicResolution &controller, double full_ms, int frames) {
+    for (int i = 0; i < frames; ++i) {
+        controller.update(frame_ms(full_ms, controller.scale()));
+    }
+    return controller.scale();
+}
+
+} // namespace
+
+TEST(DynamicResolutionTest, StartsAtMaxScale) {
+    const vw::DynamicResolution controller(16.0, 0.5f, 0.9f);
+    EXPECT_EQ(controller.scale(), 0.9f);
+    EXPECT_EQ(controller.average_ms(), 0.0);
+}
+
+TEST(DynamicResolutionTest, WithinBudgetKeepsScale) {
+    vw::DynamicResolution controller(16.0);
+    EXPECT_EQ(run(controller, 15.0, 100), 1.0f);
+}
+
+TEST(DynamicResolutionTest, OverBudgetConvergesIntoBudget) {
+    vw::DynamicResolution controller(16.0);
+    const auto scale = run(controller, 30.0, 200);
+
+    EXPECT_LT(scale, 1.0f);
+    const auto ms = frame_ms(30.0, scale);
+    EXPECT_LE(ms, 16.0);
+    EXPECT_GE(ms, 16.0 * (1.0 - vw::DynamicResolution::headroom) - 1.0);
+
+    // Settled: the scale no longer moves
+    EXPECT_EQ(run(controller, 30.0, 100), scale);
+}
+
+TEST(DynamicResolutionTest, UnderBudgetScalesBackUp) {
+    vw::DynamicResolution controller(16.0);
+    run(controller, 40.0, 200);
+    ASSERT_LT(controller.scale(), 1.0f);
+
+    EXPECT_EQ(run(controller, 8.0, 200), 1.0f);
+}
+
+TEST(DynamicResolutionTest, StepsAreBoundedAndQuantized) {
+    vw::DynamicResolution controller(16.0, 0.25f, 1.0f);
+    auto previous = controller.scale();
+    for (int i = 0; i < 50; ++i) {
+        const auto scale = controller.update(100.0);
+        EXPECT_LE(previous - scale,
+                  vw::DynamicResolution::max_step +
+                      vw::DynamicResolution::scale_step);
+        const auto steps = scale / vw::DynamicResolution::scale_step;
+        EXPECT_FLOAT_EQ(steps, std::round(steps));
+        previous = scale;
+    }
+}
+
+TEST(DynamicResolutionTest, ScaleStaysWithinBounds) {
+    vw::DynamicResolution controller(16.0, 0.5f, 0.75f);
+    EXPECT_EQ(run(controller, 1000.0, 200), 0.5f);
+    EXPECT_EQ(run(controller, 1.0, 200), 0.75f);
+}
+
+TEST(DynamicResolutionTest, InvalidSettingsThrow) {
+    EXPECT_THROW(vw::DynamicResolution(0.0), vw::LogicException);
+    EXPECT_THROW(vw::DynamicResolution(16.0, 0.0f), vw::LogicException);
+    EXPECT_THROW(vw::DynamicResolution(16.0, 0.8f, 0.5f),
+                 vw::LogicException);
+    EXPECT_THROW(vw::DynamicResolution(16.0, 0.5f, 1.5f),
+                 vw::LogicException);
+
+    vw::DynamicResolution controller(16.0);
+    EXPECT_THROW(controller.set_budget_ms(-1.0), vw::LogicException);
+    EXPECT_EQ(controller.budget_ms(), 16.0);
+}
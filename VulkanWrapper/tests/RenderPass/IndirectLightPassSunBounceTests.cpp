@@ -88,7 +88,8 @@ RayTracingGPU *create_ray_tracing_gpu() {
         auto allocator = AllocatorBuilder(instance, device).build();
 
         auto staging =
-            std::make_shared<StagingBufferManager>(device, allocator);
+            std::make_shared<StagingBufferManager>(
+                device, allocator, device->graphicsQueue());
         auto material_manager =
             std::make_unique<Model::Material::BindlessMaterialManager>(
                 device, allocator, staging);
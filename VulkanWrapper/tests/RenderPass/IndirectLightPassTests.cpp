@@ -13,6 +13,7 @@
 #include "VulkanWrapper/Model/MeshManager.h"
 #include "VulkanWrapper/RayTracing/RayTracedScene.h"
 #include "VulkanWrapper/RenderPass/IndirectLightPass.h"
+#include "VulkanWrapper/RenderPass/RenderPipeline.h"
 #include "VulkanWrapper/RenderPass/Slot.h"
 #include "VulkanWrapper/Shader/ShaderCompiler.h"
 #include "VulkanWrapper/Synchronization/Fence.h"
@@ -84,7 +85,8 @@ RayTracingGPU *create_ray_tracing_gpu() {
         auto allocator = AllocatorBuilder(instance, device).build();
 
         auto staging =
-            std::make_shared<StagingBufferManager>(device, allocator);
+            std::make_shared<StagingBufferManager>(
+                device, allocator, device->graphicsQueue());
         auto material_manager =
             std::make_unique<Model::Material::BindlessMaterialManager>(
                 device, allocator, staging);
@@ -109,6 +111,28 @@ RayTracingGPU *get_ray_tracing_gpu() {
     return gpu;
 }
 
+// Stands for the passes around IndirectLightPass in a pipeline
+class SlotPass : public RenderPass {
+  public:
+    SlotPass(std::shared_ptr<Device> device,
+             std::shared_ptr<Allocator> allocator, std::vector<Slot> inputs,
+             std::vector<Slot> outputs)
+        : RenderPass(std::move(device), std::move(allocator))
+        , m_inputs(std::move(inputs))
+        , m_outputs(std::move(outputs)) {}
+
+    std::vector<Slot> input_slots() const override { return m_inputs; }
+    std::vector<Slot> output_slots() const override { return m_outputs; }
+    std::string_view name() const override { return "SlotPass"; }
+
+    void execute(vk::CommandBuffer, Barrier::ResourceTracker &, Width,
+                 Height, size_t) override {}
+
+  private:
+    std::vector<Slot> m_inputs;
+    std::vector<Slot> m_outputs;
+};
+
 } // anonymous namespace
 
 // =============================================================================
@@ -583,6 +607,36 @@ TEST_F(IndirectLightPassTest, Name_ReturnsIndirectLightPass) {
     EXPECT_EQ(pass->name(), "IndirectLightPass");
 }
 
+TEST_F(IndirectLightPassTest, RunsInAsyncComputeSegment) {
+    rt::RayTracedScene scene(gpu->device, gpu->allocator);
+    const auto &plane = gpu->get_plane_mesh();
+    std::ignore = scene.add_instance(
+        plane, glm::translate(glm::mat4(1.0f), glm::vec3(0, -100, 0)));
+    scene.build();
+
+    RenderPipeline pipeline;
+    pipeline.add(std::make_unique<SlotPass>(
+        gpu->device, gpu->allocator, std::vector<Slot>{},
+        std::vector<Slot>{Slot::Position, Slot::Normal, Slot::Albedo,
+                          Slot::AmbientOcclusion, Slot::IndirectRay}));
+    pipeline.add(std::make_unique<IndirectLightPass>(
+        gpu->device, gpu->allocator, get_shader_dir(), scene.tlas(),
+        scene.geometry_buffer(), *gpu->material_manager,
+        vk::Format::eR32G32B32A32Sfloat));
+    pipeline.add(std::make_unique<SlotPass>(
+        gpu->device, gpu->allocator,
+        std::vector<Slot>{Slot::IndirectLight},
+        std::vector<Slot>{Slot::ToneMapped}));
+
+    const auto &segments = pipeline.queue_segments();
+
+    ASSERT_EQ(segments.size(), 3u);
+    EXPECT_EQ(segments[1].queue, PassQueue::Compute);
+    EXPECT_EQ(segments[1].passes, std::vector<size_t>{1});
+    EXPECT_EQ(segments[1].waits, std::vector<size_t>{0});
+    EXPECT_EQ(segments[2].queue, PassQueue::Graphics);
+}
+
 TEST_F(IndirectLightPassTest, ExecuteReturnsValidImageView) {
     constexpr Width width{64};
     constexpr Height height{64};
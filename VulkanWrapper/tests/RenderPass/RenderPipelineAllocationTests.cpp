@@ -0,0 +1,119 @@
+#include "utils/create_gpu.hpp"
+#include "VulkanWrapper/RenderPass/RenderPipeline.h"
+#include "VulkanWrapper/Synchronization/ResourceTracker.h"
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <new>
+
+// Counts the allocations of the test thread while enabled. Other
+// threads, e.g. of the driver, are not counted. The replacement
+// also counts the allocations of the shared library, which binds
+// operator new to the executable's definition.
+namespace {
+thread_local bool counting_allocations = false;
+thread_local std::size_t allocation_count = 0;
+} // namespace
+
+void *operator new(std::size_t size) {
+    if (counting_allocations) {
+        ++allocation_count;
+    }
+    if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+// Allocates nothing once its images exist, so what is counted is
+// the pipeline's own bookkeeping
+class ImagePass : public vw::RenderPass {
+  public:
+    ImagePass(std::shared_ptr<vw::Device> device,
+              std::shared_ptr<vw::Allocator> allocator,
+              std::vector<vw::Slot> inputs, std::vector<vw::Slot> outputs)
+        : RenderPass(std::move(device), std::move(allocator))
+        , m_inputs(std::move(inputs))
+        , m_outputs(std::move(outputs)) {}
+
+    std::vector<vw::Slot> input_slots() const override { return m_inputs; }
+    std::vector<vw::Slot> output_slots() const override {
+        return m_outputs;
+    }
+    std::string_view name() const override { return "ImagePass"; }
+
+    void execute(vk::CommandBuffer, vw::Barrier::ResourceTracker &,
+                 vw::Width width, vw::Height height,
+                 size_t frame_index) override {
+        for (auto slot : m_outputs) {
+            get_or_create_image(slot, width, height, frame_index,
+                                vk::Format::eR8G8B8A8Unorm,
+                                vk::ImageUsageFlagBits::eColorAttachment |
+                                    vk::ImageUsageFlagBits::eSampled);
+        }
+    }
+
+  private:
+    std::vector<vw::Slot> m_inputs;
+    std::vector<vw::Slot> m_outputs;
+};
+
+class RenderPipelineAllocationTest : public ::testing::Test {
+  protected:
+    void add(vw::RenderPipeline &pipeline, std::vector<vw::Slot> inputs,
+             std::vector<vw::Slot> outputs) {
+        pipeline.add(std::make_unique<ImagePass>(
+            gpu.device, gpu.allocator, std::move(inputs),
+            std::move(outputs)));
+    }
+
+    // Allocations of the frames after the first `frames_in_flight`,
+    // which create the images
+    std::size_t steady_state_allocations(vw::RenderPipeline &pipeline,
+                                         size_t frames_in_flight) {
+        vw::Barrier::ResourceTracker tracker;
+        std::size_t count = 0;
+        for (size_t frame = 0; frame < 16; ++frame) {
+            allocation_count = 0;
+            counting_allocations = frame >= frames_in_flight;
+            pipeline.execute(vk::CommandBuffer{}, tracker, vw::Width{64},
+                             vw::Height{64}, frame % frames_in_flight);
+            counting_allocations = false;
+            count += allocation_count;
+        }
+        return count;
+    }
+
+    vw::tests::GPU &gpu = vw::tests::create_gpu();
+};
+
+} // namespace
+
+TEST_F(RenderPipelineAllocationTest, SteadyStateFramesDoNotAllocate) {
+    vw::RenderPipeline pipeline;
+    add(pipeline, {}, {vw::Slot::Depth});
+    add(pipeline, {vw::Slot::Depth}, {vw::Slot::Albedo, vw::Slot::Normal});
+    add(pipeline, {}, {vw::Slot::Sky});
+    add(pipeline, {vw::Slot::Albedo, vw::Slot::Normal, vw::Slot::Sky},
+        {vw::Slot::ToneMapped});
+
+    EXPECT_EQ(steady_state_allocations(pipeline, 2), 0u);
+}
+
+TEST_F(RenderPipelineAllocationTest, ReadBackSlotDoesNotAllocate) {
+    vw::RenderPipeline pipeline;
+    add(pipeline, {}, {vw::Slot::Albedo});
+    add(pipeline, {vw::Slot::Albedo, vw::Slot::IndirectLight},
+        {vw::Slot::IndirectLight});
+    add(pipeline, {vw::Slot::IndirectLight}, {vw::Slot::ToneMapped});
+    pipeline.mark_external(vw::Slot::ToneMapped);
+
+    EXPECT_EQ(steady_state_allocations(pipeline, 1), 0u);
+}
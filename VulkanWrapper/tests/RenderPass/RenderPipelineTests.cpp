@@ -1,6 +1,10 @@
 #include "utils/create_gpu.hpp"
+#include "VulkanWrapper/Command/CommandPool.h"
+#include "VulkanWrapper/Command/GpuProfiler.h"
 #include "VulkanWrapper/RenderPass/RenderPipeline.h"
 #include "VulkanWrapper/Synchronization/ResourceTracker.h"
+#include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
 #include <gtest/gtest.h>
 
 namespace {
@@ -66,6 +70,24 @@ class MockPassWithReset : public MockPass {
     bool m_reset_called = false;
 };
 
+class ComputeMockPass : public MockPass {
+  public:
+    using MockPass::MockPass;
+
+    vw::PassQueue preferred_queue() const override {
+        return vw::PassQueue::Compute;
+    }
+};
+
+class OutputMockPass : public MockPassWithReset {
+  public:
+    using MockPassWithReset::MockPassWithReset;
+
+    vw::PassResolution resolution() const override {
+        return vw::PassResolution::Output;
+    }
+};
+
 class RenderPipelineTest : public ::testing::Test {
   protected:
     void SetUp() override {
@@ -89,10 +111,34 @@ class RenderPipelineTest : public ::testing::Test {
             std::move(outputs));
     }
 
+    auto make_compute_pass(std::vector<vw::Slot> inputs,
+                           std::vector<vw::Slot> outputs) {
+        return std::make_unique<ComputeMockPass>(
+            device, allocator, std::move(inputs),
+            std::move(outputs));
+    }
+
+    auto make_output_pass(std::vector<vw::Slot> inputs,
+                          std::vector<vw::Slot> outputs) {
+        return std::make_unique<OutputMockPass>(
+            device, allocator, std::move(inputs),
+            std::move(outputs));
+    }
+
     std::shared_ptr<vw::Device> device;
     std::shared_ptr<vw::Allocator> allocator;
 };
 
+using Segment = vw::RenderPipeline::QueueSegment;
+
+void expect_segment(const Segment &segment, vw::PassQueue queue,
+                    std::vector<size_t> passes,
+                    std::vector<size_t> waits) {
+    EXPECT_EQ(segment.queue, queue);
+    EXPECT_EQ(segment.passes, passes);
+    EXPECT_EQ(segment.waits, waits);
+}
+
 } // namespace
 
 TEST_F(RenderPipelineTest, Validate_EmptyPipeline_Valid) {
@@ -229,3 +275,450 @@ TEST_F(RenderPipelineTest, PassAccess) {
     EXPECT_EQ(pipeline.pass(0).name(), "MockPass");
     EXPECT_EQ(pipeline.pass(1).name(), "MockPass");
 }
+
+namespace {
+
+class PersistentMockPass : public MockPass {
+  public:
+    using MockPass::MockPass;
+
+    std::vector<vw::Slot> persistent_slots() const override {
+        return output_slots();
+    }
+};
+
+std::shared_ptr<const void> slot_memory(const vw::RenderPass &pass,
+                                        vw::Slot slot) {
+    for (const auto &[result_slot, cached] : pass.result_images()) {
+        if (result_slot == slot) {
+            return cached.memory;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST_F(RenderPipelineTest, SlotLifetimes_SpanProducerToLastReader) {
+    vw::RenderPipeline pipeline;
+    pipeline.add(make_pass({}, {vw::Slot::Depth}));
+    pipeline.add(make_pass({vw::Slot::Depth},
+                           {vw::Slot::Albedo, vw::Slot::Normal}));
+    pipeline.add(make_pass({vw::Slot::Albedo}, {vw::Slot::Sky}));
+    pipeline.add(make_pass({vw::Slot::Sky, vw::Slot::Normal},
+                           {vw::Slot::ToneMapped}));
+
+    auto lifetimes = pipeline.slot_lifetimes();
+
+    ASSERT_EQ(lifetimes.size(), 5u);
+    EXPECT_EQ(lifetimes[vw::Slot::Depth].passes.first, 0u);
+    EXPECT_EQ(lifetimes[vw::Slot::Depth].passes.last, 1u);
+    EXPECT_EQ(lifetimes[vw::Slot::Normal].passes.last, 3u);
+    EXPECT_EQ(lifetimes[vw::Slot::Sky].passes.first, 2u);
+    EXPECT_TRUE(lifetimes[vw::Slot::Depth].transient);
+    EXPECT_TRUE(lifetimes[vw::Slot::Sky].transient);
+    // Never read by a later pass: the caller consumes it
+    EXPECT_FALSE(lifetimes[vw::Slot::ToneMapped].transient);
+}
+
+TEST_F(RenderPipelineTest,
+       SlotLifetimes_PersistentAndExternalSlotsAreNotTransient) {
+    vw::RenderPipeline pipeline;
+    pipeline.add(std::make_unique<PersistentMockPass>(
+        device, allocator, std::vector<vw::Slot>{},
+        std::vector{vw::Slot::AmbientOcclusion}));
+    pipeline.add(make_pass({}, {vw::Slot::Albedo}));
+    pipeline.add(make_pass({vw::Slot::Sky}, {vw::Slot::Sky}));
+    pipeline.add(make_pass(
+        {vw::Slot::AmbientOcclusion, vw::Slot::Albedo, vw::Slot::Sky},
+        {}));
+    pipeline.mark_external(vw::Slot::Albedo);
+
+    auto lifetimes = pipeline.slot_lifetimes();
+
+    EXPECT_FALSE(lifetimes[vw::Slot::AmbientOcclusion].transient);
+    EXPECT_FALSE(lifetimes[vw::Slot::Albedo].transient);
+    // Read by its own producer
+    EXPECT_FALSE(lifetimes[vw::Slot::Sky].transient);
+}
+
+TEST_F(RenderPipelineTest, TransientAliasing_SharesMemoryOfDisjointSlots) {
+    vw::RenderPipeline pipeline;
+    pipeline.add(make_pass({}, {vw::Slot::Depth}));
+    pipeline.add(make_pass({vw::Slot::Depth},
+                           {vw::Slot::Albedo, vw::Slot::Normal}));
+    auto &sky_pass =
+        pipeline.add(make_pass({vw::Slot::Albedo}, {vw::Slot::Sky}));
+    pipeline.add(make_pass({vw::Slot::Sky, vw::Slot::Normal},
+                           {vw::Slot::ToneMapped}));
+    pipeline.enable_transient_aliasing();
+
+    vw::Barrier::ResourceTracker tracker;
+    for (size_t frame = 0; frame < 2; ++frame) {
+        pipeline.execute(vk::CommandBuffer{}, tracker,
+                         vw::Width{256}, vw::Height{256}, 0);
+    }
+
+    // Sky starts after the last read of Depth and reuses its memory
+    EXPECT_EQ(slot_memory(sky_pass, vw::Slot::Sky),
+              slot_memory(pipeline.pass(0), vw::Slot::Depth));
+    EXPECT_NE(slot_memory(sky_pass, vw::Slot::Sky), nullptr);
+    // ToneMapped is read by the caller and keeps its own allocation
+    EXPECT_EQ(slot_memory(pipeline.pass(3), vw::Slot::ToneMapped),
+              nullptr);
+
+    const auto statistics = pipeline.aliasing_statistics();
+    EXPECT_EQ(statistics.image_count, 4u);
+    EXPECT_EQ(statistics.block_count, 3u);
+    EXPECT_GT(statistics.saved_bytes(), 0u);
+    EXPECT_EQ(statistics.requested_bytes - statistics.allocated_bytes,
+              statistics.saved_bytes());
+}
+
+TEST_F(RenderPipelineTest, TransientAliasing_DisabledByDefault) {
+    vw::RenderPipeline pipeline;
+    pipeline.add(make_pass({}, {vw::Slot::Depth}));
+    pipeline.add(make_pass({vw::Slot::Depth}, {vw::Slot::Sky}));
+
+    vw::Barrier::ResourceTracker tracker;
+    pipeline.execute(vk::CommandBuffer{}, tracker,
+                     vw::Width{256}, vw::Height{256}, 0);
+
+    EXPECT_EQ(slot_memory(pipeline.pass(0), vw::Slot::Depth), nullptr);
+    EXPECT_EQ(pipeline.aliasing_statistics().image_count, 0u);
+}
+
+TEST_F(RenderPipelineTest, RenderTargetPool_ResizeWithinBucketKeepsImages) {
+    auto pool = std::make_shared<vw::RenderTargetPool>(device, allocator, 2);
+    vw::RenderPipeline pipeline;
+    pipeline.use_render_target_pool(pool);
+    pipeline.add(make_pass({}, {vw::Slot::Albedo}));
+    pipeline.add(make_pass({vw::Slot::Albedo}, {vw::Slot::ToneMapped}));
+
+    vw::Barrier::ResourceTracker tracker;
+    pipeline.execute(vk::CommandBuffer{}, tracker, vw::Width{1000},
+                     vw::Height{700}, 0);
+    auto before = pipeline.pass(0).result_images()[0].second;
+
+    // Interactive resize: every frame has a slightly different size
+    for (uint32_t width = 1001; width < 1020; ++width) {
+        pipeline.execute(vk::CommandBuffer{}, tracker, vw::Width{width},
+                         vw::Height{700}, 0);
+    }
+    auto after = pipeline.pass(0).result_images()[0].second;
+
+    EXPECT_EQ(after.image, before.image);
+    EXPECT_EQ(after.render_extent(), (vk::Extent2D{1019, 700}));
+    EXPECT_EQ(pool->statistics().allocation_count, 2u);
+}
+
+TEST_F(RenderPipelineTest, RenderTargetPool_RecyclesAcrossResolutions) {
+    auto pool = std::make_shared<vw::RenderTargetPool>(device, allocator, 2);
+    vw::RenderPipeline pipeline;
+    pipeline.use_render_target_pool(pool);
+    pipeline.add(make_pass({}, {vw::Slot::Albedo}));
+
+    vw::Barrier::ResourceTracker tracker;
+    // Dynamic resolution alternating between two sizes. Each
+    // execute() starts a frame of the pool.
+    for (int frame = 0; frame < 12; ++frame) {
+        const uint32_t size = (frame / 3) % 2 == 0 ? 512 : 384;
+        pipeline.execute(vk::CommandBuffer{}, tracker, vw::Width{size},
+                         vw::Height{size}, 0);
+    }
+
+    // One image per resolution: switching back recycles the image
+    // released once the frames using it are done
+    const auto statistics = pool->statistics();
+    EXPECT_EQ(statistics.allocation_count, 2u);
+    EXPECT_EQ(statistics.reuse_count, 2u);
+}
+
+TEST_F(RenderPipelineTest, RenderTargetPool_DestroyedPassReleasesImages) {
+    auto pool = std::make_shared<vw::RenderTargetPool>(device, allocator, 0);
+    {
+        vw::RenderPipeline pipeline;
+        pipeline.use_render_target_pool(pool);
+        pipeline.add(make_pass({}, {vw::Slot::Albedo, vw::Slot::Normal}));
+
+        vw::Barrier::ResourceTracker tracker;
+        pipeline.execute(vk::CommandBuffer{}, tracker, vw::Width{64},
+                         vw::Height{64}, 0);
+        EXPECT_EQ(pool->statistics().available_count, 0u);
+    }
+    EXPECT_EQ(pool->statistics().available_count, 2u);
+}
+
+TEST_F(RenderPipelineTest, Graph_DependenciesFollowSlots) {
+    vw::RenderPipeline pipeline;
+    pipeline.add(make_pass({}, {vw::Slot::Depth}));
+    pipeline.add(make_pass({vw::Slot::Depth}, {vw::Slot::Albedo}));
+    // Overwrites Depth: waits for its producer and reader
+    pipeline.add(make_pass({}, {vw::Slot::Depth}));
+    pipeline.add(make_pass({vw::Slot::Albedo, vw::Slot::Depth},
+                           {vw::Slot::ToneMapped}));
+
+    const auto &graph = pipeline.graph();
+
+    EXPECT_TRUE(graph.dependencies[0].empty());
+    EXPECT_EQ(graph.dependencies[1], (std::vector<size_t>{0}));
+    EXPECT_EQ(graph.dependencies[2], (std::vector<size_t>{0, 1}));
+    EXPECT_EQ(graph.dependencies[3], (std::vector<size_t>{1, 2}));
+    EXPECT_EQ(graph.order, (std::vector<size_t>{0, 1, 2, 3}));
+}
+
+TEST_F(RenderPipelineTest, Graph_UnconsumedPassIsCulled) {
+    vw::RenderPipeline pipeline;
+    pipeline.add(make_pass({}, {vw::Slot::Depth}));
+    auto &ao_pass = pipeline.add(
+        make_pass({vw::Slot::Depth}, {vw::Slot::AmbientOcclusion}));
+    pipeline.add(make_pass({vw::Slot::Depth}, {vw::Slot::ToneMapped}));
+
+    EXPECT_TRUE(pipeline.graph().culled[1]);
+    EXPECT_EQ(pipeline.graph().order, (std::vector<size_t>{0, 2}));
+
+    vw::Barrier::ResourceTracker tracker;
+    pipeline.execute(vk::CommandBuffer{}, tracker, vw::Width{64},
+                     vw::Height{64}, 0);
+    EXPECT_FALSE(ao_pass.was_executed());
+}
+
+TEST_F(RenderPipelineTest, Graph_ExternalSlotKeepsItsProducer) {
+    vw::RenderPipeline pipeline;
+    pipeline.add(make_pass({}, {vw::Slot::Depth}));
+    pipeline.add(
+        make_pass({vw::Slot::Depth}, {vw::Slot::AmbientOcclusion}));
+    pipeline.add(make_pass({vw::Slot::Depth}, {vw::Slot::ToneMapped}));
+    ASSERT_TRUE(pipeline.graph().culled[1]);
+
+    pipeline.mark_external(vw::Slot::AmbientOcclusion);
+
+    EXPECT_FALSE(pipeline.graph().culled[1]);
+    EXPECT_EQ(pipeline.graph().order.size(), 3u);
+}
+
+TEST_F(RenderPipelineTest, Graph_PreviousFrameReadKeepsItsProducer) {
+    vw::RenderPipeline pipeline;
+    pipeline.add(make_pass({}, {vw::Slot::Depth}));
+    // Reads the AmbientOcclusion of the previous frame
+    pipeline.add(make_pass({vw::Slot::Depth, vw::Slot::AmbientOcclusion},
+                           {vw::Slot::Albedo}));
+    pipeline.add(
+        make_pass({vw::Slot::Depth}, {vw::Slot::AmbientOcclusion}));
+    pipeline.add(make_pass({vw::Slot::Albedo}, {vw::Slot::ToneMapped}));
+
+    const auto &graph = pipeline.graph();
+
+    EXPECT_FALSE(graph.culled[2]);
+    EXPECT_EQ(graph.dependencies[1], (std::vector<size_t>{0}));
+    // Overwriting the slot still waits for its reader
+    EXPECT_EQ(graph.dependencies[2], (std::vector<size_t>{0, 1}));
+    EXPECT_EQ(graph.order, (std::vector<size_t>{0, 1, 2, 3}));
+}
+
+TEST_F(RenderPipelineTest, Graph_IndependentPassRunsBetweenDependencies) {
+    vw::RenderPipeline pipeline;
+    pipeline.add(make_pass({}, {vw::Slot::Depth}));
+    pipeline.add(make_pass({vw::Slot::Depth}, {vw::Slot::Albedo}));
+    pipeline.add(make_pass({}, {vw::Slot::Sky}));
+    pipeline.add(make_pass({vw::Slot::Albedo, vw::Slot::Sky},
+                           {vw::Slot::ToneMapped}));
+
+    // Sky gives the barrier on Depth time to resolve
+    EXPECT_EQ(pipeline.graph().order, (std::vector<size_t>{0, 2, 1, 3}));
+
+    auto lifetimes = pipeline.slot_lifetimes();
+    EXPECT_EQ(lifetimes[vw::Slot::Depth].passes.last, 2u);
+    EXPECT_EQ(lifetimes[vw::Slot::Sky].passes.first, 1u);
+}
+
+TEST_F(RenderPipelineTest, Graph_RecompiledWhenAPassIsAdded) {
+    vw::RenderPipeline pipeline;
+    pipeline.add(make_pass({}, {vw::Slot::Albedo}));
+    EXPECT_EQ(pipeline.graph().order, (std::vector<size_t>{0}));
+
+    pipeline.add(make_pass({vw::Slot::Albedo}, {vw::Slot::ToneMapped}));
+
+    EXPECT_EQ(pipeline.graph().order, (std::vector<size_t>{0, 1}));
+    EXPECT_EQ(pipeline.graph().dependencies[1], (std::vector<size_t>{0}));
+}
+
+TEST_F(RenderPipelineTest, GpuProfiler_MeasuresEveryPassByName) {
+    auto &gpu = vw::tests::create_gpu();
+    auto profiler = std::make_shared<vw::GpuProfiler>(device, 1);
+    auto pool = vw::CommandPoolBuilder(device).build();
+    vw::RenderPipeline pipeline;
+    pipeline.use_gpu_profiler(profiler);
+    pipeline.add(make_pass({}, {vw::Slot::Albedo}));
+    pipeline.add(make_pass({vw::Slot::Albedo}, {vw::Slot::ToneMapped}));
+
+    vw::Barrier::ResourceTracker tracker;
+    for (int frame = 0; frame < 2; ++frame) {
+        auto cmd = pool.allocate(1)[0];
+        std::ignore = cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        profiler->begin_frame(cmd);
+        pipeline.execute(cmd, tracker, vw::Width{64}, vw::Height{64}, 0);
+        std::ignore = cmd.end();
+        gpu.queue().enqueue_command_buffer(cmd);
+        gpu.queue().submit_enqueued().wait();
+        pool.reset();
+    }
+
+    // Both passes are named MockPass
+    const auto timings = profiler->timings();
+    ASSERT_EQ(timings.size(), 1u);
+    EXPECT_EQ(timings[0].name, "MockPass");
+    EXPECT_EQ(timings[0].sample_count, 2u);
+}
+
+TEST_F(RenderPipelineTest,
+       Segments_ComputePassOverlapsIndependentGraphicsPass) {
+    using enum vw::PassQueue;
+    vw::RenderPipeline pipeline;
+    pipeline.add(make_pass({}, {vw::Slot::Depth}));
+    pipeline.add(make_compute_pass({vw::Slot::Depth},
+                                   {vw::Slot::IndirectLight}));
+    pipeline.add(make_pass({vw::Slot::Depth}, {vw::Slot::DirectLight}));
+    pipeline.add(make_pass(
+        {vw::Slot::IndirectLight, vw::Slot::DirectLight},
+        {vw::Slot::ToneMapped}));
+
+    const auto &segments = pipeline.queue_segments();
+
+    // Pass 2 is submitted after the compute segment, without
+    // waiting for it
+    ASSERT_EQ(segments.size(), 4u);
+    expect_segment(segments[0], Graphics, {0}, {});
+    expect_segment(segments[1], Compute, {1}, {0});
+    expect_segment(segments[2], Graphics, {2}, {});
+    expect_segment(segments[3], Graphics, {3}, {1});
+}
+
+TEST_F(RenderPipelineTest, Segments_PipelineOutputsStayOnGraphics) {
+    using enum vw::PassQueue;
+    vw::RenderPipeline pipeline;
+    pipeline.add(make_pass({}, {vw::Slot::Depth}));
+    pipeline.add(make_compute_pass({vw::Slot::Depth},
+                                   {vw::Slot::AmbientOcclusion}));
+    pipeline.add(make_compute_pass({vw::Slot::Depth},
+                                   {vw::Slot::ToneMapped}));
+    pipeline.mark_external(vw::Slot::AmbientOcclusion);
+
+    const auto &segments = pipeline.queue_segments();
+
+    ASSERT_EQ(segments.size(), 1u);
+    expect_segment(segments[0], Graphics, {0, 1, 2}, {});
+}
+
+TEST_F(RenderPipelineTest, Segments_LastGraphicsSegmentJoinsCompute) {
+    using enum vw::PassQueue;
+    vw::RenderPipeline pipeline;
+    pipeline.add(make_pass({}, {vw::Slot::Albedo}));
+    // No outputs: kept for its side effects, read by no pass
+    pipeline.add(make_compute_pass({}, {}));
+    pipeline.add(make_pass({vw::Slot::Albedo}, {vw::Slot::ToneMapped}));
+
+    const auto &segments = pipeline.queue_segments();
+
+    ASSERT_EQ(segments.size(), 2u);
+    expect_segment(segments[0], Compute, {1}, {});
+    expect_segment(segments[1], Graphics, {0, 2}, {0});
+}
+
+TEST_F(RenderPipelineTest, ExecuteAsync_RunsEveryPass) {
+    auto &gpu = vw::tests::create_gpu();
+    // Without a compute family, both queues are the same
+    auto &compute = device->compute_queue();
+    vw::RenderPipeline pipeline;
+    pipeline.use_async_compute(device, gpu.queue(), compute, 2);
+    auto &depth = pipeline.add(make_pass({}, {vw::Slot::Depth}));
+    auto &indirect = pipeline.add(make_compute_pass(
+        {vw::Slot::Depth}, {vw::Slot::IndirectLight}));
+    auto &tone_mapping = pipeline.add(make_pass(
+        {vw::Slot::IndirectLight}, {vw::Slot::ToneMapped}));
+
+    vw::Barrier::ResourceTracker tracker;
+    vw::SubmitTicket ticket;
+    for (size_t frame = 0; frame < 3; ++frame) {
+        ticket = pipeline.execute_async(tracker, vw::Width{64},
+                                        vw::Height{64}, frame);
+    }
+    ticket.wait();
+
+    EXPECT_TRUE(depth.was_executed());
+    EXPECT_TRUE(indirect.was_executed());
+    EXPECT_TRUE(tone_mapping.was_executed());
+    EXPECT_EQ(ticket.queue, &gpu.queue());
+    EXPECT_TRUE(ticket.is_complete());
+}
+
+TEST_F(RenderPipelineTest, ExecuteAsync_NeedsQueues) {
+    vw::RenderPipeline pipeline;
+    pipeline.add(make_pass({}, {vw::Slot::ToneMapped}));
+
+    vw::Barrier::ResourceTracker tracker;
+    EXPECT_THROW(pipeline.execute_async(tracker, vw::Width{64},
+                                        vw::Height{64}, 0),
+                 vw::LogicException);
+}
+
+TEST_F(RenderPipelineTest, RenderScale_OnlyScalesRenderPasses) {
+    vw::RenderPipeline pipeline;
+    pipeline.add(make_pass({}, {vw::Slot::DirectLight}));
+    pipeline.add(make_output_pass({vw::Slot::DirectLight},
+                                  {vw::Slot::Upscaled}));
+    pipeline.set_render_scale(0.5f);
+
+    vw::Barrier::ResourceTracker tracker;
+    pipeline.execute(vk::CommandBuffer{}, tracker, vw::Width{256},
+                     vw::Height{100}, 0);
+
+    EXPECT_EQ(pipeline.pass(0)
+                  .result_image(vw::Slot::DirectLight)
+                  ->image->extent2D(),
+              (vk::Extent2D{128, 50}));
+    EXPECT_EQ(pipeline.pass(1)
+                  .result_image(vw::Slot::Upscaled)
+                  ->image->extent2D(),
+              (vk::Extent2D{256, 100}));
+}
+
+TEST_F(RenderPipelineTest, RenderScale_ExtentIsRoundedToAPixel) {
+    vw::RenderPipeline pipeline;
+    EXPECT_EQ(pipeline.render_scale(), 1.0f);
+    EXPECT_EQ(pipeline.render_extent(vw::Width{1920}, vw::Height{1080}),
+              (vk::Extent2D{1920, 1080}));
+
+    pipeline.set_render_scale(2.0f / 3.0f);
+    EXPECT_EQ(pipeline.render_extent(vw::Width{1920}, vw::Height{1080}),
+              (vk::Extent2D{1280, 720}));
+
+    pipeline.set_render_scale(0.001f);
+    EXPECT_EQ(pipeline.render_extent(vw::Width{100}, vw::Height{100}),
+              (vk::Extent2D{1, 1}));
+}
+
+TEST_F(RenderPipelineTest, RenderScale_ChangeResetsRenderPasses) {
+    vw::RenderPipeline pipeline;
+    auto &render = static_cast<MockPassWithReset &>(pipeline.add(
+        make_pass_with_reset({}, {vw::Slot::DirectLight})));
+    auto &output = static_cast<MockPassWithReset &>(
+        pipeline.add(make_output_pass({vw::Slot::DirectLight},
+                                      {vw::Slot::Upscaled})));
+
+    pipeline.set_render_scale(1.0f);
+    EXPECT_FALSE(render.was_reset_called());
+
+    pipeline.set_render_scale(0.75f);
+    EXPECT_TRUE(render.was_reset_called());
+    // Its history is at the output resolution
+    EXPECT_FALSE(output.was_reset_called());
+}
+
+TEST_F(RenderPipelineTest, RenderScale_OutOfRangeThrows) {
+    vw::RenderPipeline pipeline;
+    EXPECT_THROW(pipeline.set_render_scale(0.0f), vw::LogicException);
+    EXPECT_THROW(pipeline.set_render_scale(1.5f), vw::LogicException);
+    EXPECT_EQ(pipeline.render_scale(), 1.0f);
+}
@@ -158,6 +158,36 @@ TEST_F(RenderPassBaseTest, DimensionChangeRemovesOldImage) {
     EXPECT_EQ(large.image->extent2D().height, 512);
 }
 
+TEST_F(RenderPassBaseTest, DimensionChangeKeepsImagesOfOtherFrames) {
+    TestRenderPass pass(device, allocator);
+
+    std::weak_ptr<const vw::Image> weak_frame1 =
+        pass.test_get_or_create_image(
+                vw::Slot::Albedo, vw::Width{256}, vw::Height{256}, 1,
+                vk::Format::eR8G8B8A8Unorm,
+                vk::ImageUsageFlagBits::eColorAttachment)
+            .image;
+
+    // Frame 0 resizes while frame 1 may still be in flight
+    const auto &frame0 = pass.test_get_or_create_image(
+        vw::Slot::Albedo, vw::Width{512}, vw::Height{512}, 0,
+        vk::Format::eR8G8B8A8Unorm,
+        vk::ImageUsageFlagBits::eColorAttachment);
+    EXPECT_FALSE(weak_frame1.expired());
+
+    // The result is the image of the last request
+    const auto *result = pass.result_image(vw::Slot::Albedo);
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result->image, frame0.image);
+
+    // Frame 1 comes back at the new size
+    pass.test_get_or_create_image(
+        vw::Slot::Albedo, vw::Width{512}, vw::Height{512}, 1,
+        vk::Format::eR8G8B8A8Unorm,
+        vk::ImageUsageFlagBits::eColorAttachment);
+    EXPECT_TRUE(weak_frame1.expired());
+}
+
 TEST_F(RenderPassBaseTest, MultipleSlots) {
     TestRenderPass pass(device, allocator);
 
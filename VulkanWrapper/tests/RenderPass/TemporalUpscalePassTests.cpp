@@ -0,0 +1,278 @@
+#include "utils/create_gpu.hpp"
+#include "VulkanWrapper/Command/CommandPool.h"
+#include "VulkanWrapper/Image/Image.h"
+#include "VulkanWrapper/Image/ImageView.h"
+#include "VulkanWrapper/Memory/AllocateBufferUtils.h"
+#include "VulkanWrapper/Memory/Buffer.h"
+#include "VulkanWrapper/RenderPass/TemporalUpscalePass.h"
+#include "VulkanWrapper/Synchronization/ResourceTracker.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
+#include <filesystem>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include <gtest/gtest.h>
+#include <set>
+#include <utility>
+
+namespace vw::tests {
+
+namespace {
+
+std::filesystem::path get_shader_dir() {
+    return std::filesystem::path(__FILE__)
+               .parent_path()
+               .parent_path()
+               .parent_path() /
+           "Shaders";
+}
+
+} // anonymous namespace
+
+class TemporalUpscalePassTest : public ::testing::Test {
+  protected:
+    static constexpr Width render_width{4};
+    static constexpr Height render_height{4};
+    static constexpr Width output_width{8};
+    static constexpr Height output_height{8};
+
+    void SetUp() override {
+        auto &gpu = create_gpu();
+        device = gpu.device;
+        allocator = gpu.allocator;
+        queue = &gpu.queue();
+
+        cmdPool =
+            std::make_unique<CommandPool>(CommandPoolBuilder(device).build());
+    }
+
+    std::unique_ptr<TemporalUpscalePass>
+    create_pass(bool indirect_enabled = true) {
+        return std::make_unique<TemporalUpscalePass>(
+            device, allocator, get_shader_dir(),
+            vk::Format::eR16G16B16A16Sfloat, indirect_enabled);
+    }
+
+    CachedImage create_input(vk::Format format, vk::ImageUsageFlags usage) {
+        auto image = allocator->create_image_2D(
+            render_width, render_height, false, format,
+            usage | vk::ImageUsageFlagBits::eSampled |
+                vk::ImageUsageFlagBits::eTransferDst);
+        auto view = ImageViewBuilder(device, image)
+                        .setImageType(vk::ImageViewType::e2D)
+                        .build();
+        return CachedImage{image, view};
+    }
+
+    // Wires constant light buffers and a depth at the far plane,
+    // then upscales them
+    void run_frame(TemporalUpscalePass &pass, glm::vec4 sky,
+                   glm::vec4 direct, glm::vec4 indirect) {
+        auto sky_input = create_input(vk::Format::eR16G16B16A16Sfloat, {});
+        auto direct_input = create_input(vk::Format::eR16G16B16A16Sfloat, {});
+        auto indirect_input =
+            create_input(vk::Format::eR16G16B16A16Sfloat, {});
+        auto depth_input =
+            create_input(vk::Format::eD32Sfloat,
+                         vk::ImageUsageFlagBits::eDepthStencilAttachment);
+
+        auto cmd = cmdPool->allocate(1)[0];
+        std::ignore = cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+
+        for (const auto &[input, color] :
+             {std::pair{&sky_input, sky}, std::pair{&direct_input, direct},
+              std::pair{&indirect_input, indirect}}) {
+            request_transfer_dst(*input->image);
+            tracker.flush(cmd);
+            cmd.clearColorImage(
+                input->image->handle(), vk::ImageLayout::eTransferDstOptimal,
+                vk::ClearColorValue(color.r, color.g, color.b, color.a),
+                input->image->full_range());
+        }
+        request_transfer_dst(*depth_input.image);
+        tracker.flush(cmd);
+        vk::ClearDepthStencilValue far_plane(1.0f, 0);
+        cmd.clearDepthStencilImage(depth_input.image->handle(),
+                                   vk::ImageLayout::eTransferDstOptimal,
+                                   far_plane, depth_input.image->full_range());
+
+        pass.set_input(Slot::Sky, sky_input);
+        pass.set_input(Slot::DirectLight, direct_input);
+        pass.set_input(Slot::IndirectLight, indirect_input);
+        pass.set_input(Slot::Depth, depth_input);
+        pass.execute(cmd, tracker, output_width, output_height, 0);
+
+        std::ignore = cmd.end();
+        queue->enqueue_command_buffer(cmd);
+        queue->submit({}, {}, {}).wait();
+    }
+
+    glm::vec4 read_pixel(const Image &image, uint32_t x, uint32_t y) {
+        const auto width = image.extent2D().width;
+        const auto height = image.extent2D().height;
+        const size_t buffer_size = width * height * 4 * sizeof(uint16_t);
+
+        using StagingBuffer = Buffer<std::byte, true, StagingBufferUsage>;
+        auto staging = create_buffer<StagingBuffer>(*allocator, buffer_size);
+
+        auto cmd = cmdPool->allocate(1)[0];
+        std::ignore = cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        tracker.request(Barrier::ImageState{
+            .image = image.handle(),
+            .subresourceRange = image.full_range(),
+            .layout = vk::ImageLayout::eTransferSrcOptimal,
+            .stage = vk::PipelineStageFlagBits2::eTransfer,
+            .access = vk::AccessFlagBits2::eTransferRead});
+        tracker.flush(cmd);
+        cmd.copyImageToBuffer(
+            image.handle(), vk::ImageLayout::eTransferSrcOptimal,
+            staging.handle(),
+            vk::BufferImageCopy()
+                .setImageSubresource(vk::ImageSubresourceLayers(
+                    vk::ImageAspectFlagBits::eColor, 0, 0, 1))
+                .setImageExtent(vk::Extent3D(width, height, 1)));
+        std::ignore = cmd.end();
+        queue->enqueue_command_buffer(cmd);
+        queue->submit({}, {}, {}).wait();
+
+        auto bytes = staging.read_as_vector(0, buffer_size);
+        const auto *pixels = reinterpret_cast<const uint16_t *>(bytes.data());
+        const auto *pixel = pixels + (y * width + x) * 4;
+        return {glm::unpackHalf1x16(pixel[0]), glm::unpackHalf1x16(pixel[1]),
+                glm::unpackHalf1x16(pixel[2]), glm::unpackHalf1x16(pixel[3])};
+    }
+
+    void expect_rgb_near(glm::vec4 actual, glm::vec3 expected) {
+        constexpr float tolerance = 0.01f;
+        EXPECT_NEAR(actual.r, expected.r, tolerance);
+        EXPECT_NEAR(actual.g, expected.g, tolerance);
+        EXPECT_NEAR(actual.b, expected.b, tolerance);
+    }
+
+    std::shared_ptr<Device> device;
+    std::shared_ptr<Allocator> allocator;
+    Queue *queue;
+    std::unique_ptr<CommandPool> cmdPool;
+    Barrier::ResourceTracker tracker;
+
+  private:
+    void request_transfer_dst(const Image &image) {
+        tracker.request(Barrier::ImageState{
+            .image = image.handle(),
+            .subresourceRange = image.full_range(),
+            .layout = vk::ImageLayout::eTransferDstOptimal,
+            .stage = vk::PipelineStageFlagBits2::eClear,
+            .access = vk::AccessFlagBits2::eTransferWrite});
+    }
+};
+
+TEST_F(TemporalUpscalePassTest, Slots_WithIndirectEnabled) {
+    auto pass = create_pass(true);
+    EXPECT_EQ(pass->input_slots(),
+              (std::vector{Slot::Sky, Slot::DirectLight, Slot::IndirectLight,
+                           Slot::Depth}));
+    EXPECT_EQ(pass->output_slots(), std::vector{Slot::Upscaled});
+    EXPECT_TRUE(pass->persistent_slots().empty());
+    EXPECT_EQ(pass->resolution(), PassResolution::Output);
+    EXPECT_EQ(pass->name(), "TemporalUpscalePass");
+}
+
+TEST_F(TemporalUpscalePassTest, Slots_WithIndirectDisabled) {
+    auto pass = create_pass(false);
+    EXPECT_EQ(pass->input_slots(),
+              (std::vector{Slot::Sky, Slot::DirectLight, Slot::Depth}));
+}
+
+TEST_F(TemporalUpscalePassTest, PushConstantsMatchShaderLayout) {
+    EXPECT_EQ(sizeof(TemporalUpscalePass::PushConstants), 88u);
+}
+
+TEST(TemporalUpscaleJitterTest, JitterCoversDistinctSubPixelOffsets) {
+    constexpr auto count = TemporalUpscalePass::jitter_phase_count;
+    std::set<std::pair<float, float>> offsets;
+    glm::vec2 sum(0.0f);
+    for (uint32_t frame = 0; frame < count; ++frame) {
+        const auto jitter = TemporalUpscalePass::jitter_at(frame);
+        EXPECT_GE(jitter.x, -0.5f);
+        EXPECT_LT(jitter.x, 0.5f);
+        EXPECT_GE(jitter.y, -0.5f);
+        EXPECT_LT(jitter.y, 0.5f);
+        offsets.emplace(jitter.x, jitter.y);
+        sum += jitter;
+
+        EXPECT_EQ(TemporalUpscalePass::jitter_at(frame + count), jitter);
+    }
+    EXPECT_EQ(offsets.size(), count);
+    EXPECT_NEAR(sum.x / count, 0.0f, 0.1f);
+    EXPECT_NEAR(sum.y / count, 0.0f, 0.1f);
+}
+
+TEST(TemporalUpscaleJitterTest, JitteredProjectionOffsetsByPixels) {
+    const auto projection = glm::perspective(glm::radians(60.0f),
+                                             16.0f / 9.0f, 0.1f, 100.0f);
+    const vk::Extent2D extent{320, 180};
+    const glm::vec2 jitter(0.25f, -0.5f);
+    const auto jittered = TemporalUpscalePass::jittered_projection(
+        projection, jitter, extent);
+
+    const glm::vec4 point(1.0f, 2.0f, -10.0f, 1.0f);
+    const auto clip = projection * point;
+    const auto jittered_clip = jittered * point;
+    const glm::vec2 ndc = glm::vec2(clip) / clip.w;
+    const glm::vec2 jittered_ndc = glm::vec2(jittered_clip) / jittered_clip.w;
+
+    // One pixel spans 2 / extent in normalized device coordinates
+    const auto pixels = (jittered_ndc - ndc) *
+                        glm::vec2(extent.width, extent.height) * 0.5f;
+    EXPECT_NEAR(pixels.x, jitter.x, 1e-4f);
+    EXPECT_NEAR(pixels.y, jitter.y, 1e-4f);
+    EXPECT_NEAR(jittered_clip.z / jittered_clip.w, clip.z / clip.w, 1e-6f);
+}
+
+TEST_F(TemporalUpscalePassTest, Verify_ConstantInputUpscalesToOutputSize) {
+    auto pass = create_pass();
+    pass->set_indirect_intensity(0.5f);
+
+    run_frame(*pass, glm::vec4(0.5f, 0.0f, 0.0f, 1.0f),
+              glm::vec4(0.25f, 0.5f, 1.0f, 1.0f),
+              glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+
+    const auto *output = pass->result_image(Slot::Upscaled);
+    ASSERT_NE(output, nullptr);
+    EXPECT_EQ(output->image->extent2D(),
+              (vk::Extent2D{static_cast<uint32_t>(output_width),
+                            static_cast<uint32_t>(output_height)}));
+
+    // sky + direct + indirect * intensity
+    const glm::vec3 expected(1.25f, 1.0f, 1.5f);
+    expect_rgb_near(read_pixel(*output->image, 0, 0), expected);
+    expect_rgb_near(read_pixel(*output->image, 7, 7), expected);
+}
+
+TEST_F(TemporalUpscalePassTest, Verify_DisabledIndirectIsIgnored) {
+    auto pass = create_pass(false);
+    pass->set_indirect_intensity(1.0f);
+
+    run_frame(*pass, glm::vec4(0.0f), glm::vec4(0.5f, 0.5f, 0.5f, 1.0f),
+              glm::vec4(1.0f));
+
+    const auto *output = pass->result_image(Slot::Upscaled);
+    ASSERT_NE(output, nullptr);
+    expect_rgb_near(read_pixel(*output->image, 3, 3), glm::vec3(0.5f));
+}
+
+TEST_F(TemporalUpscalePassTest, Verify_StaleHistoryIsClampedToNeighbourhood) {
+    auto pass = create_pass();
+    pass->set_blend_factor(0.5f);
+
+    run_frame(*pass, glm::vec4(0.0f), glm::vec4(1.0f), glm::vec4(0.0f));
+    // Unclamped, the history would give 0.625
+    run_frame(*pass, glm::vec4(0.0f), glm::vec4(0.25f), glm::vec4(0.0f));
+
+    const auto *output = pass->result_image(Slot::Upscaled);
+    ASSERT_NE(output, nullptr);
+    expect_rgb_near(read_pixel(*output->image, 4, 4), glm::vec3(0.25f));
+}
+
+} // namespace vw::tests
@@ -1,5 +1,6 @@
 #include "utils/create_gpu.hpp"
 #include "VulkanWrapper/Command/CommandPool.h"
+#include "VulkanWrapper/Command/ParallelCommandRecorder.h"
 #include "VulkanWrapper/Image/Image.h"
 #include "VulkanWrapper/Image/ImageView.h"
 #include "VulkanWrapper/Memory/AllocateBufferUtils.h"
@@ -225,4 +226,46 @@ TEST_F(ZPassTest, Execute_Resize_CreatesNewImage) {
     EXPECT_EQ(results2[0].second.image->extent2D().width, 128u);
 }
 
+TEST_F(ZPassTest, Execute_WithParallelRecorder_ProducesDepthImage) {
+    constexpr Width width{64};
+    constexpr Height height{64};
+
+    auto pass = create_pass();
+
+    UBO ubo_data{};
+    ubo_data.proj = glm::perspective(
+        glm::radians(60.0f), 1.0f, 0.1f, 100.0f);
+    ubo_data.view = glm::lookAt(
+        glm::vec3(0, 0, 5), glm::vec3(0, 0, 0),
+        glm::vec3(0, 1, 0));
+
+    auto ubo = create_buffer<
+        Buffer<UBO, true, UniformBufferUsage>>(
+        *allocator, 1);
+    ubo.write(ubo_data, 0);
+
+    rt::RayTracedScene scene(device, allocator);
+
+    pass->set_uniform_buffer(ubo);
+    pass->set_scene(scene);
+    pass->set_parallel_recorder(
+        std::make_shared<ParallelCommandRecorder>(device, 4, 1));
+
+    auto cmd = cmdPool->allocate(1)[0];
+    std::ignore = cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+        vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+
+    Barrier::ResourceTracker tracker;
+    pass->execute(cmd, tracker, width, height, 0);
+
+    std::ignore = cmd.end();
+    queue->enqueue_command_buffer(cmd);
+    queue->submit({}, {}, {}).wait();
+
+    auto results = pass->result_images();
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].second.image->extent2D().width,
+              static_cast<uint32_t>(width));
+}
+
 } // namespace vw::tests
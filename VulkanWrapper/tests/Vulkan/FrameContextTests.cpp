@@ -0,0 +1,98 @@
+#include "utils/create_gpu.hpp"
+#include "VulkanWrapper/Synchronization/FrameContext.h"
+#include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+class FrameContextTest : public ::testing::Test {
+  protected:
+    vw::tests::GPU &gpu = vw::tests::create_gpu();
+    vw::FrameContext frames{gpu.device, gpu.queue(), 2};
+};
+
+} // namespace
+
+TEST_F(FrameContextTest, FramesCycleThroughSlots) {
+    std::vector<uint32_t> slots;
+    for (int i = 0; i < 3; ++i) {
+        std::ignore = frames.begin_frame();
+        slots.push_back(frames.frame_index());
+        frames.end_frame();
+    }
+
+    EXPECT_EQ(slots, (std::vector<uint32_t>{0, 1, 0}));
+    EXPECT_EQ(frames.frame_number(), 3);
+}
+
+TEST_F(FrameContextTest, CommandBuffersAreReusedBySlot) {
+    const auto first = frames.begin_frame();
+    frames.end_frame();
+    const auto second = frames.begin_frame();
+    frames.end_frame();
+    const auto third = frames.begin_frame();
+    frames.end_frame();
+
+    EXPECT_NE(first, second);
+    EXPECT_EQ(first, third);
+}
+
+TEST_F(FrameContextTest, FrameTicketCompletesOnTheQueue) {
+    std::ignore = frames.begin_frame();
+    const auto ticket = frames.end_frame();
+
+    ticket.wait();
+    EXPECT_TRUE(ticket.is_complete());
+    EXPECT_EQ(ticket.queue, &gpu.queue());
+}
+
+TEST_F(FrameContextTest, DeferredResourceLivesUntilSlotIsReused) {
+    auto resource = std::make_shared<int>(42);
+    const std::weak_ptr<int> watcher = resource;
+
+    std::ignore = frames.begin_frame();
+    frames.defer_destruction(std::move(resource));
+    frames.end_frame();
+    EXPECT_FALSE(watcher.expired());
+
+    std::ignore = frames.begin_frame();
+    frames.end_frame();
+    EXPECT_FALSE(watcher.expired());
+
+    // The first slot comes around: its frame completed
+    std::ignore = frames.begin_frame();
+    EXPECT_TRUE(watcher.expired());
+    frames.end_frame();
+}
+
+TEST_F(FrameContextTest, DeferredOutsideFrameGoesToNextFrame) {
+    auto resource = std::make_shared<int>(42);
+    const std::weak_ptr<int> watcher = resource;
+
+    frames.defer_destruction(std::move(resource));
+    std::ignore = frames.begin_frame();
+    frames.end_frame();
+    EXPECT_FALSE(watcher.expired());
+
+    frames.wait_idle();
+    EXPECT_TRUE(watcher.expired());
+}
+
+TEST_F(FrameContextTest, AllocatedCommandBuffersBelongToTheFrame) {
+    const auto main = frames.begin_frame();
+    const auto extra = frames.allocate_command_buffer();
+    frames.end_frame();
+
+    EXPECT_NE(main, extra);
+    EXPECT_THROW(std::ignore = frames.allocate_command_buffer(),
+                 vw::LogicException);
+}
+
+TEST_F(FrameContextTest, MismatchedBeginAndEndThrow) {
+    EXPECT_THROW(frames.end_frame(), vw::LogicException);
+
+    std::ignore = frames.begin_frame();
+    EXPECT_THROW(std::ignore = frames.begin_frame(), vw::LogicException);
+    frames.end_frame();
+}
@@ -0,0 +1,188 @@
+#include "utils/create_gpu.hpp"
+#include "VulkanWrapper/Command/CommandPool.h"
+#include "VulkanWrapper/Command/GpuProfiler.h"
+#include "VulkanWrapper/Image/Image.h"
+#include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Vulkan/DeviceFinder.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
+#include <array>
+#include <functional>
+#include <gtest/gtest.h>
+
+namespace {
+
+// Same as create_gpu(), with pipeline statistics queries, or null
+// when the device does not support them
+vw::tests::GPU *create_statistics_gpu() {
+    static vw::tests::GPU *gpu = []() -> vw::tests::GPU * {
+        try {
+            auto instance = vw::InstanceBuilder()
+                                .setDebug()
+                                .setApiVersion(vw::ApiVersion::e13)
+                                .build();
+
+            auto device = instance->findGpu()
+                              .with_queue(vk::QueueFlagBits::eGraphics)
+                              .with_synchronization_2()
+                              .with_pipeline_statistics_query()
+                              .build();
+
+            auto allocator = vw::AllocatorBuilder(instance, device).build();
+
+            return new vw::tests::GPU{std::move(instance), std::move(device),
+                                      std::move(allocator)};
+        } catch (...) {
+            return nullptr;
+        }
+    }();
+
+    return gpu;
+}
+
+class GpuProfilerTest : public ::testing::Test {
+  protected:
+    explicit GpuProfilerTest(vw::tests::GPU &gpu = vw::tests::create_gpu())
+        : gpu(gpu) {}
+
+    void SetUp() override {
+        image = gpu.allocator->create_image_2D(
+            vw::Width{256}, vw::Height{256}, false,
+            vk::Format::eR8G8B8A8Unorm,
+            vk::ImageUsageFlagBits::eTransferDst);
+    }
+
+    // Records and submits a frame, then waits for it
+    void frame(vw::GpuProfiler &profiler,
+               const std::function<void(vk::CommandBuffer)> &record) {
+        auto cmd = pool.allocate(1)[0];
+        std::ignore = cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        profiler.begin_frame(cmd);
+        record(cmd);
+        std::ignore = cmd.end();
+
+        gpu.queue().enqueue_command_buffer(cmd);
+        gpu.queue().submit_enqueued().wait();
+        pool.reset();
+    }
+
+    void clear(vk::CommandBuffer cmd) {
+        vk::ImageMemoryBarrier2 barrier;
+        barrier.dstStageMask = vk::PipelineStageFlagBits2::eClear;
+        barrier.dstAccessMask = vk::AccessFlagBits2::eTransferWrite;
+        barrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
+        barrier.image = image->handle();
+        barrier.subresourceRange = image->full_range();
+        cmd.pipelineBarrier2(
+            vk::DependencyInfo().setImageMemoryBarriers(barrier));
+        const vk::ClearColorValue red(std::array{1.0f, 0.0f, 0.0f, 1.0f});
+        cmd.clearColorImage(image->handle(),
+                            vk::ImageLayout::eTransferDstOptimal, red,
+                            image->full_range());
+    }
+
+    vw::tests::GPU &gpu;
+    vw::CommandPool pool = vw::CommandPoolBuilder(gpu.device).build();
+    std::shared_ptr<const vw::Image> image;
+};
+
+// Profilers with pipeline statistics, on a device enabling them
+class GpuProfilerStatisticsTest : public GpuProfilerTest {
+  protected:
+    GpuProfilerStatisticsTest()
+        : GpuProfilerTest(create_statistics_gpu()
+                              ? *create_statistics_gpu()
+                              : vw::tests::create_gpu()) {}
+
+    void SetUp() override {
+        if (!create_statistics_gpu()) {
+            GTEST_SKIP() << "Pipeline statistics queries not available";
+        }
+        GpuProfilerTest::SetUp();
+    }
+};
+
+} // namespace
+
+TEST_F(GpuProfilerStatisticsTest, ScopesAreReadBackFramesInFlightLater) {
+    vw::GpuProfiler profiler(gpu.device, 2, 8, true);
+    const auto record = [&](vk::CommandBuffer cmd) {
+        profiler.begin_scope(cmd, "Clear");
+        clear(cmd);
+        profiler.end_scope(cmd);
+        profiler.begin_scope(cmd, "Empty");
+        profiler.end_scope(cmd);
+    };
+
+    frame(profiler, record);
+    frame(profiler, record);
+    EXPECT_TRUE(profiler.timings().empty());
+
+    // Reads back the first frame
+    frame(profiler, record);
+    const auto timings = profiler.timings();
+    ASSERT_EQ(timings.size(), 2u);
+    EXPECT_EQ(timings[0].name, "Clear");
+    EXPECT_EQ(timings[1].name, "Empty");
+    for (const auto &timing : timings) {
+        EXPECT_EQ(timing.sample_count, 1u);
+        EXPECT_GE(timing.min_ms, 0.0);
+        EXPECT_LE(timing.min_ms, timing.avg_ms);
+        EXPECT_LE(timing.avg_ms, timing.max_ms);
+    }
+}
+
+TEST_F(GpuProfilerTest, SamplesAreKeptOverAWindow) {
+    vw::GpuProfiler profiler(gpu.device, 1);
+    const auto record = [&](vk::CommandBuffer cmd) {
+        profiler.begin_scope(cmd, "Clear");
+        clear(cmd);
+        profiler.end_scope(cmd);
+    };
+
+    for (std::size_t i = 0; i < vw::GpuProfiler::window_size + 10; ++i) {
+        frame(profiler, record);
+    }
+
+    const auto timings = profiler.timings();
+    ASSERT_EQ(timings.size(), 1u);
+    EXPECT_EQ(timings[0].sample_count, vw::GpuProfiler::window_size);
+    RecordProperty("clear_avg_ms", std::to_string(timings[0].avg_ms));
+}
+
+TEST_F(GpuProfilerTest, ScopesMustBeBalancedWithinAFrame) {
+    vw::GpuProfiler profiler(gpu.device, 1, 1);
+    auto cmd = pool.allocate(1)[0];
+    std::ignore = cmd.begin(vk::CommandBufferBeginInfo());
+
+    EXPECT_THROW(profiler.begin_scope(cmd, "Early"), vw::LogicException);
+    profiler.begin_frame(cmd);
+    EXPECT_THROW(profiler.end_scope(cmd), vw::LogicException);
+    profiler.begin_scope(cmd, "Outer");
+    EXPECT_THROW(profiler.begin_scope(cmd, "Inner"), vw::LogicException);
+    profiler.end_scope(cmd);
+    EXPECT_THROW(profiler.begin_scope(cmd, "TooMany"), vw::LogicException);
+
+    std::ignore = cmd.end();
+    pool.reset();
+}
+
+TEST_F(GpuProfilerStatisticsTest, ExportsCsvAndJson) {
+    vw::GpuProfiler profiler(gpu.device, 1, 4, true);
+    const auto record = [&](vk::CommandBuffer cmd) {
+        profiler.begin_scope(cmd, "Clear");
+        clear(cmd);
+        profiler.end_scope(cmd);
+    };
+    frame(profiler, record);
+    frame(profiler, record);
+
+    const auto csv = profiler.to_csv();
+    EXPECT_TRUE(csv.starts_with("name,samples,min_ms,avg_ms,max_ms,"));
+    EXPECT_NE(csv.find("\nClear,1,"), std::string::npos);
+
+    const auto json = profiler.to_json();
+    EXPECT_TRUE(
+        json.starts_with(R"({"scopes":[{"name":"Clear","samples":1,)"));
+    EXPECT_TRUE(json.ends_with("}]}"));
+}
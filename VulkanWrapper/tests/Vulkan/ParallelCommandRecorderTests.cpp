@@ -0,0 +1,220 @@
+#include "utils/create_gpu.hpp"
+#include "VulkanWrapper/Command/CommandPool.h"
+#include "VulkanWrapper/Command/ParallelCommandRecorder.h"
+#include "VulkanWrapper/Image/Image.h"
+#include "VulkanWrapper/Image/ImageView.h"
+#include "VulkanWrapper/Memory/AllocateBufferUtils.h"
+#include "VulkanWrapper/Pipeline/PipelineLayout.h"
+#include "VulkanWrapper/Utils/Error.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
+#include <algorithm>
+#include <chrono>
+#include <glm/glm.hpp>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+constexpr auto color_format = vk::Format::eR8G8B8A8Unorm;
+
+class ParallelCommandRecorderTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        image = gpu.allocator->create_image_2D(
+            vw::Width{64}, vw::Height{64}, false, color_format,
+            vk::ImageUsageFlagBits::eColorAttachment);
+        view = vw::ImageViewBuilder(gpu.device, image)
+                   .setImageType(vk::ImageViewType::e2D)
+                   .build();
+        inheritance.setColorAttachmentFormats(color_format)
+            .setRasterizationSamples(vk::SampleCountFlagBits::e1);
+    }
+
+    // Executes `secondaries` in a rendering to the image
+    void submit(const std::vector<vk::CommandBuffer> &secondaries) {
+        auto cmd = pool.allocate(1)[0];
+        std::ignore = cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+
+        vk::ImageMemoryBarrier2 barrier;
+        barrier.dstStageMask =
+            vk::PipelineStageFlagBits2::eColorAttachmentOutput;
+        barrier.dstAccessMask = vk::AccessFlagBits2::eColorAttachmentWrite;
+        barrier.newLayout = vk::ImageLayout::eColorAttachmentOptimal;
+        barrier.image = image->handle();
+        barrier.subresourceRange = view->subresource_range();
+        cmd.pipelineBarrier2(vk::DependencyInfo().setImageMemoryBarriers(
+            barrier));
+
+        const auto attachment =
+            vk::RenderingAttachmentInfo()
+                .setImageView(view->handle())
+                .setImageLayout(vk::ImageLayout::eColorAttachmentOptimal)
+                .setLoadOp(vk::AttachmentLoadOp::eClear)
+                .setStoreOp(vk::AttachmentStoreOp::eStore);
+        cmd.beginRendering(
+            vk::RenderingInfo()
+                .setFlags(
+                    vk::RenderingFlagBits::eContentsSecondaryCommandBuffers)
+                .setRenderArea(vk::Rect2D({0, 0}, {64, 64}))
+                .setLayerCount(1)
+                .setColorAttachments(attachment));
+        if (!secondaries.empty()) {
+            cmd.executeCommands(secondaries);
+        }
+        cmd.endRendering();
+        std::ignore = cmd.end();
+
+        gpu.queue().enqueue_command_buffer(cmd);
+        gpu.queue().submit_enqueued().wait();
+        pool.reset();
+    }
+
+    vw::tests::GPU &gpu = vw::tests::create_gpu();
+    vw::CommandPool pool = vw::CommandPoolBuilder(gpu.device).build();
+    std::shared_ptr<const vw::Image> image;
+    std::shared_ptr<const vw::ImageView> view;
+    vk::CommandBufferInheritanceRenderingInfo inheritance;
+};
+
+} // namespace
+
+TEST_F(ParallelCommandRecorderTest, EveryItemIsRecordedOnceInOrder) {
+    vw::ParallelCommandRecorder recorder(gpu.device, 4, 2);
+
+    std::mutex mutex;
+    std::vector<std::pair<std::size_t, std::size_t>> chunks;
+    const auto secondaries = recorder.record(
+        inheritance, 1000,
+        [&](vk::CommandBuffer, std::size_t first, std::size_t last) {
+            std::lock_guard lock(mutex);
+            chunks.emplace_back(first, last);
+        });
+
+    ASSERT_EQ(secondaries.size(), 4);
+    std::ranges::sort(chunks);
+    ASSERT_EQ(chunks.size(), 4);
+    EXPECT_EQ(chunks.front().first, 0);
+    EXPECT_EQ(chunks.back().second, 1000);
+    for (std::size_t i = 1; i < chunks.size(); ++i) {
+        EXPECT_EQ(chunks[i].first, chunks[i - 1].second);
+    }
+
+    submit(secondaries);
+}
+
+TEST_F(ParallelCommandRecorderTest, EmptyChunksAreNotRecorded) {
+    vw::ParallelCommandRecorder recorder(gpu.device, 4, 2);
+
+    const auto secondaries = recorder.record(
+        inheritance, 2, [](vk::CommandBuffer, std::size_t, std::size_t) {});
+    EXPECT_EQ(secondaries.size(), 2);
+
+    EXPECT_TRUE(recorder
+                    .record(inheritance, 0,
+                            [](vk::CommandBuffer, std::size_t,
+                               std::size_t) {})
+                    .empty());
+    submit(secondaries);
+}
+
+TEST_F(ParallelCommandRecorderTest, CommandBuffersAreReusedByFrameSlot) {
+    vw::ParallelCommandRecorder recorder(gpu.device, 2, 2);
+    const auto nothing = [](vk::CommandBuffer, std::size_t, std::size_t) {};
+
+    const auto first = recorder.record(inheritance, 2, nothing);
+    submit(first);
+    recorder.begin_frame();
+    const auto second = recorder.record(inheritance, 2, nothing);
+    submit(second);
+    recorder.begin_frame();
+    const auto third = recorder.record(inheritance, 2, nothing);
+    submit(third);
+
+    EXPECT_NE(first, second);
+    EXPECT_EQ(first, third);
+}
+
+TEST_F(ParallelCommandRecorderTest, WorkerExceptionIsRethrown) {
+    vw::ParallelCommandRecorder recorder(gpu.device, 3, 1);
+
+    EXPECT_THROW(std::ignore = recorder.record(
+                     inheritance, 30,
+                     [](vk::CommandBuffer, std::size_t first, std::size_t) {
+                         if (first != 0) {
+                             throw std::runtime_error("worker failed");
+                         }
+                     }),
+                 std::runtime_error);
+
+    // The recorder stays usable
+    recorder.begin_frame();
+    EXPECT_EQ(recorder
+                  .record(inheritance, 30,
+                          [](vk::CommandBuffer, std::size_t, std::size_t) {})
+                  .size(),
+              3);
+}
+
+TEST_F(ParallelCommandRecorderTest, RequiresAThread) {
+    EXPECT_THROW(vw::ParallelCommandRecorder(gpu.device, 0, 2),
+                 vw::LogicException);
+}
+
+TEST_F(ParallelCommandRecorderTest, DrawLoopScalingBenchmark) {
+    // Per instance, the state changes of a mesh draw loop: vertex and
+    // index buffers and the push constant of the transform. Timings are
+    // reported, not asserted.
+    constexpr std::size_t instance_count = 50'000;
+    using clock = std::chrono::steady_clock;
+
+    auto vertices = vw::create_buffer<float, false, vw::VertexBufferUsage>(
+        *gpu.allocator, 1024);
+    auto indices = gpu.allocator->allocate_index_buffer(1024);
+    auto layout = vw::PipelineLayoutBuilder(gpu.device)
+                      .with_push_constant_range(
+                          vk::PushConstantRange()
+                              .setStageFlags(vk::ShaderStageFlagBits::eVertex)
+                              .setSize(sizeof(glm::mat4)))
+                      .build();
+    const std::vector<glm::mat4> transforms(instance_count, glm::mat4(1.0f));
+
+    const auto draw_loop = [&](vk::CommandBuffer cmd, std::size_t first,
+                               std::size_t last) {
+        const vk::Buffer vertex_buffer = vertices.handle();
+        const vk::DeviceSize offset = 0;
+        for (std::size_t i = first; i < last; ++i) {
+            cmd.bindVertexBuffers(0, vertex_buffer, offset);
+            cmd.bindIndexBuffer(indices.handle(), 0, vk::IndexType::eUint32);
+            cmd.pushConstants(layout.handle(),
+                              vk::ShaderStageFlagBits::eVertex, 0,
+                              sizeof(glm::mat4), &transforms[i]);
+        }
+    };
+
+    double serial_seconds = 0.0;
+    for (uint32_t threads : {1U, 2U, 4U, 8U}) {
+        vw::ParallelCommandRecorder recorder(gpu.device, threads, 1);
+        // Warm up the command pools
+        submit(recorder.record(inheritance, instance_count, draw_loop));
+        recorder.begin_frame();
+
+        const auto start = clock::now();
+        const auto secondaries =
+            recorder.record(inheritance, instance_count, draw_loop);
+        const auto seconds =
+            std::chrono::duration<double>(clock::now() - start).count();
+        submit(secondaries);
+        recorder.begin_frame();
+
+        if (threads == 1) {
+            serial_seconds = seconds;
+        }
+        const auto suffix = std::to_string(threads) + "_threads";
+        RecordProperty("elapsed_us_" + suffix,
+                       std::to_string(int64_t(seconds * 1'000'000)));
+        RecordProperty("speedup_" + suffix,
+                       std::to_string(serial_seconds / seconds));
+    }
+}
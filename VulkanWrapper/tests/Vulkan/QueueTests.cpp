@@ -0,0 +1,97 @@
+#include "utils/create_gpu.hpp"
+#include "VulkanWrapper/Command/CommandPool.h"
+#include "VulkanWrapper/Memory/AllocateBufferUtils.h"
+#include "VulkanWrapper/Memory/Buffer.h"
+#include "VulkanWrapper/Synchronization/Fence.h"
+#include "VulkanWrapper/Vulkan/Queue.h"
+#include <array>
+#include <gtest/gtest.h>
+
+namespace {
+
+using HostBuffer = vw::Buffer<uint32_t, true, vw::StagingBufferUsage>;
+
+class QueueTest : public ::testing::Test {
+  protected:
+    // Records a command buffer filling `count` values of `buffer` from
+    // `offset` with `value`
+    vk::CommandBuffer fill(const HostBuffer &buffer, uint32_t offset,
+                           uint32_t count, uint32_t value) {
+        auto cmd = pool.allocate(1)[0];
+        std::ignore = cmd.begin(vk::CommandBufferBeginInfo().setFlags(
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        cmd.fillBuffer(buffer.handle(), offset * sizeof(uint32_t),
+                       count * sizeof(uint32_t), value);
+        std::ignore = cmd.end();
+        return cmd;
+    }
+
+    vw::tests::GPU &gpu = vw::tests::create_gpu();
+    vw::CommandPool pool = vw::CommandPoolBuilder(gpu.device).build();
+    HostBuffer buffer = vw::create_buffer<HostBuffer>(*gpu.allocator, 8);
+};
+
+} // namespace
+
+TEST_F(QueueTest, DefaultTicketIsComplete) {
+    const vw::SubmitTicket ticket;
+    EXPECT_TRUE(ticket.is_complete());
+    ticket.wait();
+}
+
+TEST_F(QueueTest, TicketsCompleteInSubmissionOrder) {
+    auto &queue = gpu.queue();
+
+    queue.enqueue_command_buffer(fill(buffer, 0, 8, 1));
+    const auto first = queue.submit_enqueued();
+    queue.enqueue_command_buffer(fill(buffer, 0, 8, 2));
+    const auto second = queue.submit_enqueued();
+
+    EXPECT_EQ(second.value, first.value + 1);
+    second.wait();
+    EXPECT_TRUE(first.is_complete());
+    EXPECT_GE(queue.completed_value(), second.value);
+    EXPECT_EQ(buffer.read_as_vector(0, 8), std::vector<uint32_t>(8, 2));
+}
+
+TEST_F(QueueTest, BatchesShareOneSubmission) {
+    auto &queue = gpu.queue();
+    const std::array first = {fill(buffer, 0, 4, 3)};
+    const std::array second = {fill(buffer, 4, 4, 4)};
+    const std::array batches = {vw::SubmitBatch{.command_buffers = first},
+                                vw::SubmitBatch{.command_buffers = second}};
+
+    const auto previous = queue.last_submission().value;
+    const auto ticket = queue.submit(batches);
+
+    EXPECT_EQ(ticket.value, previous + 1);
+    ticket.wait();
+    EXPECT_EQ(buffer.read_as_vector(0, 8),
+              (std::vector<uint32_t>{3, 3, 3, 3, 4, 4, 4, 4}));
+}
+
+TEST_F(QueueTest, TicketIsAWaitDependency) {
+    auto &queue = gpu.queue();
+
+    queue.enqueue_command_buffer(fill(buffer, 0, 8, 5));
+    const auto producer = queue.submit_enqueued();
+
+    const auto wait =
+        producer.wait_info(vk::PipelineStageFlagBits2::eTransfer);
+    queue.enqueue_command_buffer(fill(buffer, 4, 4, 6));
+    queue.submit_enqueued(std::span(&wait, 1)).wait();
+
+    EXPECT_EQ(buffer.read_as_vector(0, 8),
+              (std::vector<uint32_t>{5, 5, 5, 5, 6, 6, 6, 6}));
+}
+
+TEST_F(QueueTest, LegacySubmitAdvancesTimeline) {
+    auto &queue = gpu.queue();
+    const auto previous = queue.last_submission().value;
+
+    queue.enqueue_command_buffer(fill(buffer, 0, 8, 7));
+    queue.submit({}, {}, {}).wait();
+
+    EXPECT_EQ(queue.last_submission().value, previous + 1);
+    EXPECT_TRUE(queue.last_submission().is_complete());
+}
@@ -0,0 +1,85 @@
+#include "VulkanWrapper/Utils/FlatHandleMap.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+vk::Image image(uintptr_t handle) {
+    return vk::Image(reinterpret_cast<VkImage>(handle));
+}
+
+} // namespace
+
+TEST(FlatHandleMapTest, EmptyMapFindsNothing) {
+    vw::FlatHandleMap<vk::Image, int> map;
+
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(image(0x10)), nullptr);
+    EXPECT_FALSE(map.contains(image(0x10)));
+}
+
+TEST(FlatHandleMapTest, SubscriptInsertsDefaultValue) {
+    vw::FlatHandleMap<vk::Image, int> map;
+
+    EXPECT_EQ(map[image(0x10)], 0);
+    map[image(0x10)] = 42;
+
+    ASSERT_NE(map.find(image(0x10)), nullptr);
+    EXPECT_EQ(*map.find(image(0x10)), 42);
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(FlatHandleMapTest, GrowingKeepsEveryEntry) {
+    vw::FlatHandleMap<vk::Image, uintptr_t> map;
+    // Aligned like real handles, so that only high bits differ
+    for (uintptr_t i = 1; i <= 10'000; ++i) {
+        map[image(i * 256)] = i;
+    }
+
+    EXPECT_EQ(map.size(), 10'000u);
+    for (uintptr_t i = 1; i <= 10'000; ++i) {
+        const auto *value = map.find(image(i * 256));
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(*value, i);
+    }
+    EXPECT_EQ(map.find(image(10'001 * 256)), nullptr);
+}
+
+TEST(FlatHandleMapTest, ReserveKeepsValueAddressesStable) {
+    vw::FlatHandleMap<vk::Image, int> map;
+    map.reserve(1000);
+
+    int *first = &map[image(0x10)];
+    for (uintptr_t i = 1; i < 1000; ++i) {
+        map[image(0x10 + i * 8)] = 1;
+    }
+
+    EXPECT_EQ(first, map.find(image(0x10)));
+}
+
+TEST(FlatHandleMapTest, ForEachVisitsEveryEntry) {
+    vw::FlatHandleMap<vk::Image, int> map;
+    map[image(0x10)] = 1;
+    map[image(0x20)] = 2;
+    map[image(0x30)] = 3;
+
+    int sum = 0;
+    std::size_t count = 0;
+    map.for_each([&](vk::Image handle, int value) {
+        EXPECT_NE(handle, vk::Image{});
+        sum += value;
+        ++count;
+    });
+
+    EXPECT_EQ(count, 3u);
+    EXPECT_EQ(sum, 6);
+}
+
+TEST(FlatHandleMapTest, ClearRemovesEverything) {
+    vw::FlatHandleMap<vk::Image, int> map;
+    map[image(0x10)] = 1;
+
+    map.clear();
+
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains(image(0x10)));
+}
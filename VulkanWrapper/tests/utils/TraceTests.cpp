@@ -0,0 +1,116 @@
+#include "VulkanWrapper/Utils/Trace.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+class TraceTest : public ::testing::Test {
+  protected:
+    // Zones of other tests, or of the library itself with tracing on
+    void SetUp() override { std::ignore = vw::trace::collect(); }
+};
+
+} // namespace
+
+TEST_F(TraceTest, ScopedZoneIsRecordedOnItsThread) {
+    {
+        const vw::trace::ScopedZone zone("Outer");
+        const vw::trace::ScopedZone inner("Inner");
+    }
+
+    const auto zones = vw::trace::collect();
+    ASSERT_EQ(zones.size(), 2u);
+    const auto name = &vw::trace::Zone::name;
+    const auto outer = std::ranges::find(zones, "Outer", name);
+    const auto inner = std::ranges::find(zones, "Inner", name);
+    ASSERT_NE(outer, zones.end());
+    ASSERT_NE(inner, zones.end());
+    for (const auto &zone : zones) {
+        EXPECT_LE(zone.begin_ns, zone.end_ns);
+        EXPECT_EQ(zone.thread, vw::trace::thread_index());
+    }
+    EXPECT_LE(outer->begin_ns, inner->begin_ns);
+    EXPECT_LE(inner->end_ns, outer->end_ns);
+
+    EXPECT_TRUE(vw::trace::collect().empty());
+}
+
+TEST_F(TraceTest, ZonesOfEveryThreadAreCollected) {
+    constexpr int thread_count = 4;
+    constexpr int zone_count = 100;
+    {
+        std::vector<std::jthread> threads;
+        for (int i = 0; i < thread_count; ++i) {
+            threads.emplace_back([] {
+                for (int j = 0; j < zone_count; ++j) {
+                    const vw::trace::ScopedZone zone("Worker");
+                }
+            });
+        }
+    }
+
+    // The threads have exited: their buffers are still drained
+    const auto zones = vw::trace::collect();
+    ASSERT_EQ(zones.size(), std::size_t(thread_count * zone_count));
+    std::set<uint32_t> threads;
+    for (const auto &zone : zones) {
+        threads.insert(zone.thread);
+    }
+    EXPECT_EQ(threads.size(), std::size_t(thread_count));
+    EXPECT_TRUE(std::ranges::is_sorted(zones, {}, &vw::trace::Zone::begin_ns));
+}
+
+TEST_F(TraceTest, FullBufferDropsZones) {
+    const auto dropped = vw::trace::dropped_count();
+    for (std::size_t i = 0; i < vw::trace::thread_buffer_capacity + 10; ++i) {
+        vw::trace::record({.name = "Zone"});
+    }
+
+    EXPECT_EQ(vw::trace::collect().size(), vw::trace::thread_buffer_capacity);
+    EXPECT_EQ(vw::trace::dropped_count() - dropped, 10u);
+}
+
+TEST_F(TraceTest, InternedNamesAreShared) {
+    std::string name = "DynamicName";
+    const auto interned = vw::trace::intern(name);
+    name = "Changed";
+
+    EXPECT_EQ(interned, "DynamicName");
+    EXPECT_EQ(vw::trace::intern("DynamicName").data(), interned.data());
+}
+
+TEST_F(TraceTest, ChromeJsonHasCompleteEventsAndAGpuTrack) {
+    const std::vector<vw::trace::Zone> zones{
+        {.name = "Cpu", .begin_ns = 1'000, .end_ns = 3'500, .thread = 2},
+        {.name = "Gpu",
+         .begin_ns = 2'000,
+         .end_ns = 2'500,
+         .thread = vw::trace::gpu_thread}};
+
+    const auto json = vw::trace::to_chrome_json(zones);
+
+    EXPECT_TRUE(json.starts_with(R"({"traceEvents":[{"name":"thread_name")"));
+    EXPECT_NE(json.find(R"({"name":"Cpu","ph":"X","ts":0.000,"dur":2.500,)"
+                        R"("pid":1,"tid":2})"),
+              std::string::npos);
+    EXPECT_NE(json.find(R"({"name":"Gpu","ph":"X","ts":1.000,"dur":0.500,)"),
+              std::string::npos);
+    EXPECT_TRUE(json.ends_with("]}"));
+    EXPECT_EQ(vw::trace::to_chrome_json({}), R"({"traceEvents":[]})");
+}
+
+TEST_F(TraceTest, MacroFollowsTheBuildSwitch) {
+    {
+        VW_TRACE_ZONE("Macro");
+    }
+
+#ifdef VW_ENABLE_TRACING
+    EXPECT_EQ(vw::trace::collect().size(), 1u);
+#else
+    EXPECT_TRUE(vw::trace::collect().empty());
+#endif
+}
@@ -16,6 +16,7 @@ GPU &create_gpu() {
                           .with_synchronization_2()
                           .with_dynamic_rendering()
                           .with_descriptor_indexing()
+                          .with_timeline_semaphore()
                           .build();
 
         auto allocator = AllocatorBuilder(instance, device).build();
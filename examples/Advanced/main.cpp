@@ -42,7 +42,8 @@ int main() {
         App app;
 
         // Create mesh manager and ray traced scene
-        vw::Model::MeshManager mesh_manager(app.device, app.allocator);
+        vw::Model::MeshManager mesh_manager(app.device, app.allocator,
+                                            app.device->graphicsQueue());
         vw::rt::RayTracedScene rayTracedScene(app.device, app.allocator);
 
         // Load meshes (no instances yet - addresses not resolved)
@@ -241,20 +242,22 @@ int main() {
                     transfer.resourceTracker().flush(commandBuffers[index]);
                 }
 
-                const vk::PipelineStageFlags waitStage =
-                    vk::PipelineStageFlagBits::eTopOfPipe;
-
-                const auto image_available_handle =
-                    imageAvailableSemaphore.handle();
-                const auto render_finished_handle =
-                    renderFinishedSemaphore.handle();
+                const auto image_available =
+                    vk::SemaphoreSubmitInfo()
+                        .setSemaphore(imageAvailableSemaphore.handle())
+                        .setStageMask(
+                            vk::PipelineStageFlagBits2::eAllCommands);
+                const auto render_finished =
+                    vk::SemaphoreSubmitInfo()
+                        .setSemaphore(renderFinishedSemaphore.handle())
+                        .setStageMask(
+                            vk::PipelineStageFlagBits2::eAllCommands);
 
                 app.device->graphicsQueue().enqueue_command_buffer(
                     commandBuffers[index]);
 
-                app.device->graphicsQueue().submit(
-                    {&waitStage, 1}, {&image_available_handle, 1},
-                    {&render_finished_handle, 1});
+                app.device->graphicsQueue().submit_enqueued(
+                    {&image_available, 1}, {&render_finished, 1});
 
                 app.swapchain.present(index, renderFinishedSemaphore);
                 app.device->wait_idle();
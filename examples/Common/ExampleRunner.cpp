@@ -1,16 +1,19 @@
 #include "ExampleRunner.h"
-#include <VulkanWrapper/Command/CommandBuffer.h>
 #include <VulkanWrapper/Command/CommandPool.h>
 #include <VulkanWrapper/Image/ImageView.h>
 #include <VulkanWrapper/Memory/Barrier.h>
 #include <VulkanWrapper/Memory/Transfer.h>
 #include <VulkanWrapper/Synchronization/Fence.h>
+#include <VulkanWrapper/Synchronization/FrameContext.h>
 #include <VulkanWrapper/Synchronization/ResourceTracker.h>
 #include <VulkanWrapper/Synchronization/Semaphore.h>
 #include <VulkanWrapper/Utils/Error.h>
 #include <VulkanWrapper/Vulkan/Queue.h>
 
-ExampleRunner::ExampleRunner(App &app) : m_app(app) {}
+ExampleRunner::ExampleRunner(App &app)
+    : m_app(app),
+      m_frames(std::make_shared<vw::FrameContext>(
+          app.device, app.device->graphicsQueue())) {}
 
 std::shared_ptr<const vw::ImageView> ExampleRunner::result_image() {
     return nullptr;
@@ -27,22 +30,41 @@ App &ExampleRunner::app() { return m_app; }
 
 vw::Transfer &ExampleRunner::transfer() { return m_transfer; }
 
+const std::shared_ptr<vw::FrameContext> &ExampleRunner::frame_context() {
+    return m_frames;
+}
+
 int ExampleRunner::frame_count() const { return m_frame_count; }
 
 void ExampleRunner::run() {
     try {
         setup();
 
+        auto &queue = m_app.device->graphicsQueue();
+        auto &frames = *m_frames;
+
         auto commandPool = vw::CommandPoolBuilder(m_app.device)
                                .with_reset_command_buffer()
                                .build();
-        auto commandBuffers =
-            commandPool.allocate(m_app.swapchain.number_images());
-
-        auto imageAvailableSemaphore =
-            vw::SemaphoreBuilder(m_app.device).build();
-        auto renderFinishedSemaphore =
-            vw::SemaphoreBuilder(m_app.device).build();
+        auto screenshotCommandBuffer = commandPool.allocate(1)[0];
+
+        // Acquisition semaphores are reused with their frame slot,
+        // render semaphores with their swapchain image
+        std::vector<vw::Semaphore> imageAvailableSemaphores;
+        for (uint32_t i = 0; i < frames.frames_in_flight(); ++i) {
+            imageAvailableSemaphores.push_back(
+                vw::SemaphoreBuilder(m_app.device).build());
+        }
+        std::vector<vw::Semaphore> renderFinishedSemaphores;
+        auto create_render_semaphores = [&]() {
+            renderFinishedSemaphores.clear();
+            for (int i = 0; i < m_app.swapchain.number_images();
+                 ++i) {
+                renderFinishedSemaphores.push_back(
+                    vw::SemaphoreBuilder(m_app.device).build());
+            }
+        };
+        create_render_semaphores();
 
         auto do_resize = [&]() {
             auto width = m_app.window.width();
@@ -59,8 +81,7 @@ void ExampleRunner::run() {
                     .with_old_swapchain(m_app.swapchain.handle())
                     .build();
 
-            commandBuffers = commandPool.allocate(
-                m_app.swapchain.number_images());
+            create_render_semaphores();
 
             on_resize(width, height);
             m_frame_count = 0;
@@ -74,105 +95,101 @@ void ExampleRunner::run() {
                 continue;
             }
 
+            // Waits for the frame that last used this slot only,
+            // so that the GPU still executes the previous one
+            auto cmd = frames.begin_frame();
+            const auto &imageAvailableSemaphore =
+                imageAvailableSemaphores[frames.frame_index()];
+
+            uint32_t index = 0;
             try {
-                auto index =
+                index = static_cast<uint32_t>(
                     m_app.swapchain.acquire_next_image(
-                        imageAvailableSemaphore);
-
-                const auto &image_view =
-                    m_app.swapchain.image_views()[index];
-
-                commandBuffers[index].reset();
-                {
-                    vw::CommandBufferRecorder recorder(
-                        commandBuffers[index]);
-
-                    render(commandBuffers[index], m_transfer,
-                           index);
-
-                    auto result_view = result_image();
-                    if (result_view != nullptr) {
-                        m_transfer.blit(commandBuffers[index],
-                                        result_view->image(),
-                                        image_view->image());
-                    }
-
-                    // Transition swapchain image to present
-                    m_transfer.resourceTracker().request(
-                        vw::Barrier::ImageState{
-                            .image =
-                                image_view->image()->handle(),
-                            .subresourceRange =
-                                image_view->subresource_range(),
-                            .layout =
-                                vk::ImageLayout::ePresentSrcKHR,
-                            .stage =
-                                vk::PipelineStageFlagBits2::eNone,
-                            .access =
-                                vk::AccessFlagBits2::eNone});
-                    m_transfer.resourceTracker().flush(
-                        commandBuffers[index]);
-                }
-
-                // Submit
-                const vk::PipelineStageFlags waitStage =
-                    vk::PipelineStageFlagBits::eTopOfPipe;
-                const auto img_sem =
-                    imageAvailableSemaphore.handle();
-                const auto rend_sem =
-                    renderFinishedSemaphore.handle();
-
-                m_app.device->graphicsQueue()
-                    .enqueue_command_buffer(
-                        commandBuffers[index]);
-                m_app.device->graphicsQueue().submit(
-                    {&waitStage, 1}, {&img_sem, 1},
-                    {&rend_sem, 1});
+                        imageAvailableSemaphore));
+            } catch (const vw::SwapchainException &) {
+                // Submit the empty frame to release its slot
+                frames.end_frame();
+                do_resize();
+                continue;
+            }
 
-                m_app.swapchain.present(index,
-                                        renderFinishedSemaphore);
-                m_app.device->wait_idle();
+            const auto &image_view =
+                m_app.swapchain.image_views()[index];
+            const auto &renderFinishedSemaphore =
+                renderFinishedSemaphores[index];
 
-                std::cout << "Iteration: " << m_frame_count
-                          << std::endl;
-                m_frame_count++;
-
-                if (should_screenshot()) {
-                    commandBuffers[index].reset();
-                    std::ignore = commandBuffers[index].begin(
-                        vk::CommandBufferBeginInfo{});
-
-                    m_transfer.resourceTracker().request(
-                        vw::Barrier::ImageState{
-                            .image =
-                                image_view->image()->handle(),
-                            .subresourceRange =
-                                image_view->subresource_range(),
-                            .layout = vk::ImageLayout::
-                                eTransferSrcOptimal,
-                            .stage =
-                                vk::PipelineStageFlagBits2::
-                                    eTransfer,
-                            .access =
-                                vk::AccessFlagBits2::
-                                    eTransferRead});
-                    m_transfer.resourceTracker().flush(
-                        commandBuffers[index]);
-
-                    m_transfer.saveToFile(
-                        commandBuffers[index], *m_app.allocator,
-                        m_app.device->graphicsQueue(),
-                        image_view->image(), "screenshot.png",
-                        vk::ImageLayout::ePresentSrcKHR);
-
-                    std::cout
-                        << "Screenshot saved to screenshot.png"
-                        << std::endl;
-                    break;
-                }
+            render(cmd, m_transfer, index);
+
+            auto result_view = result_image();
+            if (result_view != nullptr) {
+                m_transfer.blit(cmd, result_view->image(),
+                                image_view->image());
+            }
+
+            // Transition swapchain image to present
+            m_transfer.resourceTracker().request(
+                vw::Barrier::ImageState{
+                    .image = image_view->image()->handle(),
+                    .subresourceRange =
+                        image_view->subresource_range(),
+                    .layout = vk::ImageLayout::ePresentSrcKHR,
+                    .stage = vk::PipelineStageFlagBits2::eNone,
+                    .access = vk::AccessFlagBits2::eNone});
+            m_transfer.resourceTracker().flush(cmd);
+
+            // Submit
+            const auto img_sem =
+                vk::SemaphoreSubmitInfo()
+                    .setSemaphore(imageAvailableSemaphore.handle())
+                    .setStageMask(
+                        vk::PipelineStageFlagBits2::eAllCommands);
+            const auto rend_sem =
+                vk::SemaphoreSubmitInfo()
+                    .setSemaphore(renderFinishedSemaphore.handle())
+                    .setStageMask(
+                        vk::PipelineStageFlagBits2::eAllCommands);
+            frames.end_frame({&img_sem, 1}, {&rend_sem, 1});
 
+            try {
+                m_app.swapchain.present(index,
+                                        renderFinishedSemaphore);
             } catch (const vw::SwapchainException &) {
                 do_resize();
+                continue;
+            }
+
+            std::cout << "Iteration: " << m_frame_count
+                      << std::endl;
+            m_frame_count++;
+
+            if (should_screenshot()) {
+                frames.wait_idle();
+                screenshotCommandBuffer.reset();
+                std::ignore = screenshotCommandBuffer.begin(
+                    vk::CommandBufferBeginInfo{});
+
+                m_transfer.resourceTracker().request(
+                    vw::Barrier::ImageState{
+                        .image = image_view->image()->handle(),
+                        .subresourceRange =
+                            image_view->subresource_range(),
+                        .layout =
+                            vk::ImageLayout::eTransferSrcOptimal,
+                        .stage =
+                            vk::PipelineStageFlagBits2::eTransfer,
+                        .access =
+                            vk::AccessFlagBits2::eTransferRead});
+                m_transfer.resourceTracker().flush(
+                    screenshotCommandBuffer);
+
+                m_transfer.saveToFile(
+                    screenshotCommandBuffer, *m_app.allocator,
+                    queue, image_view->image(), "screenshot.png",
+                    vk::ImageLayout::ePresentSrcKHR);
+
+                std::cout << "Screenshot saved to screenshot.png"
+                          << std::endl;
+                break;
             }
         }
 
@@ -5,6 +5,7 @@
 #include <memory>
 
 namespace vw {
+class FrameContext;
 class ImageView;
 }
 
@@ -27,10 +28,14 @@ class ExampleRunner {
 
     App &app();
     vw::Transfer &transfer();
+    // Shared with the objects that defer destructions to it, e.g.
+    // RayTracedScene::set_frame_context()
+    const std::shared_ptr<vw::FrameContext> &frame_context();
     int frame_count() const;
 
   private:
     App &m_app;
+    std::shared_ptr<vw::FrameContext> m_frames;
     vw::Transfer m_transfer;
     int m_frame_count = 0;
 };
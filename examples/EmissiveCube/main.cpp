@@ -37,7 +37,11 @@ class EmissiveCubeExample : public ExampleRunner {
     explicit EmissiveCubeExample(App &app)
         : ExampleRunner(app),
           m_mesh_manager(app.device, app.allocator),
-          m_ray_traced_scene(app.device, app.allocator) {}
+          m_ray_traced_scene(app.device, app.allocator) {
+        // Replaced acceleration structures outlive the frames in
+        // flight instead of waiting for the device
+        m_ray_traced_scene.set_frame_context(frame_context());
+    }
 
   protected:
     void setup() override {
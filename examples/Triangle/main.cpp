@@ -49,8 +49,9 @@ class TriangleExample : public ExampleRunner {
                 *app().allocator, indices.size()));
 
         {
-            vw::StagingBufferManager staging(app().device,
-                                             app().allocator);
+            vw::StagingBufferManager staging(
+                app().device, app().allocator,
+                app().device->graphicsQueue());
             staging.fill_buffer(
                 std::span<const vw::FullVertex3D>{vertices},
                 *m_vertex_buffer, 0);